@@ -13,6 +13,8 @@ Options:
   [--analyze]     Enable static source code analysis checks by the compiler.
                   This can slow down compilation time significantly.
 
+  [--benchmarks]  Also build the library benchmark executables.
+
   [--clean]       Remove all build-related directories and files and then exit.
 
   [--config]      Only execute the build configuration step. This option will skip
@@ -48,6 +50,7 @@ EOS
 
 # Arg flags
 ARG_ANALYZE=false;
+ARG_BENCHMARKS=false;
 ARG_CLEAN=false;
 ARG_CONFIG=false;
 ARG_COVERAGE=false;
@@ -69,6 +72,10 @@ for arg in "$@"; do
     ARG_ANALYZE=true;
     shift
     ;;
+    --benchmarks)
+    ARG_BENCHMARKS=true;
+    shift
+    ;;
     --clean)
     ARG_CLEAN=true;
     shift
@@ -232,6 +239,7 @@ BUILD_ONLY_LIBS=OFF;
 BUILD_ANALYZE="OFF";
 BUILD_WITH_SANITIZERS="OFF";
 BUILD_WITH_COVERAGE="OFF";
+BUILD_BENCHMARKS="OFF";
 
 if [[ $ARG_IGNORE_WARNINGS == true ]]; then
   IGNORE_WARNINGS="ON";
@@ -245,6 +253,9 @@ fi
 if [[ $ARG_SKIP_TESTS == true ]]; then
   BUILD_TESTS="OFF";
 fi
+if [[ $ARG_BENCHMARKS == true ]]; then
+  BUILD_BENCHMARKS="ON";
+fi
 if [[ $ARG_SANITIZERS == true ]]; then
   BUILD_WITH_SANITIZERS="ON";
 fi
@@ -275,6 +286,7 @@ if [[ $ARG_SKIP_CONFIG == false ]]; then
         -DRECKON_IGNORE_WARNINGS="$IGNORE_WARNINGS" \
         -DRECKON_SOURCE_ANALYSIS="$BUILD_ANALYZE" \
         -DRECKON_BUILD_TESTS="$BUILD_TESTS" \
+        -DRECKON_BUILD_BENCHMARKS="$BUILD_BENCHMARKS" \
         -DRECKON_BUILD_SHARED_LIBS="$BUILD_SHARED_LIBS" \
         -DRECKON_BUILD_ONLY_LIBS="$BUILD_ONLY_LIBS" \
         -DRECKON_USE_SANITIZERS="$BUILD_WITH_SANITIZERS" \
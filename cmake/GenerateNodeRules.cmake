@@ -0,0 +1,144 @@
+# Copyright (C) 2026 Raven Computing
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+#==============================================================================
+#
+# Generates the node rule table of a programming language as a C header.
+# This file is a CMake script and must be run in script mode, i.e. with
+# `cmake -P`. It is used by the generate_node_rules() function and should
+# not be run directly. The minimum CMake version required by this code
+# is v3.22.
+#
+# The symbol identifiers are read from the parser source of the tree-sitter
+# grammar of the language and the rules from the node rule specification of
+# the language. The generated header defines a static constant array of
+# `NodeRule` values, named NODE_RULES_${RULES_NAME}, which is indexed by
+# grammar symbol, and its size, NODE_RULES_${RULES_NAME}_SIZE. The script
+# fails if the specification refers to a symbol that the grammar does
+# not define.
+#
+# Variables:
+#
+#   GRAMMAR_SOURCE:
+#       The path to the parser source file of the grammar.
+#
+#   RULES_SPEC:
+#       The path to the node rule specification file.
+#
+#   RULES_NAME:
+#       The name of the language in all upper case, as used in the names
+#       of the generated definitions.
+#
+#   OUTPUT_HEADER:
+#       The path of the header file to generate.
+#
+#==============================================================================
+
+foreach(VAR_NAME GRAMMAR_SOURCE RULES_SPEC RULES_NAME OUTPUT_HEADER)
+    if(NOT DEFINED ${VAR_NAME})
+        message(FATAL_ERROR "Node rule generation requires ${VAR_NAME}")
+    endif()
+endforeach()
+
+file(READ "${GRAMMAR_SOURCE}" GRAMMAR_CONTENT)
+
+# Only the enumeration of the symbol identifiers is considered, since
+# other parts of the parser source have a similar syntax
+string(FIND "${GRAMMAR_CONTENT}" "enum ts_symbol_identifiers {" ENUM_START)
+if(ENUM_START EQUAL -1)
+    message(
+        FATAL_ERROR
+        "No symbol identifiers found in grammar source '${GRAMMAR_SOURCE}'"
+    )
+endif()
+string(SUBSTRING "${GRAMMAR_CONTENT}" ${ENUM_START} -1 GRAMMAR_CONTENT)
+string(FIND "${GRAMMAR_CONTENT}" "};" ENUM_END)
+string(SUBSTRING "${GRAMMAR_CONTENT}" 0 ${ENUM_END} SYMBOL_ENUM)
+
+string(
+    REGEX MATCHALL
+    "[A-Za-z0-9_]+ = [0-9]+"
+    SYMBOL_DEFINITIONS
+    "${SYMBOL_ENUM}"
+)
+foreach(DEFINITION IN LISTS SYMBOL_DEFINITIONS)
+    string(REGEX MATCH "^([A-Za-z0-9_]+) = ([0-9]+)$" _ "${DEFINITION}")
+    set(SYMBOL_ID_${CMAKE_MATCH_1} ${CMAKE_MATCH_2})
+endforeach()
+
+file(STRINGS "${RULES_SPEC}" RULE_LINES REGEX "^[^#]")
+
+set(RULES_SIZE 0)
+set(RULE_ENTRIES "")
+set(MISSING_SYMBOLS "")
+foreach(RULE_LINE IN LISTS RULE_LINES)
+    string(STRIP "${RULE_LINE}" RULE_LINE)
+    if(RULE_LINE STREQUAL "")
+        continue()
+    endif()
+    string(REGEX REPLACE "[ \t]+" ";" RULE_FIELDS "${RULE_LINE}")
+    list(LENGTH RULE_FIELDS NUM_RULE_FIELDS)
+    if(NOT NUM_RULE_FIELDS EQUAL 3)
+        message(
+            FATAL_ERROR
+            "Invalid node rule '${RULE_LINE}' in '${RULES_SPEC}'. "
+            "Expected a symbol, a weight and a kind"
+        )
+    endif()
+    list(GET RULE_FIELDS 0 RULE_SYMBOL)
+    list(GET RULE_FIELDS 1 RULE_WEIGHT)
+    list(GET RULE_FIELDS 2 RULE_KIND)
+    if(NOT DEFINED SYMBOL_ID_${RULE_SYMBOL})
+        list(APPEND MISSING_SYMBOLS ${RULE_SYMBOL})
+        continue()
+    endif()
+    set(SYMBOL_ID ${SYMBOL_ID_${RULE_SYMBOL}})
+    if(SYMBOL_ID GREATER_EQUAL RULES_SIZE)
+        math(EXPR RULES_SIZE "${SYMBOL_ID} + 1")
+    endif()
+    string(
+        APPEND
+        RULE_ENTRIES
+        "    [${SYMBOL_ID}] = { ${RULE_WEIGHT}, ${RULE_KIND} }, "
+        "// ${RULE_SYMBOL}\n"
+    )
+endforeach()
+
+if(MISSING_SYMBOLS)
+    list(JOIN MISSING_SYMBOLS ", " MISSING_SYMBOLS)
+    message(
+        FATAL_ERROR
+        "The node rules in '${RULES_SPEC}' refer to symbols that are not "
+        "defined by the grammar in '${GRAMMAR_SOURCE}': ${MISSING_SYMBOLS}"
+    )
+endif()
+
+get_filename_component(GRAMMAR_SOURCE_NAME "${GRAMMAR_SOURCE}" NAME)
+get_filename_component(RULES_SPEC_NAME "${RULES_SPEC}" NAME)
+set(RULES_ARRAY "NODE_RULES_${RULES_NAME}")
+
+set(OUTPUT_CONTENT "/*
+ * Generated from the grammar source ${GRAMMAR_SOURCE_NAME} and the node rules
+ * ${RULES_SPEC_NAME} by GenerateNodeRules.cmake. Do not edit.
+ */
+
+#pragma once
+
+enum { ${RULES_ARRAY}_SIZE = ${RULES_SIZE} };
+
+static const NodeRule ${RULES_ARRAY}[${RULES_ARRAY}_SIZE] = {
+${RULE_ENTRIES}};
+")
+
+file(WRITE "${OUTPUT_HEADER}" "${OUTPUT_CONTENT}")
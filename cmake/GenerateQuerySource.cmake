@@ -0,0 +1,76 @@
+# Copyright (C) 2026 Raven Computing
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+#==============================================================================
+#
+# Generates a C header which embeds the query of a programming language.
+# This file is a CMake script and must be run in script mode, i.e. with
+# `cmake -P`. It is used by the generate_query_source() function and should
+# not be run directly. The minimum CMake version required by this code
+# is v3.22.
+#
+# The generated header defines a static constant character array named
+# QUERY_SOURCE_${QUERY_NAME}, which holds the null-terminated content of the
+# query source file. Comments and blank lines of the query source are
+# not embedded, so the query source must not contain any semicolons
+# other than those that start a comment.
+#
+# Variables:
+#
+#   QUERY_SOURCE:
+#       The path to the query source file.
+#
+#   QUERY_NAME:
+#       The name of the language in all upper case, as used in the name
+#       of the generated definition.
+#
+#   OUTPUT_HEADER:
+#       The path of the header file to generate.
+#
+#==============================================================================
+
+foreach(VAR_NAME QUERY_SOURCE QUERY_NAME OUTPUT_HEADER)
+    if(NOT DEFINED ${VAR_NAME})
+        message(FATAL_ERROR "Query source generation requires ${VAR_NAME}")
+    endif()
+endforeach()
+
+file(READ "${QUERY_SOURCE}" QUERY_CONTENT)
+
+# Comments start with a semicolon in the query syntax. Since semicolons are
+# also list separators in CMake, the content is only processed as a string
+string(REGEX REPLACE "[ \t]*;[^\n]*" "" QUERY_CONTENT "${QUERY_CONTENT}")
+string(REGEX REPLACE "\n[ \t\n]*\n" "\n" QUERY_CONTENT "${QUERY_CONTENT}")
+string(STRIP "${QUERY_CONTENT}" QUERY_CONTENT)
+if(QUERY_CONTENT STREQUAL "")
+    message(FATAL_ERROR "No query patterns found in '${QUERY_SOURCE}'")
+endif()
+string(REPLACE "\\" "\\\\" QUERY_CONTENT "${QUERY_CONTENT}")
+string(REPLACE "\"" "\\\"" QUERY_CONTENT "${QUERY_CONTENT}")
+string(REPLACE "\n" "\\n\"\n    \"" QUERY_CONTENT "${QUERY_CONTENT}")
+
+get_filename_component(QUERY_SOURCE_NAME "${QUERY_SOURCE}" NAME)
+
+set(OUTPUT_CONTENT "/*
+ * Generated from the query source ${QUERY_SOURCE_NAME}
+ * by GenerateQuerySource.cmake. Do not edit.
+ */
+
+#pragma once
+
+static const char QUERY_SOURCE_${QUERY_NAME}[] =
+    \"${QUERY_CONTENT}\\n\";
+")
+
+file(WRITE "${OUTPUT_HEADER}" "${OUTPUT_CONTENT}")
@@ -0,0 +1,111 @@
+# Copyright (C) 2026 Raven Computing
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+#==============================================================================
+#
+# Contains functions for generating the node rule tables that are used to
+# evaluate the logical lines of code of a programming language.
+# The minimum CMake version required by this code is v3.22.
+#
+#==============================================================================
+
+include(FetchContent)
+
+set(
+    RECKON_NODE_RULES_SCRIPT
+    "${CMAKE_CURRENT_LIST_DIR}/GenerateNodeRules.cmake"
+)
+
+# Generates the node rule table of a programming language for a target.
+#
+# The table is generated at build time from the symbol identifiers in the
+# parser source of the tree-sitter grammar dependency of the language and
+# the node rule specification file of the language. The generated header is
+# written to the specified output directory and added to the sources of the
+# specified target, so that it is generated before the target is compiled.
+# The header is regenerated whenever the grammar source or the specification
+# changes. The build fails if the specification refers to a symbol that is
+# not defined by the grammar, e.g. after an upgrade of the grammar in which
+# a node type was removed or renamed.
+#
+# Arguments:
+#
+#   target_name:
+#       The name of the target whose sources include the generated header.
+#
+#   grammar_dependency:
+#       The name of the dependency which provides the tree-sitter grammar,
+#       as declared in the Dependencies.cmake file.
+#
+#   rules_spec:
+#       The path to the node rule specification file of the language.
+#
+#   rules_name:
+#       The name of the language in all upper case, as used in the names
+#       of the generated definitions.
+#
+#   output_dir:
+#       The directory to write the generated header to. The header is
+#       named "node_rules_<name>.h", where <name> is the lowercase
+#       rules name.
+#
+# Example:
+#   generate_node_rules(
+#       mytarget
+#       tree-sitter-c
+#       "${CMAKE_CURRENT_SOURCE_DIR}/c/lang_c.rules"
+#       C
+#       "${CMAKE_BINARY_DIR}/headers"
+#   )
+#
+function(
+    generate_node_rules
+    target_name
+    grammar_dependency
+    rules_spec
+    rules_name
+    output_dir
+)
+    FetchContent_GetProperties(
+        ${grammar_dependency}
+        SOURCE_DIR GRAMMAR_SOURCE_DIR
+    )
+    set(GRAMMAR_SOURCE "${GRAMMAR_SOURCE_DIR}/src/parser.c")
+    if(NOT EXISTS "${GRAMMAR_SOURCE}")
+        message(
+            FATAL_ERROR
+            "Cannot generate node rules for ${rules_name}. "
+            "No grammar source found at '${GRAMMAR_SOURCE}'"
+        )
+    endif()
+    string(TOLOWER "${rules_name}" RULES_NAME_LOWER)
+    set(OUTPUT_HEADER "${output_dir}/node_rules_${RULES_NAME_LOWER}.h")
+    add_custom_command(
+        OUTPUT "${OUTPUT_HEADER}"
+        COMMAND
+            ${CMAKE_COMMAND}
+            "-DGRAMMAR_SOURCE=${GRAMMAR_SOURCE}"
+            "-DRULES_SPEC=${rules_spec}"
+            "-DRULES_NAME=${rules_name}"
+            "-DOUTPUT_HEADER=${OUTPUT_HEADER}"
+            -P "${RECKON_NODE_RULES_SCRIPT}"
+        DEPENDS
+            "${GRAMMAR_SOURCE}"
+            "${rules_spec}"
+            "${RECKON_NODE_RULES_SCRIPT}"
+        COMMENT "Generating node rules for ${rules_name}"
+        VERBATIM
+    )
+    target_sources(${target_name} PRIVATE "${OUTPUT_HEADER}")
+endfunction()
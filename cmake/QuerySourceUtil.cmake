@@ -0,0 +1,85 @@
+# Copyright (C) 2026 Raven Computing
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+#==============================================================================
+#
+# Contains functions for embedding the tree-sitter queries that are used to
+# evaluate the logical lines of code of a programming language.
+# The minimum CMake version required by this code is v3.22.
+#
+#==============================================================================
+
+set(
+    RECKON_QUERY_SOURCE_SCRIPT
+    "${CMAKE_CURRENT_LIST_DIR}/GenerateQuerySource.cmake"
+)
+
+# Embeds the query of a programming language into a target.
+#
+# The query source file is converted at build time into a header which
+# defines the query source as a string constant. The generated header is
+# written to the specified output directory and added to the sources of the
+# specified target, so that it is generated before the target is compiled.
+# The header is regenerated whenever the query source file changes.
+#
+# Arguments:
+#
+#   target_name:
+#       The name of the target whose sources include the generated header.
+#
+#   query_source:
+#       The path to the query source file (.scm) of the language.
+#
+#   query_name:
+#       The name of the language in all upper case, as used in the name
+#       of the generated definition.
+#
+#   output_dir:
+#       The directory to write the generated header to. The header is
+#       named "query_source_<name>.h", where <name> is the lowercase
+#       query name.
+#
+# Example:
+#   generate_query_source(
+#       mytarget
+#       "${CMAKE_CURRENT_SOURCE_DIR}/c/lang_c.scm"
+#       C
+#       "${CMAKE_BINARY_DIR}/headers"
+#   )
+#
+function(
+    generate_query_source
+    target_name
+    query_source
+    query_name
+    output_dir
+)
+    string(TOLOWER "${query_name}" QUERY_NAME_LOWER)
+    set(OUTPUT_HEADER "${output_dir}/query_source_${QUERY_NAME_LOWER}.h")
+    add_custom_command(
+        OUTPUT "${OUTPUT_HEADER}"
+        COMMAND
+            ${CMAKE_COMMAND}
+            "-DQUERY_SOURCE=${query_source}"
+            "-DQUERY_NAME=${query_name}"
+            "-DOUTPUT_HEADER=${OUTPUT_HEADER}"
+            -P "${RECKON_QUERY_SOURCE_SCRIPT}"
+        DEPENDS
+            "${query_source}"
+            "${RECKON_QUERY_SOURCE_SCRIPT}"
+        COMMENT "Generating query source for ${query_name}"
+        VERBATIM
+    )
+    target_sources(${target_name} PRIVATE "${OUTPUT_HEADER}")
+endfunction()
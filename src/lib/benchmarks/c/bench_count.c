@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2026 Raven Computing
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Benchmark for the file throughput of count operations.
+ *
+ * Usage: bench_count [<PATH> [<ITERATIONS> [<THREADS>]]]
+ *
+ * Repeatedly counts all files under the specified path and reports
+ * the number of processed files per second. If no path is specified,
+ * the library test resources are used.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "reckon/reckon.h"
+#include "evaluation.h"
+#include "fileio.h"
+
+/**
+ * The default number of iterations of each benchmark.
+ */
+static const unsigned long DEFAULT_ITERATIONS = 10;
+
+static double now(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double) ts.tv_sec + ((double) ts.tv_nsec / 1e9);
+}
+
+static void report(const char* name, size_t files, double seconds) {
+    const double rate = (seconds > 0) ? ((double) files / seconds) : 0;
+    printf(
+        "%-24s %10zu files %10.3f s %12.1f files/s\n",
+        name,
+        files,
+        seconds,
+        rate
+    );
+}
+
+/**
+ * Measures the directory traversal of `newSourceFileListConcurrently()`.
+ */
+static bool benchSourceFileList(
+    const char* path,
+    unsigned long iterations,
+    uint32_t threads
+) {
+    size_t files = 0;
+    double seconds = 0;
+    for (unsigned long i = 0; i < iterations; ++i) {
+        const double start = now();
+        SourceFileList list = newSourceFileListConcurrently(path, threads);
+        seconds += now() - start;
+        if (!list.ok) {
+            return false;
+        }
+        files += list.size;
+        freeSourceFileList(&list);
+    }
+    report("newSourceFileList", files, seconds);
+    return true;
+}
+
+/**
+ * Measures `rcnCount()` with all counting operations selected.
+ */
+static bool benchCount(
+    const char* path,
+    unsigned long iterations,
+    uint32_t threads
+) {
+    size_t files = 0;
+    double seconds = 0;
+    for (unsigned long i = 0; i < iterations; ++i) {
+        RcnCountStatistics* stats = rcnCreateCountStatistics(path);
+        if (!stats || stats->state.errorCode != RCN_ERR_NONE) {
+            rcnFreeCountStatistics(stats);
+            return false;
+        }
+        RcnStatOptions options = {
+            .threads = threads
+        };
+        const double start = now();
+        rcnCount(stats, options);
+        seconds += now() - start;
+        files += stats->count.sizeProcessed;
+        rcnFreeCountStatistics(stats);
+    }
+    report("rcnCount", files, seconds);
+    return true;
+}
+
+/**
+ * Measures `rcnCountPath()`, i.e. including the directory scan, which
+ * overlaps with the counting when multiple threads are used.
+ */
+static bool benchCountPath(
+    const char* path,
+    unsigned long iterations,
+    uint32_t threads
+) {
+    size_t files = 0;
+    double seconds = 0;
+    for (unsigned long i = 0; i < iterations; ++i) {
+        RcnStatOptions options = {
+            .threads = threads
+        };
+        const double start = now();
+        RcnCountStatistics* stats = rcnCountPath(path, options);
+        seconds += now() - start;
+        if (!stats || stats->state.errorCode == RCN_ERR_INVALID_INPUT) {
+            rcnFreeCountStatistics(stats);
+            return false;
+        }
+        files += stats->count.sizeProcessed;
+        rcnFreeCountStatistics(stats);
+    }
+    report("rcnCountPath", files, seconds);
+    return true;
+}
+
+/**
+ * Measures standalone `rcnCountLogicalLines()` calls on preloaded
+ * file contents, i.e. without any reuse of parsing resources.
+ */
+static bool benchCountLogicalLines(const char* path, unsigned long iterations) {
+    RcnCountStatistics* stats = rcnCreateCountStatistics(path);
+    if (!stats || stats->state.errorCode != RCN_ERR_NONE) {
+        rcnFreeCountStatistics(stats);
+        return false;
+    }
+    size_t files = 0;
+    double seconds = 0;
+    for (unsigned long i = 0; i < iterations; ++i) {
+        for (size_t j = 0; j < stats->count.size; ++j) {
+            RcnSourceFile* file = &stats->count.files[j];
+            SourceFormatDetection detected = detectSourceFormat(file);
+            if (!detected.isProgrammingLanguage) {
+                continue;
+            }
+            if (!file->isContentRead && !readSourceFileContent(file)) {
+                continue;
+            }
+            const double start = now();
+            rcnCountLogicalLines(detected.format, file->content);
+            seconds += now() - start;
+            ++files;
+        }
+    }
+    rcnFreeCountStatistics(stats);
+    report("rcnCountLogicalLines", files, seconds);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* path = (argc > 1) ? argv[1] : RECKON_BENCH_PATH_RES_BASE;
+    unsigned long iterations = DEFAULT_ITERATIONS;
+    uint32_t threads = 1;
+    if (argc > 2) {
+        iterations = strtoul(argv[2], NULL, 10);
+    }
+    if (argc > 3) {
+        threads = (uint32_t) strtoul(argv[3], NULL, 10);
+    }
+    printf(
+        "Benchmark path: '%s' (iterations: %lu, threads: %u)\n",
+        path,
+        iterations,
+        (unsigned) threads
+    );
+    bool ok = (
+        !isDirectory(path)
+        || benchSourceFileList(path, iterations, threads)
+    );
+    ok = ok && benchCount(path, iterations, threads);
+    ok = ok && benchCountPath(path, iterations, threads);
+    ok = ok && benchCountLogicalLines(path, iterations);
+    if (!ok) {
+        (void) fprintf(stderr, "Failed to run benchmark for '%s'\n", path);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,284 @@
+/*
+ * Copyright (C) 2026 Raven Computing
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Benchmark for the engines that evaluate logical lines of code.
+ *
+ * Usage: bench_logical [<PATH> [<ITERATIONS>]]
+ *
+ * Counts the logical lines of code of all source files under the specified
+ * path with the visitor engine and the query engine. First reports the
+ * number of files for which both engines agree on the count, along with
+ * the files for which they do not, then the number of syntax tree nodes
+ * that the visitor engine visits with and without pruning subtrees, and
+ * finally the throughput of each engine. If no path is specified, the
+ * library test resources are used.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "reckon/reckon.h"
+#include "evaluation.h"
+#include "fileio.h"
+
+/**
+ * The default number of iterations of each benchmark.
+ */
+static const unsigned long DEFAULT_ITERATIONS = 10;
+
+/**
+ * Function pointer type for the functions that implement an engine.
+ */
+typedef RcnCountResult (*LogicalLinesEngine)(
+    RcnTextFormat language,
+    RcnSourceText sourceCode,
+    TextEncoding encoding,
+    ParserCache* cache
+);
+
+static double now(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double) ts.tv_sec + ((double) ts.tv_nsec / 1e9);
+}
+
+static void report(
+    const char* name,
+    size_t files,
+    size_t bytes,
+    double seconds
+) {
+    const double mebibytes = (double) bytes / (1024.0 * 1024.0);
+    const double rate = (seconds > 0) ? (mebibytes / seconds) : 0;
+    printf(
+        "%-24s %10zu files %10.3f s %12.1f MiB/s\n",
+        name,
+        files,
+        seconds,
+        rate
+    );
+}
+
+/**
+ * Reads the content of the specified file if it is source code of a
+ * supported programming language and returns its language. Returns
+ * `RCN_TEXT_UNFORMATTED` for all other files.
+ */
+static RcnTextFormat loadSourceCode(RcnSourceFile* file) {
+    SourceFormatDetection detected = detectSourceFormat(file);
+    if (!detected.isProgrammingLanguage) {
+        return RCN_TEXT_UNFORMATTED;
+    }
+    if (!file->isContentRead && !readSourceFileContent(file)) {
+        return RCN_TEXT_UNFORMATTED;
+    }
+    return detected.format;
+}
+
+/**
+ * Counts every source file with both engines and reports the files for
+ * which the counts of the engines differ. Fails if no source file
+ * can be counted.
+ */
+static bool benchAgreement(RcnCountStatistics* stats) {
+    ParserCache cache = {0};
+    size_t files = 0;
+    size_t agreements = 0;
+    for (size_t i = 0; i < stats->count.size; ++i) {
+        RcnSourceFile* file = &stats->count.files[i];
+        const RcnTextFormat language = loadSourceCode(file);
+        if (language == RCN_TEXT_UNFORMATTED) {
+            continue;
+        }
+        const TextEncoding encoding = detectEncoding(file->content);
+        RcnCountResult visited = evaluateLogicalLines(
+            language,
+            file->content,
+            encoding,
+            &cache
+        );
+        RcnCountResult matched = evaluateLogicalLinesByQuery(
+            language,
+            file->content,
+            encoding,
+            &cache
+        );
+        if (!visited.state.ok || !matched.state.ok) {
+            continue;
+        }
+        ++files;
+        if (visited.count == matched.count) {
+            ++agreements;
+        } else {
+            printf(
+                "Disagreement: %s (visitor: %llu, query: %llu)\n",
+                file->path,
+                (unsigned long long) visited.count,
+                (unsigned long long) matched.count
+            );
+        }
+    }
+    freeParserCache(&cache);
+    printf("Agreement: %zu of %zu files\n", agreements, files);
+    return files > 0;
+}
+
+/**
+ * A `NodeVisitor` which visits every node of a syntax tree without
+ * evaluating it, so that no subtree is pruned.
+ */
+static void visitEveryNode(TSNode node, NodeEvalTrace* trace) {
+    (void) node;
+    (void) trace;
+}
+
+/**
+ * Counts the syntax tree nodes of every source file that are visited by
+ * the visitor engine, which prunes the subtrees that cannot contribute to
+ * the logical lines, and by a traversal that visits every node. Reports the
+ * numbers of visited nodes and the time spent for the traversals.
+ */
+static bool benchPruning(RcnCountStatistics* stats) {
+    ParserCache cache = {0};
+    uint64_t pruned = 0;
+    uint64_t total = 0;
+    double prunedSeconds = 0;
+    double totalSeconds = 0;
+    for (size_t i = 0; i < stats->count.size; ++i) {
+        RcnSourceFile* file = &stats->count.files[i];
+        const RcnTextFormat language = loadSourceCode(file);
+        if (language == RCN_TEXT_UNFORMATTED) {
+            continue;
+        }
+        const TextEncoding encoding = detectEncoding(file->content);
+        RcnCountResult result = {0};
+        NodeEvalTrace trace = {0};
+        trace.result = &result;
+        double start = now();
+        RcnResultState state = evaluateSourceTree(
+            file->content,
+            encoding,
+            language,
+            createEvaluationFunction(language),
+            &trace,
+            &cache
+        );
+        prunedSeconds += now() - start;
+        NodeEvalTrace fullTrace = {0};
+        start = now();
+        RcnResultState fullState = evaluateSourceTree(
+            file->content,
+            encoding,
+            language,
+            visitEveryNode,
+            &fullTrace,
+            &cache
+        );
+        totalSeconds += now() - start;
+        if (state.ok && fullState.ok) {
+            pruned += trace.numVisitedNodes;
+            total += fullTrace.numVisitedNodes;
+        }
+    }
+    freeParserCache(&cache);
+    const double ratio = (
+        (total > 0) ? (100.0 * (double) pruned / (double) total) : 0
+    );
+    printf(
+        "Visited nodes: %llu with pruning (%.3f s), "
+        "%llu without (%.3f s), %.1f%%\n",
+        (unsigned long long) pruned,
+        prunedSeconds,
+        (unsigned long long) total,
+        totalSeconds,
+        ratio
+    );
+    return true;
+}
+
+/**
+ * Measures the throughput of the specified engine on all source files.
+ */
+static bool benchEngine(
+    const char* name,
+    LogicalLinesEngine engine,
+    RcnCountStatistics* stats,
+    unsigned long iterations
+) {
+    ParserCache cache = {0};
+    size_t files = 0;
+    size_t bytes = 0;
+    double seconds = 0;
+    for (unsigned long i = 0; i < iterations; ++i) {
+        for (size_t j = 0; j < stats->count.size; ++j) {
+            RcnSourceFile* file = &stats->count.files[j];
+            const RcnTextFormat language = loadSourceCode(file);
+            if (language == RCN_TEXT_UNFORMATTED) {
+                continue;
+            }
+            const TextEncoding encoding = detectEncoding(file->content);
+            const double start = now();
+            engine(language, file->content, encoding, &cache);
+            seconds += now() - start;
+            bytes += file->content.size;
+            ++files;
+        }
+    }
+    freeParserCache(&cache);
+    report(name, files, bytes, seconds);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* path = (argc > 1) ? argv[1] : RECKON_BENCH_PATH_RES_BASE;
+    unsigned long iterations = DEFAULT_ITERATIONS;
+    if (argc > 2) {
+        iterations = strtoul(argv[2], NULL, 10);
+    }
+    printf(
+        "Benchmark path: '%s' (iterations: %lu)\n",
+        path,
+        iterations
+    );
+    RcnCountStatistics* stats = rcnCreateCountStatistics(path);
+    bool ok = (stats && stats->state.errorCode == RCN_ERR_NONE);
+    // The agreement check also compiles the queries before the
+    // engines are measured
+    ok = ok && benchAgreement(stats);
+    ok = ok && benchPruning(stats);
+    ok = ok && benchEngine(
+        "visitor engine",
+        evaluateLogicalLines,
+        stats,
+        iterations
+    );
+    ok = ok && benchEngine(
+        "query engine",
+        evaluateLogicalLinesByQuery,
+        stats,
+        iterations
+    );
+    rcnFreeCountStatistics(stats);
+    if (!ok) {
+        (void) fprintf(stderr, "Failed to run benchmark for '%s'\n", path);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -20,101 +20,88 @@
 
 #include "reckon/reckon.h"
 #include "evaluation.h"
+#include "simd.h"
 
-static const uint16_t UTF16_BOM_LE = 0xfffe;
-static const uint16_t UTF16_BOM_BE = 0xfeff;
+static const size_t UTF8_BOM_SIZE = 3;
 static const uint16_t HIGH_SURROGATE_START = 0xd800;
 static const uint16_t HIGH_SURROGATE_END = 0xdbff;
-static const uint16_t LOW_SURROGATE_START = 0xdc00;
-static const uint16_t LOW_SURROGATE_END = 0xdfff;
-static const unsigned char MASK_B2 = 0xe0;
-static const unsigned char MASK_B3 = 0xf0;
-static const unsigned char MASK_B4 = 0xf8;
-static const unsigned char TWO_BYTE_SEQ = 0xc0;
-static const unsigned char THREE_BYTE_SEQ = 0xe0;
-static const unsigned char FOUR_BYTE_SEQ = 0xf0;
 
-/**
- * Reads a 16-bit code unit from text at a given byte offset.
- * No range checks are performed.
- */
-static uint16_t codeUnit(const char* text, size_t offset, bool littleEndian) {
-    const unsigned char byte0 = (unsigned char) text[offset];
-    const unsigned char byte1 = (unsigned char) text[offset + 1];
-    return (
-        littleEndian
-        ? (uint16_t) (byte0 | (byte1 << 8))
-        : (uint16_t) ((byte0 << 8) | byte1)
-    );
-}
-
-static RcnCount countCharactersUTF16(RcnSourceText source, bool littleEndian) {
-    RcnCount count = 0;
-    const size_t size = source.size;
-    size_t offset = 0;
-    // Skip UTF-16 BOMs if present
-    if (size >= 2) {
-        uint16_t cu0 = codeUnit(source.text, 0, littleEndian);
-        if (cu0 == UTF16_BOM_BE || cu0 == UTF16_BOM_LE) {
-            offset = 2;
+static size_t countCharactersUTF16(
+    ChunkedCount* counter,
+    const char* chunk,
+    size_t size,
+    bool isFinal
+) {
+    const bool isLittleEndian = (counter->encoding == TextEncodingUTF16LE);
+    size_t numUnits = size / 2;
+    if (!isFinal && numUnits > 0) {
+        const size_t last = 2 * (numUnits - 1);
+        const unsigned char byte0 = (unsigned char) chunk[last];
+        const unsigned char byte1 = (unsigned char) chunk[last + 1];
+        const uint16_t unit = (uint16_t) (
+            isLittleEndian ? (byte0 | (byte1 << 8)) : ((byte0 << 8) | byte1)
+        );
+        if (unit >= HIGH_SURROGATE_START && unit <= HIGH_SURROGATE_END) {
+            --numUnits; // The following code unit is in the next chunk
         }
     }
-    while ((offset + 1) < size) {
-        uint16_t cu0 = codeUnit(source.text, offset, littleEndian);
-        offset += 2;
-        if (cu0 == UTF16_BOM_BE || cu0 == UTF16_BOM_LE) {
-            continue; // Ignore stray BOMs beyond start
-        }
-        if (cu0 >= HIGH_SURROGATE_START && cu0 <= HIGH_SURROGATE_END) {
-            // High surrogate: check for a following low surrogate
-            if ((offset + 1) < size) {
-                uint16_t cu1 = codeUnit(source.text, offset, littleEndian);
-                if (cu1 >= LOW_SURROGATE_START && cu1 <= LOW_SURROGATE_END) {
-                    // Valid surrogate pair forms a single code point
-                    offset += 2;
-                    ++count;
-                }
-            }
-            continue;
+    counter->count += countUTF16Characters(chunk, numUnits, isLittleEndian);
+    // Any trailing single byte is ignored at the end of the text
+    return isFinal ? size : (2 * numUnits);
+}
+
+static size_t countCharactersUTF8(
+    ChunkedCount* counter,
+    const char* chunk,
+    size_t size,
+    bool isFinal
+) {
+    size_t count = 0;
+    size_t offset = (counter->skip < size) ? counter->skip : size;
+    counter->skip -= offset;
+    while (offset < size) {
+        offset += countUTF8Sequences(chunk + offset, size - offset, &count);
+        if (offset == size) {
+            break;
         }
-        if (cu0 >= LOW_SURROGATE_START && cu0 <= LOW_SURROGATE_END) {
-            continue; // Ignore stray low surrogates
+        if (!isFinal) {
+            break; // The sequence continues in the next chunk
         }
-        // BMP code point
+        // A sequence truncated by the end of the text is counted as a single
+        // character, but only its lead byte is consumed. We do not validate
+        // continuation bytes, so the remaining bytes are decoded again.
+        ++offset;
         ++count;
     }
-    // Any trailing single byte is ignored
-    return count;
+    counter->count += count;
+    return offset;
 }
 
-static RcnCount countCharactersUTF8(RcnSourceText source) {
-    RcnCount count = 0;
-    size_t offset = 0;
-    if (hasUTF8BOM(source)) {
-        offset = 3; // Skip BOM
-    }
-    const size_t size = source.size;
-    while (offset < size) {
-        const unsigned char byte = (unsigned char) source.text[offset];
-        // Always consume at least 1 byte to avoid stalling, e.g. in case
-        // of encoding errors like truncated or invalid leading byte etc.
-        // We do not validate continuation bytes. Invalid or truncated UTF-8
-        // sequences are counted as single characters.
-        size_t stride = 1;
-        if ((byte & MASK_B2) == TWO_BYTE_SEQ && (offset + 1) < size) {
-            stride = 2;
-        } else if ((byte & MASK_B3) == THREE_BYTE_SEQ && (offset + 2) < size) {
-            stride = 3;
-        } else if ((byte & MASK_B4) == FOUR_BYTE_SEQ && (offset + 3) < size) {
-            stride = 4;
-        }
-        offset += stride;
-        ++count;
+ChunkedCount initCharacterCount(RcnSourceText start, TextEncoding encoding) {
+    const bool hasBOM = (encoding == TextEncodingUTF8) && hasUTF8BOM(start);
+    return (ChunkedCount){
+        .encoding = encoding,
+        .skip = hasBOM ? UTF8_BOM_SIZE : 0
+    };
+}
+
+size_t countCharactersInChunk(
+    ChunkedCount* counter,
+    const char* chunk,
+    size_t size,
+    bool isFinal
+) {
+    if (counter->encoding == TextEncodingUTF8) {
+        return countCharactersUTF8(counter, chunk, size, isFinal);
     }
-    return count;
+    // UTF-16 with BOM indicating endianness
+    return countCharactersUTF16(counter, chunk, size, isFinal);
 }
 
-RcnCountResult rcnCountCharacters(RcnSourceText source) {
+RcnCountResult countCharactersInText(
+    RcnSourceText source,
+    TextEncoding encoding
+) {
     RcnCountResult result = {
         .count = 0,
         .state.ok = true,
@@ -137,13 +124,13 @@ RcnCountResult rcnCountCharacters(RcnSourceText source) {
         return result;
     }
 
-    TextEncoding encoding = detectEncoding(source);
-    if (encoding == TextEncodingUTF8) {
-        result.count = countCharactersUTF8(source);
-    } else { // UTF-16 with BOM indicating endianness
-        const bool isLittleEndian = (encoding == TextEncodingUTF16LE);
-        result.count = countCharactersUTF16(source, isLittleEndian);
-    }
+    ChunkedCount counter = initCharacterCount(source, encoding);
+    countCharactersInChunk(&counter, source.text, source.size, true);
+    result.count = counter.count;
 
     return result;
 }
+
+RcnCountResult rcnCountCharacters(RcnSourceText source) {
+    return countCharactersInText(source, detectEncoding(source));
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2026 Raven Computing
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "concurrency.h"
+
+struct BoundedQueue {
+    char* items;
+    size_t itemSize;
+    size_t capacity;
+    size_t head;
+    size_t size;
+    bool isClosed;
+    Mutex* mutex;
+    CondVar* notEmpty;
+};
+
+static inline void popFront(BoundedQueue* queue, void* item) {
+    const char* front = queue->items + (queue->head * queue->itemSize);
+    memcpy(item, front, queue->itemSize);
+    queue->head = (queue->head + 1) % queue->capacity;
+    queue->size--;
+}
+
+BoundedQueue* newBoundedQueue(size_t itemSize, size_t capacity) {
+    if (itemSize == 0 || capacity == 0) {
+        return NULL;
+    }
+    BoundedQueue* queue = calloc(1, sizeof(BoundedQueue));
+    if (!queue) {
+        return NULL;
+    }
+    queue->items = malloc(itemSize * capacity);
+    queue->mutex = newMutex();
+    queue->notEmpty = newCondVar();
+    if (!queue->items || !queue->mutex || !queue->notEmpty) {
+        freeBoundedQueue(queue); // LCOV_EXCL_LINE
+        return NULL; // LCOV_EXCL_LINE
+    }
+    queue->itemSize = itemSize;
+    queue->capacity = capacity;
+    return queue;
+}
+
+void freeBoundedQueue(BoundedQueue* queue) {
+    if (queue) {
+        free(queue->items);
+        freeMutex(queue->mutex);
+        freeCondVar(queue->notEmpty);
+        free(queue);
+    }
+}
+
+bool boundedQueueTryPush(BoundedQueue* queue, const void* item) {
+    lockMutex(queue->mutex);
+    const bool canPush = !queue->isClosed && queue->size < queue->capacity;
+    if (canPush) {
+        const size_t tail = (queue->head + queue->size) % queue->capacity;
+        char* back = queue->items + (tail * queue->itemSize);
+        memcpy(back, item, queue->itemSize);
+        queue->size++;
+        signalCondVar(queue->notEmpty);
+    }
+    unlockMutex(queue->mutex);
+    return canPush;
+}
+
+bool boundedQueuePop(BoundedQueue* queue, void* item) {
+    lockMutex(queue->mutex);
+    while (queue->size == 0 && !queue->isClosed) {
+        waitCondVar(queue->notEmpty, queue->mutex);
+    }
+    const bool canPop = queue->size > 0;
+    if (canPop) {
+        popFront(queue, item);
+    }
+    unlockMutex(queue->mutex);
+    return canPop;
+}
+
+bool boundedQueueTryPop(BoundedQueue* queue, void* item) {
+    lockMutex(queue->mutex);
+    const bool canPop = queue->size > 0;
+    if (canPop) {
+        popFront(queue, item);
+    }
+    unlockMutex(queue->mutex);
+    return canPop;
+}
+
+void boundedQueueClose(BoundedQueue* queue) {
+    lockMutex(queue->mutex);
+    queue->isClosed = true;
+    broadcastCondVar(queue->notEmpty);
+    unlockMutex(queue->mutex);
+}
@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2026 Raven Computing
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Portable concurrency primitives.
+ *
+ * Provides the minimal set of threading utilities that the Reckon library
+ * needs to distribute work across multiple threads. The functions declared
+ * here have platform-specific implementations.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Function pointer type for tasks executed by `runConcurrently()`.
+ */
+typedef void (*ConcurrentTask)(void* arg);
+
+/**
+ * Runs the given task concurrently on up to `count` threads.
+ *
+ * The task is called once per thread with a pointer to the corresponding
+ * element in `args`, which must be an array of `count` elements where each
+ * element has a size of `argSize` bytes. The calling thread executes the task
+ * for the first element itself. Blocks until all started tasks have finished.
+ *
+ * Returns the number of tasks that were actually run. This can be less than
+ * `count` if the underlying system fails to create more threads, but it is
+ * always at least one if `count` is not zero. The elements of `args` for
+ * tasks that were not run remain untouched. Callers must therefore distribute
+ * work dynamically, so that all work is completed even if only a single task
+ * is run.
+ */
+size_t runConcurrently(
+    ConcurrentTask task,
+    void* args,
+    size_t argSize,
+    size_t count
+);
+
+/**
+ * Function pointer type for functions that run tasks like
+ * `runConcurrently()`, but possibly on threads which already exist. The
+ * specified context is passed to the function unaltered.
+ */
+typedef size_t (*TaskRunner)(
+    ConcurrentTask task,
+    void* args,
+    size_t argSize,
+    size_t count,
+    void* context
+);
+
+/**
+ * Atomically adds `increment` to the given value.
+ * Returns the value as it was before the addition.
+ */
+size_t atomicFetchAdd(size_t* value, size_t increment);
+
+/**
+ * Atomically loads the given value.
+ */
+size_t atomicLoad(const size_t* value);
+
+/**
+ * Atomically stores the given value.
+ */
+void atomicStore(size_t* value, size_t desired);
+
+/**
+ * Atomically replaces the given value with `candidate` if `candidate`
+ * is smaller than the current value.
+ */
+void atomicStoreMin(size_t* value, size_t candidate);
+
+/**
+ * Function pointer type for functions called by `callOnce()`.
+ */
+typedef void (*OnceFunction)(void);
+
+/**
+ * A flag that records whether a function was called by `callOnce()`.
+ * A zero-initialized flag, e.g. one with static storage duration,
+ * is ready to be used.
+ */
+typedef size_t OnceFlag;
+
+/**
+ * Calls the given function if it was not called yet with the specified flag.
+ *
+ * The function is called exactly once for a flag, even if multiple threads
+ * call `callOnce()` with the same flag at the same time. Threads that do not
+ * call the function block until it has returned, so that all effects of the
+ * function are visible to every caller once `callOnce()` returns.
+ */
+void callOnce(OnceFlag* flag, OnceFunction function);
+
+/**
+ * Returns the current time of a monotonic clock in microseconds. The time
+ * is only meaningful relative to other times returned by this function,
+ * e.g. to measure elapsed time.
+ */
+uint64_t monotonicTimeMicros(void);
+
+/**
+ * Opaque type of a mutual exclusion lock.
+ */
+typedef struct Mutex Mutex;
+
+/**
+ * Opaque type of a condition variable.
+ */
+typedef struct CondVar CondVar;
+
+/**
+ * Allocates and initializes a new mutex.
+ * Returns `NULL` on failure. The returned mutex must be freed
+ * with `freeMutex()`.
+ */
+Mutex* newMutex(void);
+
+/**
+ * Frees the given mutex. The mutex must not be locked.
+ * The argument may be `NULL`.
+ */
+void freeMutex(Mutex* mutex);
+
+/**
+ * Locks the given mutex. Blocks until the lock is acquired.
+ */
+void lockMutex(Mutex* mutex);
+
+/**
+ * Unlocks the given mutex, which must be locked by the calling thread.
+ */
+void unlockMutex(Mutex* mutex);
+
+/**
+ * Allocates and initializes a new condition variable.
+ * Returns `NULL` on failure. The returned condition variable must be freed
+ * with `freeCondVar()`.
+ */
+CondVar* newCondVar(void);
+
+/**
+ * Frees the given condition variable. No thread must be waiting on it.
+ * The argument may be `NULL`.
+ */
+void freeCondVar(CondVar* condVar);
+
+/**
+ * Atomically unlocks the given mutex and waits on the condition variable.
+ * The mutex is locked again before this function returns. Spurious wakeups
+ * are possible, so callers must always check their condition in a loop.
+ */
+void waitCondVar(CondVar* condVar, Mutex* mutex);
+
+/**
+ * Wakes up at least one thread that waits on the given condition variable.
+ */
+void signalCondVar(CondVar* condVar);
+
+/**
+ * Wakes up all threads that wait on the given condition variable.
+ */
+void broadcastCondVar(CondVar* condVar);
+
+/**
+ * Opaque type of a bounded first-in-first-out queue.
+ * 
+ * The queue stores copies of fixed-size items and can be used by multiple
+ * producer and consumer threads at the same time. Once a queue is closed,
+ * no more items can be pushed, but all remaining items can still be popped.
+ */
+typedef struct BoundedQueue BoundedQueue;
+
+/**
+ * Allocates a new empty queue that can hold up to `capacity` items,
+ * each with a size of `itemSize` bytes.
+ * Returns `NULL` on failure or if any argument is zero. The returned queue
+ * must be freed with `freeBoundedQueue()`.
+ */
+BoundedQueue* newBoundedQueue(size_t itemSize, size_t capacity);
+
+/**
+ * Frees the given queue. Items that are still in the queue are discarded.
+ * The argument may be `NULL`.
+ */
+void freeBoundedQueue(BoundedQueue* queue);
+
+/**
+ * Copies the specified item to the end of the queue without blocking.
+ * Returns `true` on success, or `false` if the queue is full or closed.
+ */
+bool boundedQueueTryPush(BoundedQueue* queue, const void* item);
+
+/**
+ * Moves the item at the front of the queue to the specified item location.
+ * Blocks while the queue is empty and not closed.
+ * Returns `true` if an item was popped, or `false` if the queue is closed
+ * and empty.
+ */
+bool boundedQueuePop(BoundedQueue* queue, void* item);
+
+/**
+ * Moves the item at the front of the queue to the specified item location
+ * without blocking. Returns `true` if an item was popped, or `false` if
+ * the queue is empty.
+ */
+bool boundedQueueTryPop(BoundedQueue* queue, void* item);
+
+/**
+ * Closes the given queue and wakes up all threads that are blocked
+ * in `boundedQueuePop()`.
+ */
+void boundedQueueClose(BoundedQueue* queue);
+
+#ifdef __cplusplus
+}
+#endif
@@ -16,9 +16,11 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdlib.h>
 
 #include "reckon/reckon.h"
 #include "evaluation.h"
+#include "simd.h"
 
 static const uint8_t UTF8BOM_0 = 0xef;
 static const uint8_t UTF8BOM_1 = 0xbb;
@@ -27,9 +29,22 @@ static const uint8_t UTF16BOM_LE_0 = 0xff;
 static const uint8_t UTF16BOM_LE_1 = 0xfe;
 static const uint8_t UTF16BOM_BE_0 = 0xfe;
 static const uint8_t UTF16BOM_BE_1 = 0xff;
+static const size_t UTF16_BOM_SIZE = 2;
+
+/**
+ * The maximum number of UTF-8 bytes that a single UTF-16 code unit
+ * is transcoded to.
+ */
+static const size_t UTF8_BYTES_PER_CODE_UNIT = 3;
+
+/**
+ * The inverse of the proportion of control bytes above which a source
+ * text is considered to have binary content.
+ */
+static const size_t BINARY_CONTROL_BYTE_RATIO = 10;
 
 bool hasUTF8BOM(RcnSourceText source) {
-    if (source.size >= 3) {
+    if (source.text && source.size >= 3) {
         const uint8_t byte0 = (uint8_t) source.text[0];
         const uint8_t byte1 = (uint8_t) source.text[1];
         const uint8_t byte2 = (uint8_t) source.text[2];
@@ -44,7 +59,7 @@ TextEncoding detectEncoding(RcnSourceText source) {
     if (hasUTF8BOM(source)) {
         return TextEncodingUTF8;
     }
-    if (source.size >= 2) {
+    if (source.text && source.size >= 2) {
         // Check for UTF-16 BOM
         const uint8_t byte0 = (uint8_t) source.text[0];
         const uint8_t byte1 = (uint8_t) source.text[1];
@@ -57,3 +72,87 @@ TextEncoding detectEncoding(RcnSourceText source) {
     }
     return TextEncodingUTF8; // Default
 }
+
+bool isBinaryContent(RcnSourceText source, TextEncoding encoding) {
+    if (!source.text) {
+        return false;
+    }
+    const size_t size = (
+        source.size < BINARY_CHECK_SIZE
+        ? source.size
+        : BINARY_CHECK_SIZE
+    );
+    if (encoding != TextEncodingUTF8) {
+        // Most UTF-16 code units have a zero byte, but none is zero entirely
+        return countCodeUnit(source.text, size / 2, 0, 0) > 0;
+    }
+    if (countByte(source.text, size, '\0') > 0) {
+        return true;
+    }
+    return countControlBytes(source.text, size) * BINARY_CONTROL_BYTE_RATIO
+        > size;
+}
+
+void freeTextBuffer(TextBuffer* buffer) {
+    free(buffer->data);
+    buffer->data = NULL;
+    buffer->capacity = 0;
+}
+
+/**
+ * Ensures that the given buffer can hold at least the specified number
+ * of bytes. Returns false if the buffer cannot be enlarged, in which case
+ * it is left unchanged.
+ */
+static bool reserveTextBuffer(TextBuffer* buffer, size_t size) {
+    if (size <= buffer->capacity) {
+        return true;
+    }
+    // Grow geometrically, since a buffer is reused for many source texts
+    size_t capacity = buffer->capacity + (buffer->capacity / 2);
+    if (capacity < size) {
+        capacity = size;
+    }
+    char* data = realloc(buffer->data, capacity);
+    if (!data) {
+        return false;
+    }
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return true;
+}
+
+bool transcodeToUTF8(
+    RcnSourceText source,
+    TextEncoding encoding,
+    TextBuffer* buffer,
+    RcnSourceText* transcoded
+) {
+    if (encoding == TextEncodingUTF8 || source.size % 2 != 0) {
+        // Texts with a trailing single byte are counted as they are
+        return false;
+    }
+    const size_t numUnits = (source.size - UTF16_BOM_SIZE) / 2;
+    if (numUnits > SIZE_MAX / UTF8_BYTES_PER_CODE_UNIT) {
+        return false; // LCOV_EXCL_LINE
+    }
+    // Reserve one more byte for the terminating null character
+    const size_t capacity = (numUnits * UTF8_BYTES_PER_CODE_UNIT) + 1;
+    if (!reserveTextBuffer(buffer, capacity)) {
+        return false;
+    }
+    size_t size = 0;
+    const bool ok = transcodeUTF16(
+        source.text + UTF16_BOM_SIZE,
+        numUnits,
+        buffer->data,
+        &size,
+        encoding == TextEncodingUTF16LE
+    );
+    if (ok) {
+        buffer->data[size] = '\0';
+        transcoded->text = buffer->data;
+        transcoded->size = size;
+    }
+    return ok;
+}
@@ -28,6 +28,7 @@
 #include "tree_sitter/api.h"
 
 #include "reckon/reckon.h"
+#include "concurrency.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -72,6 +73,9 @@ typedef struct NodeEvalTrace {
     uint64_t lnLastExpr;
     uint64_t lnLastSwitchLabel;
     uint64_t lnLastArrow;
+    uint64_t line; // Line of the visited node, set by the traversal
+    uint64_t numVisitedNodes; // Number of nodes visited by the traversal
+    bool skipChildren; // Set by a visitor to not descend into a node
 } NodeEvalTrace;
 
 /**
@@ -82,35 +86,199 @@ typedef struct NodeEvalTrace {
 typedef void (*NodeVisitor)(TSNode node, NodeEvalTrace* trace);
 
 /**
- * Enumeration of supported text encodings.
+ * The kinds of a `NodeRule` that are common to all languages. The weight of
+ * a node of a plain rule is added unconditionally. The weight of a node of
+ * a pruned rule is also added unconditionally, but the children of the node
+ * are not visited, because no node in its subtree can add any weight. All
+ * other kinds are language-specific, start at `NODE_RULE_LANGUAGE` and
+ * require the evaluation function of the language to check the context of
+ * a node before its weight is added.
+ */
+enum {
+    NODE_RULE_PLAIN = 0,
+    NODE_RULE_PRUNE,
+    NODE_RULE_LANGUAGE
+};
+
+/**
+ * The rule by which the nodes of a grammar symbol are evaluated. The rules
+ * of a language are generated at build time into a table which is indexed
+ * by grammar symbol. Symbols without a rule have a zero rule, i.e. a weight
+ * of zero and the kind `NODE_RULE_PLAIN`.
+ */
+typedef struct NodeRule {
+    uint8_t weight;
+    uint8_t kind;
+} NodeRule;
+
+/**
+ * Enumeration of supported text encodings. The values are the ones of the
+ * corresponding `RcnTextEncoding` enumerators, so that both types can be
+ * converted into each other.
  */
 typedef enum TextEncoding {
-  TextEncodingUTF8,
-  TextEncodingUTF16LE,
-  TextEncodingUTF16BE
+  TextEncodingUTF8 = RCN_ENC_UTF8,
+  TextEncodingUTF16LE = RCN_ENC_UTF16LE,
+  TextEncodingUTF16BE = RCN_ENC_UTF16BE
 } TextEncoding;
 
 /**
- * Evaluates the AST of the given source code.
+ * State of counting one metric in a source text that is processed in
+ * consecutive chunks.
+ * 
+ * The count is accumulated over all chunks. The encoding of the entire
+ * source text must be known before the first chunk is processed. `skip` is the
+ * number of bytes that are still to be skipped at the start of the source
+ * text, e.g. to exclude a BOM. The initial state for a metric is returned by
+ * the corresponding init function, like `initLineBreakCount()`.
+ */
+typedef struct ChunkedCount {
+    RcnCount count;
+    TextEncoding encoding;
+    size_t skip;
+    bool inWord;
+} ChunkedCount;
+
+/**
+ * The maximum number of bytes that a `ChunkCounter` leaves unconsumed at
+ * the end of a chunk that does not end the source text.
+ */
+enum { CHUNKED_COUNT_MAX_PENDING = 3 };
+
+/**
+ * Function pointer type for functions counting one metric in a chunk of
+ * source text. The chunk is given by a pointer to its bytes and its size.
+ * Returns the number of bytes consumed from the start of the chunk. Unless
+ * `isFinal` is `true`, up to `CHUNKED_COUNT_MAX_PENDING` bytes at the end
+ * of a chunk may be left unconsumed if they do not yet form a complete unit
+ * of the metric. These bytes must be passed again at the start of the next
+ * chunk. A final chunk, i.e. one that ends the source text, is always
+ * consumed entirely.
+ */
+typedef size_t (*ChunkCounter)(
+    ChunkedCount* counter,
+    const char* chunk,
+    size_t size,
+    bool isFinal
+);
+
+/**
+ * Cache of reusable resources for parsing and traversing source trees.
+ * 
+ * Holds at most one parser per text format, a single tree cursor and a single
+ * query cursor, so that these do not have to be recreated for every processed
+ * source text.
+ * A zero-initialized cache is empty and ready to be used. A cache must not be
+ * used by more than one thread at the same time. All cached resources must be
+ * released with `freeParserCache()`.
+ */
+typedef struct ParserCache {
+    TSParser* parsers[RECKON_NUM_SUPPORTED_FORMATS];
+    TSTreeCursor cursor;
+    bool hasCursor;
+    TSQueryCursor* queryCursor;
+    uint64_t timeoutMicros; // Time budget for parsing, zero for no limit
+} ParserCache;
+
+/**
+ * Returns a parser for source code in the specified programming language
+ * from the given cache. A parser is created and added to the cache if the
+ * cache does not contain one for the specified language yet. A cached parser
+ * is reset before it is returned. May return `NULL` if the specified language
+ * is not supported or on error. The cache retains ownership of the
+ * returned parser.
+ */
+TSParser* acquireParser(ParserCache* cache, RcnTextFormat language);
+
+/**
+ * Frees all resources held by the given cache. The cache itself is not freed
+ * but is empty afterwards and can be used again.
+ */
+void freeParserCache(ParserCache* cache);
+
+/**
+ * Parses the given source code with the specified encoding into an AST.
+ * The parser is taken from the specified `ParserCache`. Returns `NULL` and
+ * sets the error code and message of the specified `RcnResultState` if the
+ * source code cannot be parsed or contains a syntax error. The parsing is
+ * cancelled with the error code `RCN_ERR_PARSE_CANCELLED` if it exceeds the
+ * time budget of the cache or if all parsing is cancelled globally.
+ * The specified `NodeEvalTrace` is only used to log syntax errors in debug
+ * mode. Ownership of the returned tree is transferred to the caller. It must
+ * be freed with `ts_tree_delete()`.
+ */
+TSTree* parseSourceTree(
+    RcnSourceText source,
+    TextEncoding encoding,
+    RcnTextFormat language,
+    NodeEvalTrace* trace,
+    ParserCache* cache,
+    RcnResultState* state
+);
+
+/**
+ * Evaluates the AST of the given source code with the specified encoding.
  * The specified `NodeVisitor` is used to evaluate every node in the tree. The
  * specified `NodeEvalTrace` can be passed by the caller to track
- * the evaluation state across nodes. The returned `RcnResultState` indicates
+ * the evaluation state across nodes. The parser and tree cursor are taken
+ * from the specified `ParserCache`. The returned `RcnResultState` indicates
  * whether the evaluation was successful or if an error occurred.
  */
 RcnResultState evaluateSourceTree(
     RcnSourceText source,
+    TextEncoding encoding,
     RcnTextFormat language,
     NodeVisitor evaluator,
-    NodeEvalTrace* trace
+    NodeEvalTrace* trace,
+    ParserCache* cache
 );
 
 /**
  * Traverses the entire AST, starting at the given root node, calling the
  * specified `NodeVisitor` for each node. The specified `NodeEvalTrace` is
- * passed to the visitor function unaltered and can be used during the
- * evaluation of the tree node.
+ * passed to the visitor function with its `line` set to the line of the
+ * visited node and can be used during the evaluation of the tree node.
+ * If the visitor sets `skipChildren` of the trace, the subtree below the
+ * visited node is skipped and the traversal continues with the next sibling.
+ * Every visited node is counted in `numVisitedNodes` of the trace.
+ * The tree cursor used for the traversal is taken from the
+ * specified `ParserCache`.
  */
-void traverseTree(TSNode root, NodeVisitor visitor, NodeEvalTrace* trace);
+void traverseTree(
+    TSNode root,
+    NodeVisitor visitor,
+    NodeEvalTrace* trace,
+    ParserCache* cache
+);
+
+/**
+ * Counts the logical lines of code in the specified source code with the
+ * specified encoding and the parsing resources of the given `ParserCache`.
+ * Behaves exactly like `rcnCountLogicalLines()` otherwise.
+ */
+RcnCountResult evaluateLogicalLines(
+    RcnTextFormat language,
+    RcnSourceText sourceCode,
+    TextEncoding encoding,
+    ParserCache* cache
+);
+
+/**
+ * Counts the logical lines of code in the specified source code with the
+ * specified encoding by matching the query of the language against the AST,
+ * instead of visiting every node with the evaluation function of the
+ * language. The queries of all languages are compiled once, on first use,
+ * and are then shared by all threads. The query cursor is taken from the
+ * given `ParserCache`. Behaves like `evaluateLogicalLines()` otherwise.
+ * Nodes whose evaluation depends on the lines of other nodes are counted
+ * after all matches, in the order of the source code.
+ */
+RcnCountResult evaluateLogicalLinesByQuery(
+    RcnTextFormat language,
+    RcnSourceText sourceCode,
+    TextEncoding encoding,
+    ParserCache* cache
+);
 
 /**
  * Allocates and creates a parser for source code in the specified
@@ -120,6 +288,21 @@ void traverseTree(TSNode root, NodeVisitor visitor, NodeEvalTrace* trace);
  */
 TSParser* createParser(RcnTextFormat language);
 
+/**
+ * Allocates and compiles the query for the evaluation of the logical lines
+ * of code of the specified programming language. Every node captured by the
+ * query with the name `count` adds one logical line, a node captured with the
+ * name `count.<n>` adds n logical lines and a node captured with the name
+ * `uncount` removes one logical line. A node captured with the name
+ * `row.<name>` marks the line it starts on, and a node captured with the
+ * name `count.unless.<name>` adds one logical line unless the last node
+ * marked with each of the dot-separated names starts on the same line.
+ * May return `NULL` if the specified language is not supported or if the
+ * query cannot be compiled. Ownership of the returned query is transferred
+ * to the caller.
+ */
+TSQuery* createQuery(RcnTextFormat language);
+
 /**
  * Returns a node evaluation function for the specified programming language.
  * May return `NULL` if the specified language is not supported. The returned
@@ -181,6 +364,231 @@ bool hasUTF8BOM(RcnSourceText source);
  */
 TextEncoding detectEncoding(RcnSourceText source);
 
+/**
+ * The number of bytes at the start of a source text which are inspected
+ * to detect binary content.
+ */
+enum { BINARY_CHECK_SIZE = 8192 };
+
+/**
+ * Indicates whether the given source text with the specified encoding
+ * appears to have binary content.
+ * 
+ * Only the first `BINARY_CHECK_SIZE` bytes of the source text are inspected.
+ * A UTF-8 encoded source text has binary content if it contains a null byte
+ * or if more than a tenth of its bytes are other control characters, as
+ * counted by `countControlBytes()`. A UTF-16 encoded source text has binary
+ * content if it contains a null code unit.
+ */
+bool isBinaryContent(RcnSourceText source, TextEncoding encoding);
+
+/**
+ * A reusable buffer for text which is derived from a source text.
+ * 
+ * The buffer grows as needed and keeps its memory between uses, so that it
+ * does not have to be reallocated for every processed source text.
+ * A zero-initialized buffer is empty and ready to be used. The memory of a
+ * buffer must be released with `freeTextBuffer()`.
+ */
+typedef struct TextBuffer {
+    char* data;
+    size_t capacity;
+} TextBuffer;
+
+/**
+ * Frees the memory held by the given buffer. The buffer itself is not freed
+ * but is empty afterwards and can be used again.
+ */
+void freeTextBuffer(TextBuffer* buffer);
+
+/**
+ * Transcodes the given UTF-16 encoded source text with the specified
+ * encoding to UTF-8 into the specified buffer. The BOM of the source text
+ * is not transcoded.
+ * 
+ * The transcoded text has the same physical lines, words, characters and
+ * logical lines as the source text. On success, `true` is returned and the
+ * transcoded text is written to `transcoded`. It is null-terminated and
+ * refers to the memory of the buffer, so that it remains valid until the
+ * buffer is used again or freed.
+ * Returns `false` if the source text is not UTF-16 encoded, if it has no
+ * UTF-8 representation with the same counts, e.g. due to an unpaired
+ * surrogate, or if the buffer cannot be enlarged. The source text must then
+ * be processed as it is.
+ */
+bool transcodeToUTF8(
+    RcnSourceText source,
+    TextEncoding encoding,
+    TextBuffer* buffer,
+    RcnSourceText* transcoded
+);
+
+/**
+ * Returns the initial state for counting line breaks in a source text that
+ * starts with the specified bytes. The specified start must include the first
+ * three bytes of the source text, or all of it if the text is smaller. The
+ * specified encoding must be the one of the source text, as detected
+ * by `detectEncoding()`.
+ */
+ChunkedCount initLineBreakCount(RcnSourceText start, TextEncoding encoding);
+
+/**
+ * Counts the physical lines in the specified source text with the specified
+ * encoding. Behaves exactly like `rcnCountPhysicalLines()` otherwise.
+ */
+RcnCountResult countPhysicalLinesInText(
+    RcnSourceText source,
+    TextEncoding encoding
+);
+
+/**
+ * A `ChunkCounter` for line breaks. The last line of a source text is
+ * not counted by this function if it does not end with a line break.
+ * Use `endsWithUnterminatedLine()` to account for such a line.
+ */
+size_t countLineBreaksInChunk(
+    ChunkedCount* counter,
+    const char* chunk,
+    size_t size,
+    bool isFinal
+);
+
+/**
+ * Checks whether a source text of the specified size and encoding ends
+ * with a line that is not terminated by a line break. The last two bytes
+ * of the source text are given by `last`, where `last[1]` is the very last
+ * byte. The first element is ignored if the text is smaller than two bytes.
+ */
+bool endsWithUnterminatedLine(
+    TextEncoding encoding,
+    const char last[2],
+    RcnCount size
+);
+
+/**
+ * Returns the initial state for counting words in a source text that
+ * starts with the specified bytes, as described for `initLineBreakCount()`.
+ */
+ChunkedCount initWordCount(RcnSourceText start, TextEncoding encoding);
+
+/**
+ * A `ChunkCounter` for words. Words are delimited by white space
+ * independently of the current locale, as by `rcnCountWords()`.
+ */
+size_t countWordsInChunk(
+    ChunkedCount* counter,
+    const char* chunk,
+    size_t size,
+    bool isFinal
+);
+
+/**
+ * A `ChunkCounter` for words which are delimited by the white space
+ * characters of the current locale, as classified by `isspace()`.
+ */
+size_t countLocaleWordsInChunk(
+    ChunkedCount* counter,
+    const char* chunk,
+    size_t size,
+    bool isFinal
+);
+
+/**
+ * Counts the number of words in the specified source text with the specified
+ * encoding like `rcnCountWords()`. If `isLocaleAware` is `true`, the words
+ * are delimited by the white space characters of the current locale.
+ */
+RcnCountResult countWordsInText(
+    RcnSourceText source,
+    TextEncoding encoding,
+    bool isLocaleAware
+);
+
+/**
+ * Creates a new count stream like `rcnCreateCountStream()`. If
+ * `isLocaleAware` is `true`, the counted words are delimited by the
+ * white space characters of the current locale.
+ */
+RcnCountStream* createCountStream(uint32_t operations, bool isLocaleAware);
+
+/**
+ * Counts the specified text metrics in the specified source text with the
+ * specified encoding like `rcnCountTextMetrics()`. If `isLocaleAware` is
+ * `true`, the counted words are delimited by the white space characters of
+ * the current locale.
+ */
+RcnCountResultGroup countTextMetrics(
+    RcnSourceText source,
+    TextEncoding encoding,
+    uint32_t operations,
+    bool isLocaleAware
+);
+
+/**
+ * Counts the specified text metrics in the specified source text like
+ * `countTextMetrics()`, but splits the source text into up to the specified
+ * number of segments which are counted concurrently.
+ * 
+ * Each split is moved to the next boundary between two characters and the
+ * words that span a split are only counted once, so that the counts are
+ * the same as the ones of `countTextMetrics()`. Segments are at least a few
+ * kilobytes in size, so smaller source texts are not split. The segments are
+ * counted by up to one task per segment with the specified runner, which is
+ * called with the specified context. If the runner is `NULL`, the tasks are
+ * run with `runConcurrently()`, i.e. the calling thread counts segments as
+ * well.
+ */
+RcnCountResultGroup countTextMetricsInSegments(
+    RcnSourceText source,
+    TextEncoding encoding,
+    uint32_t operations,
+    bool isLocaleAware,
+    size_t maxSegments,
+    TaskRunner runner,
+    void* context
+);
+
+/**
+ * Updates the given count stream with the specified chunk like
+ * `rcnUpdateCountStream()`, but splits the chunk into up to the specified
+ * number of segments which are counted concurrently like with
+ * `countTextMetricsInSegments()`. The counts of the stream are the same as if
+ * the chunk had been passed to `rcnUpdateCountStream()`, so both functions
+ * can be used with the chunks of the same stream.
+ */
+bool updateCountStreamInSegments(
+    RcnCountStream* stream,
+    RcnSourceText chunk,
+    size_t maxSegments,
+    TaskRunner runner,
+    void* context
+);
+
+/**
+ * Returns the initial state for counting characters in a source text that
+ * starts with the specified bytes, as described for `initLineBreakCount()`.
+ */
+ChunkedCount initCharacterCount(RcnSourceText start, TextEncoding encoding);
+
+/**
+ * Counts the characters in the specified source text with the specified
+ * encoding. Behaves exactly like `rcnCountCharacters()` otherwise.
+ */
+RcnCountResult countCharactersInText(
+    RcnSourceText source,
+    TextEncoding encoding
+);
+
+/**
+ * A `ChunkCounter` for characters.
+ */
+size_t countCharactersInChunk(
+    ChunkedCount* counter,
+    const char* chunk,
+    size_t size,
+    bool isFinal
+);
+
 /**
  * Returns the physical line number that corresponds to the given node.
  * The line number is one-based.
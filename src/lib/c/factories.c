@@ -25,6 +25,9 @@
 TSParser* createParserC(void);
 TSParser* createParserJava(void);
 
+TSQuery* createQueryC(void);
+TSQuery* createQueryJava(void);
+
 void evaluateNodeC(TSNode node, NodeEvalTrace* trace);
 void evaluateNodeJava(TSNode node, NodeEvalTrace* trace);
 
@@ -39,6 +42,17 @@ TSParser* createParser(RcnTextFormat language) {
     }
 }
 
+TSQuery* createQuery(RcnTextFormat language) {
+    switch (language) {
+        case RCN_LANG_C:
+            return createQueryC();
+        case RCN_LANG_JAVA:
+            return createQueryJava();
+        default:
+            return NULL;
+    }
+}
+
 NodeVisitor createEvaluationFunction(RcnTextFormat language) {
     switch (language) {
         case RCN_LANG_C:
@@ -59,6 +73,16 @@ const char* getInlineSourceCommentString(RcnTextFormat language) {
     }
 }
 
+static bool isProgrammingLanguage(RcnTextFormat format) {
+    switch (format) {
+        case RCN_LANG_C:
+        case RCN_LANG_JAVA:
+            return true;
+        default:
+            return false;
+    }
+}
+
 SourceFormatDetection detectSourceFormat(const RcnSourceFile* file) {
     SourceFormatDetection detection = {
         .isSupportedFormat = false,
@@ -66,26 +90,30 @@ SourceFormatDetection detectSourceFormat(const RcnSourceFile* file) {
         .format = RCN_TEXT_UNFORMATTED // undefined placeholder
     };
 
-    if (!file || !file->extension) {
+    if (!file) {
         return detection;
     }
-
-    const char* extension = file->extension;
-    if (strcmp(extension, "c") == 0 || strcmp(extension, "h") == 0) {
-        detection.isSupportedFormat = true;
-        detection.isProgrammingLanguage = true;
-        detection.format = RCN_LANG_C;
-    } else if (strcmp(extension, "java") == 0) {
-        detection.isSupportedFormat = true;
-        detection.isProgrammingLanguage = true;
-        detection.format = RCN_LANG_JAVA;
-    } else if (strcmp(extension, "md") == 0) {
-        detection.isSupportedFormat = true;
-        detection.format = RCN_TEXT_MARKDOWN;
-    } else if (strcmp(extension, "txt") == 0) {
-        detection.isSupportedFormat = true;
-        detection.format = RCN_TEXT_UNFORMATTED;
+    if (file->isFormatDetected) {
+        detection.isSupportedFormat = file->isFormatSupported;
+        detection.format = file->format;
+    } else if (file->extension) {
+        const char* extension = file->extension;
+        if (strcmp(extension, "c") == 0 || strcmp(extension, "h") == 0) {
+            detection.isSupportedFormat = true;
+            detection.format = RCN_LANG_C;
+        } else if (strcmp(extension, "java") == 0) {
+            detection.isSupportedFormat = true;
+            detection.format = RCN_LANG_JAVA;
+        } else if (strcmp(extension, "md") == 0) {
+            detection.isSupportedFormat = true;
+            detection.format = RCN_TEXT_MARKDOWN;
+        } else if (strcmp(extension, "txt") == 0) {
+            detection.isSupportedFormat = true;
+            detection.format = RCN_TEXT_UNFORMATTED;
+        }
     }
-
+    detection.isProgrammingLanguage = (
+        detection.isSupportedFormat && isProgrammingLanguage(detection.format)
+    );
     return detection;
 }
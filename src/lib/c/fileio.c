@@ -18,11 +18,13 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 #include <errno.h>
 #include <assert.h>
 
 #include "reckon/reckon.h"
+#include "concurrency.h"
 #include "fileio.h"
 
 /* Declarations of platform-specific implementation functions */
@@ -30,12 +32,38 @@
 char* findFilenameImpl(const char* path);
 bool hasTrailingSeparatorImpl(const char* path, size_t length);
 
+/**
+ * Maps the content of the given file into memory if the file size is
+ * at most `maxSize`. The mapped content must be null-terminated.
+ * Returns `false` without changing the file if the content is not mapped.
+ */
+bool mapFileContentImpl(RcnSourceFile* file, size_t maxSize);
+
+/**
+ * Unmaps the given content that was mapped by `mapFileContentImpl()`.
+ */
+void unmapFileContentImpl(RcnSourceText content);
+
+/**
+ * Determines the size of the regular file with the given open handle from
+ * its file system metadata, without changing the position of the handle.
+ * Returns `false` if the size cannot be determined in that way.
+ */
+bool getFileSizeImpl(FILE* handle, size_t* size);
+
 /**
  * Scans the given directory for regular files and appends them to the list.
  * Subdirectories are pushed onto the stack for further scanning. Entries that
- * have a different file type are ignored.
+ * have a different file type are ignored. The specified buffer may be used
+ * to read the directory entries and is reused across calls. The paths of all
+ * found files and subdirectories are allocated from the arenas of the buffer.
  */
-void scanDirectory(char* dirPath, DirStack* stack, SourceFileList* list);
+void scanDirectory(
+    char* dirPath,
+    DirStack* stack,
+    SourceFileList* list,
+    ScanBuffer* buffer
+);
 
 /* End of declarations */
 
@@ -56,13 +84,99 @@ static const size_t DATA_STRUCT_CAP_GROW_FACTOR = 2;
 static const size_t FILE_MAX_PROC_SIZE = 512UL * 1024UL * 1024UL;
 
 /**
- * The maximum number of `RcnSourceFile` objects that can be
- * tracked in a `SourceFileList`. This is an arbitrary limit imposed to prevent
- * resource exhaustion and infinite loops during directory traversals
- * due to e.g. symlink loops. Under normal circumstances, this limit is high
- * enough and should not be reached.
+ * The size in bytes of the chunks in which file content is read if the
+ * content is not read entirely.
  */
-static const size_t FILES_LIST_MAX_SIZE = 10000;
+static const size_t FILE_READ_CHUNK_SIZE = 1024UL * 1024UL;
+
+/**
+ * The maximum capacity in bytes that a `ReadBuffer` retains. Contents of
+ * larger files are read into memory of their own, so that a single large
+ * file does not pin its memory for the remainder of a count operation.
+ */
+static const size_t READ_BUFFER_MAX_CAPACITY = 8UL * 1024UL * 1024UL;
+
+/**
+ * The size in bytes of the chunks of a `PathArena`. Paths that do not fit
+ * into a chunk of this size are stored in a chunk of their own.
+ */
+static const size_t PATH_ARENA_CHUNK_SIZE = 64UL * 1024UL;
+
+/**
+ * The number of bytes by which files are radix sorted in each step.
+ */
+enum { FILE_SORT_PREFIX_SIZE = sizeof(uint64_t) };
+
+/**
+ * The minimum number of files that are radix sorted. Fewer files are
+ * sorted by comparison.
+ */
+enum { FILE_SORT_MIN_RADIX_SIZE = 64 };
+
+/**
+ * A chunk of memory of a `PathArena`. The chunks of an arena form a list
+ * which starts with the most recently allocated chunk.
+ */
+typedef struct PathChunk {
+    struct PathChunk* next;
+    size_t size;
+    size_t used;
+    char data[];
+} PathChunk;
+
+/**
+ * A file to be sorted along with some bytes of its sort string in big-endian
+ * order, so that comparing prefixes as integers is equivalent to comparing
+ * these bytes with `strcmp()`.
+ */
+typedef struct FileSortKey {
+    uint64_t prefix;
+    const RcnSourceFile* file;
+} FileSortKey;
+
+/**
+ * The scratch memory of a radix sort of files, which is shared by all
+ * recursive steps of the sort.
+ */
+typedef struct FileSorter {
+    FileSortKey* buffer;
+    size_t (*counts)[256];
+} FileSorter;
+
+/**
+ * The state of a single thread of a directory traversal.
+ * The stack of the worker is guarded by its mutex, since other
+ * workers may steal directories from it.
+ */
+typedef struct ScanWorker {
+    struct ScanJob* job;
+    size_t index;
+    DirStack stack;
+    DirStack found;
+    Mutex* mutex;
+    SourceFileList list;
+    ScanBuffer buffer;
+} ScanWorker;
+
+/**
+ * The state shared by all threads of a directory traversal.
+ * The number of pending directories, i.e. directories that have been
+ * found but not yet scanned, is guarded by the idle mutex. The consumer
+ * is only called while holding the consumer mutex.
+ */
+typedef struct ScanJob {
+    ScanWorker* workers;
+    size_t numWorkers;
+    size_t pending;
+    size_t isStopped;
+    Mutex* idleMutex;
+    CondVar* workAvailable;
+    SourceFileConsumer consumer;
+    void* arg;
+    Mutex* consumerMutex;
+    size_t numConsumed;
+    bool isAborted;
+} ScanJob;
 
 static char* findFilename(const char* path) {
     if (!path) {
@@ -83,10 +197,7 @@ static char* findExtension(const char* name) {
     return dot + 1;
 }
 
-/**
- * Comparator for qsort(), lexicographical sort by file name.
- */
-static int compareSourceFileByName(const void* arg1, const void* arg2) {
+int compareSourceFileByName(const void* arg1, const void* arg2) {
     const RcnSourceFile* file1 = (const RcnSourceFile*) arg1;
     const RcnSourceFile* file2 = (const RcnSourceFile*) arg2;
     if (!file1->name) {
@@ -95,20 +206,208 @@ static int compareSourceFileByName(const void* arg1, const void* arg2) {
     if (!file2->name) {
         return 1; // LCOV_EXCL_LINE
     }
-    return strcmp(file1->name, file2->name);
+    const int order = strcmp(file1->name, file2->name);
+    if (order != 0) {
+        return order;
+    }
+    // Files with equal names in different directories are ordered by their
+    // full path so that the order of all files is always fully determined
+    return strcmp(file1->path, file2->path);
 }
 
-static void trimExactSize(SourceFileList* list) {
-    if (list->size > 0 && list->capacity > list->size) {
-        RcnSourceFile* reallocatedFiles = realloc(
-            list->files,
-            list->size * sizeof(RcnSourceFile)
-        );
-        if (reallocatedFiles) {
-            list->files = reallocatedFiles;
-            list->capacity = list->size;
+/**
+ * Returns the bytes of the sort string of the given file, starting at the
+ * specified offset, as a big-endian integer. Files are ordered by name and
+ * then by path, which is equivalent to ordering them by a sort string formed
+ * by the name, a null byte and the path. The integer is padded with zeros
+ * after the end of the sort string, in which case `isEnd` is set to `true`.
+ */
+static uint64_t fileSortPrefix(
+    const RcnSourceFile* file,
+    size_t offset,
+    bool* isEnd
+) {
+    const char* name = file->name ? file->name : "";
+    const size_t nameLength = strlen(name);
+    const char* text = name;
+    size_t index = offset;
+    if (offset > nameLength) {
+        text = file->path ? file->path : "";
+        index = offset - nameLength - 1;
+    }
+    uint64_t prefix = 0;
+    bool hasEnded = false;
+    for (size_t i = 0; i < FILE_SORT_PREFIX_SIZE; ++i) {
+        unsigned char byte = 0;
+        if (!hasEnded) {
+            byte = (unsigned char) text[index++];
+            if (byte == 0 && text == name) {
+                text = file->path ? file->path : "";
+                index = 0;
+            } else if (byte == 0) {
+                hasEnded = true;
+            }
         }
+        prefix = (prefix << 8) | byte;
     }
+    *isEnd = hasEnded;
+    return prefix;
+}
+
+static int compareFileSortKeys(const void* arg1, const void* arg2) {
+    const FileSortKey* key1 = (const FileSortKey*) arg1;
+    const FileSortKey* key2 = (const FileSortKey*) arg2;
+    if (key1->prefix != key2->prefix) {
+        return (key1->prefix < key2->prefix) ? -1 : 1;
+    }
+    return compareSourceFileByName(key1->file, key2->file);
+}
+
+/**
+ * Sorts the given keys by their prefixes with a least significant digit
+ * radix sort, one byte per pass. Passes in which all keys have the same
+ * byte are skipped. The sorter provides the required scratch memory.
+ */
+static void radixSortFileKeys(
+    FileSortKey* keys,
+    size_t size,
+    FileSorter* sorter
+) {
+    size_t (*counts)[256] = sorter->counts;
+    memset((void*) counts, 0, FILE_SORT_PREFIX_SIZE * sizeof(*counts));
+    for (size_t i = 0; i < size; ++i) {
+        const uint64_t prefix = keys[i].prefix;
+        for (size_t pass = 0; pass < FILE_SORT_PREFIX_SIZE; ++pass) {
+            ++counts[pass][(prefix >> (pass * 8)) & 0xFF];
+        }
+    }
+    FileSortKey* source = keys;
+    FileSortKey* target = sorter->buffer;
+    for (size_t pass = 0; pass < FILE_SORT_PREFIX_SIZE; ++pass) {
+        size_t* count = counts[pass];
+        const size_t digit = (source[0].prefix >> (pass * 8)) & 0xFF;
+        if (count[digit] == size) {
+            continue;
+        }
+        size_t offset = 0;
+        for (size_t i = 0; i < 256; ++i) {
+            const size_t bucketSize = count[i];
+            count[i] = offset;
+            offset += bucketSize;
+        }
+        for (size_t i = 0; i < size; ++i) {
+            const size_t d = (source[i].prefix >> (pass * 8)) & 0xFF;
+            target[count[d]++] = source[i];
+        }
+        FileSortKey* sorted = target;
+        target = source;
+        source = sorted;
+    }
+    if (source != keys) {
+        memcpy(keys, source, size * sizeof(FileSortKey));
+    }
+}
+
+/**
+ * Sorts the given keys by the bytes of the sort strings of their files
+ * from the specified offset onwards. The keys are radix sorted by the next
+ * bytes of their sort strings and the keys which are still equal are then
+ * sorted recursively by the subsequent bytes. Small numbers of keys and keys
+ * of files with entirely equal sort strings are sorted by comparison.
+ */
+static void sortFileKeysFrom(
+    FileSortKey* keys,
+    size_t size,
+    size_t offset,
+    FileSorter* sorter
+) {
+    bool isEnd = false;
+    for (size_t i = 0; i < size; ++i) {
+        keys[i].prefix = fileSortPrefix(keys[i].file, offset, &isEnd);
+    }
+    if (size < FILE_SORT_MIN_RADIX_SIZE) {
+        qsort(keys, size, sizeof(FileSortKey), compareFileSortKeys);
+        return;
+    }
+    radixSortFileKeys(keys, size, sorter);
+    size_t start = 0;
+    for (size_t i = 1; i <= size; ++i) {
+        if (i < size && keys[i].prefix == keys[start].prefix) {
+            continue;
+        }
+        const size_t runSize = i - start;
+        if (runSize > 1) {
+            fileSortPrefix(keys[start].file, offset, &isEnd);
+            if (isEnd) {
+                qsort(
+                    &keys[start],
+                    runSize,
+                    sizeof(FileSortKey),
+                    compareFileSortKeys
+                );
+            } else {
+                sortFileKeysFrom(
+                    &keys[start],
+                    runSize,
+                    offset + FILE_SORT_PREFIX_SIZE,
+                    sorter
+                );
+            }
+        }
+        start = i;
+    }
+}
+
+/**
+ * Sorts the given keys in the order defined by `compareSourceFileByName()`.
+ */
+static void sortFileKeys(FileSortKey* keys, size_t size) {
+    FileSorter sorter = {0};
+    if (size >= FILE_SORT_MIN_RADIX_SIZE) {
+        sorter.buffer = malloc(size * sizeof(FileSortKey));
+        sorter.counts = calloc(FILE_SORT_PREFIX_SIZE, sizeof(*sorter.counts));
+        if (!sorter.buffer || !sorter.counts) {
+            // LCOV_EXCL_START
+            free(sorter.buffer);
+            free((void*) sorter.counts);
+            for (size_t i = 0; i < size; ++i) {
+                keys[i].prefix = 0;
+            }
+            qsort(keys, size, sizeof(FileSortKey), compareFileSortKeys);
+            return;
+            // LCOV_EXCL_STOP
+        }
+    }
+    sortFileKeysFrom(keys, size, 0, &sorter);
+    free(sorter.buffer);
+    free((void*) sorter.counts);
+}
+
+void sortSourceFiles(void* items, size_t size, size_t itemSize) {
+    if (size < 2) {
+        return;
+    }
+    char* bytes = (char*) items;
+    FileSortKey* keys = malloc(size * sizeof(FileSortKey));
+    char* sorted = malloc(size * itemSize);
+    if (!keys || !sorted) {
+        // LCOV_EXCL_START
+        free(keys);
+        free(sorted);
+        qsort(items, size, itemSize, compareSourceFileByName);
+        return;
+        // LCOV_EXCL_STOP
+    }
+    for (size_t i = 0; i < size; ++i) {
+        keys[i].file = (const RcnSourceFile*) (bytes + (i * itemSize));
+    }
+    sortFileKeys(keys, size);
+    for (size_t i = 0; i < size; ++i) {
+        memcpy(sorted + (i * itemSize), (const void*) keys[i].file, itemSize);
+    }
+    memcpy(items, sorted, size * itemSize);
+    free(keys);
+    free(sorted);
 }
 
 static bool finishFileRd(
@@ -124,10 +423,61 @@ static bool finishFileRd(
     return status == RCN_FILE_OP_OK ? true : false;
 }
 
-bool appendFile(SourceFileList* list, const char* path) {
-    if (list->size >= FILES_LIST_MAX_SIZE) {
-        return false; // LCOV_EXCL_LINE
+static void setSourceFilePath(RcnSourceFile* file, char* path) {
+    file->path = path;
+    file->name = findFilename(file->path);
+    file->extension = findExtension(file->name);
+    // The format only depends on the extension, so it is detected only once
+    file->isFormatDetected = false;
+    const SourceFormatDetection detected = detectSourceFormat(file);
+    file->format = detected.format;
+    file->isFormatSupported = detected.isSupportedFormat;
+    file->isFormatDetected = true;
+}
+
+char* allocArenaPath(PathArena* arena, size_t size) {
+    PathChunk* chunk = arena->chunks;
+    if (!chunk || chunk->size - chunk->used < size) {
+        const size_t chunkSize = (
+            size > PATH_ARENA_CHUNK_SIZE ? size : PATH_ARENA_CHUNK_SIZE
+        );
+        chunk = malloc(sizeof(PathChunk) + chunkSize);
+        if (!chunk) {
+            return NULL; // LCOV_EXCL_LINE
+        }
+        chunk->next = arena->chunks;
+        chunk->size = chunkSize;
+        chunk->used = 0;
+        arena->chunks = chunk;
+    }
+    char* path = chunk->data + chunk->used;
+    chunk->used += size;
+    return path;
+}
+
+void clearPathArena(PathArena* arena) {
+    PathChunk* chunk = arena->chunks;
+    if (chunk) {
+        PathChunk* next = chunk->next;
+        chunk->next = NULL;
+        chunk->used = 0;
+        arena->chunks = next;
+        freePathArena(arena);
+        arena->chunks = chunk;
     }
+}
+
+void freePathArena(PathArena* arena) {
+    PathChunk* chunk = arena->chunks;
+    while (chunk) {
+        PathChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    arena->chunks = NULL;
+}
+
+bool appendFile(SourceFileList* list, char* path, size_t size) {
     if (list->size >= list->capacity) {
         const size_t newCapacity = (
             list->capacity
@@ -144,7 +494,13 @@ bool appendFile(SourceFileList* list, const char* path) {
         list->files = reallocatedFiles;
         list->capacity = newCapacity;
     }
-    initSourceFile(&list->files[list->size++], path);
+    RcnSourceFile* file = &list->files[list->size++];
+    *file = (RcnSourceFile){
+        .status = RCN_FILE_OP_OK,
+        .isPathShared = true,
+        .scannedSize = size
+    };
+    setSourceFilePath(file, path);
     return true;
 }
 
@@ -206,18 +562,23 @@ void initSourceFile(RcnSourceFile* file, const char* path) {
         );
         // LCOV_EXCL_STOP
     }
-    file->path = pathCopy;
-    file->name = findFilename(file->path);
-    file->extension = findExtension(file->name);
+    setSourceFilePath(file, pathCopy);
     file->content = (RcnSourceText){0};
     file->status = status;
     file->isContentRead = false;
+    file->isContentMapped = false;
+    file->isPathShared = false;
+    file->scannedSize = 0;
+    file->encoding = RCN_ENC_UTF8;
+    file->isEncodingDetected = false;
 }
 
 void deinitSourceFile(RcnSourceFile* file) {
     if (file) {
         if (file->path) {
-            free(file->path);
+            if (!file->isPathShared) {
+                free(file->path);
+            }
             file->path = NULL;
         }
         if (file->name) {
@@ -235,50 +596,302 @@ void freeSourceFile(RcnSourceFile* file) {
     free(file);
 }
 
-// Ignore false positive. Perhaps it gets confused by a combination of realloc
-// usage in trimExactSize() and the optimization that a file name and extension
-// inside a RcnSourceFile are pointers into the copy of the path during init
-// and not independent copies.
-#if defined(__GNUC__) && !defined(__clang__)
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wanalyzer-malloc-leak"
-#endif
-SourceFileList newSourceFileList(const char* path) {
-    SourceFileList list = {0};
-    if (!path) {
-        return list;
+/**
+ * Removes the oldest directory path from the stack. Directories near the root
+ * of a traversal usually span the largest subtrees, which makes them the
+ * preferred target for stealing.
+ */
+static char* dirStackTakeOldest(DirStack* stack) {
+    if (stack->size == 0) {
+        return NULL;
     }
-    DirStack stack = {0};
-    char* dirPath = strdup(path);
-    if (!dirStackPush(&stack, dirPath)) {
-        free(dirPath);
-        return list;
+    char* path = stack->data[0];
+    stack->size--;
+    memmove(
+        (void*) stack->data,
+        (void*) (stack->data + 1),
+        stack->size * sizeof(char*)
+    );
+    return path;
+}
+
+static char* popOwnDirectory(ScanWorker* worker) {
+    lockMutex(worker->mutex);
+    char* dirPath = dirStackPop(&worker->stack);
+    unlockMutex(worker->mutex);
+    return dirPath;
+}
+
+static char* stealDirectory(ScanWorker* worker) {
+    ScanJob* job = worker->job;
+    for (size_t i = 1; i < job->numWorkers; ++i) {
+        ScanWorker* victim = &job->workers[
+            (worker->index + i) % job->numWorkers
+        ];
+        lockMutex(victim->mutex);
+        char* dirPath = dirStackTakeOldest(&victim->stack);
+        unlockMutex(victim->mutex);
+        if (dirPath) {
+            return dirPath;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Takes the next directory to be scanned by the given worker. Directories
+ * are taken from the worker's own stack first and are stolen from other
+ * workers otherwise. Blocks until a directory is available. Returns `NULL`
+ * when all directories of the traversal have been scanned.
+ */
+static char* takeDirectory(ScanWorker* worker) {
+    char* dirPath = popOwnDirectory(worker);
+    if (dirPath) {
+        return dirPath;
+    }
+    ScanJob* job = worker->job;
+    lockMutex(job->idleMutex);
+    while ((dirPath = stealDirectory(worker)) == NULL && job->pending > 0) {
+        waitCondVar(job->workAvailable, job->idleMutex);
+    }
+    unlockMutex(job->idleMutex);
+    return dirPath;
+}
+
+/**
+ * Completes the scan of a directory by the given worker. The subdirectories
+ * found by the scan are pushed onto the worker's own stack where they
+ * become visible to other workers.
+ */
+static void finishDirectory(ScanWorker* worker) {
+    ScanJob* job = worker->job;
+    DirStack* found = &worker->found;
+    size_t pushed = 0;
+    lockMutex(job->idleMutex);
+    lockMutex(worker->mutex);
+    for (size_t i = 0; i < found->size; ++i) {
+        if (dirStackPush(&worker->stack, found->data[i])) {
+            ++pushed;
+        }
+    }
+    unlockMutex(worker->mutex);
+    found->size = 0;
+    // The finished directory is accounted for only after its
+    // subdirectories, so that the count cannot drop to zero prematurely
+    job->pending = job->pending + pushed - 1;
+    if (pushed > 0 || job->pending == 0) {
+        broadcastCondVar(job->workAvailable);
+    }
+    unlockMutex(job->idleMutex);
+}
+
+/**
+ * Passes all files found by the given worker to the consumer of the
+ * traversal, if any. Each passed file owns a copy of its path, so that
+ * the arena of the file paths of the worker can be reused afterwards.
+ */
+static void passScannedFiles(ScanWorker* worker) {
+    ScanJob* job = worker->job;
+    if (!job->consumer) {
+        return;
     }
+    SourceFileList* list = &worker->list;
+    lockMutex(job->consumerMutex);
+    for (size_t i = 0; i < list->size && !job->isAborted; ++i) {
+        RcnSourceFile file;
+        initSourceFile(&file, list->files[i].path);
+        file.scannedSize = list->files[i].scannedSize;
+        ++job->numConsumed;
+        if (!job->consumer(&file, job->arg)) {
+            job->isAborted = true;
+            atomicFetchAdd(&job->isStopped, 1);
+        }
+    }
+    unlockMutex(job->consumerMutex);
+    list->size = 0;
+    clearPathArena(&worker->buffer.filePaths);
+}
+
+static void scanConcurrently(void* arg) {
+    ScanWorker* worker = (ScanWorker*) arg;
+    ScanJob* job = worker->job;
+    char* dirPath = NULL;
+    while ((dirPath = takeDirectory(worker)) != NULL) {
+        if (atomicLoad(&job->isStopped) == 0) {
+            scanDirectory(
+                dirPath,
+                &worker->found,
+                &worker->list,
+                &worker->buffer
+            );
+            passScannedFiles(worker);
+        }
+        finishDirectory(worker);
+    }
+}
 
-    while ((dirPath = dirStackPop(&stack)) != NULL) {
-        scanDirectory(dirPath, &stack, &list);
-        free(dirPath);
-        if (list.size >= FILES_LIST_MAX_SIZE) {
-            break; // LCOV_EXCL_LINE
+/**
+ * Moves the files found by all workers of the given job into the specified
+ * list in sorted order. The files and their paths are packed into a single
+ * allocation, so that the paths no longer depend on the arenas of the workers.
+ */
+static bool packScannedFiles(ScanJob* job, SourceFileList* list) {
+    size_t size = 0;
+    size_t pathsSize = 0;
+    for (size_t i = 0; i < job->numWorkers; ++i) {
+        const SourceFileList* workerList = &job->workers[i].list;
+        for (size_t j = 0; j < workerList->size; ++j) {
+            pathsSize += strlen(workerList->files[j].path) + 1;
+        }
+        size += workerList->size;
+    }
+    *list = (SourceFileList){0};
+    if (size == 0) {
+        return true;
+    }
+    FileSortKey* keys = malloc(size * sizeof(FileSortKey));
+    RcnSourceFile* files = malloc((size * sizeof(RcnSourceFile)) + pathsSize);
+    if (!keys || !files) {
+        free(keys); // LCOV_EXCL_LINE
+        free(files); // LCOV_EXCL_LINE
+        return false; // LCOV_EXCL_LINE
+    }
+    size_t index = 0;
+    for (size_t i = 0; i < job->numWorkers; ++i) {
+        const SourceFileList* workerList = &job->workers[i].list;
+        for (size_t j = 0; j < workerList->size; ++j) {
+            keys[index++].file = &workerList->files[j];
         }
     }
+    sortFileKeys(keys, size);
+    char* paths = (char*) (files + size);
+    for (size_t i = 0; i < size; ++i) {
+        const size_t pathSize = strlen(keys[i].file->path) + 1;
+        memcpy(paths, keys[i].file->path, pathSize);
+        files[i] = *keys[i].file;
+        setSourceFilePath(&files[i], paths);
+        paths += pathSize;
+    }
+    free(keys);
+    *list = (SourceFileList){
+        .files = files,
+        .size = size,
+        .capacity = size
+    };
+    return true;
+}
+
+static void freeScanWorkers(ScanWorker* workers, size_t numWorkers) {
+    for (size_t i = 0; i < numWorkers; ++i) {
+        ScanWorker* worker = &workers[i];
+        free((void*) worker->stack.data);
+        free((void*) worker->found.data);
+        freeSourceFileList(&worker->list);
+        freeMutex(worker->mutex);
+        free(worker->buffer.data);
+        freePathArena(&worker->buffer.dirPaths);
+        freePathArena(&worker->buffer.filePaths);
+    }
+    free(workers);
+}
 
-    free((void*) stack.data);
-    trimExactSize(&list);
-    if (list.size > 1) {
-        qsort(
-            list.files,
-            list.size,
-            sizeof(RcnSourceFile),
-            compareSourceFileByName
+/**
+ * Traverses the directory tree under the given path with the specified
+ * number of threads. All threads take directories from their own stack
+ * and steal directories from the stacks of other threads when their own
+ * stack is empty. If a consumer is specified, all found files are passed to
+ * it. Otherwise, all found files are moved into the specified list in sorted
+ * order. Returns `false` if an error occurred or if the consumer has aborted
+ * the traversal.
+ */
+static bool traverseDirectory(
+    const char* path,
+    size_t numThreads,
+    SourceFileConsumer consumer,
+    void* arg,
+    SourceFileList* list
+) {
+    if (numThreads == 0) {
+        numThreads = 1;
+    }
+    ScanWorker* workers = calloc(numThreads, sizeof(ScanWorker));
+    ScanJob job = {
+        .workers = workers,
+        .numWorkers = numThreads,
+        .pending = 1,
+        .idleMutex = newMutex(),
+        .workAvailable = newCondVar(),
+        .consumer = consumer,
+        .arg = arg,
+        .consumerMutex = newMutex()
+    };
+    bool ok = workers && job.idleMutex && job.workAvailable;
+    ok = ok && job.consumerMutex;
+    for (size_t i = 0; ok && i < numThreads; ++i) {
+        workers[i].job = &job;
+        workers[i].index = i;
+        workers[i].mutex = newMutex();
+        ok = workers[i].mutex != NULL;
+    }
+    if (ok) {
+        const size_t pathSize = strlen(path) + 1;
+        char* dirPath = allocArenaPath(&workers[0].buffer.dirPaths, pathSize);
+        if (dirPath) {
+            memcpy(dirPath, path, pathSize);
+        }
+        ok = dirStackPush(&workers[0].stack, dirPath);
+    }
+    if (ok) {
+        runConcurrently(
+            scanConcurrently,
+            workers,
+            sizeof(ScanWorker),
+            numThreads
         );
+        ok = !job.isAborted;
+        if (ok && list) {
+            ok = packScannedFiles(&job, list);
+        }
+    }
+    if (workers) {
+        freeScanWorkers(workers, numThreads);
+    }
+    freeMutex(job.idleMutex);
+    freeCondVar(job.workAvailable);
+    freeMutex(job.consumerMutex);
+    return ok;
+}
+
+SourceFileList newSourceFileListConcurrently(
+    const char* path,
+    size_t numThreads
+) {
+    SourceFileList list = {0};
+    if (!path) {
+        return list;
+    }
+    if (!traverseDirectory(path, numThreads, NULL, NULL, &list)) {
+        return list; // LCOV_EXCL_LINE
     }
     list.ok = true;
     return list;
 }
-#if defined(__GNUC__) && !defined(__clang__)
-#pragma GCC diagnostic pop
-#endif
+
+SourceFileList newSourceFileList(const char* path) {
+    return newSourceFileListConcurrently(path, 1);
+}
+
+bool streamSourceFiles(
+    const char* path,
+    size_t numThreads,
+    SourceFileConsumer consumer,
+    void* arg
+) {
+    if (!path) {
+        return false;
+    }
+    return traverseDirectory(path, numThreads, consumer, arg, NULL);
+}
 
 void freeSourceFileList(SourceFileList* list) {
     if (list) {
@@ -294,7 +907,93 @@ void freeSourceFileList(SourceFileList* list) {
     }
 }
 
+/**
+ * Determines the size of the file with the given open handle. The size is
+ * taken from the file system metadata if possible, otherwise the handle is
+ * sought to its end and back to its start. Returns `false` on error.
+ */
+static bool getFileSize(FILE* handle, size_t* size) {
+    if (getFileSizeImpl(handle, size)) {
+        return true;
+    }
+    if (fseek(handle, 0, SEEK_END) != 0) {
+        return false;
+    }
+    const long endPos = ftell(handle);
+    if (endPos < 0) {
+        return false;
+    }
+    *size = (size_t) endPos;
+    return fseek(handle, 0, SEEK_SET) == 0;
+}
+
+/**
+ * Returns memory of at least the specified size for reading a file content.
+ * The memory is lent from the given buffer if it is not `NULL` and the size
+ * does not exceed the capacity that a buffer retains. Otherwise, the memory
+ * is allocated on its own. Returns `NULL` on allocation failure.
+ */
+static char* acquireContentMemory(ReadBuffer* buffer, size_t size) {
+    if (!buffer || size > READ_BUFFER_MAX_CAPACITY) {
+        return malloc(size);
+    }
+    if (buffer->isLent) {
+        // The memory of the previous file was not returned,
+        // so it is owned by that file now
+        buffer->data = NULL;
+        buffer->capacity = 0;
+        buffer->isLent = false;
+    }
+    if (size > buffer->capacity) {
+        // Grow geometrically, since a buffer is reused for many files. The
+        // previous content is not needed, so the memory is not reallocated
+        size_t capacity = buffer->capacity * DATA_STRUCT_CAP_GROW_FACTOR;
+        if (capacity < size) {
+            capacity = size;
+        }
+        if (capacity > READ_BUFFER_MAX_CAPACITY) {
+            capacity = READ_BUFFER_MAX_CAPACITY;
+        }
+        char* data = malloc(capacity);
+        if (!data) {
+            return NULL; // LCOV_EXCL_LINE
+        }
+        free(buffer->data);
+        buffer->data = data;
+        buffer->capacity = capacity;
+    }
+    buffer->isLent = true;
+    return buffer->data;
+}
+
+/**
+ * Releases memory that was returned by `acquireContentMemory()` but which
+ * has not been given to a file.
+ */
+static void discardContentMemory(ReadBuffer* buffer, char* memory) {
+    if (buffer && buffer->isLent && buffer->data == memory) {
+        buffer->isLent = false;
+    } else {
+        free(memory);
+    }
+}
+
+void freeReadBuffer(ReadBuffer* buffer) {
+    if (buffer) {
+        if (!buffer->isLent) {
+            free(buffer->data);
+        }
+        buffer->data = NULL;
+        buffer->capacity = 0;
+        buffer->isLent = false;
+    }
+}
+
 bool readSourceFileContent(RcnSourceFile* file) {
+    return readSourceFileContentBuffered(file, NULL);
+}
+
+bool readSourceFileContentBuffered(RcnSourceFile* file, ReadBuffer* buffer) {
     if (!file) {
         return false;
     }
@@ -318,27 +1017,22 @@ bool readSourceFileContent(RcnSourceFile* file) {
         return false;
     }
 
-    if (fseek(handle, 0, SEEK_END) != 0) {
-        return finishFileRd(handle, file, RCN_FILE_OP_IO_ERROR);
-    }
-    const long endPos = ftell(handle);
-    if (endPos < 0) {
-        return finishFileRd(handle, file, RCN_FILE_OP_IO_ERROR);
-    }
-    const size_t length = (size_t) endPos;
-    const size_t bufferSize = length + 1;
-    if (fseek(handle, 0, SEEK_SET) != 0) {
+    size_t length = 0;
+    if (!getFileSize(handle, &length)) {
         return finishFileRd(handle, file, RCN_FILE_OP_IO_ERROR);
     }
+    // Keeps the size as a hint for later count operations
+    file->scannedSize = length;
     if (length > FILE_MAX_PROC_SIZE) {
         return finishFileRd(handle, file, RCN_FILE_OP_FILE_TOO_LARGE);
     }
-    char* content = malloc(bufferSize);
+    const size_t bufferSize = length + 1;
+    char* content = acquireContentMemory(buffer, bufferSize);
     if (!content) {
         return finishFileRd(handle, file, RCN_FILE_OP_ALLOC_FAILURE);
     }
     if (fread(content, 1, length, handle) != length) {
-        free(content);
+        discardContentMemory(buffer, content);
         return finishFileRd(handle, file, RCN_FILE_OP_IO_ERROR);
     }
     content[length] = '\0';
@@ -351,12 +1045,139 @@ bool readSourceFileContent(RcnSourceFile* file) {
     return finishFileRd(handle, file, RCN_FILE_OP_OK);
 }
 
+bool readSourceFileChunks(
+    RcnSourceFile* file,
+    size_t chunkSize,
+    SourceTextConsumer consumer,
+    void* arg
+) {
+    if (!file) {
+        return false;
+    }
+    if (file->status != RCN_FILE_OP_OK
+        && file->status != RCN_FILE_OP_FILE_TOO_LARGE) {
+
+        return false;
+    }
+    if (!file->path) {
+        file->status = RCN_FILE_OP_INVALID_PATH;
+        return false;
+    }
+    FILE* handle = fopen(file->path, "rb");
+    if (!handle) {
+        file->status = (
+            errno == ENOENT
+            ? RCN_FILE_OP_FILE_NOT_FOUND
+            : RCN_FILE_OP_IO_ERROR
+        );
+        return false;
+    }
+    if (chunkSize == 0) {
+        chunkSize = FILE_READ_CHUNK_SIZE;
+    }
+    char* buffer = malloc(chunkSize);
+    if (!buffer) {
+        return finishFileRd(handle, file, RCN_FILE_OP_ALLOC_FAILURE);
+    }
+    bool isAborted = false;
+    size_t length = 0;
+    while (!isAborted
+           && (length = fread(buffer, 1, chunkSize, handle)) > 0) {
+
+        RcnSourceText chunk = {
+            .text = buffer,
+            .size = length
+        };
+        isAborted = !consumer(chunk, arg);
+    }
+    const RcnFileOpStatus status = (
+        ferror(handle)
+        ? RCN_FILE_OP_IO_ERROR
+        : RCN_FILE_OP_OK
+    );
+    free(buffer);
+    return finishFileRd(handle, file, status) && !isAborted;
+}
+
+bool readSourceFileHead(
+    RcnSourceFile* file,
+    char* buffer,
+    size_t capacity,
+    size_t* size
+) {
+    if (!file || !buffer || !size) {
+        return false;
+    }
+    if (file->status != RCN_FILE_OP_OK
+        && file->status != RCN_FILE_OP_FILE_TOO_LARGE) {
+
+        return false;
+    }
+    if (!file->path) {
+        file->status = RCN_FILE_OP_INVALID_PATH;
+        return false;
+    }
+    FILE* handle = fopen(file->path, "rb");
+    if (!handle) {
+        file->status = (
+            errno == ENOENT
+            ? RCN_FILE_OP_FILE_NOT_FOUND
+            : RCN_FILE_OP_IO_ERROR
+        );
+        return false;
+    }
+    *size = fread(buffer, 1, capacity, handle);
+    // A file that is too large to be loaded entirely keeps its status
+    const RcnFileOpStatus status = (
+        ferror(handle)
+        ? RCN_FILE_OP_IO_ERROR
+        : file->status
+    );
+    return finishFileRd(handle, file, status);
+}
+
+bool readSourceFileContentMapped(RcnSourceFile* file, ReadBuffer* buffer) {
+    if (!file || file->status != RCN_FILE_OP_OK || !file->path) {
+        return readSourceFileContentBuffered(file, buffer);
+    }
+    if (file->isContentRead) {
+        return true;
+    }
+    if (mapFileContentImpl(file, FILE_MAX_PROC_SIZE)) {
+        file->scannedSize = file->content.size;
+        return true;
+    }
+    return readSourceFileContentBuffered(file, buffer);
+}
+
 void freeSourceFileContent(RcnSourceFile* file) {
     if (file) {
         if (file->content.text) {
-            free(file->content.text);
+            if (file->isContentMapped) {
+                unmapFileContentImpl(file->content);
+            } else {
+                free(file->content.text);
+            }
         }
         file->content = (RcnSourceText){0};
         file->isContentRead = false;
+        file->isContentMapped = false;
+        file->isEncodingDetected = false;
+    }
+}
+
+void releaseSourceFileContent(RcnSourceFile* file, ReadBuffer* buffer) {
+    const bool isLentContent = (
+        file
+        && buffer
+        && buffer->isLent
+        && !file->isContentMapped
+        && file->content.text == buffer->data
+    );
+    if (isLentContent) {
+        buffer->isLent = false;
+        // The memory now belongs to the buffer again
+        file->content.text = NULL;
     }
+    freeSourceFileContent(file);
 }
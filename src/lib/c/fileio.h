@@ -38,7 +38,9 @@ extern "C" {
  * A list of source files.
  * 
  * Use `newSourceFileList()` to scan for files in a directory.
- * Ownership passes to the caller of `newSourceFileList()`.
+ * Ownership passes to the caller of `newSourceFileList()`. The shared paths
+ * of the files in a scanned list are stored in the same allocation as the
+ * `files` array and are released together with it.
  * The list must be deallocated with `freeSourceFileList()`.
  * If `size` is zero or `ok` is `false`, then `files` is `NULL`.
  */
@@ -73,6 +75,32 @@ typedef struct BaseDir {
     bool hasTrailingSeparator;
 } BaseDir;
 
+/**
+ * An arena for the paths of scanned files and directories.
+ * 
+ * Paths are stored back to back in chunks of memory, which avoids a separate
+ * allocation for each path. Use `allocArenaPath()` to allocate a path.
+ * All paths remain valid until the arena is freed with `freePathArena()`.
+ */
+typedef struct PathArena {
+    struct PathChunk* chunks;
+} PathArena;
+
+/**
+ * The reusable memory of a single thread of a directory traversal.
+ * 
+ * Holds the buffer for reading the entries of scanned directories, which is
+ * allocated on first use if the underlying platform needs one, as well as the
+ * arenas for the paths of all found directories and files. All members must
+ * be freed by the owner of the buffer.
+ */
+typedef struct ScanBuffer {
+    char* data;
+    size_t size;
+    PathArena dirPaths;
+    PathArena filePaths;
+} ScanBuffer;
+
 /**
  * The result type of the `detectSourceFormat()` function.
  * 
@@ -89,13 +117,38 @@ typedef struct SourceFormatDetection {
     bool isProgrammingLanguage;
 } SourceFormatDetection;
 
+/**
+ * Allocates memory for a path of the given size in bytes, including
+ * the null-terminator, from the specified arena.
+ * 
+ * Returns `NULL` on allocation failure.
+ */
+char* allocArenaPath(PathArena* arena, size_t size);
+
+/**
+ * Releases the memory of all paths allocated from the given arena
+ * except for the most recently used chunk, which is kept for reuse.
+ */
+void clearPathArena(PathArena* arena);
+
+/**
+ * Frees all memory of the given arena. All paths that were allocated
+ * from the arena become invalid.
+ */
+void freePathArena(PathArena* arena);
+
 /**
  * Appends a new source file with the given path to the list.
+ * The specified size is recorded as the scanned size of the file.
+ * 
+ * The path is not copied. It must have been allocated from a `PathArena`
+ * which outlives the list, and the appended file is marked as having
+ * a shared path.
  * 
  * Returns `true` on success, `false` on failure.
  * On failure, the list remains unchanged.
  */
-bool appendFile(SourceFileList* list, const char* path);
+bool appendFile(SourceFileList* list, char* path, size_t size);
 
 /**
  * Pushes a new directory path onto the stack.
@@ -110,7 +163,7 @@ bool dirStackPush(DirStack* stack, char* path);
  * Pops a directory path from the stack.
  * 
  * Returns the popped path, or `NULL` if the stack is empty.
- * The caller takes ownership of the returned path.
+ * The stack does not own the returned path.
  */
 char* dirStackPop(DirStack* stack);
 
@@ -159,8 +212,9 @@ void freeSourceFile(RcnSourceFile* file);
  *
  * The specified path must denote an existing directory.
  * The returned list is sorted lexicographically by the file name
- * in ascending order. The returned list is owned by the caller
- * and must be deallocated with `freeSourceFileList()`.
+ * in ascending order, as defined by `compareSourceFileByName()`.
+ * The returned list is owned by the caller and must be deallocated
+ * with `freeSourceFileList()`.
  * `SourceFileList.ok` is `false` if an error occurred during scanning
  * in which case `files` is `NULL`. Otherwise, in case of a successful
  * scan, `SourceFileList.ok` is set to `true` to indicate success.
@@ -169,6 +223,70 @@ void freeSourceFile(RcnSourceFile* file);
  */
 SourceFileList newSourceFileList(const char* path);
 
+/**
+ * Creates a new list of all regular files under the given path by
+ * traversing the directory tree with the specified number of threads.
+ *
+ * Each thread scans directories from its own stack of directories and
+ * steals directories from the stacks of other threads when its own stack
+ * is empty. All threads collect the found files in their own list. The lists
+ * are merged and sorted at the end, whereby the files and their paths are
+ * packed into a single allocation. Thus, the returned list is the same as
+ * the one returned by `newSourceFileList()` for the same path. A thread count
+ * of zero or one performs the traversal on the calling thread.
+ */
+SourceFileList newSourceFileListConcurrently(
+    const char* path,
+    size_t numThreads
+);
+
+/**
+ * Function pointer type for consumers of the source files that are found
+ * by `streamSourceFiles()`. Ownership of the passed file is transferred to
+ * the consumer, which must copy the struct if it needs to retain it.
+ * The path of a passed file is always individually owned by the file.
+ * Returns `false` to abort the scan.
+ */
+typedef bool (*SourceFileConsumer)(RcnSourceFile* file, void* arg);
+
+/**
+ * Scans for all regular files under the given path and passes them to the
+ * specified consumer as soon as they are found.
+ *
+ * The specified path must denote an existing directory. Finds the same set of
+ * files as `newSourceFileList()`, but passes them in an unspecified order,
+ * one by one, while the scan is still in progress. The directory tree is
+ * traversed with the specified number of threads, as described for
+ * `newSourceFileListConcurrently()`. Calls to the consumer are serialized,
+ * but may be made from any of the scanning threads. The specified `arg` is
+ * passed to the consumer unaltered. Returns `false` if an error occurred or
+ * if the consumer has aborted the scan, otherwise returns `true`.
+ */
+bool streamSourceFiles(
+    const char* path,
+    size_t numThreads,
+    SourceFileConsumer consumer,
+    void* arg
+);
+
+/**
+ * Comparator for `qsort()` that defines the order of source files in
+ * a `SourceFileList`. Files are sorted lexicographically by file name
+ * and files with equal names are sorted by their full path.
+ * Both arguments must point to a `RcnSourceFile`.
+ */
+int compareSourceFileByName(const void* arg1, const void* arg2);
+
+/**
+ * Sorts the given array of items in the order defined by
+ * `compareSourceFileByName()`.
+ * 
+ * Each item has the specified size in bytes and must start with
+ * a `RcnSourceFile`. Files are radix sorted by a prefix of their name
+ * and only files with equal prefixes are compared with each other.
+ */
+void sortSourceFiles(void* items, size_t size, size_t itemSize);
+
 /**
  * Frees the allocated memory for the given list of source files,
  * including all source file content.
@@ -178,7 +296,9 @@ void freeSourceFileList(SourceFileList* list);
 /**
  * Performs lightweight text format detection for a file.
  *
- * Detection currently relies solely on the file extension.
+ * Detection currently relies solely on the file extension. If the format
+ * has already been detected when the file was created, then the stored
+ * format of the file is returned without detecting it again.
  */
 SourceFormatDetection detectSourceFormat(const RcnSourceFile* file);
 
@@ -194,14 +314,146 @@ SourceFormatDetection detectSourceFormat(const RcnSourceFile* file);
  */
 bool readSourceFileContent(RcnSourceFile* file);
 
+/**
+ * A reusable buffer for reading the content of source files.
+ *
+ * The memory of the buffer is lent to the file whose content is read into
+ * it and is returned with `releaseSourceFileContent()`, so that the next
+ * file can be read without allocating memory again. If the memory is not
+ * returned, e.g. because the content is kept, then the file owns it and the
+ * buffer allocates new memory for the next file. The buffer only retains
+ * memory up to a limited capacity. Larger contents are read into memory of
+ * their own. A zero-initialized buffer is empty and ready to be used. The
+ * memory of a buffer must be released with `freeReadBuffer()`.
+ */
+typedef struct ReadBuffer {
+    char* data;
+    size_t capacity;
+    bool isLent;
+} ReadBuffer;
+
+/**
+ * Frees the memory held by the given buffer, unless it is lent to a file.
+ * The buffer itself is not freed but is empty afterwards and can be
+ * used again.
+ */
+void freeReadBuffer(ReadBuffer* buffer);
+
+/**
+ * Loads the entire file content into memory of the given read buffer.
+ *
+ * Behaves like `readSourceFileContent()`, except that the content is read
+ * into the memory of the specified buffer if it fits. The content must then
+ * be released with `releaseSourceFileContent()` to be able to reuse the
+ * buffer for the next file. If `buffer` is `NULL`, then this function
+ * behaves exactly like `readSourceFileContent()`.
+ * Returns `true` on success, `false` on failure.
+ */
+bool readSourceFileContentBuffered(RcnSourceFile* file, ReadBuffer* buffer);
+
+/**
+ * Function pointer type for consumers of the chunks of file content that are
+ * read by `readSourceFileChunks()`. The passed chunk is only valid for the
+ * duration of the call. Returns `false` to abort the read operation.
+ */
+typedef bool (*SourceTextConsumer)(RcnSourceText chunk, void* arg);
+
+/**
+ * Reads the file content in consecutive chunks of the specified size and
+ * passes each chunk to the specified consumer. Only the last chunk can be
+ * smaller. If the specified size is zero, a default size is used.
+ *
+ * Only a single chunk is held in memory at any time, so that files of any
+ * size can be read, including files that are too large to be loaded with
+ * `readSourceFileContent()`. Therefore, `file->status` must either be
+ * `RCN_FILE_OP_OK` or `RCN_FILE_OP_FILE_TOO_LARGE` before calling this
+ * function. The file content is not retained and `file->isContentRead`
+ * remains unchanged. Sets `file->status` to indicate potential errors, or
+ * to `RCN_FILE_OP_OK` if the entire content was read. The specified `arg` is
+ * passed to the consumer unaltered. Returns `true` on success, `false` on
+ * failure or if the consumer has aborted the read operation.
+ */
+bool readSourceFileChunks(
+    RcnSourceFile* file,
+    size_t chunkSize,
+    SourceTextConsumer consumer,
+    void* arg
+);
+
+/**
+ * Reads the first bytes of the file content into the given buffer.
+ *
+ * At most `capacity` bytes are read and their number is written to `size`.
+ * The read bytes are not null-terminated. The file content is not retained
+ * and `file->isContentRead` remains unchanged, so this can be used to
+ * inspect the start of a file before its entire content is loaded. As with
+ * `readSourceFileChunks()`, `file->status` must either be `RCN_FILE_OP_OK`
+ * or `RCN_FILE_OP_FILE_TOO_LARGE` before calling this function. Sets
+ * `file->status` to indicate potential errors, otherwise it is unchanged.
+ * Returns `true` on success, `false` on failure.
+ */
+bool readSourceFileHead(
+    RcnSourceFile* file,
+    char* buffer,
+    size_t capacity,
+    size_t* size
+);
+
+/**
+ * Loads the entire file content into memory by mapping the file.
+ *
+ * Behaves like `readSourceFileContent()`, except that the content may be
+ * a read-only memory mapping of the file, in which case
+ * `file->isContentMapped` is set to `true`. The mapping is advised to be
+ * read sequentially. Files that cannot be mapped in a way that guarantees
+ * a null-terminated content, files smaller than a memory page, and all
+ * files on platforms without support for memory mappings are read
+ * with `readSourceFileContentBuffered()` and the specified buffer instead,
+ * which may be `NULL`.
+ * Returns `true` on success, `false` on failure.
+ */
+bool readSourceFileContentMapped(RcnSourceFile* file, ReadBuffer* buffer);
+
+/**
+ * Advises the underlying platform that the content of the file with the
+ * given path will be read soon.
+ *
+ * The platform may start to load the file content in the background, so that
+ * a subsequent call to `readSourceFileContent()` has to wait less for I/O.
+ * Does nothing if the platform does not support such advice. Errors are
+ * ignored. Only the path is used, so that the advice can be given while
+ * another thread processes the source file with that path.
+ */
+void adviseFileRead(const char* path);
+
+/**
+ * Returns the size in bytes of the file with the given path, or zero if
+ * the size cannot be determined.
+ *
+ * Is used to obtain the size of source files whose size was not seen by the
+ * directory scan that has found them. Symbolic links are followed.
+ */
+size_t probeFileSize(const char* path);
+
 /**
  * Releases any previously loaded file content.
  *
- * Resets `size` and `isContentRead`. Safe to call multiple times and
- * does nothing if no content is loaded.
+ * Unmaps the content if it is a memory mapping.
+ * Resets `size`, `isContentRead` and `isContentMapped`. Safe to call
+ * multiple times and does nothing if no content is loaded.
  */
 void freeSourceFileContent(RcnSourceFile* file);
 
+/**
+ * Releases any previously loaded file content and returns its memory to
+ * the given read buffer if it was lent from it.
+ *
+ * Behaves like `freeSourceFileContent()` for contents that were not read
+ * into the memory of the specified buffer. If `buffer` is `NULL`, then this
+ * function behaves exactly like `freeSourceFileContent()`.
+ */
+void releaseSourceFileContent(RcnSourceFile* file, ReadBuffer* buffer);
+
 #ifdef __cplusplus
 }
 #endif
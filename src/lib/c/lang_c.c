@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "tree_sitter/api.h"
@@ -25,65 +26,28 @@
 RECKON_NO_EXPORT const TSLanguage* tree_sitter_c(void);
 
 /**
- * These are the symbol identifiers as defined by the C language parser
- * of tree-sitter. We have only copied the symbol identifiers that we are
- * interested in evaluating or counting. Others do not contribute to the weight
- * of a node in the AST.
+ * The kinds of node rules that require a check of the context of a node
+ * in C source code. The weight of all other nodes is added unconditionally.
  */
-enum SymbolIdentifiersC {
-    sym_preproc_directive = 19,
-    sym_preproc_include = 164,
-    sym_preproc_def = 165,
-    sym_preproc_function_def = 166,
-    sym_preproc_if = 169,
-    sym_preproc_ifdef = 170,
-    sym_preproc_else = 171,
-    sym_preproc_elif = 172,
-    sym_preproc_elifdef = 173,
-    sym_function_definition = 196,
-    sym__old_style_function_definition = 197,
-    sym_declaration = 198,
-    sym_type_definition = 199,
-    sym__type_definition_type = 200,
-    sym__type_definition_declarators = 201,
-    sym__declaration_modifiers = 202,
-    sym__declaration_specifiers = 203,
-    sym_linkage_specification = 204,
-    sym_attribute_specifier = 205,
-    sym_attribute = 206,
-    sym_declaration_list = 213,
-    sym__declarator = 214,
-    sym__declaration_declarator = 215,
-    sym__type_declarator = 217,
-    sym__abstract_declarator = 218,
-    sym_attributed_declarator = 223,
-    sym_attributed_type_declarator = 225,
-    sym_type_specifier = 245,
-    sym_enum_specifier = 247,
-    sym_struct_specifier = 249,
-    sym_union_specifier = 250,
-    sym_field_declaration = 253,
-    sym_enumerator = 256,
-    sym_attributed_statement = 261,
-    sym_statement = 262,
-    sym__top_level_statement = 263,
-    sym_labeled_statement = 264,
-    sym__top_level_expression_statement = 265,
-    sym_expression_statement = 266,
-    sym_if_statement = 267,
-    sym_else_clause = 268,
-    sym_switch_statement = 269,
-    sym_case_statement = 270,
-    sym_while_statement = 271,
-    sym_do_statement = 272,
-    sym_for_statement = 273,
-    sym_return_statement = 275,
-    sym_break_statement = 276,
-    sym_continue_statement = 277,
-    sym_goto_statement = 278,
-    sym_expression = 283
+enum NodeRuleKindC {
+    RULE_C_FOR_STATEMENT = NODE_RULE_LANGUAGE,
+    RULE_C_DECLARATION,
+    RULE_C_TYPE_DEFINITION,
+    RULE_C_STRUCT_SPECIFIER,
+    RULE_C_ENUM_OR_UNION_SPECIFIER,
+    RULE_C_EXPRESSION_STATEMENT,
+    RULE_C_IF_STATEMENT,
+    RULE_C_ELSE_CLAUSE
 };
 
+// Defines NODE_RULES_C, the node rules of the C language indexed by
+// grammar symbol, which are generated at build time from lang_c.rules
+#include "node_rules_c.h"
+
+// Defines QUERY_SOURCE_C, the query of the C language for the evaluation
+// of logical lines, which is generated at build time from lang_c.scm
+#include "query_source_c.h"
+
 TSParser* createParserC(void) {
     TSParser* parser = ts_parser_new();
     if (parser) {
@@ -97,16 +61,35 @@ TSParser* createParserC(void) {
     return parser;
 }
 
+TSQuery* createQueryC(void) {
+    uint32_t errorOffset = 0;
+    TSQueryError error = TSQueryErrorNone;
+    return ts_query_new(
+        tree_sitter_c(),
+        QUERY_SOURCE_C,
+        (uint32_t) (sizeof(QUERY_SOURCE_C) - 1),
+        &errorOffset,
+        &error
+    );
+}
+
 static RcnCount evaluateNodeWeightCimpl(TSNode node, NodeEvalTrace* trace) {
-    RcnCount weight = 0;
-    TSSymbol sym = ts_node_grammar_symbol(node);
-    switch (sym) {
-        case sym_for_statement:
+    const TSSymbol sym = ts_node_grammar_symbol(node);
+    if (sym >= NODE_RULES_C_SIZE) {
+        return 0;
+    }
+    const NodeRule rule = NODE_RULES_C[sym];
+    switch (rule.kind) {
+        case NODE_RULE_PLAIN:
+            return rule.weight;
+        case NODE_RULE_PRUNE:
+            trace->skipChildren = true;
+            return rule.weight;
+        case RULE_C_FOR_STATEMENT:
             trace->idxLastForSym = trace->idx;
-            weight += 1;
-            break;
-        case sym_declaration:
-            trace->lnLastDecl = currentLine(node);
+            return rule.weight;
+        case RULE_C_DECLARATION:
+            trace->lnLastDecl = trace->line;
             // Check if the following is present:
             //   for_statement
             //   for
@@ -114,99 +97,46 @@ static RcnCount evaluateNodeWeightCimpl(TSNode node, NodeEvalTrace* trace) {
             //   declaration
             if (trace->idxLastForSym == (trace->idx - 3)) {
                 // Do not count variable declarations inside for-statement
-                break;
+                return 0;
             }
-            weight += 1;
-            break;
-        case sym_do_statement:
-            weight += 2;
-            break;
-        case sym_type_definition:
+            return rule.weight;
+        case RULE_C_TYPE_DEFINITION:
             trace->idxLastTypeDef = trace->idx;
-            weight += 1;
-            break;
-        case sym_struct_specifier:
+            return rule.weight;
+        case RULE_C_STRUCT_SPECIFIER:
             if (trace->idxLastTypeDef == (trace->idx - 2)) {
-                break;
+                return 0;
             }
-            if (trace->lnLastDecl == currentLine(node)) {
-                break;
+            if (trace->lnLastDecl == trace->line) {
+                return 0;
             }
-            if (trace->lnLastExpr == currentLine(node)) {
-                break;
+            if (trace->lnLastExpr == trace->line) {
+                return 0;
             }
-            weight += 1;
-            break;
-        case sym_enum_specifier:
-        case sym_union_specifier:
-            if (trace->lnLastDecl == currentLine(node)) {
-                break;
+            return rule.weight;
+        case RULE_C_ENUM_OR_UNION_SPECIFIER:
+            if (trace->lnLastDecl == trace->line) {
+                return 0;
             }
-            weight += 1;
-            break;
-        case sym__top_level_expression_statement:
-        case sym_expression_statement:
-            trace->lnLastExpr = currentLine(node);
-            weight += 1;
-            break;
-        case sym_if_statement:
+            return rule.weight;
+        case RULE_C_EXPRESSION_STATEMENT:
+            trace->lnLastExpr = trace->line;
+            return rule.weight;
+        case RULE_C_IF_STATEMENT:
             // else-if counts as one
             // Nodes are: else_clause -> else -> if_statement
             if (trace->idxLastElse == (trace->idx - 2)) {
-                break;
+                return 0;
             }
-            weight += 1;
-            break;
-        case sym_else_clause:
+            return rule.weight;
+        case RULE_C_ELSE_CLAUSE:
             trace->idxLastElse = trace->idx;
-            weight += 1;
-            break;
-        case sym_preproc_directive:
-        case sym_preproc_include:
-        case sym_preproc_def:
-        case sym_preproc_function_def:
-        case sym_preproc_if:
-        case sym_preproc_ifdef:
-        case sym_preproc_else:
-        case sym_preproc_elif:
-        case sym_preproc_elifdef:
-        case sym_function_definition:
-        case sym__old_style_function_definition:
-        case sym__type_definition_type:
-        case sym__type_definition_declarators:
-        case sym__declaration_modifiers:
-        case sym__declaration_specifiers:
-        case sym_linkage_specification:
-        case sym_attribute_specifier:
-        case sym_attribute:
-        case sym_declaration_list:
-        case sym__declarator:
-        case sym__declaration_declarator:
-        case sym__type_declarator:
-        case sym__abstract_declarator:
-        case sym_attributed_declarator:
-        case sym_attributed_type_declarator:
-        case sym_type_specifier:
-        case sym_field_declaration:
-        case sym_enumerator:
-        case sym_attributed_statement:
-        case sym_statement:
-        case sym__top_level_statement:
-        case sym_labeled_statement:
-        case sym_switch_statement:
-        case sym_case_statement:
-        case sym_while_statement:
-        case sym_return_statement:
-        case sym_break_statement:
-        case sym_continue_statement:
-        case sym_goto_statement:
-        case sym_expression:
-            weight += 1;
-            break;
+            return rule.weight;
+        // LCOV_EXCL_START
         default:
-            break;
+            return 0;
+        // LCOV_EXCL_STOP
     }
-    return weight;
 }
 
 void evaluateNodeC(TSNode node, NodeEvalTrace* trace) {
@@ -0,0 +1,80 @@
+; Copyright (C) 2026 Raven Computing
+;
+; Query of the C language for the evaluation of logical lines of code.
+;
+; Every node captured as @count adds one logical line, a node captured as
+; @count.<n> adds n logical lines and a node captured as @uncount removes
+; one logical line again, e.g. a node that is counted by one pattern but
+; does not count in the context matched by another pattern. A node captured
+; as @row.<name> marks the line it starts on. A node captured as
+; @count.unless.<name> adds one logical line, unless the last node marked
+; with that name before it starts on the same line. The patterns
+; correspond to the node rules in lang_c.rules. The query is embedded into
+; the library at build time and compiled when it is first used.
+
+[
+  (function_definition)
+  (declaration)
+  (type_definition)
+  (expression_statement)
+  (if_statement)
+  (else_clause)
+  (for_statement)
+  (preproc_directive)
+  (preproc_include)
+  (preproc_def)
+  (preproc_function_def)
+  (preproc_if)
+  (preproc_ifdef)
+  (preproc_else)
+  (preproc_elif)
+  (preproc_elifdef)
+  (linkage_specification)
+  (attribute_specifier)
+  (attribute)
+  (declaration_list)
+  (attributed_declarator)
+  (field_declaration)
+  (enumerator)
+  (attributed_statement)
+  (labeled_statement)
+  (switch_statement)
+  (case_statement)
+  (while_statement)
+  (return_statement)
+  (break_statement)
+  (continue_statement)
+  (goto_statement)
+] @count
+
+(do_statement) @count.2
+
+; Variable declarations inside a for statement
+(for_statement
+  initializer: (declaration) @uncount)
+
+; An else-if counts as one
+(else_clause
+  (if_statement) @uncount)
+
+; A type defined by a typedef
+(type_definition
+  .
+  type: (struct_specifier) @uncount)
+
+; Declarations and expression statements mark their line
+(declaration) @row.declaration
+
+[
+  (declaration)
+  (expression_statement)
+] @row.statement
+
+; A type specified on the line of a declaration, or of an expression
+; statement for structs
+(struct_specifier) @count.unless.statement
+
+[
+  (enum_specifier)
+  (union_specifier)
+] @count.unless.declaration
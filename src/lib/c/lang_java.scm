@@ -0,0 +1,96 @@
+; Copyright (C) 2026 Raven Computing
+;
+; Query of the Java language for the evaluation of logical lines of code.
+;
+; Every node captured as @count adds one logical line, a node captured as
+; @count.<n> adds n logical lines and a node captured as @uncount removes
+; one logical line again, e.g. a node that is counted by one pattern but
+; does not count in the context matched by another pattern. A node captured
+; as @row.<name> marks the line it starts on. A node captured as
+; @count.unless.<name>.<name> adds one logical line, unless the last nodes
+; marked with both names before it start on the same line. The patterns
+; correspond to the node rules in lang_java.rules. The query is embedded
+; into the library at build time and compiled when it is first used.
+
+[
+  "else"
+  "when"
+  "open"
+  "module"
+  "requires"
+  "transitive"
+  "exports"
+  "to"
+  "opens"
+  "uses"
+  "provides"
+  "with"
+  (switch_label)
+  (if_statement)
+  (local_variable_declaration)
+  (for_statement)
+  (switch_expression)
+  (pattern)
+  (type_pattern)
+  (record_pattern)
+  (record_pattern_body)
+  (record_pattern_component)
+  (guard)
+  (assert_statement)
+  (break_statement)
+  (continue_statement)
+  (return_statement)
+  (yield_statement)
+  (synchronized_statement)
+  (throw_statement)
+  (try_statement)
+  (catch_clause)
+  (finally_clause)
+  (try_with_resources_statement)
+  (while_statement)
+  (enhanced_for_statement)
+  (marker_annotation)
+  (annotation)
+  (module_declaration)
+  (requires_module_directive)
+  (requires_modifier)
+  (exports_module_directive)
+  (opens_module_directive)
+  (uses_module_directive)
+  (provides_module_directive)
+  (package_declaration)
+  (import_declaration)
+  (enum_declaration)
+  (enum_constant)
+  (class_declaration)
+  (permits)
+  (static_initializer)
+  (constructor_declaration)
+  (explicit_constructor_invocation)
+  (field_declaration)
+  (record_declaration)
+  (annotation_type_declaration)
+  (annotation_type_element_declaration)
+  (interface_declaration)
+  (constant_declaration)
+  (method_declaration)
+  (compact_constructor_declaration)
+] @count
+
+(do_statement) @count.2
+
+; Variable declarations inside a for statement
+(for_statement
+  init: (local_variable_declaration) @uncount)
+
+; An else-if counts as one
+(if_statement
+  alternative: (if_statement) @uncount)
+
+; Switch labels and arrows mark their line
+(switch_label) @row.label
+
+"->" @row.arrow
+
+; A statement on the line of a switch rule, which belongs to its label
+(expression_statement) @count.unless.label.arrow
@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2026 Raven Computing
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef __linux__
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "concurrency.h"
+
+struct Mutex {
+    pthread_mutex_t handle;
+};
+
+struct CondVar {
+    pthread_cond_t handle;
+};
+
+/**
+ * A task bound to its argument, as passed to a started thread.
+ */
+typedef struct BoundTask {
+    ConcurrentTask task;
+    void* arg;
+} BoundTask;
+
+static void* runBoundTask(void* arg) {
+    BoundTask* bound = (BoundTask*) arg;
+    bound->task(bound->arg);
+    return NULL;
+}
+
+size_t runConcurrently(
+    ConcurrentTask task,
+    void* args,
+    size_t argSize,
+    size_t count
+) {
+    if (count == 0) {
+        return 0;
+    }
+    char* const argBytes = (char*) args;
+    size_t started = 0;
+    pthread_t* threads = NULL;
+    BoundTask* bound = NULL;
+    if (count > 1) {
+        threads = malloc((count - 1) * sizeof(pthread_t));
+        bound = malloc((count - 1) * sizeof(BoundTask));
+    }
+    if (threads && bound) {
+        for (size_t i = 1; i < count; ++i) {
+            bound[started] = (BoundTask){
+                .task = task,
+                .arg = argBytes + (i * argSize)
+            };
+            const int status = pthread_create(
+                &threads[started],
+                NULL,
+                runBoundTask,
+                &bound[started]
+            );
+            if (status != 0) {
+                break; // LCOV_EXCL_LINE
+            }
+            ++started;
+        }
+    }
+    task(argBytes);
+    for (size_t i = 0; i < started; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+    free(bound);
+    return started + 1;
+}
+
+size_t atomicFetchAdd(size_t* value, size_t increment) {
+    return __atomic_fetch_add(value, increment, __ATOMIC_RELAXED);
+}
+
+size_t atomicLoad(const size_t* value) {
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+}
+
+void atomicStore(size_t* value, size_t desired) {
+    __atomic_store_n(value, desired, __ATOMIC_RELEASE);
+}
+
+void atomicStoreMin(size_t* value, size_t candidate) {
+    size_t current = __atomic_load_n(value, __ATOMIC_ACQUIRE);
+    while (candidate < current) {
+        const bool exchanged = __atomic_compare_exchange_n(
+            value,
+            &current,
+            candidate,
+            false,
+            __ATOMIC_ACQ_REL,
+            __ATOMIC_ACQUIRE
+        );
+        if (exchanged) {
+            break;
+        }
+    }
+}
+
+/**
+ * The states of a `OnceFlag`.
+ */
+enum OnceState {
+    ONCE_NOT_CALLED = 0,
+    ONCE_CALLING = 1,
+    ONCE_CALLED = 2
+};
+
+void callOnce(OnceFlag* flag, OnceFunction function) {
+    if (__atomic_load_n(flag, __ATOMIC_ACQUIRE) == ONCE_CALLED) {
+        return;
+    }
+    size_t expected = ONCE_NOT_CALLED;
+    const bool isCaller = __atomic_compare_exchange_n(
+        flag,
+        &expected,
+        ONCE_CALLING,
+        false,
+        __ATOMIC_ACQUIRE,
+        __ATOMIC_ACQUIRE
+    );
+    if (isCaller) {
+        function();
+        __atomic_store_n(flag, ONCE_CALLED, __ATOMIC_RELEASE);
+        return;
+    }
+    // The function only runs once, so waiting for it is rare and short
+    while (__atomic_load_n(flag, __ATOMIC_ACQUIRE) != ONCE_CALLED) {
+        sched_yield();
+    }
+}
+
+Mutex* newMutex(void) {
+    Mutex* mutex = malloc(sizeof(Mutex));
+    if (!mutex) {
+        return NULL;
+    }
+    if (pthread_mutex_init(&mutex->handle, NULL) != 0) {
+        free(mutex); // LCOV_EXCL_LINE
+        return NULL; // LCOV_EXCL_LINE
+    }
+    return mutex;
+}
+
+void freeMutex(Mutex* mutex) {
+    if (mutex) {
+        pthread_mutex_destroy(&mutex->handle);
+        free(mutex);
+    }
+}
+
+void lockMutex(Mutex* mutex) {
+    pthread_mutex_lock(&mutex->handle);
+}
+
+void unlockMutex(Mutex* mutex) {
+    pthread_mutex_unlock(&mutex->handle);
+}
+
+CondVar* newCondVar(void) {
+    CondVar* condVar = malloc(sizeof(CondVar));
+    if (!condVar) {
+        return NULL;
+    }
+    if (pthread_cond_init(&condVar->handle, NULL) != 0) {
+        free(condVar); // LCOV_EXCL_LINE
+        return NULL; // LCOV_EXCL_LINE
+    }
+    return condVar;
+}
+
+void freeCondVar(CondVar* condVar) {
+    if (condVar) {
+        pthread_cond_destroy(&condVar->handle);
+        free(condVar);
+    }
+}
+
+void waitCondVar(CondVar* condVar, Mutex* mutex) {
+    pthread_cond_wait(&condVar->handle, &mutex->handle);
+}
+
+void signalCondVar(CondVar* condVar) {
+    pthread_cond_signal(&condVar->handle);
+}
+
+void broadcastCondVar(CondVar* condVar) {
+    pthread_cond_broadcast(&condVar->handle);
+}
+
+uint64_t monotonicTimeMicros(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t) ts.tv_sec * 1000000) + ((uint64_t) ts.tv_nsec / 1000);
+}
+
+#endif // __linux__
@@ -20,44 +20,117 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 #include <errno.h>
 #include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <assert.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 
 #include "reckon/reckon.h"
 #include "fileio.h"
 
 /**
- * Constructs the full file path for a given directory entry,
- * i.e. a child in the `base` directory.
+ * The size in bytes of the buffer for reading directory entries. A large
+ * buffer reads the entries of large directories with only a few system calls.
  */
-static char* fullFilePath(BaseDir* base , struct dirent* file) {
-    const size_t nameLength = strlen(file->d_name);
+static const size_t DIR_ENTRIES_BUFFER_SIZE = 256UL * 1024UL;
+
+/**
+ * A directory entry as returned by the `getdents64` system call.
+ */
+typedef struct LinuxDirEntry {
+    uint64_t inode;
+    int64_t offset;
+    unsigned short length;
+    unsigned char type;
+    char name[];
+} LinuxDirEntry;
+
+/**
+ * Constructs the full file path for a given directory entry name,
+ * i.e. a child in the `base` directory, in the specified arena.
+ */
+static char* fullFilePath(
+    BaseDir* base,
+    const char* name,
+    PathArena* arena
+) {
+    const size_t nameLength = strlen(name);
+    const size_t separatorLength = base->hasTrailingSeparator ? 0 : 1;
     const size_t fullLength = (
         base->length
-        + (base->hasTrailingSeparator ? 0 : 1)
+        + separatorLength
         + nameLength
         + 1 // null-terminator
     );
-    char* fullPath = malloc(fullLength);
+    char* fullPath = allocArenaPath(arena, fullLength);
     if (fullPath) {
-        int status = snprintf(
-            fullPath,
-            fullLength,
-            base->hasTrailingSeparator ? "%s%s" : "%s/%s",
-            base->path,
-            file->d_name
-        );
-        if (status < 0) {
-            free(fullPath); // LCOV_EXCL_LINE
-            return NULL; // LCOV_EXCL_LINE
+        memcpy(fullPath, base->path, base->length);
+        if (separatorLength > 0) {
+            fullPath[base->length] = '/';
         }
+        memcpy(fullPath + base->length + separatorLength, name, nameLength);
+        fullPath[fullLength - 1] = '\0';
     }
     return fullPath;
 }
 
+/**
+ * Adds a single entry of the scanned directory with the given descriptor to
+ * either the list of files or the stack of directories. The file type reported
+ * by the directory entry is trusted, so that no status of the entry has to be
+ * queried, unless the file system does not report types in directory entries.
+ */
+static void scanDirectoryEntry(
+    int dirDescriptor,
+    BaseDir* base,
+    const LinuxDirEntry* entry,
+    DirStack* stack,
+    SourceFileList* list,
+    ScanBuffer* buffer
+) {
+    if (entry->name[0] == '.') {
+        return; // Skip '.', '..' and hidden files, etc.
+    }
+    bool entryIsDirectory = (entry->type == DT_DIR);
+    bool entryIsRegularFile = (entry->type == DT_REG);
+    size_t size = 0;
+    if (entry->type == DT_UNKNOWN) {
+        struct stat attr;
+        const int status = fstatat(
+            dirDescriptor,
+            entry->name,
+            &attr,
+            AT_SYMLINK_NOFOLLOW
+        );
+        if (status == 0) {
+            entryIsDirectory = S_ISDIR(attr.st_mode);
+            entryIsRegularFile = S_ISREG(attr.st_mode);
+            size = (attr.st_size > 0) ? (size_t) attr.st_size : 0;
+        }
+    }
+    if (!entryIsDirectory && !entryIsRegularFile) {
+        return; // Symbolic links and other file types are ignored
+    }
+    PathArena* arena = (
+        entryIsRegularFile ? &buffer->filePaths : &buffer->dirPaths
+    );
+    char* fullPath = fullFilePath(base, entry->name, arena);
+    if (!fullPath) {
+        return;
+    }
+    if (entryIsRegularFile) {
+        appendFile(list, fullPath, size);
+        return;
+    }
+    dirStackPush(stack, fullPath);
+}
+
 char* findFilenameImpl(const char* path) {
     char* slash = strrchr(path, '/');
     return slash ? slash : (char*) path;
@@ -67,9 +140,24 @@ bool hasTrailingSeparatorImpl(const char* path, size_t length) {
     return (length > 0 && path[length - 1] == '/');
 }
 
-void scanDirectory(char* dirPath, DirStack* stack, SourceFileList* list) {
-    DIR* directory = opendir(dirPath);
-    if (!directory) {
+void scanDirectory(
+    char* dirPath,
+    DirStack* stack,
+    SourceFileList* list,
+    ScanBuffer* buffer
+) {
+    if (!buffer->data) {
+        buffer->data = malloc(DIR_ENTRIES_BUFFER_SIZE);
+        if (!buffer->data) {
+            return; // LCOV_EXCL_LINE
+        }
+        buffer->size = DIR_ENTRIES_BUFFER_SIZE;
+    }
+    const int descriptor = open(
+        dirPath,
+        O_RDONLY | O_DIRECTORY | O_CLOEXEC
+    );
+    if (descriptor < 0) {
         return;
     }
     const size_t pathLength = strlen(dirPath);
@@ -78,34 +166,35 @@ void scanDirectory(char* dirPath, DirStack* stack, SourceFileList* list) {
         .length = pathLength,
         .hasTrailingSeparator = hasTrailingSeparatorImpl(dirPath, pathLength)
     };
-    struct dirent* entry = NULL;
-    while ((entry = readdir(directory)) != NULL) {
-        if (entry->d_name[0] == '.') {
-            continue; // Skip '.', '..' and hidden files, etc.
-        }
-        char* fullPath = fullFilePath(&base, entry);
-        if (!fullPath) {
-            continue;
-        }
-        bool entryIsDirectory = false;
-        bool entryIsRegularFile = false;
-        struct stat attr;
-        if (lstat(fullPath, &attr) == 0) {
-            if (!S_ISLNK(attr.st_mode)) {
-                entryIsDirectory = S_ISDIR(attr.st_mode);
-                entryIsRegularFile = S_ISREG(attr.st_mode);
-            }
-        }
-        if (entryIsRegularFile) {
-            appendFile(list, fullPath);
-        }
-        if (entryIsDirectory) {
-            dirStackPush(stack, fullPath);
-            continue;
+    long length = 0;
+    while ((length = syscall(SYS_getdents64, descriptor, buffer->data,
+                             buffer->size)) > 0) {
+
+        long offset = 0;
+        while (offset < length) {
+            const LinuxDirEntry* entry = (const LinuxDirEntry*) (
+                buffer->data + offset
+            );
+            scanDirectoryEntry(
+                descriptor,
+                &base,
+                entry,
+                stack,
+                list,
+                buffer
+            );
+            offset += entry->length;
         }
-        free(fullPath);
     }
-    closedir(directory);
+    close(descriptor);
+}
+
+size_t probeFileSize(const char* path) {
+    struct stat attr;
+    if (!path || stat(path, &attr) != 0 || attr.st_size < 0) {
+        return 0;
+    }
+    return (size_t) attr.st_size;
 }
 
 bool isDirectory(const char* path) {
@@ -148,4 +237,73 @@ const char* isValidStatsInput(const char* path) {
     return "Is not a regular file or directory"; // LCOV_EXCL_LINE
 }
 
+bool mapFileContentImpl(RcnSourceFile* file, size_t maxSize) {
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    if (pageSize <= 0) {
+        return false; // LCOV_EXCL_LINE
+    }
+    const int descriptor = open(file->path, O_RDONLY | O_CLOEXEC);
+    if (descriptor < 0) {
+        return false;
+    }
+    struct stat attr;
+    if (fstat(descriptor, &attr) != 0 || !S_ISREG(attr.st_mode)) {
+        close(descriptor); // LCOV_EXCL_LINE
+        return false; // LCOV_EXCL_LINE
+    }
+    const size_t size = (attr.st_size > 0) ? (size_t) attr.st_size : 0;
+    // The remainder of the last page of a mapping is filled with zeros,
+    // which terminates the content. Files that fill their last page
+    // completely would not be null-terminated
+    const bool isMappable = (
+        size >= (size_t) pageSize
+        && size <= maxSize
+        && size % (size_t) pageSize != 0
+    );
+    if (!isMappable) {
+        close(descriptor);
+        return false;
+    }
+    void* mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (mapping == MAP_FAILED) {
+        return false; // LCOV_EXCL_LINE
+    }
+    (void) madvise(mapping, size, MADV_SEQUENTIAL);
+    file->content = (RcnSourceText){
+        .text = (char*) mapping,
+        .size = size
+    };
+    file->isContentRead = true;
+    file->isContentMapped = true;
+    return true;
+}
+
+void unmapFileContentImpl(RcnSourceText content) {
+    munmap((void*) content.text, content.size);
+}
+
+bool getFileSizeImpl(FILE* handle, size_t* size) {
+    struct stat attr;
+    if (fstat(fileno(handle), &attr) != 0 || !S_ISREG(attr.st_mode)) {
+        return false;
+    }
+    *size = (attr.st_size > 0) ? (size_t) attr.st_size : 0;
+    return true;
+}
+
+void adviseFileRead(const char* path) {
+    if (!path) {
+        return;
+    }
+    const int descriptor = open(path, O_RDONLY | O_CLOEXEC);
+    if (descriptor < 0) {
+        return;
+    }
+    // The kernel starts reading the content into the page cache, which
+    // outlives the file descriptor
+    (void) posix_fadvise(descriptor, 0, 0, POSIX_FADV_WILLNEED);
+    close(descriptor);
+}
+
 #endif // __linux__
@@ -20,9 +20,11 @@
 #include "evaluation.h"
 #include "fileio.h"
 
-RcnCountResult rcnCountLogicalLines(
+RcnCountResult evaluateLogicalLines(
     RcnTextFormat language,
-    RcnSourceText sourceCode
+    RcnSourceText sourceCode,
+    TextEncoding encoding,
+    ParserCache* cache
 ) {
     RcnCountResult result = {0};
     if (!sourceCode.text) {
@@ -43,14 +45,31 @@ RcnCountResult rcnCountLogicalLines(
     }
     RcnResultState evalState = evaluateSourceTree(
         sourceCode,
+        encoding,
         language,
         evaluator,
-        &trace
+        &trace,
+        cache
     );
     result.state = evalState;
     return result;
 }
 
+RcnCountResult rcnCountLogicalLines(
+    RcnTextFormat language,
+    RcnSourceText sourceCode
+) {
+    ParserCache cache = {0};
+    RcnCountResult result = evaluateLogicalLines(
+        language,
+        sourceCode,
+        detectEncoding(sourceCode),
+        &cache
+    );
+    freeParserCache(&cache);
+    return result;
+}
+
 RcnSourceText rcnMarkLogicalLinesInFile(const char* path) {
     RcnSourceFile* file = newSourceFile(path);
     if (!file) {
@@ -69,22 +88,14 @@ RcnSourceText rcnMarkLogicalLinesInFile(const char* path) {
     return annotated;
 }
 
-RcnSourceText rcnMarkLogicalLinesInSourceText(
+/**
+ * Annotates the given UTF-8 encoded source code without a BOM.
+ */
+static RcnSourceText markLogicalLinesInUTF8(
     RcnTextFormat language,
     RcnSourceText sourceCode
 ) {
     RcnSourceText resultText = {0};
-    if (!sourceCode.text) {
-        return resultText;
-    }
-    TextEncoding encoding = detectEncoding(sourceCode);
-    if (encoding != TextEncodingUTF8) {
-        return resultText;
-    }
-    if (hasUTF8BOM(sourceCode)) {
-        sourceCode.text += 3;
-        sourceCode.size -= 3;
-    }
     RcnCountResult lineCount = rcnCountPhysicalLines(sourceCode);
     if (!lineCount.state.ok) {
         return resultText;
@@ -102,15 +113,45 @@ RcnSourceText rcnMarkLogicalLinesInSourceText(
     NodeEvalTrace trace = {0};
     trace.result = &result;
     trace.ctx = ctx;
+    ParserCache cache = {0};
     RcnResultState evalState = evaluateSourceTree(
         sourceCode,
+        TextEncodingUTF8,
         language,
         annotateLineWithNodeType,
-        &trace
+        &trace,
+        &cache
     );
+    freeParserCache(&cache);
     if (evalState.ok) {
         resultText = buildAnnotatedSource(sourceCode.text, &trace);
     }
     freeNodeEvalContextAnnotation(ctx);
     return resultText;
 }
+
+RcnSourceText rcnMarkLogicalLinesInSourceText(
+    RcnTextFormat language,
+    RcnSourceText sourceCode
+) {
+    if (!sourceCode.text) {
+        return (RcnSourceText){0};
+    }
+    const TextEncoding encoding = detectEncoding(sourceCode);
+    if (encoding != TextEncodingUTF8) {
+        // Annotations are only built for UTF-8, to which UTF-16 is transcoded
+        TextBuffer buffer = {0};
+        RcnSourceText transcoded = {0};
+        RcnSourceText resultText = {0};
+        if (transcodeToUTF8(sourceCode, encoding, &buffer, &transcoded)) {
+            resultText = markLogicalLinesInUTF8(language, transcoded);
+        }
+        freeTextBuffer(&buffer);
+        return resultText;
+    }
+    if (hasUTF8BOM(sourceCode)) {
+        sourceCode.text += 3;
+        sourceCode.size -= 3;
+    }
+    return markLogicalLinesInUTF8(language, sourceCode);
+}
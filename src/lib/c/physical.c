@@ -20,8 +20,70 @@
 
 #include "reckon/reckon.h"
 #include "evaluation.h"
+#include "simd.h"
 
-RcnCountResult rcnCountPhysicalLines(RcnSourceText source) {
+/**
+ * Size of the UTF-16 BOM, which is skipped when counting line breaks.
+ */
+static const size_t UTF16_BOM_SIZE = 2;
+
+size_t countLineBreaksInChunk(
+    ChunkedCount* counter,
+    const char* chunk,
+    size_t size,
+    bool isFinal
+) {
+    size_t offset = (counter->skip < size) ? counter->skip : size;
+    counter->skip -= offset;
+    if (counter->encoding == TextEncodingUTF8) {
+        counter->count += countByte(chunk + offset, size - offset, '\n');
+        return size;
+    }
+    // UTF-16
+    const bool isLittleEndian = (counter->encoding == TextEncodingUTF16LE);
+    const char nlByte0 = isLittleEndian ? 0x0a : 0x00;
+    const char nlByte1 = isLittleEndian ? 0x00 : 0x0a;
+    const size_t numUnits = (size - offset) / 2;
+    counter->count += countCodeUnit(
+        chunk + offset,
+        numUnits,
+        nlByte0,
+        nlByte1
+    );
+    offset += 2 * numUnits;
+    // A trailing single byte is only ignored at the end of the text
+    return isFinal ? size : offset;
+}
+
+ChunkedCount initLineBreakCount(RcnSourceText start, TextEncoding encoding) {
+    return (ChunkedCount){
+        .encoding = encoding,
+        .skip = (encoding == TextEncodingUTF8) ? 0 : UTF16_BOM_SIZE
+    };
+}
+
+bool endsWithUnterminatedLine(
+    TextEncoding encoding,
+    const char last[2],
+    RcnCount size
+) {
+    if (encoding == TextEncodingUTF8) {
+        return (size > 0) && (last[1] != '\n');
+    }
+    // UTF-16
+    const bool isLittleEndian = (encoding == TextEncodingUTF16LE);
+    const char nlByte0 = isLittleEndian ? 0x0a : 0x00;
+    const char nlByte1 = isLittleEndian ? 0x00 : 0x0a;
+    return (
+        (size > UTF16_BOM_SIZE)
+        && (last[0] != nlByte0 || last[1] != nlByte1)
+    );
+}
+
+RcnCountResult countPhysicalLinesInText(
+    RcnSourceText source,
+    TextEncoding encoding
+) {
     RcnCountResult result = {0};
     if (source.size == 0) {
         result.state.ok = true;
@@ -39,39 +101,25 @@ RcnCountResult rcnCountPhysicalLines(RcnSourceText source) {
         return result;
     }
 
-    TextEncoding encoding = detectEncoding(source);
-    const char* content  = source.text;
-
-    if (encoding == TextEncodingUTF8) {
-        for (size_t i = 0; i < source.size; ++i) {
-            if (content[i] == '\n') {
-                result.count++;
-            }
-        }
-        // Account for last line if not ending with newline
-        if (content[source.size - 1] != '\n') {
-            result.count++;
-        }
-    } else { // UTF-16
-        const bool isLittleEndian = (encoding == TextEncodingUTF16LE);
-        const char nlByte0 = isLittleEndian ? 0x0a : 0x00;
-        const char nlByte1 = isLittleEndian ? 0x00 : 0x0a;
-        for (size_t i = 2; i < source.size - 1; i+=2) {
-            if (content[i] == nlByte0 && content[i + 1] == nlByte1) {
-                result.count++;
-            }
-        }
-        // Account for last line if not ending with newline
-        if ((source.size > 2)
-            && (content[source.size - 2] != nlByte0
-                || content[source.size - 1] != nlByte1)) {
-
-            result.count++;
-        }
+    ChunkedCount counter = initLineBreakCount(source, encoding);
+    countLineBreaksInChunk(&counter, source.text, source.size, true);
+    const size_t size = source.size;
+    const char last[2] = {
+        (size > 1) ? source.text[size - 2] : '\0',
+        source.text[size - 1]
+    };
+    // Account for last line if not ending with newline
+    if (endsWithUnterminatedLine(counter.encoding, last, size)) {
+        counter.count++;
     }
+    result.count = counter.count;
 
     result.state.ok = true;
     result.state.errorCode = RCN_ERR_NONE;
 
     return result;
 }
+
+RcnCountResult rcnCountPhysicalLines(RcnSourceText source) {
+    return countPhysicalLinesInText(source, detectEncoding(source));
+}
@@ -0,0 +1,415 @@
+/*
+ * Copyright (C) 2026 Raven Computing
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "tree_sitter/api.h"
+
+#include "reckon/reckon.h"
+#include "evaluation.h"
+#include "concurrency.h"
+
+/**
+ * The capture name of nodes that add one logical line.
+ */
+static const char CAPTURE_COUNT[] = "count";
+
+/**
+ * The prefix of capture names of nodes that add the number of logical lines
+ * specified after the prefix.
+ */
+static const char CAPTURE_COUNT_PREFIX[] = "count.";
+
+/**
+ * The capture name of nodes that remove one logical line.
+ */
+static const char CAPTURE_UNCOUNT[] = "uncount";
+
+/**
+ * The prefix of capture names of nodes that mark the line they start on with
+ * the name specified after the prefix. Such nodes add no logical lines.
+ */
+static const char CAPTURE_ROW_PREFIX[] = "row.";
+
+/**
+ * The prefix of capture names of nodes that add one logical line, unless
+ * the last nodes marked with all of the dot-separated names specified after
+ * the prefix start on the same line, before the node itself.
+ */
+static const char CAPTURE_COUNT_UNLESS_PREFIX[] = "count.unless.";
+
+/**
+ * The maximum number of distinct names of line marks in a query.
+ */
+#define MAX_ROW_MARKS 32
+
+/**
+ * How a capture of a query contributes to the logical lines. The line marks
+ * are bit sets with one bit for each distinct name of a line mark.
+ */
+typedef struct CaptureRule {
+    int32_t weight;
+    uint32_t marks;  // The line marks set by the captured node
+    uint32_t unless; // The line marks that cancel the captured node
+} CaptureRule;
+
+/**
+ * A compiled query of a language together with the contribution of each
+ * capture of the query to the logical lines, indexed by capture ID.
+ */
+typedef struct LogicalLinesQuery {
+    TSQuery* query;
+    CaptureRule* captureRules;
+} LogicalLinesQuery;
+
+/**
+ * A captured node that either sets line marks or is cancelled by them.
+ */
+typedef struct RowMark {
+    uint32_t startByte;
+    uint32_t row;
+    uint32_t marks;
+    uint32_t unless;
+} RowMark;
+
+/**
+ * A growable list of the captured nodes that set or depend on line marks.
+ */
+typedef struct RowMarkList {
+    RowMark* marks;
+    size_t size;
+    size_t capacity;
+} RowMarkList;
+
+/**
+ * The compiled queries of all supported languages, indexed by text format.
+ * The queries are immutable once compiled and are therefore shared by all
+ * threads. They are never freed and remain valid until the process exits.
+ */
+static LogicalLinesQuery compiledQueries[RECKON_NUM_SUPPORTED_FORMATS];
+
+static OnceFlag compiledQueriesFlag;
+
+static bool hasPrefix(
+    const char* name,
+    uint32_t length,
+    const char* prefix,
+    size_t prefixLength
+) {
+    return (length > prefixLength)
+        && (strncmp(name, prefix, prefixLength) == 0);
+}
+
+static int32_t captureWeight(const char* name, uint32_t length) {
+    const size_t prefixLength = sizeof(CAPTURE_COUNT_PREFIX) - 1;
+    if ((length == (sizeof(CAPTURE_COUNT) - 1))
+     && (strncmp(name, CAPTURE_COUNT, length) == 0)) {
+        return 1;
+    }
+    if ((length == (sizeof(CAPTURE_UNCOUNT) - 1))
+     && (strncmp(name, CAPTURE_UNCOUNT, length) == 0)) {
+        return -1;
+    }
+    if (hasPrefix(name, length, CAPTURE_COUNT_PREFIX, prefixLength)) {
+        int32_t weight = 0;
+        for (uint32_t i = prefixLength; i < length; ++i) {
+            if (name[i] < '0' || name[i] > '9') {
+                return 0;
+            }
+            weight = (weight * 10) + (name[i] - '0'); // NOLINT
+        }
+        return weight;
+    }
+    // Other captures are only used within patterns
+    return 0;
+}
+
+/**
+ * Returns the bit of the line mark with the specified name in the given
+ * query, or zero if the query has no such line mark. The bits are assigned
+ * in the order of the capture IDs.
+ */
+static uint32_t rowMarkBit(TSQuery* query, const char* mark, uint32_t length) {
+    const size_t prefixLength = sizeof(CAPTURE_ROW_PREFIX) - 1;
+    const uint32_t numCaptures = ts_query_capture_count(query);
+    uint32_t numMarks = 0;
+    for (uint32_t i = 0; i < numCaptures && numMarks < MAX_ROW_MARKS; ++i) {
+        uint32_t nameLength = 0;
+        const char* name = ts_query_capture_name_for_id(query, i, &nameLength);
+        if (!hasPrefix(name, nameLength, CAPTURE_ROW_PREFIX, prefixLength)) {
+            continue;
+        }
+        const bool isMatch = (
+            (nameLength - prefixLength == length)
+            && (strncmp(name + prefixLength, mark, length) == 0)
+        );
+        if (isMatch) {
+            return UINT32_C(1) << numMarks;
+        }
+        ++numMarks;
+    }
+    return 0;
+}
+
+/**
+ * Returns the line marks of all dot-separated names of the specified
+ * length in the given query. Returns false if the query lacks any of them.
+ */
+static bool rowMarkBits(
+    TSQuery* query,
+    const char* names,
+    uint32_t length,
+    uint32_t* bits
+) {
+    *bits = 0;
+    uint32_t start = 0;
+    for (uint32_t i = 0; i <= length; ++i) {
+        if (i < length && names[i] != '.') {
+            continue;
+        }
+        const uint32_t bit = rowMarkBit(query, names + start, i - start);
+        if (!bit) {
+            return false;
+        }
+        *bits |= bit;
+        start = i + 1;
+    }
+    return true;
+}
+
+/**
+ * Determines the contribution of the capture with the specified name in the
+ * given query. Returns false if the capture refers to unknown line marks.
+ */
+static bool captureRule(
+    TSQuery* query,
+    const char* name,
+    uint32_t length,
+    CaptureRule* rule
+) {
+    const size_t rowLength = sizeof(CAPTURE_ROW_PREFIX) - 1;
+    const size_t unlessLength = sizeof(CAPTURE_COUNT_UNLESS_PREFIX) - 1;
+    *rule = (CaptureRule){0};
+    if (hasPrefix(name, length, CAPTURE_ROW_PREFIX, rowLength)) {
+        rule->marks = rowMarkBit(
+            query,
+            name + rowLength,
+            length - rowLength
+        );
+        return rule->marks != 0;
+    }
+    if (hasPrefix(name, length, CAPTURE_COUNT_UNLESS_PREFIX, unlessLength)) {
+        rule->weight = 1;
+        return rowMarkBits(
+            query,
+            name + unlessLength,
+            length - unlessLength,
+            &rule->unless
+        );
+    }
+    rule->weight = captureWeight(name, length);
+    return true;
+}
+
+static LogicalLinesQuery compileQuery(RcnTextFormat language) {
+    LogicalLinesQuery compiled = {0};
+    TSQuery* query = createQuery(language);
+    if (!query) {
+        return compiled;
+    }
+    const uint32_t numCaptures = ts_query_capture_count(query);
+    CaptureRule* rules = malloc(sizeof(CaptureRule) * (numCaptures + 1));
+    bool ok = (rules != NULL);
+    for (uint32_t i = 0; ok && i < numCaptures; ++i) {
+        uint32_t length = 0;
+        const char* name = ts_query_capture_name_for_id(query, i, &length);
+        ok = captureRule(query, name, length, &rules[i]);
+    }
+    if (!ok) {
+        // LCOV_EXCL_START
+        free(rules);
+        ts_query_delete(query);
+        return compiled;
+        // LCOV_EXCL_STOP
+    }
+    compiled.query = query;
+    compiled.captureRules = rules;
+    return compiled;
+}
+
+static void compileQueries(void) {
+    for (size_t i = 0; i < RECKON_NUM_SUPPORTED_FORMATS; ++i) {
+        compiledQueries[i] = compileQuery((RcnTextFormat) i);
+    }
+}
+
+static bool appendRowMark(RowMarkList* list, RowMark mark) {
+    if (list->size == list->capacity) {
+        const size_t newCapacity = list->capacity ? list->capacity * 2 : 64;
+        RowMark* marks = realloc(list->marks, newCapacity * sizeof(RowMark));
+        if (!marks) {
+            return false; // LCOV_EXCL_LINE
+        }
+        list->marks = marks;
+        list->capacity = newCapacity;
+    }
+    list->marks[list->size++] = mark;
+    return true;
+}
+
+/**
+ * Comparator for `qsort()` that orders captured nodes by their start in the
+ * source code. Nodes that set line marks are ordered before nodes starting
+ * at the same byte that depend on line marks, which are usually contained.
+ */
+static int compareRowMarks(const void* arg1, const void* arg2) {
+    const RowMark* mark1 = (const RowMark*) arg1;
+    const RowMark* mark2 = (const RowMark*) arg2;
+    if (mark1->startByte != mark2->startByte) {
+        return (mark1->startByte < mark2->startByte) ? -1 : 1;
+    }
+    return (mark1->unless != 0) - (mark2->unless != 0);
+}
+
+/**
+ * Returns the number of logical lines added by the captured nodes of the
+ * given list that depend on line marks. The nodes are evaluated in the
+ * order of the source code, which is the order in which the evaluation
+ * function of the language visits them, so that only the last node set
+ * for each line mark is considered.
+ */
+static int64_t countRowMarks(RowMarkList* list) {
+    qsort(list->marks, list->size, sizeof(RowMark), compareRowMarks);
+    uint32_t lastRows[MAX_ROW_MARKS];
+    for (size_t i = 0; i < MAX_ROW_MARKS; ++i) {
+        lastRows[i] = UINT32_MAX;
+    }
+    int64_t count = 0;
+    for (size_t i = 0; i < list->size; ++i) {
+        const RowMark* mark = &list->marks[i];
+        bool isCancelled = (mark->unless != 0);
+        for (uint32_t bit = 0; bit < MAX_ROW_MARKS; ++bit) {
+            const uint32_t mask = UINT32_C(1) << bit;
+            if (mark->marks & mask) {
+                lastRows[bit] = mark->row;
+            }
+            if ((mark->unless & mask) && lastRows[bit] != mark->row) {
+                isCancelled = false;
+            }
+        }
+        if (mark->unless != 0 && !isCancelled) {
+            count += 1;
+        }
+    }
+    return count;
+}
+
+RcnCountResult evaluateLogicalLinesByQuery(
+    RcnTextFormat language,
+    RcnSourceText sourceCode,
+    TextEncoding encoding,
+    ParserCache* cache
+) {
+    RcnCountResult result = {0};
+    if (!sourceCode.text) {
+        result.state.errorCode = RCN_ERR_INVALID_INPUT;
+        result.state.errorMessage = "Source code input must not be NULL";
+        return result;
+    }
+    if (!createEvaluationFunction(language)) {
+        result.state.errorCode = RCN_ERR_UNSUPPORTED_FORMAT;
+        result.state.errorMessage = (
+            "The input format or programming language is not supported"
+        );
+        return result;
+    }
+    callOnce(&compiledQueriesFlag, compileQueries);
+    const LogicalLinesQuery* compiled = &compiledQueries[language];
+    if (!compiled->query) {
+        // LCOV_EXCL_START
+        result.state.errorCode = RCN_ERR_UNKNOWN;
+        result.state.errorMessage = (
+            "The query of the programming language cannot be compiled"
+        );
+        return result;
+        // LCOV_EXCL_STOP
+    }
+    if (!cache->queryCursor) {
+        cache->queryCursor = ts_query_cursor_new();
+    }
+    NodeEvalTrace trace = {0};
+    trace.result = &result;
+    TSTree* tree = parseSourceTree(
+        sourceCode,
+        encoding,
+        language,
+        &trace,
+        cache,
+        &result.state
+    );
+    if (!tree) {
+        return result;
+    }
+    TSQueryCursor* cursor = cache->queryCursor;
+    const TSNode rootNode = ts_tree_root_node(tree);
+    // The range of a cursor is kept across executions, so it must always be
+    // set to the range of the current tree when a cached cursor is reused
+    (void) ts_query_cursor_set_byte_range(
+        cursor,
+        ts_node_start_byte(rootNode),
+        ts_node_end_byte(rootNode)
+    );
+    ts_query_cursor_exec(cursor, compiled->query, rootNode);
+    int64_t count = 0;
+    bool ok = true;
+    RowMarkList rowMarks = {0};
+    TSQueryMatch match;
+    while (ok && ts_query_cursor_next_match(cursor, &match)) {
+        for (uint16_t i = 0; ok && i < match.capture_count; ++i) {
+            const TSQueryCapture* capture = &match.captures[i];
+            const CaptureRule* rule = &compiled->captureRules[capture->index];
+            if (rule->marks || rule->unless) {
+                // Nodes which depend on the lines of other nodes are counted
+                // once all nodes are captured
+                const RowMark mark = {
+                    .startByte = ts_node_start_byte(capture->node),
+                    .row = ts_node_start_point(capture->node).row,
+                    .marks = rule->marks,
+                    .unless = rule->unless
+                };
+                ok = appendRowMark(&rowMarks, mark);
+            } else {
+                count += rule->weight;
+            }
+        }
+    }
+    ts_tree_delete(tree);
+    if (!ok) {
+        // LCOV_EXCL_START
+        free(rowMarks.marks);
+        result.state.errorCode = RCN_ERR_ALLOC_FAILURE;
+        result.state.errorMessage = "Failed to allocate captured nodes";
+        return result;
+        // LCOV_EXCL_STOP
+    }
+    count += countRowMarks(&rowMarks);
+    free(rowMarks.marks);
+    result.count = (count > 0) ? (RcnCount) count : 0;
+    result.state.ok = true;
+    return result;
+}
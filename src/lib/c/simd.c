@@ -0,0 +1,2478 @@
+/*
+ * Copyright (C) 2026 Raven Computing
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "concurrency.h"
+#include "simd.h"
+
+#if defined(__x86_64__) || defined(_M_X64) \
+    || defined(__i386__) || defined(_M_IX86)
+#define SIMD_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#else
+#define SIMD_X86 0
+#endif
+
+// Kernel variants are compiled for their instruction set extensions
+// individually, so that the library itself does not require them
+#if defined(__GNUC__) || defined(__clang__)
+#define SIMD_TARGET(extensions) __attribute__((target(extensions)))
+#else
+#define SIMD_TARGET(extensions)
+#endif
+
+/**
+ * The maximum number of vectors whose byte comparisons can be accumulated in
+ * 8-bit lanes before the lanes must be summed up to avoid an overflow.
+ */
+static const size_t SIMD_MAX_LANE_SUMS = 255;
+
+/**
+ * The number of bytes of a block of text whose byte classes are
+ * represented by the bits of a 64-bit mask.
+ */
+enum { SIMD_BLOCK_SIZE = 64 };
+
+static const unsigned char MASK_B2 = 0xe0;
+static const unsigned char MASK_B3 = 0xf0;
+static const unsigned char MASK_B4 = 0xf8;
+static const unsigned char TWO_BYTE_SEQ = 0xc0;
+static const unsigned char THREE_BYTE_SEQ = 0xe0;
+static const unsigned char FOUR_BYTE_SEQ = 0xf0;
+
+static const uint64_t WORD_LOW_BITS = 0x7F7F7F7F7F7F7F7FULL;
+static const uint64_t WORD_HIGH_BITS = 0x8080808080808080ULL;
+static const uint64_t WORD_ONES = 0x0101010101010101ULL;
+
+/**
+ * The number of code units of a block of UTF-16 text, which has the same
+ * number of bytes as a block of text.
+ */
+enum { UTF16_BLOCK_UNITS = SIMD_BLOCK_SIZE / 2 };
+
+static const uint64_t UTF16_BLOCK_MASK = 0xFFFFFFFFULL;
+
+static const uint16_t UTF16_BOM = 0xFEFF;
+static const uint16_t UTF16_SWAPPED_BOM = 0xFFFE;
+static const uint16_t HIGH_SURROGATE_START = 0xD800;
+static const uint16_t LOW_SURROGATE_START = 0xDC00;
+static const uint16_t LOW_SURROGATE_END = 0xDFFF;
+static const uint32_t SUPPLEMENTARY_START = 0x10000;
+
+static const uint16_t TWO_BYTE_SEQ_START = 0x80;
+static const uint16_t THREE_BYTE_SEQ_START = 0x800;
+static const unsigned char CONTINUATION_BYTE = 0x80;
+static const unsigned char CONTINUATION_BITS = 0x3f;
+static const unsigned CONTINUATION_SHIFT = 6;
+static const unsigned SURROGATE_SHIFT = 10;
+static const uint16_t NON_ASCII_UNIT_BITS = 0xFF80;
+
+/**
+ * The first byte which is not a C0 control character.
+ */
+static const unsigned char CONTROL_BYTES_END = 0x20;
+static const unsigned char ESCAPE_BYTE = 0x1B;
+
+/**
+ * The classes of bytes with respect to delimiting words.
+ */
+typedef enum WordByteClass {
+    WordByteText,
+    WordByteSpace,
+    WordByteNeutral
+} WordByteClass;
+
+/**
+ * The `WordByteClass` of every byte value. White space bytes are those of
+ * `isspace()` in the "C" locale. A null byte neither starts nor ends a word.
+ */
+static const unsigned char WORD_BYTE_CLASSES[256] = {
+    [0x00] = WordByteNeutral,
+    ['\t'] = WordByteSpace,
+    ['\n'] = WordByteSpace,
+    ['\v'] = WordByteSpace,
+    ['\f'] = WordByteSpace,
+    ['\r'] = WordByteSpace,
+    [' '] = WordByteSpace
+};
+
+/**
+ * The detected `SimdLevel`, or `SIZE_MAX` if not yet detected.
+ */
+static size_t detectedSimdLevel = SIZE_MAX;
+
+static size_t countByteScalar(const char* text, size_t size, char byte) {
+    size_t count = 0;
+    for (size_t i = 0; i < size; ++i) {
+        if (text[i] == byte) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+/**
+ * Returns the number of zero bytes in the given word. The high bit of a byte
+ * is set after the addition if any of its low bits is set, and no carry can
+ * propagate into the next byte, so that no byte is miscounted.
+ */
+static inline size_t countZeroBytes(uint64_t word) {
+    const uint64_t nonZero = ((word & WORD_LOW_BITS) + WORD_LOW_BITS) | word;
+    const uint64_t zeroFlags = (~nonZero & WORD_HIGH_BITS) >> 7;
+    // The sum of all flags accumulates in the most significant byte
+    return (size_t) ((zeroFlags * WORD_ONES) >> 56);
+}
+
+static size_t countBytePortable(const char* text, size_t size, char byte) {
+    const uint64_t pattern = WORD_ONES * (unsigned char) byte;
+    size_t count = 0;
+    size_t offset = 0;
+    for (; size - offset >= sizeof(uint64_t); offset += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, text + offset, sizeof(uint64_t));
+        count += countZeroBytes(word ^ pattern);
+    }
+    return count + countByteScalar(text + offset, size - offset, byte);
+}
+
+/**
+ * Indicates whether the given byte is a C0 control character which does not
+ * usually occur in text, i.e. any except the white space characters of the
+ * "C" locale and the escape character of terminal control sequences.
+ */
+static inline bool isControlByte(unsigned char byte) {
+    return (
+        byte < CONTROL_BYTES_END
+        && (byte < '\t' || byte > '\r')
+        && byte != ESCAPE_BYTE
+    );
+}
+
+static size_t countControlBytesScalar(const char* text, size_t size) {
+    size_t count = 0;
+    for (size_t i = 0; i < size; ++i) {
+        if (isControlByte((unsigned char) text[i])) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+/**
+ * Returns the number of bytes in the given word which are below the given
+ * bound, which must not be greater than 0x80. Like in `countZeroBytes()`,
+ * the addition sets the high bit of a byte if its low bits reach the bound,
+ * without a carry into the next byte.
+ */
+static inline size_t countBytesBelow(uint64_t word, unsigned char bound) {
+    const uint64_t addend = WORD_ONES * (unsigned char) (0x80 - bound);
+    const uint64_t notBelow = ((word & WORD_LOW_BITS) + addend) | word;
+    const uint64_t belowFlags = (~notBelow & WORD_HIGH_BITS) >> 7;
+    return (size_t) ((belowFlags * WORD_ONES) >> 56);
+}
+
+static size_t countControlBytesPortable(const char* text, size_t size) {
+    size_t count = 0;
+    size_t offset = 0;
+    for (; size - offset >= sizeof(uint64_t); offset += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, text + offset, sizeof(uint64_t));
+        // The excluded bytes are all below the bound of control bytes
+        count += countBytesBelow(word, CONTROL_BYTES_END);
+        for (unsigned char byte = '\t'; byte <= '\r'; ++byte) {
+            count -= countZeroBytes(word ^ (WORD_ONES * byte));
+        }
+        count -= countZeroBytes(word ^ (WORD_ONES * ESCAPE_BYTE));
+    }
+    return count + countControlBytesScalar(text + offset, size - offset);
+}
+
+/**
+ * The classes of the bytes of a block of UTF-8 text. Bit `i` of each mask
+ * refers to byte `i` of the block. The masks of lead bytes are inclusive,
+ * e.g. the lead bytes of three-byte sequences are also contained in the
+ * mask of lead bytes of sequences with at least two bytes.
+ */
+typedef struct UTF8BlockMasks {
+    uint64_t continuation;
+    uint64_t lead2;
+    uint64_t lead3;
+    uint64_t lead4;
+} UTF8BlockMasks;
+
+/**
+ * The state of counting a run of consecutive well-formed blocks of UTF-8
+ * text. The carry marks the bytes at the start of the next block which must
+ * be continuation bytes of a sequence started in the previous block.
+ */
+typedef struct UTF8Blocks {
+    size_t count;
+    uint64_t carry;
+    size_t lastLead;
+} UTF8Blocks;
+
+static inline size_t countBits(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (size_t) __builtin_popcountll(value);
+#else
+    value = value - ((value >> 1) & 0x5555555555555555ULL);
+    value = (
+        (value & 0x3333333333333333ULL)
+        + ((value >> 2) & 0x3333333333333333ULL)
+    );
+    value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (size_t) ((value * WORD_ONES) >> 56);
+#endif
+}
+
+/**
+ * Returns the index of the highest set bit of the given non-zero value.
+ */
+static inline size_t highestBit(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (size_t) (63 - __builtin_clzll(value));
+#else
+    size_t index = 0;
+    while (value >>= 1) {
+        ++index;
+    }
+    return index;
+#endif
+}
+
+/**
+ * Counts the block with the given masks at the specified offset if the block
+ * is well-formed, i.e. if exactly those bytes are continuation bytes that are
+ * announced by the preceding lead bytes. The sequences of a well-formed run of
+ * blocks are exactly the sequences decoded from their lead bytes, so that the
+ * number of characters is the number of bytes which are no continuation bytes.
+ * Returns `false` without counting if the block is not well-formed.
+ */
+static inline bool acceptUTF8Block(
+    UTF8Blocks* blocks,
+    UTF8BlockMasks masks,
+    size_t offset
+) {
+    const uint64_t expected = (
+        (masks.lead2 << 1)
+        | (masks.lead3 << 2)
+        | (masks.lead4 << 3)
+        | blocks->carry
+    );
+    if (expected != masks.continuation) {
+        return false;
+    }
+    blocks->carry = (
+        (masks.lead2 >> 63)
+        | (masks.lead3 >> 62)
+        | (masks.lead4 >> 61)
+    );
+    // A block always contains a byte which is no continuation byte,
+    // since no sequence spans more than three continuation bytes
+    blocks->lastLead = offset + highestBit(~masks.continuation);
+    blocks->count += SIMD_BLOCK_SIZE - countBits(masks.continuation);
+    return true;
+}
+
+/**
+ * Completes the count of a run of well-formed blocks which ends at the
+ * specified offset. Returns the offset of the first sequence that was not
+ * counted, which is the last sequence of the run if it continues beyond
+ * the last block of the run.
+ */
+static inline size_t finishUTF8Blocks(
+    const UTF8Blocks* blocks,
+    size_t offset,
+    size_t* count
+) {
+    if (blocks->carry != 0) {
+        *count += blocks->count - 1;
+        return blocks->lastLead;
+    }
+    *count += blocks->count;
+    return offset;
+}
+
+/**
+ * Function pointer type for the functions which count a run of well-formed
+ * blocks of UTF-8 text at the start of the given text. Returns the number of
+ * bytes of all counted sequences, which may be zero.
+ */
+typedef size_t (*UTF8BlocksCounter)(
+    const char* text,
+    size_t size,
+    size_t* count
+);
+
+static size_t countUTF8Scalar(const char* text, size_t size, size_t* count) {
+    size_t offset = 0;
+    size_t numSequences = 0;
+    while (offset < size) {
+        const unsigned char byte = (unsigned char) text[offset];
+        size_t length = 1;
+        if ((byte & MASK_B2) == TWO_BYTE_SEQ) {
+            length = 2;
+        } else if ((byte & MASK_B3) == THREE_BYTE_SEQ) {
+            length = 3;
+        } else if ((byte & MASK_B4) == FOUR_BYTE_SEQ) {
+            length = 4;
+        }
+        if (length > size - offset) {
+            break; // The sequence is truncated
+        }
+        offset += length;
+        ++numSequences;
+    }
+    *count += numSequences;
+    return offset;
+}
+
+/**
+ * Counts the characters of the given UTF-8 text by alternating between runs
+ * of well-formed blocks, which are counted by the specified function, and
+ * single blocks which are not well-formed, which are counted by decoding
+ * all their sequences.
+ */
+static size_t countUTF8Blocks(
+    const char* text,
+    size_t size,
+    size_t* count,
+    UTF8BlocksCounter countBlocks
+) {
+    size_t offset = 0;
+    while (size - offset >= SIMD_BLOCK_SIZE) {
+        offset += countBlocks(text + offset, size - offset, count);
+        if (size - offset < SIMD_BLOCK_SIZE) {
+            break;
+        }
+        offset += countUTF8Scalar(text + offset, SIMD_BLOCK_SIZE, count);
+    }
+    return offset + countUTF8Scalar(text + offset, size - offset, count);
+}
+
+static size_t countUTF8Portable(const char* text, size_t size, size_t* count) {
+    size_t offset = 0;
+    while (size - offset >= sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, text + offset, sizeof(uint64_t));
+        if ((word & WORD_HIGH_BITS) == 0) {
+            *count += sizeof(uint64_t); // Only ASCII characters
+            offset += sizeof(uint64_t);
+        } else {
+            offset += countUTF8Scalar(text + offset, sizeof(uint64_t), count);
+        }
+    }
+    return offset + countUTF8Scalar(text + offset, size - offset, count);
+}
+
+static size_t countWordsScalar(const char* text, size_t size, bool* inWord) {
+    size_t count = 0;
+    bool isInWord = *inWord;
+    for (size_t i = 0; i < size; ++i) {
+        const unsigned char byte = (unsigned char) text[i];
+        switch (WORD_BYTE_CLASSES[byte]) {
+        case WordByteSpace:
+            isInWord = false;
+            break;
+        case WordByteText:
+            count += isInWord ? 0 : 1;
+            isInWord = true;
+            break;
+        default:
+            break;
+        }
+    }
+    *inWord = isInWord;
+    return count;
+}
+
+/**
+ * The bytes of a block of text that are white space and the bytes that are
+ * neutral with respect to delimiting words. Bit `i` of each mask refers to
+ * byte `i` of the block.
+ */
+typedef struct WordBlockMasks {
+    uint64_t space;
+    uint64_t neutral;
+} WordBlockMasks;
+
+/**
+ * Counts the words starting in the given block with the specified masks.
+ * A word starts at every byte which is not white space and which follows
+ * white space, or the start of the text, with the given in-word state
+ * carried over from the preceding block. Blocks with neutral bytes are
+ * rare and are counted byte by byte.
+ */
+static inline size_t countWordBlock(
+    const char* block,
+    WordBlockMasks masks,
+    bool* inWord
+) {
+    if (masks.neutral != 0) {
+        return countWordsScalar(block, SIMD_BLOCK_SIZE, inWord);
+    }
+    const uint64_t followsSpace = (masks.space << 1) | (*inWord ? 0 : 1);
+    *inWord = (masks.space >> 63) == 0;
+    return countBits(~masks.space & followsSpace);
+}
+
+/**
+ * Gathers the high bits of the eight bytes of the given word into the
+ * eight low bits of the result. All other bits of the word must be zero.
+ */
+static inline uint64_t gatherHighBits(uint64_t flags) {
+    return ((flags >> 7) * 0x0102040810204080ULL) >> 56;
+}
+
+static inline uint64_t flagZeroBytes(uint64_t word) {
+    return ~(((word & WORD_LOW_BITS) + WORD_LOW_BITS) | word) & WORD_HIGH_BITS;
+}
+
+/**
+ * Classifies the bytes of the given word. Adding to the low bits of a byte
+ * sets its high bit if the byte is at least the complement of the addend,
+ * without a carry into the next byte.
+ */
+static inline WordBlockMasks classifyWordBytes(uint64_t word) {
+    const uint64_t low = word & WORD_LOW_BITS;
+    const uint64_t atLeastTab = low + (WORD_ONES * (0x80 - '\t'));
+    const uint64_t aboveReturn = low + (WORD_ONES * (0x80 - '\r' - 1));
+    const uint64_t control = atLeastTab & ~aboveReturn & ~word;
+    const uint64_t blank = flagZeroBytes(word ^ (WORD_ONES * ' '));
+    return (WordBlockMasks){
+        .space = gatherHighBits((control & WORD_HIGH_BITS) | blank),
+        .neutral = gatherHighBits(flagZeroBytes(word))
+    };
+}
+
+static size_t countWordsPortable(
+    const char* text,
+    size_t size,
+    bool* inWord
+) {
+    size_t count = 0;
+    size_t offset = 0;
+    for (; size - offset >= SIMD_BLOCK_SIZE; offset += SIMD_BLOCK_SIZE) {
+        WordBlockMasks masks = {0};
+        for (size_t i = 0; i < SIMD_BLOCK_SIZE; i += sizeof(uint64_t)) {
+            uint64_t word;
+            memcpy(&word, text + offset + i, sizeof(uint64_t));
+            const WordBlockMasks part = classifyWordBytes(word);
+            masks.space |= part.space << i;
+            masks.neutral |= part.neutral << i;
+        }
+        count += countWordBlock(text + offset, masks, inWord);
+    }
+    return count + countWordsScalar(text + offset, size - offset, inWord);
+}
+
+static size_t countCodeUnitScalar(
+    const char* text,
+    size_t numUnits,
+    char byte0,
+    char byte1
+) {
+    size_t count = 0;
+    for (size_t i = 0; i < numUnits; ++i) {
+        if (text[2 * i] == byte0 && text[(2 * i) + 1] == byte1) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+static size_t countCodeUnitPortable(
+    const char* text,
+    size_t numUnits,
+    char byte0,
+    char byte1
+) {
+    const char bytes[sizeof(uint64_t)] = {
+        byte0, byte1, byte0, byte1, byte0, byte1, byte0, byte1
+    };
+    uint64_t pattern;
+    memcpy(&pattern, bytes, sizeof(uint64_t));
+    // The high bits of the first byte of all code units, in either order
+    // of the bytes of a word, as both bytes of a matching unit are flagged
+    const uint64_t unitFlags = 0x0080008000800080ULL;
+    const size_t size = 2 * numUnits;
+    size_t count = 0;
+    size_t offset = 0;
+    for (; size - offset >= sizeof(uint64_t); offset += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, text + offset, sizeof(uint64_t));
+        const uint64_t zeroFlags = flagZeroBytes(word ^ pattern);
+        count += countBits(zeroFlags & (zeroFlags >> 8) & unitFlags);
+    }
+    return count + countCodeUnitScalar(
+        text + offset,
+        (size - offset) / 2,
+        byte0,
+        byte1
+    );
+}
+
+/**
+ * Reads the code unit with the specified index from the given UTF-16 text.
+ * The byte order is usually a constant, so that the function is specialized
+ * for it when inlined.
+ */
+static inline uint16_t loadCodeUnit(
+    const char* text,
+    size_t index,
+    bool isLittleEndian
+) {
+    const unsigned char byte0 = (unsigned char) text[2 * index];
+    const unsigned char byte1 = (unsigned char) text[(2 * index) + 1];
+    return (
+        isLittleEndian
+        ? (uint16_t) (byte0 | (byte1 << 8))
+        : (uint16_t) ((byte0 << 8) | byte1)
+    );
+}
+
+/**
+ * Counts the words starting in the given UTF-16 text one code unit at a
+ * time. Code units are classified like the bytes of other text by their
+ * value, whereby all code units outside of ASCII are part of words, except
+ * for byte order marks which are neutral like null characters.
+ */
+static inline size_t countUTF16WordsFrom(
+    const char* text,
+    size_t numUnits,
+    bool* inWord,
+    bool isLittleEndian
+) {
+    size_t count = 0;
+    bool isInWord = *inWord;
+    for (size_t i = 0; i < numUnits; ++i) {
+        const uint16_t unit = loadCodeUnit(text, i, isLittleEndian);
+        WordByteClass unitClass = WordByteText;
+        if (unit < sizeof(WORD_BYTE_CLASSES)) {
+            unitClass = (WordByteClass) WORD_BYTE_CLASSES[unit];
+        } else if (unit == UTF16_BOM || unit == UTF16_SWAPPED_BOM) {
+            unitClass = WordByteNeutral;
+        }
+        switch (unitClass) {
+        case WordByteSpace:
+            isInWord = false;
+            break;
+        case WordByteText:
+            count += isInWord ? 0 : 1;
+            isInWord = true;
+            break;
+        default:
+            break;
+        }
+    }
+    *inWord = isInWord;
+    return count;
+}
+
+static size_t countUTF16LEWordsScalar(
+    const char* text,
+    size_t numUnits,
+    bool* inWord
+) {
+    return countUTF16WordsFrom(text, numUnits, inWord, true);
+}
+
+static size_t countUTF16BEWordsScalar(
+    const char* text,
+    size_t numUnits,
+    bool* inWord
+) {
+    return countUTF16WordsFrom(text, numUnits, inWord, false);
+}
+
+/**
+ * Counts the characters of the given UTF-16 text one code unit at a time.
+ * Whether the code unit preceding the text is a high surrogate is given
+ * by `afterHigh`. A low surrogate is only counted if it follows a high
+ * surrogate, so that a surrogate pair is counted once.
+ */
+static inline size_t countUTF16From(
+    const char* text,
+    size_t numUnits,
+    bool afterHigh,
+    bool isLittleEndian
+) {
+    size_t count = 0;
+    bool isAfterHigh = afterHigh;
+    for (size_t i = 0; i < numUnits; ++i) {
+        const uint16_t unit = loadCodeUnit(text, i, isLittleEndian);
+        const bool isHigh = (
+            unit >= HIGH_SURROGATE_START && unit < LOW_SURROGATE_START
+        );
+        if (unit >= LOW_SURROGATE_START && unit <= LOW_SURROGATE_END) {
+            count += isAfterHigh ? 1 : 0;
+        } else if (
+            !isHigh
+            && unit != UTF16_BOM
+            && unit != UTF16_SWAPPED_BOM
+        ) {
+            ++count;
+        }
+        isAfterHigh = isHigh;
+    }
+    return count;
+}
+
+static size_t countUTF16LEScalar(const char* text, size_t numUnits) {
+    return countUTF16From(text, numUnits, false, true);
+}
+
+static size_t countUTF16BEScalar(const char* text, size_t numUnits) {
+    return countUTF16From(text, numUnits, false, false);
+}
+
+/**
+ * Transcodes the given UTF-16 text to UTF-8 one code unit at a time, from the
+ * code unit at `position` up to the one at `stop`. A surrogate pair which
+ * starts before `stop` is transcoded entirely, so that the position can end
+ * up one code unit after `stop`. The UTF-8 sequences are written to `out`.
+ * Both `position` and `out` are advanced past the transcoded code units.
+ * Returns `false` on code units without a UTF-8 representation, as described
+ * for the `UTF16TranscodeKernel`.
+ */
+static inline bool transcodeUTF16From(
+    const char* text,
+    size_t numUnits,
+    size_t* position,
+    size_t stop,
+    char** out,
+    bool isLittleEndian
+) {
+    size_t i = *position;
+    unsigned char* bytes = (unsigned char*) *out;
+    while (i < stop) {
+        const uint16_t unit = loadCodeUnit(text, i++, isLittleEndian);
+        if (unit < TWO_BYTE_SEQ_START) {
+            *bytes++ = (unsigned char) unit;
+        } else if (unit < THREE_BYTE_SEQ_START) {
+            *bytes++ = TWO_BYTE_SEQ | (unit >> CONTINUATION_SHIFT);
+            *bytes++ = CONTINUATION_BYTE | (unit & CONTINUATION_BITS);
+        } else if (unit >= HIGH_SURROGATE_START && unit <= LOW_SURROGATE_END) {
+            if (unit >= LOW_SURROGATE_START || i == numUnits) {
+                return false;
+            }
+            const uint16_t low = loadCodeUnit(text, i++, isLittleEndian);
+            if (low < LOW_SURROGATE_START || low > LOW_SURROGATE_END) {
+                return false;
+            }
+            const uint32_t codePoint = SUPPLEMENTARY_START + (
+                ((uint32_t) (unit - HIGH_SURROGATE_START) << SURROGATE_SHIFT)
+                | (uint32_t) (low - LOW_SURROGATE_START)
+            );
+            *bytes++ = FOUR_BYTE_SEQ | (codePoint >> (3 * CONTINUATION_SHIFT));
+            *bytes++ = CONTINUATION_BYTE | (
+                (codePoint >> (2 * CONTINUATION_SHIFT)) & CONTINUATION_BITS
+            );
+            *bytes++ = CONTINUATION_BYTE | (
+                (codePoint >> CONTINUATION_SHIFT) & CONTINUATION_BITS
+            );
+            *bytes++ = CONTINUATION_BYTE | (codePoint & CONTINUATION_BITS);
+        } else if (unit == UTF16_BOM || unit == UTF16_SWAPPED_BOM) {
+            return false;
+        } else {
+            *bytes++ = THREE_BYTE_SEQ | (unit >> (2 * CONTINUATION_SHIFT));
+            *bytes++ = CONTINUATION_BYTE | (
+                (unit >> CONTINUATION_SHIFT) & CONTINUATION_BITS
+            );
+            *bytes++ = CONTINUATION_BYTE | (unit & CONTINUATION_BITS);
+        }
+    }
+    *position = i;
+    *out = (char*) bytes;
+    return true;
+}
+
+static bool transcodeUTF16LEScalar(
+    const char* text,
+    size_t numUnits,
+    char* out,
+    size_t* size
+) {
+    size_t position = 0;
+    char* end = out;
+    const bool ok = transcodeUTF16From(
+        text,
+        numUnits,
+        &position,
+        numUnits,
+        &end,
+        true
+    );
+    *size = (size_t) (end - out);
+    return ok;
+}
+
+static bool transcodeUTF16BEScalar(
+    const char* text,
+    size_t numUnits,
+    char* out,
+    size_t* size
+) {
+    size_t position = 0;
+    char* end = out;
+    const bool ok = transcodeUTF16From(
+        text,
+        numUnits,
+        &position,
+        numUnits,
+        &end,
+        false
+    );
+    *size = (size_t) (end - out);
+    return ok;
+}
+
+/**
+ * Counts the words starting in the given block of UTF-16 text with the
+ * specified masks, like `countWordBlock()` but for the code units of the
+ * block. Blocks with neutral code units, e.g. the byte order mark at the
+ * start of a text, are counted one code unit at a time.
+ */
+static inline size_t countUTF16WordBlock(
+    const char* block,
+    WordBlockMasks masks,
+    bool* inWord,
+    bool isLittleEndian
+) {
+    if (masks.neutral != 0) {
+        return countUTF16WordsFrom(
+            block,
+            UTF16_BLOCK_UNITS,
+            inWord,
+            isLittleEndian
+        );
+    }
+    const uint64_t followsSpace = (masks.space << 1) | (*inWord ? 0 : 1);
+    *inWord = (masks.space >> (UTF16_BLOCK_UNITS - 1)) == 0;
+    return countBits(~masks.space & followsSpace & UTF16_BLOCK_MASK);
+}
+
+/**
+ * The classes of the code units of a block of UTF-16 text with respect to
+ * counting characters. Bit `i` of each mask refers to code unit `i` of the
+ * block. The ignored code units are byte order marks.
+ */
+typedef struct UTF16BlockMasks {
+    uint64_t high;
+    uint64_t low;
+    uint64_t ignored;
+} UTF16BlockMasks;
+
+/**
+ * Counts the characters of a block of UTF-16 text with the given masks.
+ * Whether the last code unit of the preceding block is a high surrogate
+ * is carried over by `afterHigh`.
+ */
+static inline size_t countUTF16Block(UTF16BlockMasks masks, bool* afterHigh) {
+    const uint64_t followsHigh = (masks.high << 1) | (*afterHigh ? 1 : 0);
+    const uint64_t other = ~(masks.high | masks.low | masks.ignored);
+    *afterHigh = (masks.high >> (UTF16_BLOCK_UNITS - 1)) != 0;
+    return (
+        countBits(other & UTF16_BLOCK_MASK)
+        + countBits(masks.low & followsHigh)
+    );
+}
+
+#if SIMD_X86
+
+SIMD_TARGET("sse2")
+static size_t countByteSSE2(const char* text, size_t size, char byte) {
+    const __m128i pattern = _mm_set1_epi8(byte);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i totals = zero;
+    size_t offset = 0;
+    while (size - offset >= sizeof(__m128i)) {
+        size_t vectors = (size - offset) / sizeof(__m128i);
+        if (vectors > SIMD_MAX_LANE_SUMS) {
+            vectors = SIMD_MAX_LANE_SUMS;
+        }
+        __m128i sums = zero;
+        for (size_t i = 0; i < vectors; ++i) {
+            const __m128i chunk = _mm_loadu_si128(
+                (const __m128i*) (text + offset)
+            );
+            // Matching lanes are all ones, i.e. minus one
+            sums = _mm_sub_epi8(sums, _mm_cmpeq_epi8(chunk, pattern));
+            offset += sizeof(__m128i);
+        }
+        totals = _mm_add_epi64(totals, _mm_sad_epu8(sums, zero));
+    }
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i*) lanes, totals);
+    const size_t count = (size_t) (lanes[0] + lanes[1]);
+    return count + countByteScalar(text + offset, size - offset, byte);
+}
+
+SIMD_TARGET("avx2")
+static size_t countByteAVX2(const char* text, size_t size, char byte) {
+    const __m256i pattern = _mm256_set1_epi8(byte);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i totals = zero;
+    size_t offset = 0;
+    while (size - offset >= sizeof(__m256i)) {
+        size_t vectors = (size - offset) / sizeof(__m256i);
+        if (vectors > SIMD_MAX_LANE_SUMS) {
+            vectors = SIMD_MAX_LANE_SUMS;
+        }
+        __m256i sums = zero;
+        for (size_t i = 0; i < vectors; ++i) {
+            const __m256i chunk = _mm256_loadu_si256(
+                (const __m256i*) (text + offset)
+            );
+            sums = _mm256_sub_epi8(sums, _mm256_cmpeq_epi8(chunk, pattern));
+            offset += sizeof(__m256i);
+        }
+        totals = _mm256_add_epi64(totals, _mm256_sad_epu8(sums, zero));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i*) lanes, totals);
+    const size_t count = (size_t) (lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    return count + countByteScalar(text + offset, size - offset, byte);
+}
+
+SIMD_TARGET("avx512f,avx512bw")
+static size_t countByteAVX512(const char* text, size_t size, char byte) {
+    const __m512i pattern = _mm512_set1_epi8(byte);
+    const __m512i zero = _mm512_setzero_si512();
+    __m512i totals = zero;
+    size_t offset = 0;
+    while (size - offset >= sizeof(__m512i)) {
+        size_t vectors = (size - offset) / sizeof(__m512i);
+        if (vectors > SIMD_MAX_LANE_SUMS) {
+            vectors = SIMD_MAX_LANE_SUMS;
+        }
+        __m512i sums = zero;
+        for (size_t i = 0; i < vectors; ++i) {
+            const __m512i chunk = _mm512_loadu_si512(
+                (const void*) (text + offset)
+            );
+            const __mmask64 matches = _mm512_cmpeq_epi8_mask(chunk, pattern);
+            sums = _mm512_sub_epi8(sums, _mm512_movm_epi8(matches));
+            offset += sizeof(__m512i);
+        }
+        totals = _mm512_add_epi64(totals, _mm512_sad_epu8(sums, zero));
+    }
+    uint64_t lanes[8];
+    _mm512_storeu_si512((void*) lanes, totals);
+    size_t count = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        count += (size_t) lanes[i];
+    }
+    return count + countByteScalar(text + offset, size - offset, byte);
+}
+
+/**
+ * Returns a mask of the control bytes of the given vector, as defined by
+ * `isControlByte()`. Unsigned comparisons are expressed by the minimum, i.e.
+ * a byte is not greater than a bound if the minimum of both is the byte.
+ */
+SIMD_TARGET("sse2")
+static inline __m128i maskControlBytesSSE2(__m128i bytes) {
+    const __m128i below = _mm_cmpeq_epi8(
+        _mm_min_epu8(bytes, _mm_set1_epi8(CONTROL_BYTES_END - 1)),
+        bytes
+    );
+    const __m128i offset = _mm_sub_epi8(bytes, _mm_set1_epi8('\t'));
+    const __m128i space = _mm_cmpeq_epi8(
+        _mm_min_epu8(offset, _mm_set1_epi8('\r' - '\t')),
+        offset
+    );
+    const __m128i escape = _mm_cmpeq_epi8(bytes, _mm_set1_epi8(ESCAPE_BYTE));
+    return _mm_andnot_si128(_mm_or_si128(space, escape), below);
+}
+
+SIMD_TARGET("sse2")
+static size_t countControlBytesSSE2(const char* text, size_t size) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i totals = zero;
+    size_t offset = 0;
+    while (size - offset >= sizeof(__m128i)) {
+        size_t vectors = (size - offset) / sizeof(__m128i);
+        if (vectors > SIMD_MAX_LANE_SUMS) {
+            vectors = SIMD_MAX_LANE_SUMS;
+        }
+        __m128i sums = zero;
+        for (size_t i = 0; i < vectors; ++i) {
+            const __m128i chunk = _mm_loadu_si128(
+                (const __m128i*) (text + offset)
+            );
+            sums = _mm_sub_epi8(sums, maskControlBytesSSE2(chunk));
+            offset += sizeof(__m128i);
+        }
+        totals = _mm_add_epi64(totals, _mm_sad_epu8(sums, zero));
+    }
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i*) lanes, totals);
+    const size_t count = (size_t) (lanes[0] + lanes[1]);
+    return count + countControlBytesScalar(text + offset, size - offset);
+}
+
+SIMD_TARGET("avx2")
+static inline __m256i maskControlBytesAVX2(__m256i bytes) {
+    const __m256i below = _mm256_cmpeq_epi8(
+        _mm256_min_epu8(bytes, _mm256_set1_epi8(CONTROL_BYTES_END - 1)),
+        bytes
+    );
+    const __m256i offset = _mm256_sub_epi8(bytes, _mm256_set1_epi8('\t'));
+    const __m256i space = _mm256_cmpeq_epi8(
+        _mm256_min_epu8(offset, _mm256_set1_epi8('\r' - '\t')),
+        offset
+    );
+    const __m256i escape = _mm256_cmpeq_epi8(
+        bytes,
+        _mm256_set1_epi8(ESCAPE_BYTE)
+    );
+    return _mm256_andnot_si256(_mm256_or_si256(space, escape), below);
+}
+
+SIMD_TARGET("avx2")
+static size_t countControlBytesAVX2(const char* text, size_t size) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i totals = zero;
+    size_t offset = 0;
+    while (size - offset >= sizeof(__m256i)) {
+        size_t vectors = (size - offset) / sizeof(__m256i);
+        if (vectors > SIMD_MAX_LANE_SUMS) {
+            vectors = SIMD_MAX_LANE_SUMS;
+        }
+        __m256i sums = zero;
+        for (size_t i = 0; i < vectors; ++i) {
+            const __m256i chunk = _mm256_loadu_si256(
+                (const __m256i*) (text + offset)
+            );
+            sums = _mm256_sub_epi8(sums, maskControlBytesAVX2(chunk));
+            offset += sizeof(__m256i);
+        }
+        totals = _mm256_add_epi64(totals, _mm256_sad_epu8(sums, zero));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i*) lanes, totals);
+    const size_t count = (size_t) (lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    return count + countControlBytesScalar(text + offset, size - offset);
+}
+
+SIMD_TARGET("avx512f,avx512bw,popcnt")
+static size_t countControlBytesAVX512(const char* text, size_t size) {
+    const __m512i bound = _mm512_set1_epi8(CONTROL_BYTES_END - 1);
+    const __m512i spaceStart = _mm512_set1_epi8('\t');
+    const __m512i spaceRange = _mm512_set1_epi8('\r' - '\t');
+    const __m512i escape = _mm512_set1_epi8(ESCAPE_BYTE);
+    size_t count = 0;
+    size_t offset = 0;
+    for (; size - offset >= sizeof(__m512i); offset += sizeof(__m512i)) {
+        const __m512i chunk = _mm512_loadu_si512((const void*) (text + offset));
+        const __mmask64 below = _mm512_cmple_epu8_mask(chunk, bound);
+        const __mmask64 space = _mm512_cmple_epu8_mask(
+            _mm512_sub_epi8(chunk, spaceStart),
+            spaceRange
+        );
+        const __mmask64 escapes = _mm512_cmpeq_epi8_mask(chunk, escape);
+        count += countBits(below & ~(space | escapes));
+    }
+    return count + countControlBytesScalar(text + offset, size - offset);
+}
+
+/**
+ * Classifies the bytes of the given vector with signed comparisons, for which
+ * continuation bytes are below -64 and lead bytes are in the range -64 to -9.
+ */
+SIMD_TARGET("sse2")
+static inline UTF8BlockMasks classifyUTF8SSE2(__m128i bytes) {
+    const __m128i maxLead = _mm_set1_epi8(-8);
+    const __m128i isBelowMaxLead = _mm_cmpgt_epi8(maxLead, bytes);
+    const __m128i lead2 = _mm_and_si128(
+        isBelowMaxLead,
+        _mm_cmpgt_epi8(bytes, _mm_set1_epi8(-65))
+    );
+    const __m128i lead3 = _mm_and_si128(
+        isBelowMaxLead,
+        _mm_cmpgt_epi8(bytes, _mm_set1_epi8(-33))
+    );
+    const __m128i lead4 = _mm_and_si128(
+        isBelowMaxLead,
+        _mm_cmpgt_epi8(bytes, _mm_set1_epi8(-17))
+    );
+    const __m128i continuation = _mm_cmpgt_epi8(_mm_set1_epi8(-64), bytes);
+    return (UTF8BlockMasks){
+        .continuation = (uint16_t) _mm_movemask_epi8(continuation),
+        .lead2 = (uint16_t) _mm_movemask_epi8(lead2),
+        .lead3 = (uint16_t) _mm_movemask_epi8(lead3),
+        .lead4 = (uint16_t) _mm_movemask_epi8(lead4)
+    };
+}
+
+SIMD_TARGET("sse2")
+static size_t countUTF8BlocksSSE2(
+    const char* text,
+    size_t size,
+    size_t* count
+) {
+    UTF8Blocks blocks = {0};
+    size_t offset = 0;
+    for (; size - offset >= SIMD_BLOCK_SIZE; offset += SIMD_BLOCK_SIZE) {
+        UTF8BlockMasks masks = {0};
+        for (size_t i = 0; i < SIMD_BLOCK_SIZE; i += sizeof(__m128i)) {
+            const UTF8BlockMasks part = classifyUTF8SSE2(
+                _mm_loadu_si128((const __m128i*) (text + offset + i))
+            );
+            masks.continuation |= part.continuation << i;
+            masks.lead2 |= part.lead2 << i;
+            masks.lead3 |= part.lead3 << i;
+            masks.lead4 |= part.lead4 << i;
+        }
+        if (!acceptUTF8Block(&blocks, masks, offset)) {
+            break;
+        }
+    }
+    return finishUTF8Blocks(&blocks, offset, count);
+}
+
+SIMD_TARGET("avx2")
+static inline UTF8BlockMasks classifyUTF8AVX2(__m256i bytes) {
+    const __m256i maxLead = _mm256_set1_epi8(-8);
+    const __m256i isBelowMaxLead = _mm256_cmpgt_epi8(maxLead, bytes);
+    const __m256i lead2 = _mm256_and_si256(
+        isBelowMaxLead,
+        _mm256_cmpgt_epi8(bytes, _mm256_set1_epi8(-65))
+    );
+    const __m256i lead3 = _mm256_and_si256(
+        isBelowMaxLead,
+        _mm256_cmpgt_epi8(bytes, _mm256_set1_epi8(-33))
+    );
+    const __m256i lead4 = _mm256_and_si256(
+        isBelowMaxLead,
+        _mm256_cmpgt_epi8(bytes, _mm256_set1_epi8(-17))
+    );
+    const __m256i continuation = _mm256_cmpgt_epi8(
+        _mm256_set1_epi8(-64),
+        bytes
+    );
+    return (UTF8BlockMasks){
+        .continuation = (uint32_t) _mm256_movemask_epi8(continuation),
+        .lead2 = (uint32_t) _mm256_movemask_epi8(lead2),
+        .lead3 = (uint32_t) _mm256_movemask_epi8(lead3),
+        .lead4 = (uint32_t) _mm256_movemask_epi8(lead4)
+    };
+}
+
+SIMD_TARGET("avx2,popcnt")
+static size_t countUTF8BlocksAVX2(
+    const char* text,
+    size_t size,
+    size_t* count
+) {
+    UTF8Blocks blocks = {0};
+    size_t offset = 0;
+    for (; size - offset >= SIMD_BLOCK_SIZE; offset += SIMD_BLOCK_SIZE) {
+        const UTF8BlockMasks low = classifyUTF8AVX2(
+            _mm256_loadu_si256((const __m256i*) (text + offset))
+        );
+        const UTF8BlockMasks high = classifyUTF8AVX2(
+            _mm256_loadu_si256((const __m256i*) (text + offset + 32))
+        );
+        const UTF8BlockMasks masks = {
+            .continuation = low.continuation | (high.continuation << 32),
+            .lead2 = low.lead2 | (high.lead2 << 32),
+            .lead3 = low.lead3 | (high.lead3 << 32),
+            .lead4 = low.lead4 | (high.lead4 << 32)
+        };
+        if (!acceptUTF8Block(&blocks, masks, offset)) {
+            break;
+        }
+    }
+    return finishUTF8Blocks(&blocks, offset, count);
+}
+
+SIMD_TARGET("avx512f,avx512bw,popcnt")
+static size_t countUTF8BlocksAVX512(
+    const char* text,
+    size_t size,
+    size_t* count
+) {
+    const __m512i maxLead = _mm512_set1_epi8(-8);
+    const __m512i minLead2 = _mm512_set1_epi8(-65);
+    const __m512i minLead3 = _mm512_set1_epi8(-33);
+    const __m512i minLead4 = _mm512_set1_epi8(-17);
+    const __m512i minLead = _mm512_set1_epi8(-64);
+    UTF8Blocks blocks = {0};
+    size_t offset = 0;
+    for (; size - offset >= SIMD_BLOCK_SIZE; offset += SIMD_BLOCK_SIZE) {
+        const __m512i bytes = _mm512_loadu_si512(
+            (const void*) (text + offset)
+        );
+        const __mmask64 isBelowMaxLead = _mm512_cmpgt_epi8_mask(
+            maxLead,
+            bytes
+        );
+        const UTF8BlockMasks masks = {
+            .continuation = _mm512_cmpgt_epi8_mask(minLead, bytes),
+            .lead2 = isBelowMaxLead & _mm512_cmpgt_epi8_mask(bytes, minLead2),
+            .lead3 = isBelowMaxLead & _mm512_cmpgt_epi8_mask(bytes, minLead3),
+            .lead4 = isBelowMaxLead & _mm512_cmpgt_epi8_mask(bytes, minLead4)
+        };
+        if (!acceptUTF8Block(&blocks, masks, offset)) {
+            break;
+        }
+    }
+    return finishUTF8Blocks(&blocks, offset, count);
+}
+
+/**
+ * Classifies the bytes of the given vector with signed comparisons, for which
+ * all bytes with the high bit set are negative and thus neither white space
+ * nor neutral.
+ */
+SIMD_TARGET("sse2")
+static inline WordBlockMasks classifyWordBytesSSE2(__m128i bytes) {
+    const __m128i control = _mm_and_si128(
+        _mm_cmpgt_epi8(bytes, _mm_set1_epi8('\t' - 1)),
+        _mm_cmpgt_epi8(_mm_set1_epi8('\r' + 1), bytes)
+    );
+    const __m128i space = _mm_or_si128(
+        control,
+        _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' '))
+    );
+    const __m128i neutral = _mm_cmpeq_epi8(bytes, _mm_setzero_si128());
+    return (WordBlockMasks){
+        .space = (uint16_t) _mm_movemask_epi8(space),
+        .neutral = (uint16_t) _mm_movemask_epi8(neutral)
+    };
+}
+
+SIMD_TARGET("sse2")
+static size_t countWordsSSE2(const char* text, size_t size, bool* inWord) {
+    size_t count = 0;
+    size_t offset = 0;
+    for (; size - offset >= SIMD_BLOCK_SIZE; offset += SIMD_BLOCK_SIZE) {
+        WordBlockMasks masks = {0};
+        for (size_t i = 0; i < SIMD_BLOCK_SIZE; i += sizeof(__m128i)) {
+            const WordBlockMasks part = classifyWordBytesSSE2(
+                _mm_loadu_si128((const __m128i*) (text + offset + i))
+            );
+            masks.space |= part.space << i;
+            masks.neutral |= part.neutral << i;
+        }
+        count += countWordBlock(text + offset, masks, inWord);
+    }
+    return count + countWordsScalar(text + offset, size - offset, inWord);
+}
+
+SIMD_TARGET("avx2")
+static inline WordBlockMasks classifyWordBytesAVX2(__m256i bytes) {
+    const __m256i control = _mm256_and_si256(
+        _mm256_cmpgt_epi8(bytes, _mm256_set1_epi8('\t' - 1)),
+        _mm256_cmpgt_epi8(_mm256_set1_epi8('\r' + 1), bytes)
+    );
+    const __m256i space = _mm256_or_si256(
+        control,
+        _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' '))
+    );
+    const __m256i neutral = _mm256_cmpeq_epi8(bytes, _mm256_setzero_si256());
+    return (WordBlockMasks){
+        .space = (uint32_t) _mm256_movemask_epi8(space),
+        .neutral = (uint32_t) _mm256_movemask_epi8(neutral)
+    };
+}
+
+SIMD_TARGET("avx2,popcnt")
+static size_t countWordsAVX2(const char* text, size_t size, bool* inWord) {
+    size_t count = 0;
+    size_t offset = 0;
+    for (; size - offset >= SIMD_BLOCK_SIZE; offset += SIMD_BLOCK_SIZE) {
+        const WordBlockMasks low = classifyWordBytesAVX2(
+            _mm256_loadu_si256((const __m256i*) (text + offset))
+        );
+        const WordBlockMasks high = classifyWordBytesAVX2(
+            _mm256_loadu_si256((const __m256i*) (text + offset + 32))
+        );
+        const WordBlockMasks masks = {
+            .space = low.space | (high.space << 32),
+            .neutral = low.neutral | (high.neutral << 32)
+        };
+        count += countWordBlock(text + offset, masks, inWord);
+    }
+    return count + countWordsScalar(text + offset, size - offset, inWord);
+}
+
+SIMD_TARGET("avx512f,avx512bw,popcnt")
+static size_t countWordsAVX512(const char* text, size_t size, bool* inWord) {
+    const __m512i belowTab = _mm512_set1_epi8('\t' - 1);
+    const __m512i aboveReturn = _mm512_set1_epi8('\r' + 1);
+    const __m512i blank = _mm512_set1_epi8(' ');
+    const __m512i zero = _mm512_setzero_si512();
+    size_t count = 0;
+    size_t offset = 0;
+    for (; size - offset >= SIMD_BLOCK_SIZE; offset += SIMD_BLOCK_SIZE) {
+        const __m512i bytes = _mm512_loadu_si512(
+            (const void*) (text + offset)
+        );
+        const __mmask64 control = (
+            _mm512_cmpgt_epi8_mask(bytes, belowTab)
+            & _mm512_cmpgt_epi8_mask(aboveReturn, bytes)
+        );
+        const WordBlockMasks masks = {
+            .space = control | _mm512_cmpeq_epi8_mask(bytes, blank),
+            .neutral = _mm512_cmpeq_epi8_mask(bytes, zero)
+        };
+        count += countWordBlock(text + offset, masks, inWord);
+    }
+    return count + countWordsScalar(text + offset, size - offset, inWord);
+}
+
+SIMD_TARGET("sse2")
+static size_t countCodeUnitSSE2(
+    const char* text,
+    size_t numUnits,
+    char byte0,
+    char byte1
+) {
+    const __m128i pattern = _mm_set1_epi16(
+        (short) ((unsigned char) byte0 | ((unsigned char) byte1 << 8))
+    );
+    const __m128i zero = _mm_setzero_si128();
+    const size_t size = 2 * numUnits;
+    __m128i totals = zero;
+    size_t offset = 0;
+    while (size - offset >= sizeof(__m128i)) {
+        size_t vectors = (size - offset) / sizeof(__m128i);
+        if (vectors > SIMD_MAX_LANE_SUMS) {
+            vectors = SIMD_MAX_LANE_SUMS;
+        }
+        __m128i sums = zero;
+        for (size_t i = 0; i < vectors; ++i) {
+            const __m128i chunk = _mm_loadu_si128(
+                (const __m128i*) (text + offset)
+            );
+            // Only the low byte of a sum can be non-zero
+            sums = _mm_sub_epi16(sums, _mm_cmpeq_epi16(chunk, pattern));
+            offset += sizeof(__m128i);
+        }
+        totals = _mm_add_epi64(totals, _mm_sad_epu8(sums, zero));
+    }
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i*) lanes, totals);
+    const size_t count = (size_t) (lanes[0] + lanes[1]);
+    return count + countCodeUnitScalar(
+        text + offset,
+        (size - offset) / 2,
+        byte0,
+        byte1
+    );
+}
+
+SIMD_TARGET("avx2")
+static size_t countCodeUnitAVX2(
+    const char* text,
+    size_t numUnits,
+    char byte0,
+    char byte1
+) {
+    const __m256i pattern = _mm256_set1_epi16(
+        (short) ((unsigned char) byte0 | ((unsigned char) byte1 << 8))
+    );
+    const __m256i zero = _mm256_setzero_si256();
+    const size_t size = 2 * numUnits;
+    __m256i totals = zero;
+    size_t offset = 0;
+    while (size - offset >= sizeof(__m256i)) {
+        size_t vectors = (size - offset) / sizeof(__m256i);
+        if (vectors > SIMD_MAX_LANE_SUMS) {
+            vectors = SIMD_MAX_LANE_SUMS;
+        }
+        __m256i sums = zero;
+        for (size_t i = 0; i < vectors; ++i) {
+            const __m256i chunk = _mm256_loadu_si256(
+                (const __m256i*) (text + offset)
+            );
+            sums = _mm256_sub_epi16(sums, _mm256_cmpeq_epi16(chunk, pattern));
+            offset += sizeof(__m256i);
+        }
+        totals = _mm256_add_epi64(totals, _mm256_sad_epu8(sums, zero));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i*) lanes, totals);
+    const size_t count = (size_t) (lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    return count + countCodeUnitScalar(
+        text + offset,
+        (size - offset) / 2,
+        byte0,
+        byte1
+    );
+}
+
+SIMD_TARGET("avx512f,avx512bw")
+static size_t countCodeUnitAVX512(
+    const char* text,
+    size_t numUnits,
+    char byte0,
+    char byte1
+) {
+    const __m512i pattern = _mm512_set1_epi16(
+        (short) ((unsigned char) byte0 | ((unsigned char) byte1 << 8))
+    );
+    const __m512i zero = _mm512_setzero_si512();
+    const size_t size = 2 * numUnits;
+    __m512i totals = zero;
+    size_t offset = 0;
+    while (size - offset >= sizeof(__m512i)) {
+        size_t vectors = (size - offset) / sizeof(__m512i);
+        if (vectors > SIMD_MAX_LANE_SUMS) {
+            vectors = SIMD_MAX_LANE_SUMS;
+        }
+        __m512i sums = zero;
+        for (size_t i = 0; i < vectors; ++i) {
+            const __m512i chunk = _mm512_loadu_si512(
+                (const void*) (text + offset)
+            );
+            const __mmask32 matches = _mm512_cmpeq_epi16_mask(chunk, pattern);
+            sums = _mm512_sub_epi16(sums, _mm512_movm_epi16(matches));
+            offset += sizeof(__m512i);
+        }
+        totals = _mm512_add_epi64(totals, _mm512_sad_epu8(sums, zero));
+    }
+    uint64_t lanes[8];
+    _mm512_storeu_si512((void*) lanes, totals);
+    size_t count = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        count += (size_t) lanes[i];
+    }
+    return count + countCodeUnitScalar(
+        text + offset,
+        (size - offset) / 2,
+        byte0,
+        byte1
+    );
+}
+
+/**
+ * Loads a vector of code units of UTF-16 text, with the bytes of each
+ * code unit swapped if the text is big-endian.
+ */
+SIMD_TARGET("sse2")
+static inline __m128i loadCodeUnitsSSE2(
+    const char* text,
+    bool isLittleEndian
+) {
+    const __m128i units = _mm_loadu_si128((const __m128i*) text);
+    if (isLittleEndian) {
+        return units;
+    }
+    return _mm_or_si128(_mm_slli_epi16(units, 8), _mm_srli_epi16(units, 8));
+}
+
+/**
+ * Classifies the given code units with signed comparisons, for which all
+ * code units outside of ASCII are negative or above the white space range.
+ * Returns the masks of 16-bit lanes.
+ */
+SIMD_TARGET("sse2")
+static inline __m128i maskUTF16SpaceSSE2(__m128i units) {
+    const __m128i control = _mm_and_si128(
+        _mm_cmpgt_epi16(units, _mm_set1_epi16('\t' - 1)),
+        _mm_cmpgt_epi16(_mm_set1_epi16('\r' + 1), units)
+    );
+    return _mm_or_si128(
+        control,
+        _mm_cmpeq_epi16(units, _mm_set1_epi16(' '))
+    );
+}
+
+SIMD_TARGET("sse2")
+static inline __m128i maskUTF16NeutralSSE2(__m128i units) {
+    const __m128i bom = _mm_or_si128(
+        _mm_cmpeq_epi16(units, _mm_set1_epi16((short) UTF16_BOM)),
+        _mm_cmpeq_epi16(units, _mm_set1_epi16((short) UTF16_SWAPPED_BOM))
+    );
+    return _mm_or_si128(
+        bom,
+        _mm_cmpeq_epi16(units, _mm_setzero_si128())
+    );
+}
+
+/**
+ * Computes the masks of 16-bit lanes of the high surrogates, the low
+ * surrogates and the byte order marks among the given code units.
+ */
+SIMD_TARGET("sse2")
+static inline void maskUTF16SSE2(__m128i units, __m128i lanes[3]) {
+    // Surrogates are in the range of -10240 to -8193 as signed values
+    const __m128i lowStart = _mm_set1_epi16(-9216);
+    lanes[0] = _mm_and_si128(
+        _mm_cmpgt_epi16(units, _mm_set1_epi16(-10241)),
+        _mm_cmpgt_epi16(lowStart, units)
+    );
+    lanes[1] = _mm_and_si128(
+        _mm_cmpgt_epi16(units, _mm_set1_epi16(-9217)),
+        _mm_cmpgt_epi16(_mm_set1_epi16(-8192), units)
+    );
+    lanes[2] = _mm_or_si128(
+        _mm_cmpeq_epi16(units, _mm_set1_epi16((short) UTF16_BOM)),
+        _mm_cmpeq_epi16(units, _mm_set1_epi16((short) UTF16_SWAPPED_BOM))
+    );
+}
+
+/**
+ * Packs two masks of 16-bit lanes into the bits of a 16-bit mask.
+ */
+SIMD_TARGET("sse2")
+static inline uint64_t packMasksSSE2(__m128i first, __m128i second) {
+    return (uint16_t) _mm_movemask_epi8(_mm_packs_epi16(first, second));
+}
+
+SIMD_TARGET("sse2")
+static inline size_t countUTF16WordsSSE2(
+    const char* text,
+    size_t numUnits,
+    bool* inWord,
+    bool isLittleEndian
+) {
+    const size_t size = 2 * numUnits;
+    size_t count = 0;
+    size_t offset = 0;
+    for (; size - offset >= SIMD_BLOCK_SIZE; offset += SIMD_BLOCK_SIZE) {
+        WordBlockMasks masks = {0};
+        for (size_t i = 0; i < SIMD_BLOCK_SIZE; i += 2 * sizeof(__m128i)) {
+            const __m128i first = loadCodeUnitsSSE2(
+                text + offset + i,
+                isLittleEndian
+            );
+            const __m128i second = loadCodeUnitsSSE2(
+                text + offset + i + sizeof(__m128i),
+                isLittleEndian
+            );
+            masks.space |= packMasksSSE2(
+                maskUTF16SpaceSSE2(first),
+                maskUTF16SpaceSSE2(second)
+            ) << (i / 2);
+            masks.neutral |= packMasksSSE2(
+                maskUTF16NeutralSSE2(first),
+                maskUTF16NeutralSSE2(second)
+            ) << (i / 2);
+        }
+        count += countUTF16WordBlock(
+            text + offset,
+            masks,
+            inWord,
+            isLittleEndian
+        );
+    }
+    return count + countUTF16WordsFrom(
+        text + offset,
+        (size - offset) / 2,
+        inWord,
+        isLittleEndian
+    );
+}
+
+SIMD_TARGET("sse2")
+static inline size_t countUTF16SSE2(
+    const char* text,
+    size_t numUnits,
+    bool isLittleEndian
+) {
+    const size_t size = 2 * numUnits;
+    bool afterHigh = false;
+    size_t count = 0;
+    size_t offset = 0;
+    for (; size - offset >= SIMD_BLOCK_SIZE; offset += SIMD_BLOCK_SIZE) {
+        UTF16BlockMasks masks = {0};
+        for (size_t i = 0; i < SIMD_BLOCK_SIZE; i += 2 * sizeof(__m128i)) {
+            __m128i first[3];
+            __m128i second[3];
+            maskUTF16SSE2(
+                loadCodeUnitsSSE2(text + offset + i, isLittleEndian),
+                first
+            );
+            maskUTF16SSE2(
+                loadCodeUnitsSSE2(
+                    text + offset + i + sizeof(__m128i),
+                    isLittleEndian
+                ),
+                second
+            );
+            masks.high |= packMasksSSE2(first[0], second[0]) << (i / 2);
+            masks.low |= packMasksSSE2(first[1], second[1]) << (i / 2);
+            masks.ignored |= packMasksSSE2(first[2], second[2]) << (i / 2);
+        }
+        count += countUTF16Block(masks, &afterHigh);
+    }
+    return count + countUTF16From(
+        text + offset,
+        (size - offset) / 2,
+        afterHigh,
+        isLittleEndian
+    );
+}
+
+SIMD_TARGET("avx2")
+static inline __m256i loadCodeUnitsAVX2(
+    const char* text,
+    bool isLittleEndian
+) {
+    const __m256i units = _mm256_loadu_si256((const __m256i*) text);
+    if (isLittleEndian) {
+        return units;
+    }
+    return _mm256_or_si256(
+        _mm256_slli_epi16(units, 8),
+        _mm256_srli_epi16(units, 8)
+    );
+}
+
+SIMD_TARGET("avx2")
+static inline __m256i maskUTF16SpaceAVX2(__m256i units) {
+    const __m256i control = _mm256_and_si256(
+        _mm256_cmpgt_epi16(units, _mm256_set1_epi16('\t' - 1)),
+        _mm256_cmpgt_epi16(_mm256_set1_epi16('\r' + 1), units)
+    );
+    return _mm256_or_si256(
+        control,
+        _mm256_cmpeq_epi16(units, _mm256_set1_epi16(' '))
+    );
+}
+
+SIMD_TARGET("avx2")
+static inline __m256i maskUTF16NeutralAVX2(__m256i units) {
+    const __m256i bom = _mm256_or_si256(
+        _mm256_cmpeq_epi16(units, _mm256_set1_epi16((short) UTF16_BOM)),
+        _mm256_cmpeq_epi16(
+            units,
+            _mm256_set1_epi16((short) UTF16_SWAPPED_BOM)
+        )
+    );
+    return _mm256_or_si256(
+        bom,
+        _mm256_cmpeq_epi16(units, _mm256_setzero_si256())
+    );
+}
+
+SIMD_TARGET("avx2")
+static inline void maskUTF16AVX2(__m256i units, __m256i lanes[3]) {
+    const __m256i lowStart = _mm256_set1_epi16(-9216);
+    lanes[0] = _mm256_and_si256(
+        _mm256_cmpgt_epi16(units, _mm256_set1_epi16(-10241)),
+        _mm256_cmpgt_epi16(lowStart, units)
+    );
+    lanes[1] = _mm256_and_si256(
+        _mm256_cmpgt_epi16(units, _mm256_set1_epi16(-9217)),
+        _mm256_cmpgt_epi16(_mm256_set1_epi16(-8192), units)
+    );
+    lanes[2] = _mm256_or_si256(
+        _mm256_cmpeq_epi16(units, _mm256_set1_epi16((short) UTF16_BOM)),
+        _mm256_cmpeq_epi16(
+            units,
+            _mm256_set1_epi16((short) UTF16_SWAPPED_BOM)
+        )
+    );
+}
+
+/**
+ * Packs two masks of 16-bit lanes into the bits of a 32-bit mask. Packing
+ * interleaves the 128-bit halves of both masks, which are then reordered.
+ */
+SIMD_TARGET("avx2")
+static inline uint64_t packMasksAVX2(__m256i first, __m256i second) {
+    const __m256i packed = _mm256_permute4x64_epi64(
+        _mm256_packs_epi16(first, second),
+        0xD8
+    );
+    return (uint32_t) _mm256_movemask_epi8(packed);
+}
+
+SIMD_TARGET("avx2,popcnt")
+static inline size_t countUTF16WordsAVX2(
+    const char* text,
+    size_t numUnits,
+    bool* inWord,
+    bool isLittleEndian
+) {
+    const size_t size = 2 * numUnits;
+    size_t count = 0;
+    size_t offset = 0;
+    for (; size - offset >= SIMD_BLOCK_SIZE; offset += SIMD_BLOCK_SIZE) {
+        const __m256i first = loadCodeUnitsAVX2(
+            text + offset,
+            isLittleEndian
+        );
+        const __m256i second = loadCodeUnitsAVX2(
+            text + offset + sizeof(__m256i),
+            isLittleEndian
+        );
+        const WordBlockMasks masks = {
+            .space = packMasksAVX2(
+                maskUTF16SpaceAVX2(first),
+                maskUTF16SpaceAVX2(second)
+            ),
+            .neutral = packMasksAVX2(
+                maskUTF16NeutralAVX2(first),
+                maskUTF16NeutralAVX2(second)
+            )
+        };
+        count += countUTF16WordBlock(
+            text + offset,
+            masks,
+            inWord,
+            isLittleEndian
+        );
+    }
+    return count + countUTF16WordsFrom(
+        text + offset,
+        (size - offset) / 2,
+        inWord,
+        isLittleEndian
+    );
+}
+
+SIMD_TARGET("avx2,popcnt")
+static inline size_t countUTF16AVX2(
+    const char* text,
+    size_t numUnits,
+    bool isLittleEndian
+) {
+    const size_t size = 2 * numUnits;
+    bool afterHigh = false;
+    size_t count = 0;
+    size_t offset = 0;
+    for (; size - offset >= SIMD_BLOCK_SIZE; offset += SIMD_BLOCK_SIZE) {
+        __m256i first[3];
+        __m256i second[3];
+        maskUTF16AVX2(loadCodeUnitsAVX2(text + offset, isLittleEndian), first);
+        maskUTF16AVX2(
+            loadCodeUnitsAVX2(text + offset + sizeof(__m256i), isLittleEndian),
+            second
+        );
+        const UTF16BlockMasks masks = {
+            .high = packMasksAVX2(first[0], second[0]),
+            .low = packMasksAVX2(first[1], second[1]),
+            .ignored = packMasksAVX2(first[2], second[2])
+        };
+        count += countUTF16Block(masks, &afterHigh);
+    }
+    return count + countUTF16From(
+        text + offset,
+        (size - offset) / 2,
+        afterHigh,
+        isLittleEndian
+    );
+}
+
+SIMD_TARGET("avx512f,avx512bw")
+static inline __m512i loadCodeUnitsAVX512(
+    const char* text,
+    bool isLittleEndian
+) {
+    const __m512i units = _mm512_loadu_si512((const void*) text);
+    if (isLittleEndian) {
+        return units;
+    }
+    return _mm512_or_si512(
+        _mm512_slli_epi16(units, 8),
+        _mm512_srli_epi16(units, 8)
+    );
+}
+
+SIMD_TARGET("avx512f,avx512bw,popcnt")
+static inline size_t countUTF16WordsAVX512(
+    const char* text,
+    size_t numUnits,
+    bool* inWord,
+    bool isLittleEndian
+) {
+    const __m512i belowTab = _mm512_set1_epi16('\t' - 1);
+    const __m512i aboveReturn = _mm512_set1_epi16('\r' + 1);
+    const __m512i blank = _mm512_set1_epi16(' ');
+    const __m512i bom = _mm512_set1_epi16((short) UTF16_BOM);
+    const __m512i swappedBom = _mm512_set1_epi16((short) UTF16_SWAPPED_BOM);
+    const __m512i zero = _mm512_setzero_si512();
+    const size_t size = 2 * numUnits;
+    size_t count = 0;
+    size_t offset = 0;
+    for (; size - offset >= SIMD_BLOCK_SIZE; offset += SIMD_BLOCK_SIZE) {
+        const __m512i units = loadCodeUnitsAVX512(
+            text + offset,
+            isLittleEndian
+        );
+        const __mmask32 control = (
+            _mm512_cmpgt_epi16_mask(units, belowTab)
+            & _mm512_cmpgt_epi16_mask(aboveReturn, units)
+        );
+        const WordBlockMasks masks = {
+            .space = control | _mm512_cmpeq_epi16_mask(units, blank),
+            .neutral = (
+                _mm512_cmpeq_epi16_mask(units, zero)
+                | _mm512_cmpeq_epi16_mask(units, bom)
+                | _mm512_cmpeq_epi16_mask(units, swappedBom)
+            )
+        };
+        count += countUTF16WordBlock(
+            text + offset,
+            masks,
+            inWord,
+            isLittleEndian
+        );
+    }
+    return count + countUTF16WordsFrom(
+        text + offset,
+        (size - offset) / 2,
+        inWord,
+        isLittleEndian
+    );
+}
+
+SIMD_TARGET("avx512f,avx512bw,popcnt")
+static inline size_t countUTF16AVX512(
+    const char* text,
+    size_t numUnits,
+    bool isLittleEndian
+) {
+    const __m512i belowHigh = _mm512_set1_epi16(-10241);
+    const __m512i lowStart = _mm512_set1_epi16(-9216);
+    const __m512i belowLow = _mm512_set1_epi16(-9217);
+    const __m512i aboveLow = _mm512_set1_epi16(-8192);
+    const __m512i bom = _mm512_set1_epi16((short) UTF16_BOM);
+    const __m512i swappedBom = _mm512_set1_epi16((short) UTF16_SWAPPED_BOM);
+    const size_t size = 2 * numUnits;
+    bool afterHigh = false;
+    size_t count = 0;
+    size_t offset = 0;
+    for (; size - offset >= SIMD_BLOCK_SIZE; offset += SIMD_BLOCK_SIZE) {
+        const __m512i units = loadCodeUnitsAVX512(
+            text + offset,
+            isLittleEndian
+        );
+        const UTF16BlockMasks masks = {
+            .high = (
+                _mm512_cmpgt_epi16_mask(units, belowHigh)
+                & _mm512_cmpgt_epi16_mask(lowStart, units)
+            ),
+            .low = (
+                _mm512_cmpgt_epi16_mask(units, belowLow)
+                & _mm512_cmpgt_epi16_mask(aboveLow, units)
+            ),
+            .ignored = (
+                _mm512_cmpeq_epi16_mask(units, bom)
+                | _mm512_cmpeq_epi16_mask(units, swappedBom)
+            )
+        };
+        count += countUTF16Block(masks, &afterHigh);
+    }
+    return count + countUTF16From(
+        text + offset,
+        (size - offset) / 2,
+        afterHigh,
+        isLittleEndian
+    );
+}
+
+/**
+ * Transcodes the given UTF-16 text to UTF-8. Blocks of code units which are
+ * all within ASCII are narrowed to bytes with vector instructions. All other
+ * blocks and the remainder of the text are transcoded one code unit at
+ * a time.
+ */
+SIMD_TARGET("sse2")
+static inline bool transcodeUTF16SSE2(
+    const char* text,
+    size_t numUnits,
+    char* out,
+    size_t* size,
+    bool isLittleEndian
+) {
+    const size_t blockUnits = sizeof(__m128i);
+    const __m128i nonASCII = _mm_set1_epi16((short) NON_ASCII_UNIT_BITS);
+    const __m128i zero = _mm_setzero_si128();
+    size_t position = 0;
+    char* end = out;
+    bool ok = true;
+    while (ok && numUnits - position >= blockUnits) {
+        const char* block = text + (2 * position);
+        const __m128i first = loadCodeUnitsSSE2(block, isLittleEndian);
+        const __m128i second = loadCodeUnitsSSE2(
+            block + sizeof(__m128i),
+            isLittleEndian
+        );
+        const __m128i outside = _mm_and_si128(
+            _mm_or_si128(first, second),
+            nonASCII
+        );
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(outside, zero)) == 0xFFFF) {
+            _mm_storeu_si128((__m128i*) end, _mm_packus_epi16(first, second));
+            end += blockUnits;
+            position += blockUnits;
+        } else {
+            ok = transcodeUTF16From(
+                text,
+                numUnits,
+                &position,
+                position + blockUnits,
+                &end,
+                isLittleEndian
+            );
+        }
+    }
+    if (ok) {
+        ok = transcodeUTF16From(
+            text,
+            numUnits,
+            &position,
+            numUnits,
+            &end,
+            isLittleEndian
+        );
+    }
+    *size = (size_t) (end - out);
+    return ok;
+}
+
+SIMD_TARGET("avx2")
+static inline bool transcodeUTF16AVX2(
+    const char* text,
+    size_t numUnits,
+    char* out,
+    size_t* size,
+    bool isLittleEndian
+) {
+    const size_t blockUnits = sizeof(__m256i);
+    const __m256i nonASCII = _mm256_set1_epi16((short) NON_ASCII_UNIT_BITS);
+    size_t position = 0;
+    char* end = out;
+    bool ok = true;
+    while (ok && numUnits - position >= blockUnits) {
+        const char* block = text + (2 * position);
+        const __m256i first = loadCodeUnitsAVX2(block, isLittleEndian);
+        const __m256i second = loadCodeUnitsAVX2(
+            block + sizeof(__m256i),
+            isLittleEndian
+        );
+        if (_mm256_testz_si256(_mm256_or_si256(first, second), nonASCII)) {
+            // Packing interleaves the 128-bit lanes of both vectors
+            const __m256i bytes = _mm256_permute4x64_epi64(
+                _mm256_packus_epi16(first, second),
+                0xD8
+            );
+            _mm256_storeu_si256((__m256i*) end, bytes);
+            end += blockUnits;
+            position += blockUnits;
+        } else {
+            ok = transcodeUTF16From(
+                text,
+                numUnits,
+                &position,
+                position + blockUnits,
+                &end,
+                isLittleEndian
+            );
+        }
+    }
+    if (ok) {
+        ok = transcodeUTF16From(
+            text,
+            numUnits,
+            &position,
+            numUnits,
+            &end,
+            isLittleEndian
+        );
+    }
+    *size = (size_t) (end - out);
+    return ok;
+}
+
+SIMD_TARGET("avx512f,avx512bw")
+static inline bool transcodeUTF16AVX512(
+    const char* text,
+    size_t numUnits,
+    char* out,
+    size_t* size,
+    bool isLittleEndian
+) {
+    const __m512i nonASCII = _mm512_set1_epi16((short) NON_ASCII_UNIT_BITS);
+    size_t position = 0;
+    char* end = out;
+    bool ok = true;
+    while (ok && numUnits - position >= UTF16_BLOCK_UNITS) {
+        const __m512i units = loadCodeUnitsAVX512(
+            text + (2 * position),
+            isLittleEndian
+        );
+        if (_mm512_test_epi16_mask(units, nonASCII) == 0) {
+            _mm256_storeu_si256((__m256i*) end, _mm512_cvtepi16_epi8(units));
+            end += UTF16_BLOCK_UNITS;
+            position += UTF16_BLOCK_UNITS;
+        } else {
+            ok = transcodeUTF16From(
+                text,
+                numUnits,
+                &position,
+                position + UTF16_BLOCK_UNITS,
+                &end,
+                isLittleEndian
+            );
+        }
+    }
+    if (ok) {
+        ok = transcodeUTF16From(
+            text,
+            numUnits,
+            &position,
+            numUnits,
+            &end,
+            isLittleEndian
+        );
+    }
+    *size = (size_t) (end - out);
+    return ok;
+}
+
+static size_t countUTF16LEWordsSSE2(
+    const char* text,
+    size_t numUnits,
+    bool* inWord
+) {
+    return countUTF16WordsSSE2(text, numUnits, inWord, true);
+}
+
+static size_t countUTF16BEWordsSSE2(
+    const char* text,
+    size_t numUnits,
+    bool* inWord
+) {
+    return countUTF16WordsSSE2(text, numUnits, inWord, false);
+}
+
+static size_t countUTF16LEWordsAVX2(
+    const char* text,
+    size_t numUnits,
+    bool* inWord
+) {
+    return countUTF16WordsAVX2(text, numUnits, inWord, true);
+}
+
+static size_t countUTF16BEWordsAVX2(
+    const char* text,
+    size_t numUnits,
+    bool* inWord
+) {
+    return countUTF16WordsAVX2(text, numUnits, inWord, false);
+}
+
+static size_t countUTF16LEWordsAVX512(
+    const char* text,
+    size_t numUnits,
+    bool* inWord
+) {
+    return countUTF16WordsAVX512(text, numUnits, inWord, true);
+}
+
+static size_t countUTF16BEWordsAVX512(
+    const char* text,
+    size_t numUnits,
+    bool* inWord
+) {
+    return countUTF16WordsAVX512(text, numUnits, inWord, false);
+}
+
+static size_t countUTF16LESSE2(const char* text, size_t numUnits) {
+    return countUTF16SSE2(text, numUnits, true);
+}
+
+static size_t countUTF16BESSE2(const char* text, size_t numUnits) {
+    return countUTF16SSE2(text, numUnits, false);
+}
+
+static size_t countUTF16LEAVX2(const char* text, size_t numUnits) {
+    return countUTF16AVX2(text, numUnits, true);
+}
+
+static size_t countUTF16BEAVX2(const char* text, size_t numUnits) {
+    return countUTF16AVX2(text, numUnits, false);
+}
+
+static size_t countUTF16LEAVX512(const char* text, size_t numUnits) {
+    return countUTF16AVX512(text, numUnits, true);
+}
+
+static size_t countUTF16BEAVX512(const char* text, size_t numUnits) {
+    return countUTF16AVX512(text, numUnits, false);
+}
+
+static bool transcodeUTF16LESSE2(
+    const char* text,
+    size_t numUnits,
+    char* out,
+    size_t* size
+) {
+    return transcodeUTF16SSE2(text, numUnits, out, size, true);
+}
+
+static bool transcodeUTF16BESSE2(
+    const char* text,
+    size_t numUnits,
+    char* out,
+    size_t* size
+) {
+    return transcodeUTF16SSE2(text, numUnits, out, size, false);
+}
+
+static bool transcodeUTF16LEAVX2(
+    const char* text,
+    size_t numUnits,
+    char* out,
+    size_t* size
+) {
+    return transcodeUTF16AVX2(text, numUnits, out, size, true);
+}
+
+static bool transcodeUTF16BEAVX2(
+    const char* text,
+    size_t numUnits,
+    char* out,
+    size_t* size
+) {
+    return transcodeUTF16AVX2(text, numUnits, out, size, false);
+}
+
+static bool transcodeUTF16LEAVX512(
+    const char* text,
+    size_t numUnits,
+    char* out,
+    size_t* size
+) {
+    return transcodeUTF16AVX512(text, numUnits, out, size, true);
+}
+
+static bool transcodeUTF16BEAVX512(
+    const char* text,
+    size_t numUnits,
+    char* out,
+    size_t* size
+) {
+    return transcodeUTF16AVX512(text, numUnits, out, size, false);
+}
+
+static size_t countUTF8SSE2(const char* text, size_t size, size_t* count) {
+    return countUTF8Blocks(text, size, count, countUTF8BlocksSSE2);
+}
+
+static size_t countUTF8AVX2(const char* text, size_t size, size_t* count) {
+    return countUTF8Blocks(text, size, count, countUTF8BlocksAVX2);
+}
+
+static size_t countUTF8AVX512(const char* text, size_t size, size_t* count) {
+    return countUTF8Blocks(text, size, count, countUTF8BlocksAVX512);
+}
+
+#endif // SIMD_X86
+
+#if SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+
+static SimdLevel detectSimdLevel(void) {
+    __builtin_cpu_init();
+    // The checks include whether the OS saves the state of the registers
+    if (__builtin_cpu_supports("avx512bw")) {
+        return SimdLevelAVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevelAVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return SimdLevelSSE2;
+    }
+    return SimdLevelPortable; // LCOV_EXCL_LINE
+}
+
+#elif SIMD_X86 && defined(_MSC_VER)
+
+static SimdLevel detectSimdLevel(void) {
+    enum {
+        CPUID_SSE2_BIT = 26,
+        CPUID_OSXSAVE_BIT = 27,
+        CPUID_AVX_BIT = 28,
+        CPUID_AVX2_BIT = 5,
+        CPUID_AVX512F_BIT = 16,
+        CPUID_AVX512BW_BIT = 30
+    };
+    // The register states enabled by the OS: SSE and AVX, as well
+    // as additionally the opmask and upper ZMM registers
+    const unsigned long long XCR0_AVX_STATE = 0x06ULL;
+    const unsigned long long XCR0_AVX512_STATE = 0xE6ULL;
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    if ((info[3] & (1 << CPUID_SSE2_BIT)) == 0) {
+        return SimdLevelPortable;
+    }
+    const bool hasAVX = (
+        (info[2] & (1 << CPUID_OSXSAVE_BIT)) != 0
+        && (info[2] & (1 << CPUID_AVX_BIT)) != 0
+    );
+    if (!hasAVX || maxLeaf < 7) {
+        return SimdLevelSSE2;
+    }
+    const unsigned long long xcr0 = _xgetbv(0);
+    if ((xcr0 & XCR0_AVX_STATE) != XCR0_AVX_STATE) {
+        return SimdLevelSSE2;
+    }
+    __cpuidex(info, 7, 0);
+    const bool hasAVX512 = (
+        (info[1] & (1 << CPUID_AVX512F_BIT)) != 0
+        && (info[1] & (1 << CPUID_AVX512BW_BIT)) != 0
+        && (xcr0 & XCR0_AVX512_STATE) == XCR0_AVX512_STATE
+    );
+    if (hasAVX512) {
+        return SimdLevelAVX512;
+    }
+    if ((info[1] & (1 << CPUID_AVX2_BIT)) != 0) {
+        return SimdLevelAVX2;
+    }
+    return SimdLevelSSE2;
+}
+
+#else
+
+static SimdLevel detectSimdLevel(void) {
+    return SimdLevelPortable;
+}
+
+#endif // Compiler-specific CPU detection
+
+static const ByteCountKernel BYTE_COUNT_KERNELS[SIMD_NUM_LEVELS] = {
+    countByteScalar,
+    countBytePortable,
+#if SIMD_X86
+    countByteSSE2,
+    countByteAVX2,
+    countByteAVX512
+#else
+    NULL,
+    NULL,
+    NULL
+#endif
+};
+
+static const ControlByteCountKernel CONTROL_BYTE_COUNT_KERNELS[
+    SIMD_NUM_LEVELS
+] = {
+    countControlBytesScalar,
+    countControlBytesPortable,
+#if SIMD_X86
+    countControlBytesSSE2,
+    countControlBytesAVX2,
+    countControlBytesAVX512
+#else
+    NULL,
+    NULL,
+    NULL
+#endif
+};
+
+static const UTF8CountKernel UTF8_COUNT_KERNELS[SIMD_NUM_LEVELS] = {
+    countUTF8Scalar,
+    countUTF8Portable,
+#if SIMD_X86
+    countUTF8SSE2,
+    countUTF8AVX2,
+    countUTF8AVX512
+#else
+    NULL,
+    NULL,
+    NULL
+#endif
+};
+
+static const WordCountKernel WORD_COUNT_KERNELS[SIMD_NUM_LEVELS] = {
+    countWordsScalar,
+    countWordsPortable,
+#if SIMD_X86
+    countWordsSSE2,
+    countWordsAVX2,
+    countWordsAVX512
+#else
+    NULL,
+    NULL,
+    NULL
+#endif
+};
+
+static const CodeUnitCountKernel CODE_UNIT_COUNT_KERNELS[SIMD_NUM_LEVELS] = {
+    countCodeUnitScalar,
+    countCodeUnitPortable,
+#if SIMD_X86
+    countCodeUnitSSE2,
+    countCodeUnitAVX2,
+    countCodeUnitAVX512
+#else
+    NULL,
+    NULL,
+    NULL
+#endif
+};
+
+// The portable variants of the UTF-16 kernels are the scalar ones, since
+// code units are not classified faster within machine words
+
+static const UTF16WordCountKernel UTF16LE_WORD_KERNELS[SIMD_NUM_LEVELS] = {
+    countUTF16LEWordsScalar,
+    countUTF16LEWordsScalar,
+#if SIMD_X86
+    countUTF16LEWordsSSE2,
+    countUTF16LEWordsAVX2,
+    countUTF16LEWordsAVX512
+#else
+    NULL,
+    NULL,
+    NULL
+#endif
+};
+
+static const UTF16WordCountKernel UTF16BE_WORD_KERNELS[SIMD_NUM_LEVELS] = {
+    countUTF16BEWordsScalar,
+    countUTF16BEWordsScalar,
+#if SIMD_X86
+    countUTF16BEWordsSSE2,
+    countUTF16BEWordsAVX2,
+    countUTF16BEWordsAVX512
+#else
+    NULL,
+    NULL,
+    NULL
+#endif
+};
+
+static const UTF16CountKernel UTF16LE_COUNT_KERNELS[SIMD_NUM_LEVELS] = {
+    countUTF16LEScalar,
+    countUTF16LEScalar,
+#if SIMD_X86
+    countUTF16LESSE2,
+    countUTF16LEAVX2,
+    countUTF16LEAVX512
+#else
+    NULL,
+    NULL,
+    NULL
+#endif
+};
+
+static const UTF16CountKernel UTF16BE_COUNT_KERNELS[SIMD_NUM_LEVELS] = {
+    countUTF16BEScalar,
+    countUTF16BEScalar,
+#if SIMD_X86
+    countUTF16BESSE2,
+    countUTF16BEAVX2,
+    countUTF16BEAVX512
+#else
+    NULL,
+    NULL,
+    NULL
+#endif
+};
+
+static const UTF16TranscodeKernel UTF16LE_TRANSCODERS[SIMD_NUM_LEVELS] = {
+    transcodeUTF16LEScalar,
+    transcodeUTF16LEScalar,
+#if SIMD_X86
+    transcodeUTF16LESSE2,
+    transcodeUTF16LEAVX2,
+    transcodeUTF16LEAVX512
+#else
+    NULL,
+    NULL,
+    NULL
+#endif
+};
+
+static const UTF16TranscodeKernel UTF16BE_TRANSCODERS[SIMD_NUM_LEVELS] = {
+    transcodeUTF16BEScalar,
+    transcodeUTF16BEScalar,
+#if SIMD_X86
+    transcodeUTF16BESSE2,
+    transcodeUTF16BEAVX2,
+    transcodeUTF16BEAVX512
+#else
+    NULL,
+    NULL,
+    NULL
+#endif
+};
+
+SimdLevel getSimdLevel(void) {
+    size_t level = atomicLoad(&detectedSimdLevel);
+    if (level == SIZE_MAX) {
+        // Concurrent first calls all detect the same level
+        level = (size_t) detectSimdLevel();
+        atomicStoreMin(&detectedSimdLevel, level);
+    }
+    return (SimdLevel) level;
+}
+
+ByteCountKernel getByteCountKernel(SimdLevel level) {
+    if (level > getSimdLevel()) {
+        return NULL;
+    }
+    return BYTE_COUNT_KERNELS[level];
+}
+
+size_t countByte(const char* text, size_t size, char byte) {
+    return BYTE_COUNT_KERNELS[getSimdLevel()](text, size, byte);
+}
+
+ControlByteCountKernel getControlByteCountKernel(SimdLevel level) {
+    if (level > getSimdLevel()) {
+        return NULL;
+    }
+    return CONTROL_BYTE_COUNT_KERNELS[level];
+}
+
+size_t countControlBytes(const char* text, size_t size) {
+    return CONTROL_BYTE_COUNT_KERNELS[getSimdLevel()](text, size);
+}
+
+UTF8CountKernel getUTF8CountKernel(SimdLevel level) {
+    if (level > getSimdLevel()) {
+        return NULL;
+    }
+    return UTF8_COUNT_KERNELS[level];
+}
+
+size_t countUTF8Sequences(const char* text, size_t size, size_t* count) {
+    return UTF8_COUNT_KERNELS[getSimdLevel()](text, size, count);
+}
+
+WordCountKernel getWordCountKernel(SimdLevel level) {
+    if (level > getSimdLevel()) {
+        return NULL;
+    }
+    return WORD_COUNT_KERNELS[level];
+}
+
+size_t countWordStarts(const char* text, size_t size, bool* inWord) {
+    return WORD_COUNT_KERNELS[getSimdLevel()](text, size, inWord);
+}
+
+CodeUnitCountKernel getCodeUnitCountKernel(SimdLevel level) {
+    if (level > getSimdLevel()) {
+        return NULL;
+    }
+    return CODE_UNIT_COUNT_KERNELS[level];
+}
+
+size_t countCodeUnit(
+    const char* text,
+    size_t numUnits,
+    char byte0,
+    char byte1
+) {
+    return CODE_UNIT_COUNT_KERNELS[getSimdLevel()](
+        text,
+        numUnits,
+        byte0,
+        byte1
+    );
+}
+
+UTF16WordCountKernel getUTF16WordCountKernel(
+    SimdLevel level,
+    bool isLittleEndian
+) {
+    if (level > getSimdLevel()) {
+        return NULL;
+    }
+    return (
+        isLittleEndian
+        ? UTF16LE_WORD_KERNELS[level]
+        : UTF16BE_WORD_KERNELS[level]
+    );
+}
+
+size_t countUTF16WordStarts(
+    const char* text,
+    size_t numUnits,
+    bool* inWord,
+    bool isLittleEndian
+) {
+    const SimdLevel level = getSimdLevel();
+    return (
+        isLittleEndian
+        ? UTF16LE_WORD_KERNELS[level](text, numUnits, inWord)
+        : UTF16BE_WORD_KERNELS[level](text, numUnits, inWord)
+    );
+}
+
+UTF16CountKernel getUTF16CountKernel(SimdLevel level, bool isLittleEndian) {
+    if (level > getSimdLevel()) {
+        return NULL;
+    }
+    return (
+        isLittleEndian
+        ? UTF16LE_COUNT_KERNELS[level]
+        : UTF16BE_COUNT_KERNELS[level]
+    );
+}
+
+size_t countUTF16Characters(
+    const char* text,
+    size_t numUnits,
+    bool isLittleEndian
+) {
+    const SimdLevel level = getSimdLevel();
+    return (
+        isLittleEndian
+        ? UTF16LE_COUNT_KERNELS[level](text, numUnits)
+        : UTF16BE_COUNT_KERNELS[level](text, numUnits)
+    );
+}
+
+UTF16TranscodeKernel getUTF16TranscodeKernel(
+    SimdLevel level,
+    bool isLittleEndian
+) {
+    if (level > getSimdLevel()) {
+        return NULL;
+    }
+    return (
+        isLittleEndian
+        ? UTF16LE_TRANSCODERS[level]
+        : UTF16BE_TRANSCODERS[level]
+    );
+}
+
+bool transcodeUTF16(
+    const char* text,
+    size_t numUnits,
+    char* out,
+    size_t* size,
+    bool isLittleEndian
+) {
+    const SimdLevel level = getSimdLevel();
+    return (
+        isLittleEndian
+        ? UTF16LE_TRANSCODERS[level](text, numUnits, out, size)
+        : UTF16BE_TRANSCODERS[level](text, numUnits, out, size)
+    );
+}
@@ -0,0 +1,292 @@
+/*
+ * Copyright (C) 2026 Raven Computing
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Vectorized kernels for scanning source text.
+ *
+ * Each kernel has one variant per level of instruction set extensions. The
+ * scalar variant processes one byte at a time and is the reference which all
+ * other variants must agree with. The portable variant processes machine words
+ * and is available on all platforms. The other variants are only available on
+ * x86 platforms. The best level supported by the executing CPU is detected once
+ * and the dispatching functions declared here use the variants of that level.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The levels of instruction set extensions used by kernel variants,
+ * in ascending order of their vector width.
+ */
+typedef enum SimdLevel {
+    SimdLevelScalar,
+    SimdLevelPortable,
+    SimdLevelSSE2,
+    SimdLevelAVX2,
+    SimdLevelAVX512
+} SimdLevel;
+
+/**
+ * The number of defined `SimdLevel` values.
+ */
+enum { SIMD_NUM_LEVELS = SimdLevelAVX512 + 1 };
+
+/**
+ * Function pointer type for the variants of the kernel which counts the
+ * occurrences of the given byte in a text of the specified size.
+ */
+typedef size_t (*ByteCountKernel)(const char* text, size_t size, char byte);
+
+/**
+ * Function pointer type for the variants of the kernel which counts the
+ * control bytes in a text of the specified size. Control bytes are the C0
+ * control characters except the white space characters of the "C" locale
+ * and the escape character, i.e. the ones which do not usually occur in text.
+ */
+typedef size_t (*ControlByteCountKernel)(const char* text, size_t size);
+
+/**
+ * Function pointer type for the variants of the kernel which counts the
+ * characters of a UTF-8 encoded text of the specified size.
+ * 
+ * The text is decoded sequence by sequence, whereby the length of each
+ * sequence is solely determined by its lead byte. Continuation bytes are not
+ * validated and bytes which are not valid lead bytes form a sequence of their
+ * own. Counting stops before the first sequence which is truncated by the end
+ * of the text. The number of counted characters is added to `count` and the
+ * number of bytes of all counted sequences is returned.
+ */
+typedef size_t (*UTF8CountKernel)(
+    const char* text,
+    size_t size,
+    size_t* count
+);
+
+/**
+ * Function pointer type for the variants of the kernel which counts the
+ * words starting in a text of the specified size.
+ * 
+ * Words are delimited by the white space bytes of `isspace()` in the "C"
+ * locale, independent of the current locale. Null bytes neither start nor
+ * end a word. Whether the text continues a word of a preceding text is given
+ * by `inWord`, which is updated to whether the text ends within a word.
+ * Returns the number of words starting in the text.
+ */
+typedef size_t (*WordCountKernel)(const char* text, size_t size, bool* inWord);
+
+/**
+ * Function pointer type for the variants of the kernel which counts the
+ * code units of a UTF-16 encoded text that are equal to a given code unit.
+ * The text has the specified number of code units. The counted code unit
+ * is given by its two bytes in the byte order of the text.
+ */
+typedef size_t (*CodeUnitCountKernel)(
+    const char* text,
+    size_t numUnits,
+    char byte0,
+    char byte1
+);
+
+/**
+ * Function pointer type for the variants of the kernel which counts the
+ * words starting in a UTF-16 encoded text with the specified number of code
+ * units. Each variant is specialized for one byte order.
+ * 
+ * Words are delimited by the code units of the white space characters of
+ * the "C" locale, like for the `WordCountKernel`. Null characters and byte
+ * order marks, including byte-swapped ones, neither start nor end a word.
+ * The in-word state is passed as for the `WordCountKernel`.
+ */
+typedef size_t (*UTF16WordCountKernel)(
+    const char* text,
+    size_t numUnits,
+    bool* inWord
+);
+
+/**
+ * Function pointer type for the variants of the kernel which counts the
+ * characters of a UTF-16 encoded text with the specified number of code
+ * units. Each variant is specialized for one byte order.
+ * 
+ * A high surrogate which is directly followed by a low surrogate is counted
+ * as one character. All other surrogates as well as byte order marks,
+ * including byte-swapped ones, are not counted. Every other code unit is
+ * counted as one character.
+ */
+typedef size_t (*UTF16CountKernel)(const char* text, size_t numUnits);
+
+/**
+ * Function pointer type for the variants of the kernel which transcodes a
+ * UTF-16 encoded text with the specified number of code units to UTF-8.
+ * Each variant is specialized for one byte order.
+ * 
+ * The UTF-8 sequences are written to `out`, which must have room for three
+ * bytes per code unit, and their total size is written to `size`. Returns
+ * `false` if the text contains a surrogate which is not part of a surrogate
+ * pair or a byte order mark, including byte-swapped ones. Such a text has no
+ * UTF-8 representation with the same text metrics. The contents of `out`
+ * are unspecified in that case.
+ */
+typedef bool (*UTF16TranscodeKernel)(
+    const char* text,
+    size_t numUnits,
+    char* out,
+    size_t* size
+);
+
+/**
+ * Returns the best level of instruction set extensions that is supported
+ * by both the executing CPU and the build of the library. The level is
+ * detected on the first call and cached for all subsequent calls.
+ */
+SimdLevel getSimdLevel(void);
+
+/**
+ * Returns the variant of the byte count kernel for the given level, or
+ * `NULL` if the level is not supported, as defined by `getSimdLevel()`.
+ */
+ByteCountKernel getByteCountKernel(SimdLevel level);
+
+/**
+ * Counts the occurrences of the given byte in a text of the specified size
+ * with the best supported variant of the byte count kernel.
+ */
+size_t countByte(const char* text, size_t size, char byte);
+
+/**
+ * Returns the variant of the control byte count kernel for the given level,
+ * or `NULL` if the level is not supported, as defined by `getSimdLevel()`.
+ */
+ControlByteCountKernel getControlByteCountKernel(SimdLevel level);
+
+/**
+ * Counts the control bytes in a text of the specified size with the best
+ * supported variant of the control byte count kernel.
+ */
+size_t countControlBytes(const char* text, size_t size);
+
+/**
+ * Returns the variant of the UTF-8 count kernel for the given level, or
+ * `NULL` if the level is not supported, as defined by `getSimdLevel()`.
+ */
+UTF8CountKernel getUTF8CountKernel(SimdLevel level);
+
+/**
+ * Counts the characters of a UTF-8 encoded text of the specified size with
+ * the best supported variant of the UTF-8 count kernel.
+ */
+size_t countUTF8Sequences(const char* text, size_t size, size_t* count);
+
+/**
+ * Returns the variant of the word count kernel for the given level, or
+ * `NULL` if the level is not supported, as defined by `getSimdLevel()`.
+ */
+WordCountKernel getWordCountKernel(SimdLevel level);
+
+/**
+ * Counts the words starting in a text of the specified size with the best
+ * supported variant of the word count kernel.
+ */
+size_t countWordStarts(const char* text, size_t size, bool* inWord);
+
+/**
+ * Returns the variant of the code unit count kernel for the given level, or
+ * `NULL` if the level is not supported, as defined by `getSimdLevel()`.
+ */
+CodeUnitCountKernel getCodeUnitCountKernel(SimdLevel level);
+
+/**
+ * Counts the code units of a UTF-16 encoded text that are equal to the
+ * given code unit with the best supported variant of the code unit
+ * count kernel.
+ */
+size_t countCodeUnit(
+    const char* text,
+    size_t numUnits,
+    char byte0,
+    char byte1
+);
+
+/**
+ * Returns the variant of the UTF-16 word count kernel for the given level
+ * and byte order, or `NULL` if the level is not supported, as defined
+ * by `getSimdLevel()`.
+ */
+UTF16WordCountKernel getUTF16WordCountKernel(
+    SimdLevel level,
+    bool isLittleEndian
+);
+
+/**
+ * Counts the words starting in a UTF-16 encoded text of the given byte order
+ * with the best supported variant of the UTF-16 word count kernel.
+ */
+size_t countUTF16WordStarts(
+    const char* text,
+    size_t numUnits,
+    bool* inWord,
+    bool isLittleEndian
+);
+
+/**
+ * Returns the variant of the UTF-16 count kernel for the given level and
+ * byte order, or `NULL` if the level is not supported, as defined
+ * by `getSimdLevel()`.
+ */
+UTF16CountKernel getUTF16CountKernel(SimdLevel level, bool isLittleEndian);
+
+/**
+ * Counts the characters of a UTF-16 encoded text of the given byte order
+ * with the best supported variant of the UTF-16 count kernel.
+ */
+size_t countUTF16Characters(
+    const char* text,
+    size_t numUnits,
+    bool isLittleEndian
+);
+
+/**
+ * Returns the variant of the UTF-16 transcode kernel for the given level and
+ * byte order, or `NULL` if the level is not supported, as defined
+ * by `getSimdLevel()`.
+ */
+UTF16TranscodeKernel getUTF16TranscodeKernel(
+    SimdLevel level,
+    bool isLittleEndian
+);
+
+/**
+ * Transcodes a UTF-16 encoded text of the given byte order to UTF-8 with
+ * the best supported variant of the UTF-16 transcode kernel.
+ */
+bool transcodeUTF16(
+    const char* text,
+    size_t numUnits,
+    char* out,
+    size_t* size,
+    bool isLittleEndian
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -23,6 +23,7 @@
 #include "reckon/reckon.h"
 #include "evaluation.h"
 #include "fileio.h"
+#include "concurrency.h"
 
 /**
  * Control flow macro used in the main processing loop in rcnCount().
@@ -43,6 +44,54 @@ Did you forget to update RECKON_NUM_SUPPORTED_FORMATS \
 after adding support for another text format?" \
 );
 
+/**
+ * Reusable resources for processing source files in a count operation.
+ * 
+ * Every thread of a count operation uses its own resources, so that they
+ * are reused for all files processed by that thread. The segments of large
+ * files are counted with the runner, which is called with the runner context,
+ * or on new threads if no runner is set. A zero-initialized struct is ready
+ * to be used. All resources must be released with `freeCountResources()`.
+ */
+typedef struct CountResources {
+    ParserCache cache;
+    TextBuffer transcoded;
+    ReadBuffer read;
+    TaskRunner runner;
+    void* runnerContext;
+} CountResources;
+
+static void freeCountResources(CountResources* resources) {
+    freeParserCache(&resources->cache);
+    freeTextBuffer(&resources->transcoded);
+    freeReadBuffer(&resources->read);
+}
+
+/**
+ * The initial capacity of the list of counted files of a worker thread
+ * in a pipelined count operation.
+ */
+static const size_t COUNTED_FILES_CAP_INIT = 16;
+
+/**
+ * The factor by which the list of counted files of a worker thread grows.
+ */
+static const size_t COUNTED_FILES_CAP_GROW_FACTOR = 2;
+
+/**
+ * The number of scanned files per thread that can be queued in a
+ * pipelined count operation before the scanning thread has to help
+ * with the counting.
+ */
+static const size_t PIPELINE_QUEUE_CAP_PER_THREAD = 64;
+
+/**
+ * The size in bytes of the chunks in which the content of a streamed source
+ * file is read if the chunks are split into segments. Chunks are much larger
+ * than segments, so that the threads are not synchronized too often.
+ */
+static const size_t SPLIT_STREAM_CHUNK_SIZE = 16UL * 1024UL * 1024UL;
+
 /**
  * If all option bits are zero, semantically, all ops/formats are
  * selected so in that case all bits are explicitly set to ones so
@@ -64,22 +113,46 @@ static inline void resetResultGroup(RcnCountResultGroup* resultGroup) {
     resultGroup->isProcessed = false;
 }
 
+static void reportReadFailure(
+    RcnCountStatistics* stats,
+    RcnStatOptions options,
+    RcnCountResultGroup* resultGroup
+) {
+    resultGroup->state.errorCode = RCN_ERR_INVALID_INPUT;
+    resultGroup->state.errorMessage = "Failed to read file content";
+    resultGroup->state.ok = false;
+    stats->state.errorCode = RCN_ERR_INVALID_INPUT;
+    stats->state.errorMessage = "Failed to read file content";
+    if (options.stopOnError) {
+        stats->state.ok = false;
+    }
+}
+
+/**
+ * Reads the content of the given file if it was not read yet. A file that is
+ * too large to be read entirely is not reported as an error if it
+ * can be streamed, as indicated by the `canStream` argument. The content is
+ * read into the specified buffer if it is not `NULL`.
+ */
 static inline bool ensureFileContent(
     RcnCountStatistics* stats,
     RcnStatOptions options,
     RcnSourceFile* file,
-    RcnCountResultGroup* resultGroup
+    RcnCountResultGroup* resultGroup,
+    bool canStream,
+    ReadBuffer* buffer
 ) {
     if (!file->isContentRead) {
-        if (!readSourceFileContent(file)) {
-            resultGroup->state.errorCode = RCN_ERR_INVALID_INPUT;
-            resultGroup->state.errorMessage = "Failed to read file content";
-            resultGroup->state.ok = false;
-            stats->state.errorCode = RCN_ERR_INVALID_INPUT;
-            stats->state.errorMessage = "Failed to read file content";
-            if (options.stopOnError) {
-                stats->state.ok = false;
+        const bool isRead = (
+            options.mapFileContent
+            ? readSourceFileContentMapped(file, buffer)
+            : readSourceFileContentBuffered(file, buffer)
+        );
+        if (!isRead) {
+            if (canStream && file->status == RCN_FILE_OP_FILE_TOO_LARGE) {
+                return false;
             }
+            reportReadFailure(stats, options, resultGroup);
             return false;
         }
     }
@@ -116,13 +189,39 @@ static bool checkIntermediateResultState(
         return false;
 }
 
+/**
+ * The content of a source file which is counted, together with its
+ * detected encoding.
+ */
+typedef struct CountedContent {
+    RcnSourceText text;
+    TextEncoding encoding;
+} CountedContent;
+
 static inline bool countLogicalLines(
     RcnCountStatistics* stats,
-    RcnSourceFile* file,
+    CountedContent content,
     RcnTextFormat language,
-    RcnCountResultGroup* resultGroup
+    RcnCountResultGroup* resultGroup,
+    RcnStatOptions options,
+    ParserCache* cache
 ) {
-    RcnCountResult result = rcnCountLogicalLines(language, file->content);
+    cache->timeoutMicros = options.parseTimeoutMicros;
+    RcnCountResult result = (
+        (options.logicalLinesEngine == RCN_LLC_ENGINE_QUERY)
+        ? evaluateLogicalLinesByQuery(
+            language,
+            content.text,
+            content.encoding,
+            cache
+        )
+        : evaluateLogicalLines(
+            language,
+            content.text,
+            content.encoding,
+            cache
+        )
+    );
     if (!checkIntermediateResultState(stats, resultGroup, result.state)) {
         return false;
     }
@@ -136,11 +235,14 @@ static inline bool countLogicalLines(
 
 static inline bool countPhysicalLines(
     RcnCountStatistics* stats,
-    RcnSourceFile* file,
+    CountedContent content,
     RcnTextFormat sourceFormat,
     RcnCountResultGroup* resultGroup
 ) {
-    RcnCountResult result = rcnCountPhysicalLines(file->content);
+    RcnCountResult result = countPhysicalLinesInText(
+        content.text,
+        content.encoding
+    );
     if (!checkIntermediateResultState(stats, resultGroup, result.state)) {
         return false;
     }
@@ -154,11 +256,16 @@ static inline bool countPhysicalLines(
 
 static inline bool countWords(
     RcnCountStatistics* stats,
-    RcnSourceFile* file,
+    CountedContent content,
     RcnTextFormat sourceFormat,
-    RcnCountResultGroup* resultGroup
+    RcnCountResultGroup* resultGroup,
+    bool isLocaleAware
 ) {
-    RcnCountResult result = rcnCountWords(file->content);
+    RcnCountResult result = countWordsInText(
+        content.text,
+        content.encoding,
+        isLocaleAware
+    );
     if (!checkIntermediateResultState(stats, resultGroup, result.state)) {
         return false;
     }
@@ -172,11 +279,14 @@ static inline bool countWords(
 
 static inline bool countCharacters(
     RcnCountStatistics* stats,
-    RcnSourceFile* file,
+    CountedContent content,
     RcnTextFormat sourceFormat,
     RcnCountResultGroup* resultGroup
 ) {
-    RcnCountResult result = rcnCountCharacters(file->content);
+    RcnCountResult result = countCharactersInText(
+        content.text,
+        content.encoding
+    );
     if (!checkIntermediateResultState(stats, resultGroup, result.state)) {
         return false;
     }
@@ -190,11 +300,10 @@ static inline bool countCharacters(
 
 static inline void countProcessedFile(
     RcnCountStatistics* stats,
-    RcnSourceFile* file,
+    RcnCount fileSize,
     RcnTextFormat sourceFormat,
     RcnCountResultGroup* resultGroup
 ) {
-    const RcnCount fileSize = file->content.size;
     resultGroup->isProcessed = true;
     resultGroup->sourceSize = fileSize;
     stats->count.sizeProcessed += 1;
@@ -202,6 +311,218 @@ static inline void countProcessedFile(
     stats->sourceSize[sourceFormat] += fileSize;
 }
 
+/**
+ * Indicates whether the selected operations can be performed on the content
+ * of a source file while it is read in chunks, i.e. without holding the
+ * entire content in memory.
+ */
+static inline bool canCountStreamed(
+    RcnStatOptions options,
+    SourceFormatDetection detected
+) {
+    return !(
+        (options.operations & RCN_OPT_COUNT_LOGICAL_LINES)
+        && detected.isProgrammingLanguage
+    );
+}
+
+/**
+ * Indicates whether more than one of the text metrics, i.e. the physical
+ * lines, words and characters, are selected by the given options.
+ */
+static inline bool hasMultipleTextMetrics(RcnStatOptions options) {
+    const uint32_t selected = options.operations & (
+        RCN_OPT_COUNT_PHYSICAL_LINES
+        | RCN_OPT_COUNT_WORDS
+        | RCN_OPT_COUNT_CHARACTERS
+    );
+    return (selected & (selected - 1)) != 0;
+}
+
+/**
+ * Indicates whether the text metrics of a source file with the given size
+ * are counted in multiple segments concurrently according to the given
+ * options.
+ */
+static inline bool isSplitSize(RcnStatOptions options, size_t size) {
+    return (
+        options.threads > 1
+        && options.splitThreshold > 0
+        && size >= options.splitThreshold
+        && (options.operations & (
+            RCN_OPT_COUNT_PHYSICAL_LINES
+            | RCN_OPT_COUNT_WORDS
+            | RCN_OPT_COUNT_CHARACTERS
+        )) != 0
+    );
+}
+
+/**
+ * Indicates whether the text metrics of the given content of a source file
+ * are counted in multiple segments concurrently according to the given
+ * options.
+ */
+static inline bool isSplitContent(
+    RcnStatOptions options,
+    CountedContent content
+) {
+    return isSplitSize(options, content.text.size);
+}
+
+/**
+ * Adds the counts of the selected text metrics of the given counted result
+ * group to the given result group of a source file and to the statistics.
+ */
+static bool addTextMetrics(
+    RcnCountStatistics* stats,
+    RcnStatOptions options,
+    RcnTextFormat sourceFormat,
+    RcnCountResultGroup* resultGroup,
+    RcnCountResultGroup counted
+) {
+    if (!checkIntermediateResultState(stats, resultGroup, counted.state)) {
+        return false;
+    }
+    resultGroup->state.ok = true;
+    resultGroup->state.errorCode = RCN_ERR_NONE;
+    if (options.operations & RCN_OPT_COUNT_PHYSICAL_LINES) {
+        resultGroup->physicalLines = counted.physicalLines;
+        stats->totalPhysicalLines += counted.physicalLines;
+        stats->physicalLines[sourceFormat] += counted.physicalLines;
+    }
+    if (options.operations & RCN_OPT_COUNT_WORDS) {
+        resultGroup->words = counted.words;
+        stats->totalWords += counted.words;
+        stats->words[sourceFormat] += counted.words;
+    }
+    if (options.operations & RCN_OPT_COUNT_CHARACTERS) {
+        resultGroup->characters = counted.characters;
+        stats->totalCharacters += counted.characters;
+        stats->characters[sourceFormat] += counted.characters;
+    }
+    return true;
+}
+
+/**
+ * Sets the given result group of a source file to indicate that the file was
+ * skipped because of its binary content.
+ */
+static void reportBinaryContent(RcnCountResultGroup* resultGroup) {
+    resultGroup->state.errorCode = RCN_ERR_BINARY_CONTENT;
+    resultGroup->state.errorMessage = "The file content is binary";
+    resultGroup->state.ok = false;
+}
+
+/**
+ * A count stream whose chunks are split into up to the specified number of
+ * segments, which are counted with the runner of the specified resources.
+ * A maximum of one segment means that chunks are not split.
+ */
+typedef struct SplitCountStream {
+    RcnCountStream* stream;
+    size_t maxSegments;
+    const CountResources* resources;
+} SplitCountStream;
+
+static bool updateCountStream(RcnSourceText chunk, void* arg) {
+    SplitCountStream* split = (SplitCountStream*) arg;
+    return updateCountStreamInSegments(
+        split->stream,
+        chunk,
+        split->maxSegments,
+        split->resources->runner,
+        split->resources->runnerContext
+    );
+}
+
+/**
+ * Counts the given source file while its content is read in chunks. This is
+ * used for files that are too large to be read entirely. The chunks are split
+ * into segments which are counted concurrently if the options say so.
+ */
+static bool countStreamed(
+    RcnCountStatistics* stats,
+    RcnStatOptions options,
+    RcnSourceFile* file,
+    RcnTextFormat sourceFormat,
+    RcnCountResultGroup* resultGroup,
+    const CountResources* resources
+) {
+    RcnCountStream* stream = createCountStream(
+        options.operations,
+        options.localeWordDelimiters
+    );
+    if (!stream) {
+        RcnResultState state = {
+            .errorCode = RCN_ERR_ALLOC_FAILURE,
+            .errorMessage = "Failed to allocate count stream"
+        };
+        return checkIntermediateResultState(stats, resultGroup, state);
+    }
+    const size_t size = (
+        file->scannedSize > 0
+        ? file->scannedSize
+        : probeFileSize(file->path)
+    );
+    const bool isSplit = isSplitSize(options, size);
+    SplitCountStream split = {
+        .stream = stream,
+        .maxSegments = isSplit ? options.threads : 1,
+        .resources = resources
+    };
+    const bool isRead = readSourceFileChunks(
+        file,
+        isSplit ? SPLIT_STREAM_CHUNK_SIZE : 0,
+        updateCountStream,
+        &split
+    );
+    RcnCountResultGroup counted = rcnFinishCountStream(stream);
+    rcnFreeCountStream(stream);
+    if (!isRead && file->status != RCN_FILE_OP_OK) {
+        reportReadFailure(stats, options, resultGroup);
+        return false;
+    }
+    if (!addTextMetrics(stats, options, sourceFormat, resultGroup, counted)) {
+        return false;
+    }
+    countProcessedFile(stats, counted.sourceSize, sourceFormat, resultGroup);
+    return true;
+}
+
+/**
+ * Counts all selected text metrics of the given content of a source file
+ * in a single pass. Large contents are split into segments which are
+ * counted concurrently if the options say so.
+ */
+static inline bool countTextMetricsFused(
+    RcnCountStatistics* stats,
+    RcnStatOptions options,
+    CountedContent content,
+    RcnTextFormat sourceFormat,
+    RcnCountResultGroup* resultGroup,
+    const CountResources* resources
+) {
+    const RcnCountResultGroup counted = (
+        isSplitContent(options, content)
+        ? countTextMetricsInSegments(
+            content.text,
+            content.encoding,
+            options.operations,
+            options.localeWordDelimiters,
+            options.threads,
+            resources->runner,
+            resources->runnerContext
+        )
+        : countTextMetrics(
+            content.text,
+            content.encoding,
+            options.operations,
+            options.localeWordDelimiters
+        )
+    );
+    return addTextMetrics(stats, options, sourceFormat, resultGroup, counted);
+}
+
 static bool collectFiles(const char* directory, RcnCountStatistics* stats) {
     SourceFileList list = newSourceFileList(directory);
     if (!list.ok) {
@@ -239,38 +560,181 @@ static bool setupFile(const char* regularFile, RcnCountStatistics* stats) {
     return false;
 }
 
+/**
+ * Returns the encoding of the read content of the given source file. The
+ * encoding is only detected once and then stored in the file until its
+ * content is released.
+ */
+static TextEncoding detectFileEncoding(RcnSourceFile* file) {
+    if (!file->isEncodingDetected) {
+        file->encoding = (RcnTextEncoding) detectEncoding(file->content);
+        file->isEncodingDetected = true;
+    }
+    return (TextEncoding) file->encoding;
+}
+
+/**
+ * Indicates whether the given source file appears to have binary content.
+ * If the content of the file is not loaded yet, then only the bytes that are
+ * inspected by `isBinaryContent()` are read, so that a skipped file is never
+ * loaded entirely. Files whose start cannot be read are not considered to
+ * have binary content, so that the failure is reported when the content
+ * is loaded.
+ */
+static bool hasBinaryContent(RcnSourceFile* file) {
+    if (file->isContentRead) {
+        return isBinaryContent(file->content, detectFileEncoding(file));
+    }
+    char head[BINARY_CHECK_SIZE];
+    size_t size = 0;
+    if (!readSourceFileHead(file, head, sizeof(head), &size)) {
+        return false;
+    }
+    const RcnSourceText text = {
+        .text = head,
+        .size = size
+    };
+    return isBinaryContent(text, detectEncoding(text));
+}
+
+/**
+ * Returns the read content of the given source file which is to be counted.
+ * If enabled by the specified options, UTF-16 encoded content is transcoded
+ * to UTF-8 into the transcoding buffer of the specified resources, so that
+ * all counts operate on UTF-8. Otherwise, or if the content cannot be
+ * transcoded, the content is returned as it is.
+ */
+static CountedContent selectCountedContent(
+    RcnStatOptions options,
+    RcnSourceFile* file,
+    CountResources* resources
+) {
+    const CountedContent content = {
+        .text = file->content,
+        .encoding = detectFileEncoding(file)
+    };
+    if (!options.transcodeUTF16 || content.encoding == TextEncodingUTF8) {
+        return content;
+    }
+    RcnSourceText transcoded = {0};
+    const bool isTranscoded = (
+        transcodeToUTF8(
+            content.text,
+            content.encoding,
+            &resources->transcoded,
+            &transcoded
+        )
+        && transcoded.size <= UINT32_MAX
+    );
+    if (!isTranscoded) {
+        return content;
+    }
+    return (CountedContent){
+        .text = transcoded,
+        .encoding = TextEncodingUTF8
+    };
+}
+
 static inline bool count(
     RcnCountStatistics* stats,
     RcnStatOptions options,
     RcnSourceFile* file,
     RcnCountResultGroup* result,
-    SourceFormatDetection detected
+    SourceFormatDetection detected,
+    CountResources* resources
 ) {
     RCN_LOG_DBG("Processing file:")
     RCN_LOG_DBG(file->path)
 
     bool ok = false;
     RcnTextFormat sourceFormat = detected.format;
-    ok = ensureFileContent(stats, options, file, result);
+    const bool canStream = canCountStreamed(options, detected);
+    // Files with binary content are skipped before their content is loaded
+    if (options.skipBinaryContent && hasBinaryContent(file)) {
+        reportBinaryContent(result);
+        RCN_LOG_DBG("Skipped file with binary content:")
+        RCN_LOG_DBG(file->path)
+        return true;
+    }
+    // Contents which are not kept are read into the reusable buffer
+    ReadBuffer* buffer = options.keepFileContent ? NULL : &resources->read;
+    ok = ensureFileContent(stats, options, file, result, canStream, buffer);
+    if (!ok && canStream && file->status == RCN_FILE_OP_FILE_TOO_LARGE) {
+        ok = countStreamed(
+            stats,
+            options,
+            file,
+            sourceFormat,
+            result,
+            resources
+        );
+        RCN_LOG_DBG("Done processing streamed file:")
+        RCN_LOG_DBG(file->path)
+        return ok;
+    }
+    // The counted content might be transcoded, but the reported source
+    // size always refers to the original content of the file
+    const CountedContent content = (
+        ok
+        ? selectCountedContent(options, file, resources)
+        : (CountedContent){0}
+    );
     if (ok && options.operations & RCN_OPT_COUNT_LOGICAL_LINES){
         if (detected.isProgrammingLanguage) {
-            ok = countLogicalLines(stats, file, sourceFormat, result);
+            ok = countLogicalLines(
+                stats,
+                content,
+                sourceFormat,
+                result,
+                options,
+                &resources->cache
+            );
         }
     }
-    if (ok && options.operations & RCN_OPT_COUNT_PHYSICAL_LINES) {
-        ok = countPhysicalLines(stats, file, sourceFormat, result);
-    }
-    if (ok && options.operations & RCN_OPT_COUNT_WORDS) {
-        ok = countWords(stats, file, sourceFormat, result);
+    // Files whose parsing was cut off do not stop the count operation
+    if (!ok && result->state.errorCode == RCN_ERR_PARSE_CANCELLED) {
+        if (!options.keepFileContent) {
+            releaseSourceFileContent(file, buffer);
+        }
+        RCN_LOG_DBG("Cancelled parsing of file:")
+        RCN_LOG_DBG(file->path)
+        return true;
     }
-    if (ok && options.operations & RCN_OPT_COUNT_CHARACTERS) {
-        ok = countCharacters(stats, file, sourceFormat, result);
+    const bool isFused = (
+        hasMultipleTextMetrics(options)
+        || isSplitContent(options, content)
+    );
+    if (ok && isFused) {
+        ok = countTextMetricsFused(
+            stats,
+            options,
+            content,
+            sourceFormat,
+            result,
+            resources
+        );
+    } else {
+        if (ok && options.operations & RCN_OPT_COUNT_PHYSICAL_LINES) {
+            ok = countPhysicalLines(stats, content, sourceFormat, result);
+        }
+        if (ok && options.operations & RCN_OPT_COUNT_WORDS) {
+            ok = countWords(
+                stats,
+                content,
+                sourceFormat,
+                result,
+                options.localeWordDelimiters
+            );
+        }
+        if (ok && options.operations & RCN_OPT_COUNT_CHARACTERS) {
+            ok = countCharacters(stats, content, sourceFormat, result);
+        }
     }
     if (ok) {
-        countProcessedFile(stats, file, sourceFormat, result);
+        countProcessedFile(stats, file->content.size, sourceFormat, result);
     }
     if (!options.keepFileContent) {
-        freeSourceFileContent(file);
+        releaseSourceFileContent(file, buffer);
     }
 
     RCN_LOG_DBG("Done processing file:")
@@ -278,6 +742,804 @@ static inline bool count(
     return ok;
 }
 
+/**
+ * The contribution of a single source file to the overall statistics of
+ * a concurrent count operation. Outcomes are recorded by the worker threads
+ * and merged afterwards in file order, so that the merged statistics are
+ * identical to the ones of a sequential count operation.
+ */
+typedef struct FileOutcome {
+    RcnResultState state;
+    RcnTextFormat format;
+    RcnCount logicalLines;
+    RcnCount physicalLines;
+    RcnCount words;
+    RcnCount characters;
+    RcnCount sourceSize;
+    bool isClaimed;
+    bool isCounted;
+    bool isProcessed;
+    bool isStopping;
+} FileOutcome;
+
+/**
+ * A source file of a pipelined count operation together with its result.
+ * The file is the first member so that counted files can be sorted with
+ * the comparator for source files.
+ */
+typedef struct CountedFile {
+    RcnSourceFile file;
+    RcnCountResultGroup result;
+    FileOutcome outcome;
+} CountedFile;
+
+/**
+ * An entry in the processing order of a concurrent count operation.
+ * Refers to a source file by its index in the statistics.
+ */
+typedef struct ScheduledFile {
+    size_t size;
+    size_t index;
+} ScheduledFile;
+
+/**
+ * Tasks that a worker thread of a concurrent count operation shares with the
+ * other worker threads, e.g. to count the segments of a large file. Each
+ * task is claimed with the index of the next task, so that worker threads
+ * without files to count can help until all tasks are claimed. The number
+ * of finished tasks and of helping threads are guarded by the mutex of the
+ * count operation.
+ */
+typedef struct SharedTasks {
+    ConcurrentTask task;
+    char* args;
+    size_t argSize;
+    size_t count;
+    size_t next;
+    size_t numFinished;
+    size_t numHelpers;
+    struct SharedTasks* nextShared;
+} SharedTasks;
+
+/**
+ * The state shared by all worker threads of a concurrent count operation.
+ * The files are claimed in the order of the schedule. In a pipelined count
+ * operation, the files are taken from the queue instead of the statistics.
+ * The list of shared tasks and the number of worker threads which still
+ * count files are guarded by the mutex. Every change of them is broadcast
+ * with the condition variable. The mutex also guards the earliest file that
+ * has stopped a pipelined count operation so far.
+ */
+typedef struct CountJob {
+    RcnCountStatistics* stats;
+    RcnStatOptions options;
+    FileOutcome* outcomes;
+    ScheduledFile* schedule;
+    size_t next;
+    size_t stopIndex;
+    const char* path;
+    size_t numThreads;
+    BoundedQueue* queue;
+    size_t failures;
+    Mutex* mutex;
+    CondVar* changed;
+    SharedTasks* shared;
+    size_t numCounting;
+    RcnSourceFile stoppingFile;
+    size_t numStopping;
+} CountJob;
+
+/**
+ * The state of a single worker thread of a concurrent count operation.
+ */
+typedef struct CountWorker {
+    CountJob* job;
+    RcnCountStatistics scratch;
+    CountResources resources;
+    CountedFile* counted;
+    size_t sizeCounted;
+    size_t capacityCounted;
+    bool isScanner;
+} CountWorker;
+
+static void selectDefaultOptions(RcnStatOptions* options) {
+    if (options->operations == 0) {
+        options->operations = DEFAULT_OPT_ENABLE_ALL;
+    }
+    if (options->formats == 0) {
+        options->formats = DEFAULT_OPT_ENABLE_ALL;
+    }
+}
+
+/**
+ * Processes the given source file and writes its result to the specified
+ * result group. All counts and state changes are accumulated in the
+ * specified totals. The detected source format is written to the specified
+ * detection. Parsers and buffers are taken from the specified resources.
+ * 
+ * Returns true if processing should continue with the next file.
+ */
+static bool processFile(
+    RcnSourceFile* file,
+    RcnCountResultGroup* result,
+    RcnCountStatistics* totals,
+    RcnStatOptions options,
+    SourceFormatDetection* detected,
+    CountResources* resources
+) {
+    resetResultGroup(result);
+
+    *detected = detectSourceFormat(file);
+    if (!detected->isSupportedFormat) {
+        result->state.errorCode = RCN_ERR_UNSUPPORTED_FORMAT;
+        result->state.errorMessage = "The source format is not supported";
+        return true;
+    }
+    RcnTextFormat sourceFormat = detected->format;
+    ASSERT_SOURCE_FORMAT_INDEX(sourceFormat);
+    if (!isFormatSelected(options, sourceFormat)) {
+        return true;
+    }
+    const bool ok = count(
+        totals,
+        options,
+        file,
+        result,
+        *detected,
+        resources
+    );
+    return ok || (!options.stopOnError && totals->state.ok);
+}
+
+/**
+ * Advises that the upcoming source files of the given statistics will be
+ * read soon, as configured by the read-ahead option. Files are processed in
+ * the order of the specified schedule, or in the order of the statistics if
+ * no schedule is specified. The specified position is the one of the file
+ * which is about to be processed. Files that would not be processed with the
+ * specified options are skipped. Only immutable members of the files are
+ * accessed, since other threads might process them at the same time.
+ */
+static void adviseReadAhead(
+    const RcnCountStatistics* stats,
+    RcnStatOptions options,
+    const ScheduledFile* schedule,
+    size_t position
+) {
+    const size_t readAhead = options.readAhead;
+    if (readAhead == 0) {
+        return;
+    }
+    // The first file advises the entire initial read-ahead window,
+    // every subsequent file advises the one at the end of the window
+    const size_t first = (position == 0) ? 1 : position + readAhead;
+    const size_t last = position + readAhead;
+    for (size_t i = first; i <= last && i < stats->count.size; ++i) {
+        const size_t index = schedule ? schedule[i].index : i;
+        const RcnSourceFile* file = &stats->count.files[index];
+        const SourceFormatDetection detected = detectSourceFormat(file);
+        const bool isSelected = (
+            detected.isSupportedFormat
+            && isFormatSelected(options, detected.format)
+        );
+        if (isSelected) {
+            adviseFileRead(file->path);
+        }
+    }
+}
+
+/**
+ * Processes the given source file with the resources of the specified worker
+ * and records the contribution of the file in the specified outcome.
+ */
+static void processFileOutcome(
+    CountWorker* worker,
+    RcnSourceFile* file,
+    RcnCountResultGroup* result,
+    FileOutcome* outcome
+) {
+    const RcnStatOptions options = worker->job->options;
+    RcnCountStatistics* scratch = &worker->scratch;
+    *scratch = (RcnCountStatistics){0};
+    scratch->state.ok = true;
+    SourceFormatDetection detected = {0};
+    const bool proceed = processFile(
+        file,
+        result,
+        scratch,
+        options,
+        &detected,
+        &worker->resources
+    );
+    outcome->isClaimed = true;
+    outcome->isCounted = (
+        detected.isSupportedFormat
+        && isFormatSelected(options, detected.format)
+    );
+    outcome->format = detected.format;
+    outcome->state = scratch->state;
+    outcome->logicalLines = scratch->totalLogicalLines;
+    outcome->physicalLines = scratch->totalPhysicalLines;
+    outcome->words = scratch->totalWords;
+    outcome->characters = scratch->totalCharacters;
+    outcome->sourceSize = scratch->totalSourceSize;
+    outcome->isProcessed = scratch->count.sizeProcessed > 0;
+    outcome->isStopping = !proceed;
+}
+
+/**
+ * Runs the tasks of the given shared tasks until all tasks are claimed.
+ */
+static void runSharedTasks(CountJob* job, SharedTasks* shared) {
+    size_t index = 0;
+    while ((index = atomicFetchAdd(&shared->next, 1)) < shared->count) {
+        shared->task(shared->args + (index * shared->argSize));
+        lockMutex(job->mutex);
+        if (++shared->numFinished == shared->count) {
+            broadcastCondVar(job->changed);
+        }
+        unlockMutex(job->mutex);
+    }
+}
+
+/**
+ * A `TaskRunner` for the worker threads of the concurrent count operation
+ * given as the context. The tasks are shared with the worker threads that
+ * have no more files to count, while the calling thread runs tasks as well.
+ * Blocks until all tasks have finished.
+ */
+static size_t runWithIdleWorkers(
+    ConcurrentTask task,
+    void* args,
+    size_t argSize,
+    size_t count,
+    void* context
+) {
+    CountJob* job = (CountJob*) context;
+    SharedTasks shared = {
+        .task = task,
+        .args = (char*) args,
+        .argSize = argSize,
+        .count = count
+    };
+    lockMutex(job->mutex);
+    shared.nextShared = job->shared;
+    job->shared = &shared;
+    broadcastCondVar(job->changed);
+    unlockMutex(job->mutex);
+
+    runSharedTasks(job, &shared);
+
+    lockMutex(job->mutex);
+    SharedTasks** link = &job->shared;
+    while (*link != &shared) {
+        link = &(*link)->nextShared;
+    }
+    *link = shared.nextShared;
+    // Helping threads might still access the shared tasks
+    while (shared.numFinished < count || shared.numHelpers > 0) {
+        waitCondVar(job->changed, job->mutex);
+    }
+    unlockMutex(job->mutex);
+    return count;
+}
+
+/**
+ * Registers the calling worker thread of the given job as a thread that
+ * counts files, so that it can share tasks with the other worker threads.
+ */
+static void startCounting(CountWorker* worker) {
+    CountJob* job = worker->job;
+    worker->resources.runner = runWithIdleWorkers;
+    worker->resources.runnerContext = job;
+    lockMutex(job->mutex);
+    job->numCounting++;
+    unlockMutex(job->mutex);
+}
+
+/**
+ * Helps with the tasks shared by the other worker threads of the given job
+ * after the calling worker thread has no more files to count. Returns once
+ * no worker thread counts files anymore, since no more tasks can be shared
+ * from then on.
+ */
+static void helpWithSharedTasks(CountJob* job) {
+    lockMutex(job->mutex);
+    job->numCounting--;
+    broadcastCondVar(job->changed);
+    while (true) {
+        SharedTasks* shared = job->shared;
+        while (shared && atomicLoad(&shared->next) >= shared->count) {
+            shared = shared->nextShared;
+        }
+        if (shared) {
+            shared->numHelpers++;
+            unlockMutex(job->mutex);
+            runSharedTasks(job, shared);
+            lockMutex(job->mutex);
+            shared->numHelpers--;
+            broadcastCondVar(job->changed);
+        } else if (job->numCounting == 0) {
+            break;
+        } else {
+            waitCondVar(job->changed, job->mutex);
+        }
+    }
+    unlockMutex(job->mutex);
+}
+
+static void countConcurrently(void* arg) {
+    CountWorker* worker = (CountWorker*) arg;
+    CountJob* job = worker->job;
+    RcnCountStatistics* stats = job->stats;
+    const size_t size = stats->count.size;
+    startCounting(worker);
+    while (true) {
+        const size_t position = atomicFetchAdd(&job->next, 1);
+        if (position >= size) {
+            break;
+        }
+        adviseReadAhead(stats, job->options, job->schedule, position);
+        const size_t index = job->schedule[position].index;
+        if (index > atomicLoad(&job->stopIndex)) {
+            // Would not have been processed in a sequential count operation,
+            // but files scheduled later might still precede the stopping file
+            continue;
+        }
+        FileOutcome* outcome = &job->outcomes[index];
+        processFileOutcome(
+            worker,
+            &stats->count.files[index],
+            &stats->count.results[index],
+            outcome
+        );
+        if (outcome->isStopping) {
+            atomicStoreMin(&job->stopIndex, index);
+        }
+    }
+    helpWithSharedTasks(job);
+    freeCountResources(&worker->resources);
+}
+
+static void mergeFileOutcome(
+    RcnCountStatistics* stats,
+    const FileOutcome* outcome
+) {
+    const RcnTextFormat sourceFormat = outcome->format;
+    stats->totalLogicalLines += outcome->logicalLines;
+    stats->logicalLines[sourceFormat] += outcome->logicalLines;
+    stats->totalPhysicalLines += outcome->physicalLines;
+    stats->physicalLines[sourceFormat] += outcome->physicalLines;
+    stats->totalWords += outcome->words;
+    stats->words[sourceFormat] += outcome->words;
+    stats->totalCharacters += outcome->characters;
+    stats->characters[sourceFormat] += outcome->characters;
+    stats->totalSourceSize += outcome->sourceSize;
+    stats->sourceSize[sourceFormat] += outcome->sourceSize;
+    if (outcome->isProcessed) {
+        stats->count.sizeProcessed += 1;
+    }
+    if (outcome->state.errorCode != RCN_ERR_NONE) {
+        stats->state.errorCode = outcome->state.errorCode;
+        if (outcome->state.errorMessage) {
+            stats->state.errorMessage = outcome->state.errorMessage;
+        }
+    }
+    if (!outcome->state.ok) {
+        stats->state.ok = false;
+    }
+}
+
+/**
+ * Merges the given outcomes of all files of the specified statistics in
+ * file order. The results of files after the first file that has stopped the
+ * count operation are discarded and their loaded content is released, since
+ * these files would not have been processed in a sequential count operation.
+ */
+static void mergeFileOutcomes(
+    RcnCountStatistics* stats,
+    const FileOutcome* outcomes
+) {
+    bool isStopped = false;
+    for (size_t i = 0; i < stats->count.size; ++i) {
+        const FileOutcome* outcome = &outcomes[i];
+        if (isStopped) {
+            if (outcome->isClaimed) {
+                // Leave the file as if it had never been processed
+                RcnSourceFile* file = &stats->count.files[i];
+                freeSourceFileContent(file);
+                file->status = RCN_FILE_OP_OK;
+                stats->count.results[i] = (RcnCountResultGroup){0};
+            }
+            continue;
+        }
+        if (outcome->isCounted) {
+            mergeFileOutcome(stats, outcome);
+        }
+        isStopped = outcome->isStopping;
+    }
+}
+
+/**
+ * Comparator for `qsort()` that orders scheduled files by descending size.
+ * Files of equal size keep the order of the statistics.
+ */
+static int compareScheduledFileBySize(const void* arg1, const void* arg2) {
+    const ScheduledFile* file1 = (const ScheduledFile*) arg1;
+    const ScheduledFile* file2 = (const ScheduledFile*) arg2;
+    if (file1->size != file2->size) {
+        return (file1->size > file2->size) ? -1 : 1;
+    }
+    return (file1->index > file2->index) - (file1->index < file2->index);
+}
+
+/**
+ * Creates the processing order for the source files of the given statistics.
+ * Larger files are processed first so that a large file which is claimed
+ * late cannot stretch the duration of the entire count operation. The files
+ * are ordered by the size seen in the directory scan, or when their content
+ * was last read, since reading the file contents is part of the processing
+ * itself. Files of unknown size are processed last, in file order. Their
+ * sizes are not probed up front, so that counting can start right away.
+ */
+static ScheduledFile* newSchedule(const RcnCountStatistics* stats) {
+    const size_t size = stats->count.size;
+    ScheduledFile* schedule = malloc(size * sizeof(ScheduledFile));
+    if (!schedule) {
+        return NULL; // LCOV_EXCL_LINE
+    }
+    for (size_t i = 0; i < size; ++i) {
+        schedule[i] = (ScheduledFile){
+            .size = stats->count.files[i].scannedSize,
+            .index = i
+        };
+    }
+    qsort(schedule, size, sizeof(ScheduledFile), compareScheduledFileBySize);
+    return schedule;
+}
+
+/**
+ * Processes all source files of the given statistics with the specified
+ * number of threads. The files are processed in the order of descending
+ * size, whereas the results are reported in the order of the statistics.
+ * Returns false if the required resources could not be allocated, in which
+ * case no file has been processed.
+ */
+static bool countFilesConcurrently(
+    RcnCountStatistics* stats,
+    RcnStatOptions options,
+    size_t numThreads
+) {
+    const size_t size = stats->count.size;
+    FileOutcome* outcomes = calloc(size, sizeof(FileOutcome));
+    CountWorker* workers = calloc(numThreads, sizeof(CountWorker));
+    ScheduledFile* schedule = newSchedule(stats);
+    Mutex* mutex = newMutex();
+    CondVar* changed = newCondVar();
+    if (!outcomes || !workers || !schedule || !mutex || !changed) {
+        // LCOV_EXCL_START
+        free(outcomes);
+        free(workers);
+        free(schedule);
+        freeMutex(mutex);
+        freeCondVar(changed);
+        return false;
+        // LCOV_EXCL_STOP
+    }
+    // Large files are split into segments which idle threads help to count
+    CountJob job = {
+        .stats = stats,
+        .options = options,
+        .outcomes = outcomes,
+        .schedule = schedule,
+        .next = 0,
+        .stopIndex = SIZE_MAX,
+        .mutex = mutex,
+        .changed = changed
+    };
+    for (size_t i = 0; i < numThreads; ++i) {
+        workers[i].job = &job;
+    }
+    runConcurrently(
+        countConcurrently,
+        workers,
+        sizeof(CountWorker),
+        numThreads
+    );
+    mergeFileOutcomes(stats, outcomes);
+    free(outcomes);
+    free(workers);
+    free(schedule);
+    freeMutex(mutex);
+    freeCondVar(changed);
+    return true;
+}
+
+/**
+ * Appends a copy of the given source file to the counted files of the
+ * specified worker. Returns the appended entry, or `NULL` on failure.
+ */
+static CountedFile* appendCountedFile(
+    CountWorker* worker,
+    const RcnSourceFile* file
+) {
+    if (worker->sizeCounted == worker->capacityCounted) {
+        const size_t newCapacity = (
+            worker->capacityCounted
+            ? worker->capacityCounted * COUNTED_FILES_CAP_GROW_FACTOR
+            : COUNTED_FILES_CAP_INIT
+        );
+        CountedFile* reallocatedFiles = realloc(
+            worker->counted,
+            newCapacity * sizeof(CountedFile)
+        );
+        if (!reallocatedFiles) {
+            return NULL; // LCOV_EXCL_LINE
+        }
+        worker->counted = reallocatedFiles;
+        worker->capacityCounted = newCapacity;
+    }
+    CountedFile* counted = &worker->counted[worker->sizeCounted++];
+    *counted = (CountedFile){
+        .file = *file
+    };
+    return counted;
+}
+
+/**
+ * Indicates whether the given file is ordered after the earliest file that
+ * has stopped the specified pipelined count operation so far. Such a file
+ * would not have been processed in a sequential count operation.
+ */
+static bool isAfterStoppingFile(CountJob* job, const RcnSourceFile* file) {
+    if (atomicLoad(&job->numStopping) == 0) {
+        return false;
+    }
+    lockMutex(job->mutex);
+    const bool isAfter = compareSourceFileByName(file, &job->stoppingFile) > 0;
+    unlockMutex(job->mutex);
+    return isAfter;
+}
+
+/**
+ * Records the given file as the stopping file of the specified pipelined
+ * count operation if it is ordered before all previously recorded ones.
+ * Only the name and path of the file are referenced, which stay valid
+ * until the counted files are released.
+ */
+static void recordStoppingFile(CountJob* job, const RcnSourceFile* file) {
+    lockMutex(job->mutex);
+    const bool isEarliest = (
+        atomicLoad(&job->numStopping) == 0
+        || compareSourceFileByName(file, &job->stoppingFile) < 0
+    );
+    if (isEarliest) {
+        job->stoppingFile = *file;
+    }
+    atomicFetchAdd(&job->numStopping, 1);
+    unlockMutex(job->mutex);
+}
+
+/**
+ * Processes the given source file in a pipelined count operation.
+ * The specified worker takes ownership of the file. Files ordered after a
+ * file that has stopped the count operation are only listed and left
+ * unprocessed, just like in a sequential count operation.
+ */
+static void countPipelinedFile(CountWorker* worker, RcnSourceFile* file) {
+    CountJob* job = worker->job;
+    if (atomicLoad(&job->failures) > 0) {
+        deinitSourceFile(file);
+        return;
+    }
+    CountedFile* counted = appendCountedFile(worker, file);
+    if (!counted) {
+        // LCOV_EXCL_START
+        deinitSourceFile(file);
+        atomicFetchAdd(&job->failures, 1);
+        return;
+        // LCOV_EXCL_STOP
+    }
+    if (isAfterStoppingFile(job, &counted->file)) {
+        return;
+    }
+    processFileOutcome(
+        worker,
+        &counted->file,
+        &counted->result,
+        &counted->outcome
+    );
+    if (counted->outcome.isStopping) {
+        recordStoppingFile(job, &counted->file);
+    }
+}
+
+/**
+ * A `SourceFileConsumer` that passes scanned files to the queue of a
+ * pipelined count operation. The argument must be the `CountWorker`
+ * of the scanning thread. Calls are serialized by the directory traversal,
+ * even if it uses multiple threads.
+ */
+static bool pushScannedFile(RcnSourceFile* file, void* arg) {
+    CountWorker* worker = (CountWorker*) arg;
+    CountJob* job = worker->job;
+    while (!boundedQueueTryPush(job->queue, file)) {
+        // The queue is full, so the scanning thread helps with the counting
+        RcnSourceFile pending;
+        if (boundedQueueTryPop(job->queue, &pending)) {
+            countPipelinedFile(worker, &pending);
+        }
+    }
+    return atomicLoad(&job->failures) == 0;
+}
+
+static void countFromQueue(void* arg) {
+    CountWorker* worker = (CountWorker*) arg;
+    CountJob* job = worker->job;
+    startCounting(worker);
+    if (worker->isScanner) {
+        const bool ok = streamSourceFiles(
+            job->path,
+            job->numThreads,
+            pushScannedFile,
+            worker
+        );
+        if (!ok) {
+            atomicFetchAdd(&job->failures, 1);
+        }
+        boundedQueueClose(job->queue);
+    }
+    RcnSourceFile file;
+    while (boundedQueuePop(job->queue, &file)) {
+        countPipelinedFile(worker, &file);
+    }
+    helpWithSharedTasks(job);
+    freeCountResources(&worker->resources);
+}
+
+/**
+ * Moves the counted files of all specified workers into the given statistics.
+ * The files are sorted in the same order as by `newSourceFileList()`. The
+ * outcomes of the files are written to a newly allocated array in the same
+ * order. If `isComplete` is false or on allocation failure, all counted
+ * files are released and false is returned.
+ */
+static bool collectCountedFiles(
+    RcnCountStatistics* stats,
+    CountWorker* workers,
+    size_t numThreads,
+    bool isComplete,
+    FileOutcome** outcomes
+) {
+    size_t size = 0;
+    for (size_t i = 0; i < numThreads; ++i) {
+        size += workers[i].sizeCounted;
+    }
+    CountedFile* counted = NULL;
+    RcnSourceFile* files = NULL;
+    RcnCountResultGroup* results = NULL;
+    FileOutcome* fileOutcomes = NULL;
+    bool ok = isComplete;
+    if (ok && size > 0) {
+        counted = malloc(size * sizeof(CountedFile));
+        files = malloc(size * sizeof(RcnSourceFile));
+        results = malloc(size * sizeof(RcnCountResultGroup));
+        fileOutcomes = malloc(size * sizeof(FileOutcome));
+        ok = counted && files && results && fileOutcomes;
+    }
+    size_t index = 0;
+    for (size_t i = 0; i < numThreads; ++i) {
+        CountWorker* worker = &workers[i];
+        for (size_t j = 0; j < worker->sizeCounted; ++j) {
+            if (ok) {
+                counted[index++] = worker->counted[j];
+            } else {
+                deinitSourceFile(&worker->counted[j].file);
+            }
+        }
+        free(worker->counted);
+        worker->counted = NULL;
+        worker->sizeCounted = 0;
+    }
+    if (!ok) {
+        free(counted);
+        free(files);
+        free(results);
+        free(fileOutcomes);
+        return false;
+    }
+    sortSourceFiles(counted, size, sizeof(CountedFile));
+    for (size_t i = 0; i < size; ++i) {
+        files[i] = counted[i].file;
+        results[i] = counted[i].result;
+        fileOutcomes[i] = counted[i].outcome;
+    }
+    free(counted);
+    stats->count.files = files;
+    stats->count.results = results;
+    stats->count.size = size;
+    *outcomes = fileOutcomes;
+    return true;
+}
+
+/**
+ * Scans the given directory and concurrently processes all found files
+ * with the specified number of threads. The first thread scans the
+ * directory and passes the found files through a bounded queue to all
+ * other threads. The directory traversal itself uses the same number of
+ * threads, which are mostly blocked on file system metadata operations.
+ * Returns `NULL` on error.
+ */
+static RcnCountStatistics* countPipelined(
+    const char* directory,
+    RcnStatOptions options,
+    size_t numThreads
+) {
+    RcnCountStatistics* stats = calloc(1, sizeof(RcnCountStatistics));
+    CountWorker* workers = calloc(numThreads, sizeof(CountWorker));
+    BoundedQueue* queue = newBoundedQueue(
+        sizeof(RcnSourceFile),
+        numThreads * PIPELINE_QUEUE_CAP_PER_THREAD
+    );
+    Mutex* mutex = newMutex();
+    CondVar* changed = newCondVar();
+    if (!stats || !workers || !queue || !mutex || !changed) {
+        // LCOV_EXCL_START
+        free(stats);
+        free(workers);
+        freeBoundedQueue(queue);
+        freeMutex(mutex);
+        freeCondVar(changed);
+        return NULL;
+        // LCOV_EXCL_STOP
+    }
+    // Large files are split into segments which idle threads help to count
+    CountJob job = {
+        .options = options,
+        .path = directory,
+        .numThreads = numThreads,
+        .queue = queue,
+        .failures = 0,
+        .mutex = mutex,
+        .changed = changed
+    };
+    for (size_t i = 0; i < numThreads; ++i) {
+        workers[i].job = &job;
+    }
+    workers[0].isScanner = true;
+    runConcurrently(countFromQueue, workers, sizeof(CountWorker), numThreads);
+    freeBoundedQueue(queue);
+    freeMutex(mutex);
+    freeCondVar(changed);
+
+    FileOutcome* outcomes = NULL;
+    const bool ok = collectCountedFiles(
+        stats,
+        workers,
+        numThreads,
+        job.failures == 0,
+        &outcomes
+    );
+    free(workers);
+    if (!ok) {
+        free(stats);
+        return NULL;
+    }
+    if (stats->count.size == 0) {
+        free(outcomes);
+        return stats;
+    }
+    stats->state.ok = true;
+    stats->state.errorCode = RCN_ERR_NONE;
+    stats->state.errorMessage = NULL;
+    mergeFileOutcomes(stats, outcomes);
+    free(outcomes);
+    if (stats->count.size == 1) {
+        stats->state = stats->count.results[0].state;
+    }
+    return stats;
+}
+
 RcnCountStatistics* rcnCreateCountStatistics(const char* path) {
     if (!path) {
         return NULL;
@@ -334,6 +1596,29 @@ void rcnFreeSourceText(RcnSourceText* source) {
     }
 }
 
+/**
+ * Resets all counts and result states of the given statistics, so that
+ * a count operation can be performed on them again.
+ */
+static void resetCountStatistics(RcnCountStatistics* stats) {
+    stats->totalLogicalLines = 0;
+    stats->totalPhysicalLines = 0;
+    stats->totalWords = 0;
+    stats->totalCharacters = 0;
+    stats->totalSourceSize = 0;
+    for (size_t i = 0; i < RECKON_NUM_SUPPORTED_FORMATS; ++i) {
+        stats->logicalLines[i] = 0;
+        stats->physicalLines[i] = 0;
+        stats->words[i] = 0;
+        stats->characters[i] = 0;
+        stats->sourceSize[i] = 0;
+    }
+    stats->count.sizeProcessed = 0;
+    for (size_t i = 0; i < stats->count.size; ++i) {
+        stats->count.results[i] = (RcnCountResultGroup){0};
+    }
+}
+
 void rcnCount(RcnCountStatistics* stats, RcnStatOptions options) {
     if (!stats) {
         return;
@@ -351,40 +1636,72 @@ void rcnCount(RcnCountStatistics* stats, RcnStatOptions options) {
         return;
     }
 
-    if (options.operations == 0) {
-        options.operations = DEFAULT_OPT_ENABLE_ALL;
-    }
-    if (options.formats == 0) {
-        options.formats = DEFAULT_OPT_ENABLE_ALL;
-    }
+    selectDefaultOptions(&options);
+    resetCountStatistics(stats);
 
     // Set as successful upfront, is potentially invalidated inside loop
     stats->state.ok = true;
     stats->state.errorCode = RCN_ERR_NONE;
     stats->state.errorMessage = NULL;
 
-    for (size_t i = 0; i < stats->count.size; ++i) {
-        RcnSourceFile* file = &stats->count.files[i];
-        RcnCountResultGroup* result = &stats->count.results[i];
-        resetResultGroup(result);
-
-        SourceFormatDetection detected = detectSourceFormat(file);
-        if (!detected.isSupportedFormat) {
-            result->state.errorCode = RCN_ERR_UNSUPPORTED_FORMAT;
-            result->state.errorMessage = "The source format is not supported";
-            continue;
-        }
-        RcnTextFormat sourceFormat = detected.format;
-        ASSERT_SOURCE_FORMAT_INDEX(sourceFormat);
-        if (!isFormatSelected(options, sourceFormat)) {
-            continue;
-        }
-        const bool ok = count(stats, options, file, result, detected);
-        if (!ok && (options.stopOnError || !stats->state.ok)) {
-            break;
+    size_t numThreads = options.threads;
+    if (numThreads > stats->count.size) {
+        numThreads = stats->count.size;
+    }
+    bool isDone = false;
+    if (numThreads > 1) {
+        isDone = countFilesConcurrently(stats, options, numThreads);
+    }
+    if (!isDone) {
+        CountResources resources = {0};
+        for (size_t i = 0; i < stats->count.size; ++i) {
+            adviseReadAhead(stats, options, NULL, i);
+            SourceFormatDetection detected;
+            const bool proceed = processFile(
+                &stats->count.files[i],
+                &stats->count.results[i],
+                stats,
+                options,
+                &detected,
+                &resources
+            );
+            if (!proceed) {
+                break;
+            }
         }
+        freeCountResources(&resources);
     }
     if (stats->count.size == 1) {
         stats->state = stats->count.results[0].state;
     }
 }
+
+RcnCountStatistics* rcnCountPath(const char* path, RcnStatOptions options) {
+    if (!path) {
+        return NULL;
+    }
+    const bool isPipelined = (
+        options.threads > 1
+        && isValidStatsInput(path) == NULL
+        && isDirectory(path)
+    );
+    if (isPipelined) {
+        selectDefaultOptions(&options);
+        RcnCountStatistics* stats = countPipelined(
+            path,
+            options,
+            options.threads
+        );
+        if (!stats || stats->count.size > 0) {
+            return stats;
+        }
+        // Nothing was found, so the error state of a sequential
+        // count operation is reproduced below
+        rcnFreeCountStatistics(stats);
+    }
+    RcnCountStatistics* stats = rcnCreateCountStatistics(path);
+    if (stats && stats->state.errorCode == RCN_ERR_NONE) {
+        rcnCount(stats, options);
+    }
+    return stats;
+}
@@ -0,0 +1,754 @@
+/*
+ * Copyright (C) 2026 Raven Computing
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "reckon/reckon.h"
+#include "concurrency.h"
+#include "evaluation.h"
+
+/**
+ * The number of bytes at the start of a source text which are required to
+ * detect its encoding and to initialize the counted metrics.
+ */
+enum { STREAM_HEAD_SIZE = 3 };
+
+/**
+ * The number of bytes of a source text in which all selected metrics are
+ * counted consecutively by `countTextMetrics()`. Tiles fit into the cache
+ * of a core, so that they are not reloaded from memory for every metric.
+ */
+enum { STREAM_TILE_SIZE = 32 * 1024 };
+
+/**
+ * The minimum number of bytes of a segment of a source text that is counted
+ * by `countTextMetricsInSegments()`. Segments are therefore always larger
+ * than the start of a source text which is needed by `startStream()`.
+ */
+enum { SEGMENT_MIN_SIZE = 4 * 1024 };
+
+/**
+ * The maximum number of bytes by which a split between two segments is moved
+ * forward to a boundary between two characters. A split is dropped if no
+ * boundary is found within this distance, which only happens in text that
+ * is not well-formed.
+ */
+enum { SEGMENT_MAX_ALIGNMENT = 64 };
+
+/**
+ * The initial number of bytes before the start of a segment whose words
+ * are counted to derive whether the segment starts within a word.
+ */
+enum { SEGMENT_WORD_WINDOW = 64 };
+
+/**
+ * The maximum number of bytes of a UTF-8 sequence that precede the last byte
+ * of the sequence.
+ */
+enum { UTF8_MAX_PRECEDING_BYTES = 3 };
+
+static const unsigned char MASK_B2 = 0xe0;
+static const unsigned char MASK_B3 = 0xf0;
+static const unsigned char MASK_B4 = 0xf8;
+static const unsigned char TWO_BYTE_SEQ = 0xc0;
+static const unsigned char THREE_BYTE_SEQ = 0xe0;
+static const unsigned char FOUR_BYTE_SEQ = 0xf0;
+static const uint16_t HIGH_SURROGATE_START = 0xd800;
+static const uint16_t HIGH_SURROGATE_END = 0xdbff;
+
+/**
+ * Indices of the metrics that can be counted by a stream.
+ */
+enum {
+    STREAM_LINES,
+    STREAM_WORDS,
+    STREAM_CHARACTERS,
+    STREAM_NUM_METRICS
+};
+
+/**
+ * A metric counted by a stream. The pending bytes at the end of the last
+ * chunk that were not yet consumed by the chunk counter are kept until
+ * they can be passed again together with the bytes of the next chunk.
+ */
+typedef struct StreamedMetric {
+    ChunkCounter countChunk;
+    ChunkedCount counter;
+    char pending[CHUNKED_COUNT_MAX_PENDING + 1];
+    size_t pendingSize;
+    bool isSelected;
+} StreamedMetric;
+
+struct RcnCountStream {
+    StreamedMetric metrics[STREAM_NUM_METRICS];
+    char head[STREAM_HEAD_SIZE];
+    size_t headSize;
+    char last[2];
+    RcnCount size;
+    RcnResultState state;
+    TextEncoding encoding;
+    bool isEncodingKnown;
+    bool isStarted;
+    bool isFinished;
+};
+
+static void countPendingBytes(
+    StreamedMetric* metric,
+    const char* chunk,
+    size_t size,
+    size_t* offset
+) {
+    // At most one byte is added before the pending bytes form a complete
+    // unit, so the pending bytes never exceed their capacity
+    while (metric->pendingSize > 0 && *offset < size) {
+        metric->pending[metric->pendingSize++] = chunk[(*offset)++];
+        const size_t consumed = metric->countChunk(
+            &metric->counter,
+            metric->pending,
+            metric->pendingSize,
+            false
+        );
+        metric->pendingSize -= consumed;
+        memmove(
+            metric->pending,
+            metric->pending + consumed,
+            metric->pendingSize
+        );
+    }
+}
+
+static void countInMetric(
+    StreamedMetric* metric,
+    const char* chunk,
+    size_t size
+) {
+    size_t offset = 0;
+    countPendingBytes(metric, chunk, size, &offset);
+    if (offset < size) {
+        offset += metric->countChunk(
+            &metric->counter,
+            chunk + offset,
+            size - offset,
+            false
+        );
+        metric->pendingSize = size - offset;
+        memcpy(metric->pending, chunk + offset, metric->pendingSize);
+    }
+}
+
+static void countInMetrics(
+    RcnCountStream* stream,
+    const char* chunk,
+    size_t size
+) {
+    for (size_t i = 0; i < STREAM_NUM_METRICS; ++i) {
+        if (stream->metrics[i].isSelected) {
+            countInMetric(&stream->metrics[i], chunk, size);
+        }
+    }
+}
+
+/**
+ * Initializes all selected metrics of the given stream with the bytes at the
+ * start of the source text and counts in these bytes. The encoding of the
+ * source text is detected from these bytes unless it is already known.
+ */
+static void startStream(RcnCountStream* stream) {
+    const RcnSourceText head = {
+        .text = stream->head,
+        .size = stream->headSize
+    };
+    if (!stream->isEncodingKnown) {
+        stream->encoding = detectEncoding(head);
+        stream->isEncodingKnown = true;
+    }
+    const TextEncoding encoding = stream->encoding;
+    StreamedMetric* metrics = stream->metrics;
+    metrics[STREAM_LINES].counter = initLineBreakCount(head, encoding);
+    metrics[STREAM_WORDS].counter = initWordCount(head, encoding);
+    metrics[STREAM_CHARACTERS].counter = initCharacterCount(head, encoding);
+    stream->isStarted = true;
+    countInMetrics(stream, head.text, head.size);
+}
+
+static void trackLastBytes(
+    RcnCountStream* stream,
+    const char* chunk,
+    size_t size
+) {
+    if (size > 1) {
+        stream->last[0] = chunk[size - 2];
+        stream->last[1] = chunk[size - 1];
+    } else if (size == 1) {
+        stream->last[0] = stream->last[1];
+        stream->last[1] = chunk[0];
+    }
+    stream->size += size;
+}
+
+static void initCountStream(
+    RcnCountStream* stream,
+    uint32_t operations,
+    bool isLocaleAware
+) {
+    StreamedMetric* metrics = stream->metrics;
+    metrics[STREAM_LINES].countChunk = countLineBreaksInChunk;
+    metrics[STREAM_LINES].isSelected = (
+        (operations & RCN_OPT_COUNT_PHYSICAL_LINES) != 0
+    );
+    metrics[STREAM_WORDS].countChunk = (
+        isLocaleAware ? countLocaleWordsInChunk : countWordsInChunk
+    );
+    metrics[STREAM_WORDS].isSelected = (
+        (operations & RCN_OPT_COUNT_WORDS) != 0
+    );
+    metrics[STREAM_CHARACTERS].countChunk = countCharactersInChunk;
+    metrics[STREAM_CHARACTERS].isSelected = (
+        (operations & RCN_OPT_COUNT_CHARACTERS) != 0
+    );
+    stream->state.ok = true;
+    stream->state.errorCode = RCN_ERR_NONE;
+}
+
+/**
+ * A part of a source text whose text metrics are counted independently of
+ * the other parts of the source text. The counts of a segment are the
+ * contributions of the segment to the counts of the entire source text.
+ */
+typedef struct TextSegment {
+    size_t start;
+    size_t end;
+    RcnCountResultGroup counted;
+} TextSegment;
+
+/**
+ * The state of counting the segments of a source text concurrently. Segments
+ * are claimed by the worker threads with the index of the next segment.
+ * If the source text is a chunk of a stream, `origin` is the stream before
+ * the chunk and `end` receives the state of the stream after the last
+ * segment. Otherwise, `origin` is `NULL`.
+ */
+typedef struct SegmentedCount {
+    RcnSourceText source;
+    TextEncoding encoding;
+    uint32_t operations;
+    bool isLocaleAware;
+    TextSegment* segments;
+    size_t numSegments;
+    size_t next;
+    const RcnCountStream* origin;
+    RcnCountStream end;
+} SegmentedCount;
+
+/**
+ * Counts all selected metrics of the given stream in consecutive tiles of
+ * the specified text.
+ */
+static void countInTiles(RcnCountStream* stream, char* text, size_t size) {
+    // All metrics are counted in one tile before the next tile is loaded,
+    // so that the text is only read once from main memory
+    for (size_t offset = 0; offset < size; offset += STREAM_TILE_SIZE) {
+        RcnSourceText tile = {
+            .text = text + offset,
+            .size = size - offset
+        };
+        if (tile.size > STREAM_TILE_SIZE) {
+            tile.size = STREAM_TILE_SIZE;
+        }
+        rcnUpdateCountStream(stream, tile);
+    }
+}
+
+/**
+ * Counts the pending bytes of all selected metrics of the given stream. If
+ * `isFinal` is `true`, the pending bytes end the source text.
+ */
+static void finishMetrics(RcnCountStream* stream, bool isFinal) {
+    for (size_t i = 0; i < STREAM_NUM_METRICS; ++i) {
+        StreamedMetric* metric = &stream->metrics[i];
+        if (metric->isSelected) {
+            metric->countChunk(
+                &metric->counter,
+                metric->pending,
+                metric->pendingSize,
+                isFinal
+            );
+            metric->pendingSize = 0;
+        }
+    }
+}
+
+static inline size_t getUTF8SequenceLength(unsigned char byte) {
+    if ((byte & MASK_B2) == TWO_BYTE_SEQ) {
+        return 2;
+    }
+    if ((byte & MASK_B3) == THREE_BYTE_SEQ) {
+        return 3;
+    }
+    if ((byte & MASK_B4) == FOUR_BYTE_SEQ) {
+        return 4;
+    }
+    return 1;
+}
+
+/**
+ * Indicates whether a source text can be split at the specified position, so
+ * that no character is split and both parts can be counted independently.
+ * In UTF-8, no sequence that starts before the position may extend beyond
+ * it. A position is not considered as a boundary if any of the preceding
+ * bytes would start such a sequence, even though it might be a continuation
+ * byte of an earlier sequence. In UTF-16, the position must be between two
+ * code units of the entire source text and must not split a surrogate pair.
+ */
+static bool isSegmentBoundary(const SegmentedCount* job, size_t position) {
+    const unsigned char* text = (const unsigned char*) job->source.text;
+    if (job->encoding == TextEncodingUTF8) {
+        for (size_t i = 1; i <= UTF8_MAX_PRECEDING_BYTES; ++i) {
+            if (getUTF8SequenceLength(text[position - i]) > i) {
+                return false;
+            }
+        }
+        return true;
+    }
+    const size_t offset = job->origin ? (size_t) job->origin->size : 0;
+    if ((offset + position) % 2 != 0) {
+        return false;
+    }
+    const unsigned char byte0 = text[position - 2];
+    const unsigned char byte1 = text[position - 1];
+    const uint16_t unit = (uint16_t) (
+        job->encoding == TextEncodingUTF16LE
+        ? (byte0 | (byte1 << 8))
+        : ((byte0 << 8) | byte1)
+    );
+    return unit < HIGH_SURROGATE_START || unit > HIGH_SURROGATE_END;
+}
+
+/**
+ * Splits the source text of the given count into up to the specified number
+ * of segments of nearly equal size. Each split is moved forward to the next
+ * boundary between two characters.
+ */
+static void splitSegments(SegmentedCount* job, size_t maxSegments) {
+    const size_t size = job->source.size;
+    const size_t segmentSize = size / maxSegments;
+    size_t start = 0;
+    size_t numSegments = 0;
+    for (size_t i = 1; i < maxSegments; ++i) {
+        size_t split = segmentSize * i;
+        const size_t limit = split + SEGMENT_MAX_ALIGNMENT;
+        while (split < limit && !isSegmentBoundary(job, split)) {
+            ++split;
+        }
+        if (split < limit) {
+            job->segments[numSegments++] = (TextSegment){
+                .start = start,
+                .end = split
+            };
+            start = split;
+        }
+    }
+    job->segments[numSegments++] = (TextSegment){
+        .start = start,
+        .end = size
+    };
+    job->numSegments = numSegments;
+}
+
+/**
+ * Indicates whether the specified position of the source text of the given
+ * count is within a word, i.e. whether a word started before the position
+ * continues after it. The state only depends on the last code unit before
+ * the position that either starts or ends a word. Therefore, the words of an
+ * increasing number of bytes before the position are counted starting both
+ * within and outside of a word, until both agree on the state.
+ */
+static bool isInWordAt(const SegmentedCount* job, size_t position) {
+    const ChunkCounter countChunk = (
+        job->isLocaleAware ? countLocaleWordsInChunk : countWordsInChunk
+    );
+    const char* text = job->source.text;
+    for (size_t window = SEGMENT_WORD_WINDOW; window < position; window *= 2) {
+        ChunkedCount outside = { .encoding = job->encoding };
+        ChunkedCount inside = { .encoding = job->encoding, .inWord = true };
+        countChunk(&outside, text + position - window, window, false);
+        countChunk(&inside, text + position - window, window, false);
+        if (outside.inWord == inside.inWord) {
+            return outside.inWord;
+        }
+    }
+    // Otherwise, the state is derived like in a sequential count
+    if (job->origin) {
+        StreamedMetric words = job->origin->metrics[STREAM_WORDS];
+        countInMetric(&words, text, position);
+        words.countChunk(
+            &words.counter,
+            words.pending,
+            words.pendingSize,
+            false
+        );
+        return words.counter.inWord;
+    }
+    ChunkedCount counter = initWordCount(job->source, job->encoding);
+    countChunk(&counter, text, position, false);
+    return counter.inWord;
+}
+
+/**
+ * Counts the selected text metrics in the given segment of the source text
+ * of the specified count. The last segment of a chunk is not finished, since
+ * the stream continues after the chunk.
+ */
+static void countSegment(SegmentedCount* job, TextSegment* segment) {
+    RcnCountStream stream = {0};
+    if (job->origin) {
+        // The segments of a chunk are counted like the chunk in the stream,
+        // but only their own contributions to the counts are recorded
+        stream = *job->origin;
+        for (size_t i = 0; i < STREAM_NUM_METRICS; ++i) {
+            stream.metrics[i].counter.count = 0;
+        }
+    } else {
+        initCountStream(&stream, job->operations, job->isLocaleAware);
+        stream.encoding = job->encoding;
+        stream.isEncodingKnown = true;
+    }
+    if (segment->start > 0) {
+        // Only the first segment contains the start of the source text,
+        // e.g. a BOM, which is handled when the stream is started
+        for (size_t i = 0; i < STREAM_NUM_METRICS; ++i) {
+            stream.metrics[i].counter = (ChunkedCount){
+                .encoding = job->encoding
+            };
+            stream.metrics[i].pendingSize = 0;
+        }
+        if (stream.metrics[STREAM_WORDS].isSelected) {
+            stream.metrics[STREAM_WORDS].counter.inWord = isInWordAt(
+                job,
+                segment->start
+            );
+        }
+        stream.isStarted = true;
+    }
+    countInTiles(
+        &stream,
+        job->source.text + segment->start,
+        segment->end - segment->start
+    );
+    // No character extends beyond a segment, so only the last segment
+    // can have pending bytes which are not consumed otherwise
+    const bool isLast = segment->end == job->source.size;
+    if (job->origin && isLast) {
+        job->end = stream;
+    } else {
+        finishMetrics(&stream, isLast);
+    }
+    segment->counted.physicalLines = stream.metrics[STREAM_LINES].counter.count;
+    segment->counted.words = stream.metrics[STREAM_WORDS].counter.count;
+    segment->counted.characters = (
+        stream.metrics[STREAM_CHARACTERS].counter.count
+    );
+}
+
+static void countSegmentsConcurrently(void* arg) {
+    SegmentedCount* job = *(SegmentedCount**) arg;
+    while (true) {
+        const size_t index = atomicFetchAdd(&job->next, 1);
+        if (index >= job->numSegments) {
+            break;
+        }
+        countSegment(job, &job->segments[index]);
+    }
+}
+
+/**
+ * Splits the source text of the given count into up to the specified number
+ * of segments and counts all segments with the specified runner, or with
+ * `runConcurrently()` if the runner is `NULL`. The segments must be freed by
+ * the caller. Returns `false` if the segments could not be allocated, in
+ * which case nothing is counted.
+ */
+static bool countSegments(
+    SegmentedCount* job,
+    size_t maxSegments,
+    TaskRunner runner,
+    void* context
+) {
+    TextSegment* segments = calloc(maxSegments, sizeof(TextSegment));
+    SegmentedCount** args = malloc(maxSegments * sizeof(SegmentedCount*));
+    if (!segments || !args) {
+        // LCOV_EXCL_START
+        free(segments);
+        free(args);
+        return false;
+        // LCOV_EXCL_STOP
+    }
+    job->segments = segments;
+    splitSegments(job, maxSegments);
+    for (size_t i = 0; i < job->numSegments; ++i) {
+        args[i] = job;
+    }
+    if (runner) {
+        runner(
+            countSegmentsConcurrently,
+            args,
+            sizeof(SegmentedCount*),
+            job->numSegments,
+            context
+        );
+    } else {
+        runConcurrently(
+            countSegmentsConcurrently,
+            args,
+            sizeof(SegmentedCount*),
+            job->numSegments
+        );
+    }
+    free(args);
+    return true;
+}
+
+RcnCountStream* createCountStream(uint32_t operations, bool isLocaleAware) {
+    RcnCountStream* stream = calloc(1, sizeof(RcnCountStream));
+    if (!stream) {
+        return NULL;
+    }
+    initCountStream(stream, operations, isLocaleAware);
+    return stream;
+}
+
+RcnCountStream* rcnCreateCountStream(uint32_t operations) {
+    return createCountStream(operations, false);
+}
+
+bool rcnUpdateCountStream(RcnCountStream* stream, RcnSourceText chunk) {
+    if (!stream->state.ok) {
+        return false;
+    }
+    if (stream->isFinished) {
+        stream->state.ok = false;
+        stream->state.errorCode = RCN_ERR_INVALID_INPUT;
+        stream->state.errorMessage = "Count stream is already finished";
+        return false;
+    }
+    if (chunk.size == 0) {
+        return true;
+    }
+    if (!chunk.text) {
+        stream->state.ok = false;
+        stream->state.errorCode = RCN_ERR_INVALID_INPUT;
+        stream->state.errorMessage = "Text input must not be NULL";
+        return false;
+    }
+    trackLastBytes(stream, chunk.text, chunk.size);
+    size_t offset = 0;
+    if (!stream->isStarted) {
+        while (stream->headSize < STREAM_HEAD_SIZE && offset < chunk.size) {
+            stream->head[stream->headSize++] = chunk.text[offset++];
+        }
+        if (stream->headSize < STREAM_HEAD_SIZE) {
+            return true;
+        }
+        startStream(stream);
+    }
+    countInMetrics(stream, chunk.text + offset, chunk.size - offset);
+    return true;
+}
+
+bool updateCountStreamInSegments(
+    RcnCountStream* stream,
+    RcnSourceText chunk,
+    size_t maxSegments,
+    TaskRunner runner,
+    void* context
+) {
+    if (!stream->state.ok || stream->isFinished || !chunk.text) {
+        return rcnUpdateCountStream(stream, chunk);
+    }
+    size_t offset = 0;
+    if (!stream->isStarted) {
+        // The stream is started before the rest of the chunk is split
+        offset = STREAM_HEAD_SIZE - stream->headSize;
+        if (offset > chunk.size) {
+            offset = chunk.size;
+        }
+        const RcnSourceText head = { .text = chunk.text, .size = offset };
+        rcnUpdateCountStream(stream, head);
+    }
+    const RcnSourceText rest = {
+        .text = chunk.text + offset,
+        .size = chunk.size - offset
+    };
+    if (rest.size / SEGMENT_MIN_SIZE < maxSegments) {
+        maxSegments = rest.size / SEGMENT_MIN_SIZE;
+    }
+    if (maxSegments < 2) {
+        return rcnUpdateCountStream(stream, rest);
+    }
+    SegmentedCount job = {
+        .source = rest,
+        .encoding = stream->encoding,
+        .isLocaleAware = (
+            stream->metrics[STREAM_WORDS].countChunk == countLocaleWordsInChunk
+        ),
+        .origin = stream
+    };
+    if (!countSegments(&job, maxSegments, runner, context)) {
+        return rcnUpdateCountStream(stream, rest); // LCOV_EXCL_LINE
+    }
+    RcnCount counts[STREAM_NUM_METRICS] = {0};
+    for (size_t i = 0; i < STREAM_NUM_METRICS; ++i) {
+        counts[i] = stream->metrics[i].counter.count;
+    }
+    for (size_t i = 0; i < job.numSegments; ++i) {
+        counts[STREAM_LINES] += job.segments[i].counted.physicalLines;
+        counts[STREAM_WORDS] += job.segments[i].counted.words;
+        counts[STREAM_CHARACTERS] += job.segments[i].counted.characters;
+    }
+    free(job.segments);
+    // The stream continues with the state after the last segment
+    for (size_t i = 0; i < STREAM_NUM_METRICS; ++i) {
+        stream->metrics[i] = job.end.metrics[i];
+        stream->metrics[i].counter.count = counts[i];
+    }
+    trackLastBytes(stream, rest.text, rest.size);
+    return true;
+}
+
+RcnCountResultGroup rcnFinishCountStream(RcnCountStream* stream) {
+    RcnCountResultGroup result = {0};
+    if (stream->isFinished && stream->state.ok) {
+        stream->state.ok = false;
+        stream->state.errorCode = RCN_ERR_INVALID_INPUT;
+        stream->state.errorMessage = "Count stream is already finished";
+    }
+    stream->isFinished = true;
+    if (!stream->state.ok) {
+        result.state = stream->state;
+        return result;
+    }
+    if (!stream->isStarted) {
+        startStream(stream);
+    }
+    finishMetrics(stream, true);
+    ChunkedCount* lines = &stream->metrics[STREAM_LINES].counter;
+    if (stream->metrics[STREAM_LINES].isSelected) {
+        const TextEncoding encoding = lines->encoding;
+        // Account for last line if not ending with newline
+        if (endsWithUnterminatedLine(encoding, stream->last, stream->size)) {
+            lines->count++;
+        }
+        result.physicalLines = lines->count;
+    }
+    result.words = stream->metrics[STREAM_WORDS].counter.count;
+    result.characters = stream->metrics[STREAM_CHARACTERS].counter.count;
+    result.sourceSize = stream->size;
+    result.state = stream->state;
+    result.isProcessed = true;
+    return result;
+}
+
+void rcnFreeCountStream(RcnCountStream* stream) {
+    free(stream);
+}
+
+RcnCountResultGroup countTextMetrics(
+    RcnSourceText source,
+    TextEncoding encoding,
+    uint32_t operations,
+    bool isLocaleAware
+) {
+    RcnCountResultGroup result = {0};
+    if (source.size > 0 && !source.text) {
+        result.state.errorCode = RCN_ERR_INVALID_INPUT;
+        result.state.errorMessage = "Text input must not be NULL";
+        return result;
+    }
+    if (source.size > UINT32_MAX) {
+        result.state.errorCode = RCN_ERR_INPUT_TOO_LARGE;
+        result.state.errorMessage = "Input exceeds maximum supported size";
+        return result;
+    }
+    RcnCountStream stream = {0};
+    initCountStream(&stream, operations, isLocaleAware);
+    stream.encoding = encoding;
+    stream.isEncodingKnown = true;
+    countInTiles(&stream, source.text, source.size);
+    return rcnFinishCountStream(&stream);
+}
+
+RcnCountResultGroup countTextMetricsInSegments(
+    RcnSourceText source,
+    TextEncoding encoding,
+    uint32_t operations,
+    bool isLocaleAware,
+    size_t maxSegments,
+    TaskRunner runner,
+    void* context
+) {
+    if (source.size / SEGMENT_MIN_SIZE < maxSegments) {
+        maxSegments = source.size / SEGMENT_MIN_SIZE;
+    }
+    if (maxSegments < 2 || !source.text || source.size > UINT32_MAX) {
+        return countTextMetrics(source, encoding, operations, isLocaleAware);
+    }
+    SegmentedCount job = {
+        .source = source,
+        .encoding = encoding,
+        .operations = operations,
+        .isLocaleAware = isLocaleAware
+    };
+    if (!countSegments(&job, maxSegments, runner, context)) {
+        // LCOV_EXCL_START
+        return countTextMetrics(source, encoding, operations, isLocaleAware);
+        // LCOV_EXCL_STOP
+    }
+    RcnCountResultGroup result = {0};
+    for (size_t i = 0; i < job.numSegments; ++i) {
+        result.physicalLines += job.segments[i].counted.physicalLines;
+        result.words += job.segments[i].counted.words;
+        result.characters += job.segments[i].counted.characters;
+    }
+    free(job.segments);
+    const size_t size = source.size;
+    const char last[2] = { source.text[size - 2], source.text[size - 1] };
+    const bool hasLines = (operations & RCN_OPT_COUNT_PHYSICAL_LINES) != 0;
+    // Account for last line if not ending with newline
+    if (hasLines && endsWithUnterminatedLine(encoding, last, size)) {
+        result.physicalLines++;
+    }
+    result.sourceSize = size;
+    result.state.ok = true;
+    result.state.errorCode = RCN_ERR_NONE;
+    result.isProcessed = true;
+    return result;
+}
+
+RcnCountResultGroup rcnCountTextMetrics(
+    RcnSourceText source,
+    uint32_t operations
+) {
+    return countTextMetrics(
+        source,
+        detectEncoding(source),
+        operations,
+        false
+    );
+}
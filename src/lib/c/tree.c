@@ -15,17 +15,19 @@
  */
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include "tree_sitter/api.h"
 
 #include "reckon/reckon.h"
 #include "evaluation.h"
+#include "concurrency.h"
 
 #ifdef RECKON_DEBUG
 #define RECKON_LOG_SYNTAX_ERRORS \
     RCN_LOG_DBG("[ERROR] Syntax error in file detected") \
-    traverseTree(rootNode, showNodeSyntaxError, trace);
+    traverseTree(rootNode, showNodeSyntaxError, trace, cache);
 
 /**
  * A `NodeVisitor` function that logs syntax errors for a node.
@@ -65,82 +67,239 @@ static inline TSInputEncoding mapInputEncoding(TextEncoding encoding) {
     }
 }
 
-void traverseTree(TSNode root, NodeVisitor visitor, NodeEvalTrace* trace) {
-    TSTreeCursor cursor = ts_tree_cursor_new(root);
+/**
+ * A `TSInput` read function for source texts held in memory. The payload
+ * must point to the `RcnSourceText`. Returns the remainder of the text
+ * starting at the requested byte, so that the parser reads the text in
+ * place without any copies.
+ */
+static const char* readSourceText(
+    void* payload,
+    uint32_t byteIndex,
+    TSPoint position,
+    uint32_t* bytesRead
+) {
+    const RcnSourceText* source = (const RcnSourceText*) payload;
+    if (byteIndex >= source->size) {
+        *bytesRead = 0;
+        return "";
+    }
+    *bytesRead = (uint32_t) (source->size - byteIndex);
+    return source->text + byteIndex;
+}
+
+/**
+ * The global flag by which all parsing is cancelled. Is nonzero while
+ * parsing is cancelled.
+ */
+static size_t isParsingCancelled = 0;
+
+/**
+ * The state of the progress of parsing a single source text.
+ */
+typedef struct ParseProgress {
+    uint64_t deadline; // Monotonic time in microseconds, zero for none
+    bool isTimedOut;
+} ParseProgress;
+
+/**
+ * A progress callback for the parser, which is called periodically while
+ * a source text is parsed. The payload must point to the `ParseProgress`.
+ * Returns true if the parsing is to be cancelled.
+ */
+static bool checkParseProgress(TSParseState* state) {
+    ParseProgress* progress = (ParseProgress*) state->payload;
+    if (atomicLoad(&isParsingCancelled)) {
+        return true;
+    }
+    if (progress->deadline && (monotonicTimeMicros() >= progress->deadline)) {
+        progress->isTimedOut = true;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Returns the deadline for parsing with the given time budget in
+ * microseconds, or zero for no limit. A budget which would extend the
+ * deadline beyond the range of the monotonic clock is not limited either.
+ */
+static uint64_t computeParseDeadline(uint64_t timeoutMicros) {
+    if (timeoutMicros == 0) {
+        return 0;
+    }
+    const uint64_t now = monotonicTimeMicros();
+    return (timeoutMicros > UINT64_MAX - now) ? 0 : now + timeoutMicros;
+}
+
+void rcnCancelParsing(bool cancel) {
+    atomicStore(&isParsingCancelled, cancel ? 1 : 0);
+}
+
+TSParser* acquireParser(ParserCache* cache, RcnTextFormat language) {
+    if (language >= RECKON_NUM_SUPPORTED_FORMATS) {
+        return NULL;
+    }
+    TSParser* parser = cache->parsers[language];
+    if (parser) {
+        ts_parser_reset(parser);
+        return parser;
+    }
+    parser = createParser(language);
+    cache->parsers[language] = parser;
+    return parser;
+}
+
+void freeParserCache(ParserCache* cache) {
+    for (size_t i = 0; i < RECKON_NUM_SUPPORTED_FORMATS; ++i) {
+        if (cache->parsers[i]) {
+            ts_parser_delete(cache->parsers[i]);
+            cache->parsers[i] = NULL;
+        }
+    }
+    if (cache->hasCursor) {
+        ts_tree_cursor_delete(&cache->cursor);
+        cache->hasCursor = false;
+    }
+    if (cache->queryCursor) {
+        ts_query_cursor_delete(cache->queryCursor);
+        cache->queryCursor = NULL;
+    }
+}
+
+void traverseTree(
+    TSNode root,
+    NodeVisitor visitor,
+    NodeEvalTrace* trace,
+    ParserCache* cache
+) {
+    TSTreeCursor* cursor = &cache->cursor;
+    if (cache->hasCursor) {
+        ts_tree_cursor_reset(cursor, root);
+    } else {
+        *cursor = ts_tree_cursor_new(root);
+        cache->hasCursor = true;
+    }
     enum TraversalState state = DESCEND;
     for (;;) {
-        TSNode node = ts_tree_cursor_current_node(&cursor);
+        TSNode node = ts_tree_cursor_current_node(cursor);
         if (state == DESCEND) {
+            bool isPruned = false;
             if (visitor) {
                 RCN_LOG_DBG_NODE(node);
+                trace->line = currentLine(node);
+                trace->skipChildren = false;
+                trace->numVisitedNodes++;
                 visitor(node, trace);
+                isPruned = trace->skipChildren;
             }
-            if (ts_tree_cursor_goto_first_child(&cursor)) {
+            if (!isPruned && ts_tree_cursor_goto_first_child(cursor)) {
                 state = DESCEND;
                 continue;
             }
             state = NEXT_SIBLING;
         }
         if (state == NEXT_SIBLING) {
-            if (ts_tree_cursor_goto_next_sibling(&cursor)) {
+            if (ts_tree_cursor_goto_next_sibling(cursor)) {
                 state = DESCEND;
                 continue;
             }
             state = ASCEND;
         }
         if (state == ASCEND) {
-            if (!ts_tree_cursor_goto_parent(&cursor)) {
+            if (!ts_tree_cursor_goto_parent(cursor)) {
                 break;
             }
             state = NEXT_SIBLING;
         }
     }
-    ts_tree_cursor_delete(&cursor);
 }
 
-RcnResultState evaluateSourceTree(
+TSTree* parseSourceTree(
     RcnSourceText source,
+    TextEncoding encoding,
     RcnTextFormat language,
-    NodeVisitor evaluator,
-    NodeEvalTrace* trace
+    NodeEvalTrace* trace,
+    ParserCache* cache,
+    RcnResultState* state
 ) {
-    RcnResultState state = {0};
     if (source.size > UINT32_MAX) {
-        state.errorCode = RCN_ERR_INPUT_TOO_LARGE;
-        state.errorMessage = "Source input exceeds maximum supported size";
-        return state;
+        state->errorCode = RCN_ERR_INPUT_TOO_LARGE;
+        state->errorMessage = "Source input exceeds maximum supported size";
+        return NULL;
+    }
+    if (atomicLoad(&isParsingCancelled)) {
+        state->errorCode = RCN_ERR_PARSE_CANCELLED;
+        state->errorMessage = "Parsing of source code was cancelled";
+        return NULL;
     }
-    TSParser* parser = createParser(language);
+    TSParser* parser = acquireParser(cache, language);
     if (!parser) {
-        state.errorCode = RCN_ERR_UNSUPPORTED_FORMAT;
-        state.errorMessage = "The input language is not supported";
-        return state;
+        state->errorCode = RCN_ERR_UNSUPPORTED_FORMAT;
+        state->errorMessage = "The input language is not supported";
+        return NULL;
+    }
+    TSInput input = {
+        .payload = &source,
+        .read = readSourceText,
+        .encoding = mapInputEncoding(encoding),
+        .decode = NULL
+    };
+    ParseProgress progress = {
+        .deadline = computeParseDeadline(cache->timeoutMicros),
+        .isTimedOut = false
+    };
+    TSParseOptions options = {
+        .payload = &progress,
+        .progress_callback = checkParseProgress
+    };
+    TSTree* tree = ts_parser_parse_with_options(parser, NULL, input, options);
+    if (!tree) {
+        state->errorCode = RCN_ERR_PARSE_CANCELLED;
+        state->errorMessage = (
+            progress.isTimedOut
+            ? "Parsing of source code exceeded the time budget"
+            : "Parsing of source code was cancelled"
+        );
+        return NULL;
     }
-    TextEncoding encoding = detectEncoding(source);
-
-    TSTree* tree = ts_parser_parse_string_encoding(
-        parser,
-        NULL,
-        source.text,
-        (uint32_t) source.size,
-        mapInputEncoding(encoding)
-    );
 
     TSNode rootNode = ts_tree_root_node(tree);
 
     if (ts_node_has_error(rootNode)) {
         RECKON_LOG_SYNTAX_ERRORS
         ts_tree_delete(tree);
-        ts_parser_delete(parser);
-        state.errorCode = RCN_ERR_SYNTAX_ERROR;
-        state.errorMessage = "Syntax error detected in source code";
+        state->errorCode = RCN_ERR_SYNTAX_ERROR;
+        state->errorMessage = "Syntax error detected in source code";
+        return NULL;
+    }
+    return tree;
+}
+
+RcnResultState evaluateSourceTree(
+    RcnSourceText source,
+    TextEncoding encoding,
+    RcnTextFormat language,
+    NodeVisitor evaluator,
+    NodeEvalTrace* trace,
+    ParserCache* cache
+) {
+    RcnResultState state = {0};
+    TSTree* tree = parseSourceTree(
+        source,
+        encoding,
+        language,
+        trace,
+        cache,
+        &state
+    );
+    if (!tree) {
         return state;
     }
 
-    traverseTree(rootNode, evaluator, trace);
+    traverseTree(ts_tree_root_node(tree), evaluator, trace, cache);
 
     ts_tree_delete(tree);
-    ts_parser_delete(parser);
     state.ok = true;
     return state;
 }
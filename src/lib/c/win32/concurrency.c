@@ -0,0 +1,250 @@
+/*
+ * Copyright (C) 2026 Raven Computing
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef _WIN32
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <windows.h>
+
+#include "concurrency.h"
+
+struct Mutex {
+    SRWLOCK handle;
+};
+
+struct CondVar {
+    CONDITION_VARIABLE handle;
+};
+
+/**
+ * A task bound to its argument, as passed to a started thread.
+ */
+typedef struct BoundTask {
+    ConcurrentTask task;
+    void* arg;
+} BoundTask;
+
+static DWORD WINAPI runBoundTask(LPVOID arg) {
+    BoundTask* bound = (BoundTask*) arg;
+    bound->task(bound->arg);
+    return 0;
+}
+
+size_t runConcurrently(
+    ConcurrentTask task,
+    void* args,
+    size_t argSize,
+    size_t count
+) {
+    if (count == 0) {
+        return 0;
+    }
+    char* const argBytes = (char*) args;
+    size_t started = 0;
+    HANDLE* threads = NULL;
+    BoundTask* bound = NULL;
+    if (count > 1) {
+        threads = malloc((count - 1) * sizeof(HANDLE));
+        bound = malloc((count - 1) * sizeof(BoundTask));
+    }
+    if (threads && bound) {
+        for (size_t i = 1; i < count; ++i) {
+            bound[started] = (BoundTask){
+                .task = task,
+                .arg = argBytes + (i * argSize)
+            };
+            HANDLE thread = CreateThread(
+                NULL,
+                0,
+                runBoundTask,
+                &bound[started],
+                0,
+                NULL
+            );
+            if (!thread) {
+                break; // LCOV_EXCL_LINE
+            }
+            threads[started] = thread;
+            ++started;
+        }
+    }
+    task(argBytes);
+    for (size_t i = 0; i < started; ++i) {
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+    }
+    free(threads);
+    free(bound);
+    return started + 1;
+}
+
+Mutex* newMutex(void) {
+    Mutex* mutex = malloc(sizeof(Mutex));
+    if (mutex) {
+        InitializeSRWLock(&mutex->handle);
+    }
+    return mutex;
+}
+
+void freeMutex(Mutex* mutex) {
+    free(mutex);
+}
+
+void lockMutex(Mutex* mutex) {
+    AcquireSRWLockExclusive(&mutex->handle);
+}
+
+void unlockMutex(Mutex* mutex) {
+    ReleaseSRWLockExclusive(&mutex->handle);
+}
+
+CondVar* newCondVar(void) {
+    CondVar* condVar = malloc(sizeof(CondVar));
+    if (condVar) {
+        InitializeConditionVariable(&condVar->handle);
+    }
+    return condVar;
+}
+
+void freeCondVar(CondVar* condVar) {
+    free(condVar);
+}
+
+void waitCondVar(CondVar* condVar, Mutex* mutex) {
+    SleepConditionVariableSRW(&condVar->handle, &mutex->handle, INFINITE, 0);
+}
+
+void signalCondVar(CondVar* condVar) {
+    WakeConditionVariable(&condVar->handle);
+}
+
+void broadcastCondVar(CondVar* condVar) {
+    WakeAllConditionVariable(&condVar->handle);
+}
+
+/**
+ * The states of a `OnceFlag`.
+ */
+enum OnceState {
+    ONCE_NOT_CALLED = 0,
+    ONCE_CALLING = 1,
+    ONCE_CALLED = 2
+};
+
+void callOnce(OnceFlag* flag, OnceFunction function) {
+    // A size_t has the size of a pointer on all Windows targets
+    volatile PVOID* state = (volatile PVOID*) flag;
+    const PVOID previous = InterlockedCompareExchangePointer(
+        state,
+        (PVOID) ONCE_CALLING,
+        (PVOID) ONCE_NOT_CALLED
+    );
+    if (previous == (PVOID) ONCE_NOT_CALLED) {
+        function();
+        InterlockedExchangePointer(state, (PVOID) ONCE_CALLED);
+        return;
+    }
+    // The function only runs once, so waiting for it is rare and short
+    while (atomicLoad(flag) != ONCE_CALLED) {
+        SwitchToThread();
+    }
+}
+
+#ifdef _WIN64
+
+size_t atomicFetchAdd(size_t* value, size_t increment) {
+    return (size_t) InterlockedExchangeAdd64(
+        (volatile LONG64*) value,
+        (LONG64) increment
+    );
+}
+
+size_t atomicLoad(const size_t* value) {
+    return (size_t) InterlockedCompareExchange64(
+        (volatile LONG64*) value,
+        0,
+        0
+    );
+}
+
+void atomicStore(size_t* value, size_t desired) {
+    InterlockedExchange64((volatile LONG64*) value, (LONG64) desired);
+}
+
+void atomicStoreMin(size_t* value, size_t candidate) {
+    size_t current = atomicLoad(value);
+    while (candidate < current) {
+        const size_t previous = (size_t) InterlockedCompareExchange64(
+            (volatile LONG64*) value,
+            (LONG64) candidate,
+            (LONG64) current
+        );
+        if (previous == current) {
+            break;
+        }
+        current = previous;
+    }
+}
+
+#else
+
+size_t atomicFetchAdd(size_t* value, size_t increment) {
+    return (size_t) InterlockedExchangeAdd(
+        (volatile LONG*) value,
+        (LONG) increment
+    );
+}
+
+size_t atomicLoad(const size_t* value) {
+    return (size_t) InterlockedCompareExchange((volatile LONG*) value, 0, 0);
+}
+
+void atomicStore(size_t* value, size_t desired) {
+    InterlockedExchange((volatile LONG*) value, (LONG) desired);
+}
+
+void atomicStoreMin(size_t* value, size_t candidate) {
+    size_t current = atomicLoad(value);
+    while (candidate < current) {
+        const size_t previous = (size_t) InterlockedCompareExchange(
+            (volatile LONG*) value,
+            (LONG) candidate,
+            (LONG) current
+        );
+        if (previous == current) {
+            break;
+        }
+        current = previous;
+    }
+}
+
+#endif // _WIN64
+
+uint64_t monotonicTimeMicros(void) {
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    const uint64_t ticks = (uint64_t) counter.QuadPart;
+    const uint64_t perSecond = (uint64_t) frequency.QuadPart;
+    return ((ticks / perSecond) * 1000000)
+        + (((ticks % perSecond) * 1000000) / perSecond);
+}
+
+#endif // _WIN32
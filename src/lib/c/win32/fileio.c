@@ -20,8 +20,11 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 #include <assert.h>
+#include <sys/types.h>
+#include <sys/stat.h>
 #include <windows.h>
 
 #include "reckon/reckon.h"
@@ -66,7 +69,14 @@ bool hasTrailingSeparatorImpl(const char* path, size_t length) {
     );
 }
 
-void scanDirectory(char* dirPath, DirStack* stack, SourceFileList* list) {
+void scanDirectory(
+    char* dirPath,
+    DirStack* stack,
+    SourceFileList* list,
+    ScanBuffer* buffer
+) {
+    // The find functions provide their own buffer. All found
+    // entries already include their file attributes and size
     const size_t pathLength = strlen(dirPath);
     const bool trailingSep = hasTrailingSeparatorImpl(dirPath, pathLength);
     // Search pattern: dirPath + ("*" or "\*")
@@ -100,7 +110,16 @@ void scanDirectory(char* dirPath, DirStack* stack, SourceFileList* list) {
             + nameLength
             + 1
         );
-        char* fullPath = malloc(fullLength);
+        DWORD attributes = findData.dwFileAttributes;
+        const bool isDirectory = (attributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+        const bool isRegularFile = isRegularFileAttr(attributes);
+        if (!isDirectory && !isRegularFile) {
+            continue;
+        }
+        char* fullPath = allocArenaPath(
+            isRegularFile ? &buffer->filePaths : &buffer->dirPaths,
+            fullLength
+        );
         if (!fullPath) {
             continue;
         }
@@ -118,17 +137,15 @@ void scanDirectory(char* dirPath, DirStack* stack, SourceFileList* list) {
             );
         }
 
-        DWORD attributes = findData.dwFileAttributes;
-        const bool isDirectory = (attributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
-        const bool isRegularFile = isRegularFileAttr(attributes);
         if (isRegularFile) {
-            appendFile(list, fullPath);
-        }
-        if (isDirectory) {
+            const uint64_t size = (
+                ((uint64_t) findData.nFileSizeHigh << 32)
+                | findData.nFileSizeLow
+            );
+            appendFile(list, fullPath, (size_t) size);
+        } else {
             dirStackPush(stack, fullPath);
-            continue;
         }
-        free(fullPath);
     } while (FindNextFileA(found, &findData));
 
     FindClose(found);
@@ -174,4 +191,41 @@ const char* isValidStatsInput(const char* path) {
     return "Is not a regular file or directory";
 }
 
+bool mapFileContentImpl(RcnSourceFile* file, size_t maxSize) {
+    // Not supported. File contents are always read into allocated buffers
+    return false;
+}
+
+void unmapFileContentImpl(RcnSourceText content) {
+    // Not supported. See mapFileContentImpl()
+}
+
+bool getFileSizeImpl(FILE* handle, size_t* size) {
+    struct _stat64 attr;
+    if (_fstat64(_fileno(handle), &attr) != 0) {
+        return false;
+    }
+    if ((attr.st_mode & _S_IFMT) != _S_IFREG) {
+        return false;
+    }
+    *size = (attr.st_size > 0) ? (size_t) attr.st_size : 0;
+    return true;
+}
+
+void adviseFileRead(const char* path) {
+    // Not supported. File contents are only loaded when they are read
+}
+
+size_t probeFileSize(const char* path) {
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!path || !GetFileAttributesExA(path, GetFileExInfoStandard, &data)) {
+        return 0;
+    }
+    const uint64_t size = (
+        ((uint64_t) data.nFileSizeHigh << 32)
+        | data.nFileSizeLow
+    );
+    return (size_t) size;
+}
+
 #endif // _WIN32
@@ -20,8 +20,62 @@
 #include <ctype.h>
 
 #include "reckon/reckon.h"
+#include "evaluation.h"
+#include "simd.h"
 
-RcnCountResult rcnCountWords(RcnSourceText source) {
+ChunkedCount initWordCount(RcnSourceText start, TextEncoding encoding) {
+    return (ChunkedCount){
+        .encoding = encoding
+    };
+}
+
+size_t countWordsInChunk(
+    ChunkedCount* counter,
+    const char* chunk,
+    size_t size,
+    bool isFinal
+) {
+    if (counter->encoding == TextEncodingUTF8) {
+        counter->count += countWordStarts(chunk, size, &counter->inWord);
+        return size;
+    }
+    // UTF-16 with BOM indicating endianness
+    const size_t numUnits = size / 2;
+    counter->count += countUTF16WordStarts(
+        chunk,
+        numUnits,
+        &counter->inWord,
+        counter->encoding == TextEncodingUTF16LE
+    );
+    // A trailing single byte is only ignored at the end of the text
+    return isFinal ? size : (2 * numUnits);
+}
+
+size_t countLocaleWordsInChunk(
+    ChunkedCount* counter,
+    const char* chunk,
+    size_t size,
+    bool isFinal
+) {
+    bool inWord = counter->inWord;
+    for (size_t i = 0; i < size; ++i) {
+        unsigned char character = (unsigned char) chunk[i];
+        if (isspace(character)) {
+            inWord = false;
+        } else if (character && !inWord) {
+            counter->count++;
+            inWord = true;
+        }
+    }
+    counter->inWord = inWord;
+    return size;
+}
+
+RcnCountResult countWordsInText(
+    RcnSourceText source,
+    TextEncoding encoding,
+    bool isLocaleAware
+) {
     RcnCountResult result = {0};
     if (source.size == 0) {
         result.state.ok = true;
@@ -39,19 +93,19 @@ RcnCountResult rcnCountWords(RcnSourceText source) {
         return result;
     }
 
-    bool inWord = false;
-    for (size_t i = 0; i < source.size; ++i) {
-        unsigned char character = (unsigned char) source.text[i];
-        if (isspace(character)) {
-            inWord = false;
-        } else if (character && !inWord) {
-            result.count++;
-            inWord = true;
-        }
-    }
+    ChunkedCount counter = initWordCount(source, encoding);
+    const ChunkCounter countChunk = (
+        isLocaleAware ? countLocaleWordsInChunk : countWordsInChunk
+    );
+    countChunk(&counter, source.text, source.size, true);
+    result.count = counter.count;
 
     result.state.ok = true;
     result.state.errorCode = RCN_ERR_NONE;
 
     return result;
 }
+
+RcnCountResult rcnCountWords(RcnSourceText source) {
+    return countWordsInText(source, detectEncoding(source), false);
+}
@@ -78,7 +78,8 @@
  * particular metric and input combination.
  * For more information, please refer to the official Reckon documentation.
  * 
- * The functions in this library are not MT-safe.
+ * The functions in this library are not MT-safe. Some functions can
+ * internally use multiple threads if explicitly requested by the caller.
  *
  * @see https://docs.raven-computing.com/reckon/latest
  * @author Phil Gaiser
@@ -157,6 +158,31 @@ typedef enum RcnTextFormat {
 
 } RcnTextFormat;
 
+/**
+ * Enumeration of supported text encodings.
+ * 
+ * The encoding of a text is detected by the BOM at its start. A text without
+ * a BOM is assumed to be encoded with UTF-8.
+ */
+typedef enum RcnTextEncoding {
+
+    /**
+     * Text encoded with UTF-8, with or without a BOM.
+     */
+    RCN_ENC_UTF8 = 0,
+
+    /**
+     * Text encoded with UTF-16 in little-endian byte order, with a BOM.
+     */
+    RCN_ENC_UTF16LE = 1,
+
+    /**
+     * Text encoded with UTF-16 in big-endian byte order, with a BOM.
+     */
+    RCN_ENC_UTF16BE = 2
+
+} RcnTextEncoding;
+
 /**
  * Enumeration of error states.
  * 
@@ -209,7 +235,27 @@ typedef enum RcnErrorCode {
      * 
      * This is used as a catch-all for errors that are not further specified.
      */
-    RCN_ERR_UNKNOWN
+    RCN_ERR_UNKNOWN,
+
+    /**
+     * The input has binary content.
+     * 
+     * This indicates that the content of a source file is not text, even
+     * though the file has the file extension of a supported format. Such
+     * source files are skipped if `RcnStatOptions.skipBinaryContent` is set.
+     */
+    RCN_ERR_BINARY_CONTENT,
+
+    /**
+     * The parsing of source code was cancelled.
+     * 
+     * This indicates that the logical lines of code of a source file were not
+     * counted because its parsing exceeded the time budget specified by
+     * `RcnStatOptions.parseTimeoutMicros` or because all parsing was cancelled
+     * with `rcnCancelParsing()`. Such source files are skipped without
+     * stopping a count operation.
+     */
+    RCN_ERR_PARSE_CANCELLED
 
 } RcnErrorCode;
 
@@ -480,11 +526,86 @@ typedef struct RcnSourceFile {
      */
     bool isContentRead;
 
+    /**
+     * Indicates whether the content of the file is a read-only memory
+     * mapping of the file instead of an allocated copy.
+     * 
+     * A mapped content is still a null-terminated string, but it must
+     * not be modified. It is released together with the source file and
+     * must never be passed to `rcnFreeSourceText()`. It may only be set
+     * if `isContentRead` is `true`.
+     */
+    bool isContentMapped;
+
+    /**
+     * Indicates whether the path of the file is stored in memory that is
+     * shared with other files instead of being an individual allocation.
+     * 
+     * This is the case for files found by a directory scan, whose paths are
+     * packed together with the list of files they belong to. A shared path
+     * is released together with that list and must not be freed individually.
+     */
+    bool isPathShared;
+
     /**
      * The status code indicating the processing state of the source code file.
      */
     RcnFileOpStatus status;
 
+    /**
+     * The size in bytes of the file on disk, as seen when the file was found
+     * by a directory scan or when its content was last read.
+     * 
+     * It is only used as a hint, for example to schedule the processing of
+     * large files early. The actual size of the file content is given by
+     * `content.size` after the file has been read. Is zero if the file was
+     * neither read nor found by a directory scan, or if the scan has
+     * determined the type of the file without querying its size.
+     */
+    size_t scannedSize;
+
+    /**
+     * The text format of the source file, as detected from its file extension.
+     * 
+     * Is only valid if both `isFormatDetected` and `isFormatSupported` are
+     * `true`.
+     */
+    RcnTextFormat format;
+
+    /**
+     * Indicates whether the text format of the source file is supported.
+     * 
+     * Is only valid if `isFormatDetected` is `true`.
+     */
+    bool isFormatSupported;
+
+    /**
+     * Indicates whether the text format of the source file has been detected.
+     * 
+     * The format is detected once when the file is created by the Reckon
+     * library, so that it does not have to be detected again by every count
+     * operation on the file. If this is `false`, then the format is detected
+     * whenever it is needed.
+     */
+    bool isFormatDetected;
+
+    /**
+     * The text encoding of the content of the source file.
+     * 
+     * Is only valid if `isEncodingDetected` is `true`.
+     */
+    RcnTextEncoding encoding;
+
+    /**
+     * Indicates whether the text encoding of the content of the source file
+     * has been detected.
+     * 
+     * The encoding is detected once after the content has been read, so that
+     * it does not have to be detected again by every count operation on the
+     * content. It must be detected again whenever the content is read anew.
+     */
+    bool isEncodingDetected;
+
 } RcnSourceFile;
 
 /**
@@ -687,6 +808,32 @@ typedef enum RcnFormatOption {
 
 } RcnFormatOption;
 
+/**
+ * The engines to evaluate the logical lines of code of source code.
+ */
+typedef enum RcnLogicalLinesEngine {
+
+    /**
+     * Evaluates every node of the syntax tree of source code with the
+     * hand-written evaluation function of the programming language.
+     * This is the default engine.
+     */
+    RCN_LLC_ENGINE_VISITOR = 0,
+
+    /**
+     * Evaluates the syntax tree of source code by matching it against
+     * precompiled tree-sitter queries, one per programming language.
+     * 
+     * The counts of this engine agree with the ones of the visitor engine
+     * for common source code, including nodes whose evaluation depends on
+     * the line of other nodes, e.g. a struct specifier on the line of a
+     * declaration. They may still differ for rare combinations of such
+     * rules, e.g. a typedef on the line of another declaration.
+     */
+    RCN_LLC_ENGINE_QUERY = 1
+
+} RcnLogicalLinesEngine;
+
 /**
  * Options to customize the behaviour of counting operations.
  * 
@@ -740,8 +887,164 @@ typedef struct RcnStatOptions {
      */
     bool keepFileContent;
 
+    /**
+     * The maximum number of threads to use for processing source files.
+     * 
+     * If this is set to a value greater than one, then compound functions
+     * like `rcnCount()` may distribute the processing of source files across
+     * up to the specified number of threads, which includes the calling
+     * thread. The computed results are always the same as in a sequential
+     * processing of all source files, regardless of this option's value.
+     * 
+     * A value of zero (default) or one processes all source files
+     * sequentially on the calling thread.
+     */
+    uint32_t threads;
+
+    /**
+     * The number of source files to read ahead of the processing.
+     * 
+     * If this is set to a value greater than zero, then compound functions
+     * like `rcnCount()` advise the underlying platform that the content of
+     * up to the specified number of upcoming source files will be read soon.
+     * The platform may then load the file contents asynchronously while other
+     * files are still being processed. This can reduce the time spent waiting
+     * for I/O when the file contents are not yet cached. On platforms that
+     * do not support such advice, this option has no effect.
+     * 
+     * A value of zero (default) disables reading ahead.
+     */
+    uint32_t readAhead;
+
+    /**
+     * Whether to map file contents into memory instead of copying them.
+     * 
+     * If this is set to `true`, then compound functions like `rcnCount()`
+     * may access the content of a source file through a read-only memory
+     * mapping of the file, which avoids copying the file content into an
+     * allocated buffer. Files for which a mapping is not possible or not
+     * worthwhile, e.g. very small files, are read as usual. A mapped file
+     * must not be truncated while it is being processed, e.g. by a log
+     * rotation, since accessing the truncated part of a mapping terminates
+     * the process with a bus error instead of causing a read error. Only
+     * enable this option for files that are not modified during the count
+     * operation. On platforms that do not support memory mappings, this
+     * option has no effect.
+     */
+    bool mapFileContent;
+
+    /**
+     * Whether to delimit words by the white space characters of the
+     * current locale.
+     * 
+     * By default, words are delimited by the white space characters of the
+     * "C" locale, i.e. space, form feed, line feed, carriage return,
+     * horizontal tab and vertical tab, regardless of the locale that is set
+     * in the process. If this is set to `true`, then the words are delimited
+     * by the characters classified as white space by `isspace()` in the
+     * current locale, as in previous versions. The word counts may then
+     * depend on calls to `setlocale()` made by the application.
+     */
+    bool localeWordDelimiters;
+
+    /**
+     * Whether to transcode UTF-16 encoded source texts to UTF-8 before
+     * counting them.
+     * 
+     * If this is set to `true`, then compound functions like `rcnCount()`
+     * transcode the content of a UTF-16 encoded source file to UTF-8 once
+     * and perform all count operations on the transcoded text, instead of
+     * decoding UTF-16 in every count operation. The counts are the same
+     * either way and the source size always refers to the original content
+     * of the file. Source texts which cannot be transcoded without changing
+     * their counts, e.g. due to an unpaired surrogate, are counted as they
+     * are. Source files that are read in chunks because of their size are
+     * not transcoded.
+     */
+    bool transcodeUTF16;
+
+    /**
+     * Whether to skip source files with binary content.
+     * 
+     * If this is set to `true`, then compound functions like `rcnCount()`
+     * inspect the first few kilobytes of the content of a source file before
+     * counting it. A source file which appears to have binary content, i.e.
+     * which contains null bytes outside of UTF-16 encoded text or a high
+     * proportion of other control characters, is then not counted and its
+     * result state has the error code `RCN_ERR_BINARY_CONTENT`. This avoids
+     * counting, and parsing, files that merely have the file extension of a
+     * supported format. A skipped file does not stop the count operation,
+     * regardless of `stopOnError`.
+     */
+    bool skipBinaryContent;
+
+    /**
+     * The minimum size in bytes of the content of a source file for it to
+     * be counted in multiple segments concurrently.
+     * 
+     * If this is set to a value greater than zero and `threads` is greater
+     * than one, then compound functions like `rcnCount()` split the content
+     * of a source file of at least the specified size into segments at
+     * character boundaries and count the physical lines, words and
+     * characters of the segments concurrently on up to `threads` threads.
+     * This speeds up the counting of a single large file, e.g. a log file,
+     * which would otherwise be processed by a single thread. The counts are
+     * always the same as without splitting. The logical lines are never
+     * counted in segments. Source files that are read in chunks because of
+     * their size are split chunk by chunk. When the source files themselves
+     * are distributed across multiple threads, the segments of a large file
+     * are counted by the threads that have no other files left to count.
+     * 
+     * A value of zero (default) disables the splitting of contents.
+     */
+    uint32_t splitThreshold;
+
+    /**
+     * The engine to evaluate the logical lines of code with.
+     * 
+     * Compound functions like `rcnCount()` use the specified engine when
+     * the logical lines of code are counted. The default is the visitor
+     * engine. See `RcnLogicalLinesEngine` for the available engines.
+     */
+    RcnLogicalLinesEngine logicalLinesEngine;
+
+    /**
+     * The maximum time in microseconds to spend on parsing the source code
+     * of a single source file.
+     * 
+     * If this is set to a value greater than zero, then compound functions
+     * like `rcnCount()` cancel the parsing of a source file once it takes
+     * longer than the specified time, e.g. for a generated source file with
+     * huge macro tables. Such a source file is then not counted and its
+     * result state has the error code `RCN_ERR_PARSE_CANCELLED`. A cancelled
+     * file does not stop the count operation, regardless of `stopOnError`,
+     * so that all files which were cut off are reported in the results.
+     * 
+     * A value of zero (default) disables the time budget.
+     */
+    uint64_t parseTimeoutMicros;
+
 } RcnStatOptions;
 
+/**
+ * A count operation on source text that is provided in consecutive chunks.
+ * 
+ * A count stream computes the physical lines, words and characters of a
+ * source text without requiring the entire text to be in memory at once.
+ * Thus, it can be used to count arbitrarily large source texts, e.g.
+ * multi-gigabyte log files, in constant memory. The source text can be split
+ * into chunks at any byte position, including positions within a line, a word
+ * or a multi-byte encoded character. The computed counts are the same as the
+ * ones of the corresponding count functions for the entire source text,
+ * e.g. `rcnCountPhysicalLines()`, but not limited in the size of the text.
+ * 
+ * This is an opaque type. Use `rcnCreateCountStream()` to create a stream,
+ * pass the chunks of source text in order to `rcnUpdateCountStream()`, get
+ * the results with `rcnFinishCountStream()` and finally free the stream
+ * with `rcnFreeCountStream()`.
+ */
+typedef struct RcnCountStream RcnCountStream;
+
 /**
  * Creates a new `RcnCountStatistics` struct for the specified file path.
  *
@@ -764,7 +1067,8 @@ RECKON_EXPORT RcnCountStatistics* rcnCreateCountStatistics(const char* path);
 /**
  * Frees a previously allocated `RcnCountStatistics` struct.
  * 
- * Must have been previously allocated using `rcnCreateCountStatistics()`.
+ * Must have been previously allocated using `rcnCreateCountStatistics()`
+ * or `rcnCountPath()`.
  *
  * @param stats The `RcnCountStatistics` struct to free. May be `NULL`.
  */
@@ -778,15 +1082,48 @@ RECKON_EXPORT void rcnFreeCountStatistics(RcnCountStatistics* stats);
  * the given options. The files inside the given statistics must exist and be
  * readable regular text files.
  * 
- * This function is not idempotent with respect to the same stats struct.
- * Calling it multiple times on the same `RcnCountStatistics` struct is
- * undefined behaviour.
+ * This function can be called multiple times on the same
+ * `RcnCountStatistics` struct, e.g. with different options. Every call
+ * first resets all counts and result states of the statistics, so that they
+ * only reflect the last call. The text format of each source file is
+ * detected once when the statistics are created and is reused by every call.
+ * The content of a source file and its detected text encoding are only
+ * reused by a subsequent call if `RcnStatOptions.keepFileContent` was set,
+ * otherwise the content is read and its encoding detected again. Source
+ * files that could not be read keep their error status.
  *
  * @param stats The statistics to evaluate.
  * @param options Options to customize the analysis behaviour.
  */
 RECKON_EXPORT void rcnCount(RcnCountStatistics* stats, RcnStatOptions options);
 
+/**
+ * Creates a new `RcnCountStatistics` struct for the specified file path and
+ * performs counting operations using the specified statistics options.
+ *
+ * The returned statistics are the same as if they were created with
+ * `rcnCreateCountStatistics()` and then passed to `rcnCount()`. If the
+ * creation of the statistics fails with an error state, the statistics are
+ * returned without performing any counting operations. If the specified path
+ * denotes a directory and `RcnStatOptions.threads` is greater than one, then
+ * the directory is scanned while already found files are processed
+ * concurrently. This hides the latency of the directory traversal behind the
+ * counting operations. The files in the returned statistics are always sorted
+ * in the same order as by `rcnCreateCountStatistics()`.
+ *
+ * A user takes ownership of the returned struct and must free it with
+ * `rcnFreeCountStatistics()`.
+ *
+ * @param path A path in the file system. Is interpreted as a byte sequence in
+ *             the underlying platform's native encoding.
+ * @param options Options to customize the analysis behaviour.
+ * @return A newly allocated `RcnCountStatistics` struct, or `NULL` on error.
+ */
+RECKON_EXPORT RcnCountStatistics* rcnCountPath(
+    const char* path,
+    RcnStatOptions options
+);
+
 /**
  * Counts the number of logical lines of code in the specified source text.
  * 
@@ -803,6 +1140,24 @@ RECKON_EXPORT RcnCountResult rcnCountLogicalLines(
     RcnSourceText sourceCode
 );
 
+/**
+ * Sets whether all parsing of source code is cancelled.
+ *
+ * This is a global flag which affects all threads and all operations that
+ * count logical lines of code. While the flag is set, the parsing of source
+ * code is cancelled as soon as possible, including parsing that is already
+ * in progress, and the affected results have the error code
+ * `RCN_ERR_PARSE_CANCELLED`. Compound functions like `rcnCount()` still
+ * run to completion, but skip every source file whose logical lines would
+ * have to be counted, so that they finish quickly. This function can be
+ * called from any thread, e.g. when an application is interrupted. The flag
+ * is not set initially and stays set until it is cleared by calling this
+ * function with `false`.
+ *
+ * @param cancel Whether parsing is cancelled.
+ */
+RECKON_EXPORT void rcnCancelParsing(bool cancel);
+
 /**
  * Marks the counted logical lines in the source code of the specified file.
  *
@@ -816,8 +1171,10 @@ RECKON_EXPORT RcnCountResult rcnCountLogicalLines(
  * language.
  * 
  * See header documentation for details on how logical lines of code are
- * defined. The text in the file must be encoded with UTF-8. Other encodings
- * are not supported by this function and result in undefined behaviour.
+ * defined. The text in the file must be encoded with UTF-8, or with UTF-16
+ * with a BOM. UTF-16 encoded text is transcoded to UTF-8, so that the
+ * returned text is always encoded with UTF-8. Other encodings are not
+ * supported by this function and result in undefined behaviour.
  *
  * @param path The file system path of the source code file to annotate.
  *             Is interpreted as a byte sequence in the underlying platform's
@@ -843,8 +1200,11 @@ RECKON_EXPORT RcnSourceText rcnMarkLogicalLinesInFile(const char* path);
  * `RcnTextFormat` enumerators that represent a supported programming language.
  * 
  * See header documentation for details on how logical lines of code are
- * defined. The specified source code text must be encoded with UTF-8. Other
- * encodings are not supported by this function and result
+ * defined. The specified source code text must be encoded with UTF-8, or
+ * with UTF-16 with a BOM. UTF-16 encoded text is transcoded to UTF-8, so that
+ * the returned text is always encoded with UTF-8. UTF-16 encoded text which
+ * cannot be transcoded, e.g. due to an unpaired surrogate, is not supported.
+ * Other encodings are not supported by this function and result
  * in undefined behaviour.
  *
  * @param language The format of the specified source code. Must denote a
@@ -867,7 +1227,9 @@ RECKON_EXPORT RcnSourceText rcnMarkLogicalLinesInSourceText(
  * 
  * Use this deallocation function for `RcnSourceText` structs that were
  * returned by functions of this API that allocate new source text.
- * The struct must not be used after calling this function.
+ * The struct must not be used after calling this function. The content of
+ * a `RcnSourceFile` must not be freed with this function, since it might
+ * be a memory mapping, as indicated by `isContentMapped`.
  * 
  * @param source The `RcnSourceText` struct to free. The provided struct
  *               and the `text` field may be `NULL`.
@@ -894,7 +1256,9 @@ RECKON_EXPORT RcnCountResult rcnCountPhysicalLines(RcnSourceText source);
  * Counts the number of words in the specified source text.
  * 
  * A word is a non-zero-length sequence of printable characters delimited
- * by white space. See header documentation for details on supported encodings.
+ * by white space. White space characters are those of the "C" locale, so
+ * that the count does not depend on the current locale. See header
+ * documentation for details on supported encodings.
  *
  * @param source The source text to count words in.
  * @return A `RcnCountResult` containing the word count.
@@ -914,6 +1278,82 @@ RECKON_EXPORT RcnCountResult rcnCountWords(RcnSourceText source);
  */
 RECKON_EXPORT RcnCountResult rcnCountCharacters(RcnSourceText source);
 
+/**
+ * Counts the specified text metrics in the specified source text.
+ * 
+ * The specified operations are a bitwise combination of `RcnCountOption`
+ * values. Only physical lines, words and characters can be counted by
+ * this function. Other selected operations are ignored. All selected metrics
+ * are counted in a single pass over the source text. The computed counts are
+ * the same as the ones of the corresponding count functions, e.g.
+ * `rcnCountPhysicalLines()`, but the text is only read once, which is
+ * faster when more than one metric is selected.
+ *
+ * @param source The source text to count the metrics in.
+ * @param operations The text metrics to count.
+ * @return A `RcnCountResultGroup` containing the counts of the selected
+ *         metrics. The source size is the size of the source text.
+ */
+RECKON_EXPORT RcnCountResultGroup rcnCountTextMetrics(
+    RcnSourceText source,
+    uint32_t operations
+);
+
+/**
+ * Creates a new count stream for the specified counting operations.
+ * 
+ * The specified operations are a bitwise combination of `RcnCountOption`
+ * values. Only physical lines, words and characters can be counted
+ * by a stream. Other selected operations are ignored.
+ * 
+ * A user takes ownership of the returned stream and must free it with
+ * `rcnFreeCountStream()`.
+ *
+ * @param operations The counting operations to perform.
+ * @return A newly allocated `RcnCountStream`, or `NULL` on error.
+ */
+RECKON_EXPORT RcnCountStream* rcnCreateCountStream(uint32_t operations);
+
+/**
+ * Counts in the next chunk of source text of the specified count stream.
+ * 
+ * The chunk is not retained by the stream and can be reused or freed by the
+ * caller after this function returns. Empty chunks are allowed. Once a call
+ * has failed, or after the stream was finished, all subsequent calls fail.
+ *
+ * @param stream The count stream to update. Must not be `NULL`.
+ * @param chunk The next chunk of the source text.
+ * @return `true` if the chunk was counted, `false` on error.
+ */
+RECKON_EXPORT bool rcnUpdateCountStream(
+    RcnCountStream* stream,
+    RcnSourceText chunk
+);
+
+/**
+ * Finishes the specified count stream and returns the computed counts.
+ * 
+ * The end of the source text is given by the end of the last chunk
+ * that was passed to the stream. In the returned result group, only the
+ * counts of the selected operations are set. The source size is the total
+ * size of all chunks. If an error has occurred, the state of the returned
+ * group indicates the error and no counts are available. A stream can only
+ * be finished once.
+ *
+ * @param stream The count stream to finish. Must not be `NULL`.
+ * @return A `RcnCountResultGroup` containing the computed counts.
+ */
+RECKON_EXPORT RcnCountResultGroup rcnFinishCountStream(RcnCountStream* stream);
+
+/**
+ * Frees a previously allocated `RcnCountStream`.
+ * 
+ * Must have been previously allocated using `rcnCreateCountStream()`.
+ *
+ * @param stream The `RcnCountStream` to free. May be `NULL`.
+ */
+RECKON_EXPORT void rcnFreeCountStream(RcnCountStream* stream);
+
 #ifdef __cplusplus
 }
 #endif
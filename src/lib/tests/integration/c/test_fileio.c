@@ -16,6 +16,7 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdbool.h>
 #include <string.h>
 
 #include "unity.h"
@@ -126,6 +127,12 @@ void testInitSourceFile(void) {
     TEST_ASSERT_EQUAL_STRING("txt", file.extension);
     TEST_ASSERT_EQUAL_STRING(path, file.path);
     TEST_ASSERT_EQUAL_INT(RCN_FILE_OP_OK, file.status);
+    TEST_ASSERT_EQUAL_INT(0, file.scannedSize);
+    TEST_ASSERT_FALSE(file.isPathShared);
+    TEST_ASSERT_TRUE(file.isFormatDetected);
+    TEST_ASSERT_TRUE(file.isFormatSupported);
+    TEST_ASSERT_EQUAL_INT(RCN_TEXT_UNFORMATTED, file.format);
+    TEST_ASSERT_FALSE(file.isEncodingDetected);
     deinitSourceFile(&file);
 }
 
@@ -172,6 +179,120 @@ void testFreeSourceFileContent(void) {
     freeSourceFile(file);
 }
 
+void testFreeSourceFileContentResetsDetectedEncoding(void) {
+    RcnSourceFile* file = newSourceFile(PATH_SAMPLE_DIR1_FILE1);
+    TEST_ASSERT_TRUE(readSourceFileContent(file));
+    file->encoding = RCN_ENC_UTF16LE;
+    file->isEncodingDetected = true;
+    freeSourceFileContent(file);
+    TEST_ASSERT_FALSE(file->isEncodingDetected);
+    // The detected format is not bound to the content
+    TEST_ASSERT_TRUE(file->isFormatDetected);
+    freeSourceFile(file);
+}
+
+void testReadSourceFileContentMapped(void) {
+    char* path = RECKON_TEST_PATH_RES_BASE "/java/SampleAnnotated.java";
+    RcnSourceFile* expected = newSourceFile(path);
+    RcnSourceFile* file = newSourceFile(path);
+    TEST_ASSERT_TRUE(readSourceFileContent(expected));
+    TEST_ASSERT_TRUE(readSourceFileContentMapped(file, NULL));
+    TEST_ASSERT_TRUE(file->isContentRead);
+#ifdef __linux__
+    TEST_ASSERT_TRUE(file->isContentMapped);
+#endif
+    TEST_ASSERT_EQUAL_INT(RCN_FILE_OP_OK, file->status);
+    TEST_ASSERT_EQUAL_INT(7424, file->content.size);
+    TEST_ASSERT_EQUAL_INT(expected->content.size, file->content.size);
+    TEST_ASSERT_EQUAL_STRING(expected->content.text, file->content.text);
+    TEST_ASSERT_EQUAL_INT(0, file->content.text[file->content.size]);
+    // Read should be idempotent
+    TEST_ASSERT_TRUE(readSourceFileContentMapped(file, NULL));
+    freeSourceFileContent(file);
+    TEST_ASSERT_FALSE(file->isContentRead);
+    TEST_ASSERT_FALSE(file->isContentMapped);
+    TEST_ASSERT_NULL(file->content.text);
+    TEST_ASSERT_EQUAL_INT(0, file->content.size);
+    freeSourceFile(expected);
+    freeSourceFile(file);
+}
+
+void testReadSourceFileContentMappedOfSmallFileIsCopied(void) {
+    RcnSourceFile* file = newSourceFile(PATH_SAMPLE_DIR1_FILE1);
+    TEST_ASSERT_TRUE(readSourceFileContentMapped(file, NULL));
+    TEST_ASSERT_TRUE(file->isContentRead);
+    TEST_ASSERT_FALSE(file->isContentMapped);
+    TEST_ASSERT_EQUAL_STRING("File: res/txt/1sample1.txt", file->content.text);
+    freeSourceFile(file);
+}
+
+void testReadSourceFileContentMappedOfNonExistentFileFails(void) {
+    char* nonexistent = RECKON_TEST_PATH_RES_BASE "/this-file-does-not-exist";
+    RcnSourceFile* file = newSourceFile(nonexistent);
+    TEST_ASSERT_FALSE(readSourceFileContentMapped(file, NULL));
+    TEST_ASSERT_FALSE(file->isContentRead);
+    TEST_ASSERT_FALSE(file->isContentMapped);
+    TEST_ASSERT_EQUAL_INT(RCN_FILE_OP_FILE_NOT_FOUND, file->status);
+    freeSourceFile(file);
+    TEST_ASSERT_FALSE(readSourceFileContentMapped(NULL, NULL));
+}
+
+void testReadSourceFileContentBufferedReusesReleasedMemory(void) {
+    char* path = RECKON_TEST_PATH_RES_BASE "/java/SampleAnnotated.java";
+    RcnSourceFile* large = newSourceFile(path);
+    RcnSourceFile* small = newSourceFile(PATH_SAMPLE_DIR1_FILE1);
+    ReadBuffer buffer = {0};
+    TEST_ASSERT_TRUE(readSourceFileContentBuffered(large, &buffer));
+    TEST_ASSERT_TRUE(large->isContentRead);
+    TEST_ASSERT_EQUAL_INT(7424, large->content.size);
+    TEST_ASSERT_EQUAL_INT(0, large->content.text[large->content.size]);
+    const char* memory = large->content.text;
+    releaseSourceFileContent(large, &buffer);
+    TEST_ASSERT_FALSE(large->isContentRead);
+    TEST_ASSERT_NULL(large->content.text);
+    TEST_ASSERT_EQUAL_INT(0, large->content.size);
+    TEST_ASSERT_TRUE(readSourceFileContentBuffered(small, &buffer));
+    TEST_ASSERT_TRUE(small->content.text == memory);
+    TEST_ASSERT_EQUAL_STRING("File: res/txt/1sample1.txt", small->content.text);
+    releaseSourceFileContent(small, &buffer);
+    freeReadBuffer(&buffer);
+    TEST_ASSERT_NULL(buffer.data);
+    freeSourceFile(large);
+    freeSourceFile(small);
+}
+
+void testReadSourceFileContentBufferedKeepsUnreleasedContent(void) {
+    RcnSourceFile* kept = newSourceFile(PATH_SAMPLE_DIR1_FILE1);
+    RcnSourceFile* file = newSourceFile(PATH_SAMPLE_DIR1_FILE1);
+    ReadBuffer buffer = {0};
+    TEST_ASSERT_TRUE(readSourceFileContentBuffered(kept, &buffer));
+    // The content of the first file is not released, so it is owned by
+    // that file and the second file is read into other memory
+    TEST_ASSERT_TRUE(readSourceFileContentBuffered(file, &buffer));
+    TEST_ASSERT_TRUE(kept->content.text != file->content.text);
+    TEST_ASSERT_EQUAL_STRING(kept->content.text, file->content.text);
+    // Content of other memory is freed when released
+    releaseSourceFileContent(kept, &buffer);
+    TEST_ASSERT_FALSE(kept->isContentRead);
+    freeReadBuffer(&buffer);
+    // Content of the buffer's memory that is not returned stays valid
+    TEST_ASSERT_EQUAL_STRING("File: res/txt/1sample1.txt", file->content.text);
+    freeSourceFile(kept);
+    freeSourceFile(file);
+}
+
+void testReadSourceFileContentBufferedWithoutBuffer(void) {
+    RcnSourceFile* file = newSourceFile(PATH_SAMPLE_DIR1_FILE1);
+    TEST_ASSERT_TRUE(readSourceFileContentBuffered(file, NULL));
+    TEST_ASSERT_TRUE(file->isContentRead);
+    TEST_ASSERT_EQUAL_STRING("File: res/txt/1sample1.txt", file->content.text);
+    releaseSourceFileContent(file, NULL);
+    TEST_ASSERT_FALSE(file->isContentRead);
+    TEST_ASSERT_NULL(file->content.text);
+    TEST_ASSERT_FALSE(readSourceFileContentBuffered(NULL, NULL));
+    freeSourceFile(file);
+}
+
 void testReadSourceFileContentOfNonExistentFileFails(void) {
     char* nonexistent = RECKON_TEST_PATH_RES_BASE "/this-file-does-not-exist";
     RcnSourceFile* file = newSourceFile(nonexistent);
@@ -224,12 +345,64 @@ void testReadSourceFileFailsWhenFilePathIsNull(void) {
     freeSourceFile(file);
 }
 
+void testReadSourceFileHead(void) {
+    RcnSourceFile* file = newSourceFile(PATH_SAMPLE_DIR1_FILE1);
+    char buffer[64] = {0};
+    size_t size = 0;
+    TEST_ASSERT_TRUE(readSourceFileHead(file, buffer, 6, &size));
+    TEST_ASSERT_EQUAL_INT(6, size);
+    TEST_ASSERT_EQUAL_STRING("File: ", buffer);
+    TEST_ASSERT_FALSE(file->isContentRead);
+    TEST_ASSERT_NULL(file->content.text);
+    TEST_ASSERT_EQUAL_INT(RCN_FILE_OP_OK, file->status);
+    // The head of a small file is its entire content
+    TEST_ASSERT_TRUE(readSourceFileHead(file, buffer, sizeof(buffer), &size));
+    TEST_ASSERT_EQUAL_INT(strlen("File: res/txt/1sample1.txt"), size);
+    freeSourceFile(file);
+}
+
+void testReadSourceFileHeadOfNonExistentFileFails(void) {
+    char* nonexistent = RECKON_TEST_PATH_RES_BASE "/this-file-does-not-exist";
+    RcnSourceFile* file = newSourceFile(nonexistent);
+    char buffer[16];
+    size_t size = 0;
+    TEST_ASSERT_FALSE(readSourceFileHead(file, buffer, sizeof(buffer), &size));
+    TEST_ASSERT_EQUAL_INT(RCN_FILE_OP_FILE_NOT_FOUND, file->status);
+    TEST_ASSERT_FALSE(readSourceFileHead(file, buffer, sizeof(buffer), &size));
+    TEST_ASSERT_FALSE(readSourceFileHead(NULL, buffer, sizeof(buffer), &size));
+    freeSourceFile(file);
+}
+
+void testAdviseFileReadDoesNotChangeFile(void) {
+    RcnSourceFile* file = newSourceFile(PATH_SAMPLE_DIR1_FILE1);
+    adviseFileRead(file->path);
+    TEST_ASSERT_FALSE(file->isContentRead);
+    TEST_ASSERT_NULL(file->content.text);
+    TEST_ASSERT_EQUAL_INT(RCN_FILE_OP_OK, file->status);
+    TEST_ASSERT_TRUE(readSourceFileContent(file));
+    TEST_ASSERT_EQUAL_INT(strlen(file->content.text), file->content.size);
+    freeSourceFile(file);
+}
+
+void testAdviseFileReadIgnoresNonExistentFile(void) {
+    adviseFileRead(PATH_DIR_RES1 "/doesNotExist.txt");
+    adviseFileRead(NULL);
+    RcnSourceFile* file = newSourceFile(PATH_DIR_RES1 "/doesNotExist.txt");
+    TEST_ASSERT_FALSE(readSourceFileContent(file));
+    TEST_ASSERT_EQUAL_INT(RCN_FILE_OP_FILE_NOT_FOUND, file->status);
+    freeSourceFile(file);
+}
+
 void testDetectSourceFormatSupported(void) {
     RcnSourceFile* file = newSourceFile(PATH_SAMPLE_JAVA_FILE);
     TEST_ASSERT_NOT_NULL(file);
     SourceFormatDetection detection = detectSourceFormat(file);
     TEST_ASSERT_TRUE(detection.isSupportedFormat);
+    TEST_ASSERT_TRUE(detection.isProgrammingLanguage);
     TEST_ASSERT_EQUAL_INT(RCN_LANG_JAVA, detection.format);
+    TEST_ASSERT_TRUE(file->isFormatDetected);
+    TEST_ASSERT_TRUE(file->isFormatSupported);
+    TEST_ASSERT_EQUAL_INT(RCN_LANG_JAVA, file->format);
     freeSourceFile(file);
 }
 
@@ -238,9 +411,20 @@ void testDetectSourceFormatUnsupported(void) {
     TEST_ASSERT_NOT_NULL(file);
     SourceFormatDetection detection = detectSourceFormat(file);
     TEST_ASSERT_FALSE(detection.isSupportedFormat);
+    TEST_ASSERT_TRUE(file->isFormatDetected);
+    TEST_ASSERT_FALSE(file->isFormatSupported);
     freeSourceFile(file);
 }
 
+void testDetectSourceFormatOfRecordWithoutStoredFormat(void) {
+    RcnSourceFile file = {0};
+    file.extension = "c";
+    SourceFormatDetection detection = detectSourceFormat(&file);
+    TEST_ASSERT_TRUE(detection.isSupportedFormat);
+    TEST_ASSERT_TRUE(detection.isProgrammingLanguage);
+    TEST_ASSERT_EQUAL_INT(RCN_LANG_C, detection.format);
+}
+
 void testCreateSourceFileListOfEmptyDirectory(void) {
     char* emptyDirectory = PATH_DIR_RES4;
     SourceFileList fileList = newSourceFileList(emptyDirectory);
@@ -317,6 +501,197 @@ void testCreateSourceFileListOfDirectoryWithTrailingSlashInPath(void) {
     freeSourceFileList(&fileList);
 }
 
+void testCreateSourceFileListRecordsScannedSizeIfSeen(void) {
+    char* dirPath = RECKON_TEST_PATH_RES_BASE "/java";
+    SourceFileList fileList = newSourceFileList(dirPath);
+    TEST_ASSERT_TRUE(fileList.ok);
+    TEST_ASSERT_EQUAL_INT(3, fileList.size);
+    const size_t expectedSizes[] = {4709, 7424, 4061};
+    for (size_t i = 0; i < fileList.size; ++i) {
+        // The scan may determine the file type without querying the size
+        const size_t scannedSize = fileList.files[i].scannedSize;
+        TEST_ASSERT_TRUE(scannedSize == 0 || scannedSize == expectedSizes[i]);
+    }
+    freeSourceFileList(&fileList);
+}
+
+void testReadSourceFileContentRecordsScannedSize(void) {
+    char* path = RECKON_TEST_PATH_RES_BASE "/java/SampleAnnotated.java";
+    RcnSourceFile* file1 = newSourceFile(path);
+    RcnSourceFile* file2 = newSourceFile(path);
+    TEST_ASSERT_EQUAL_INT(0, file1->scannedSize);
+    TEST_ASSERT_TRUE(readSourceFileContent(file1));
+    TEST_ASSERT_EQUAL_INT(7424, file1->scannedSize);
+    TEST_ASSERT_TRUE(readSourceFileContentMapped(file2, NULL));
+    TEST_ASSERT_EQUAL_INT(7424, file2->scannedSize);
+    // The size is kept as a hint after the content is released
+    freeSourceFileContent(file1);
+    TEST_ASSERT_EQUAL_INT(7424, file1->scannedSize);
+    freeSourceFile(file1);
+    freeSourceFile(file2);
+}
+
+void testProbeFileSize(void) {
+    TEST_ASSERT_EQUAL_INT(26, probeFileSize(PATH_SAMPLE_DIR1_FILE1));
+    TEST_ASSERT_EQUAL_INT(
+        7424,
+        probeFileSize(RECKON_TEST_PATH_RES_BASE "/java/SampleAnnotated.java")
+    );
+    TEST_ASSERT_EQUAL_INT(0, probeFileSize(PATH_DIR_RES1 "/non_existent.txt"));
+    TEST_ASSERT_EQUAL_INT(0, probeFileSize(NULL));
+}
+
+static bool countStreamedFile(RcnSourceFile* file, void* arg) {
+    size_t* count = (size_t*) arg;
+    *count += 1;
+    deinitSourceFile(file);
+    return true;
+}
+
+static bool abortStreamedFiles(RcnSourceFile* file, void* arg) {
+    deinitSourceFile(file);
+    return false;
+}
+
+void testCreateSourceFileListConcurrently(void) {
+    char* dirPath = PATH_DIR_RES1;
+    SourceFileList fileList = newSourceFileListConcurrently(dirPath, 4);
+    TEST_ASSERT_TRUE(fileList.ok);
+    TEST_ASSERT_EQUAL_INT(6, fileList.size);
+    TEST_ASSERT_NOT_NULL(fileList.files);
+    RcnSourceFile* file1 = &fileList.files[0];
+    assertValidFileListItem(file1, "1" FILE_SAMPLE1, PATH_SAMPLE_DIR1_FILE1);
+    RcnSourceFile* file2 = &fileList.files[1];
+    assertValidFileListItem(file2, "1" FILE_SAMPLE2, PATH_SAMPLE_DIR1_FILE2);
+    RcnSourceFile* file3 = &fileList.files[2];
+    assertValidFileListItem(file3, "1" FILE_SAMPLE3, PATH_SAMPLE_DIR1_FILE3);
+    RcnSourceFile* file4 = &fileList.files[3];
+    assertValidFileListItem(file4, "2" FILE_SAMPLE1, PATH_SAMPLE_DIR2_FILE1);
+    RcnSourceFile* file5 = &fileList.files[4];
+    assertValidFileListItem(file5, "2" FILE_SAMPLE2, PATH_SAMPLE_DIR2_FILE2);
+    RcnSourceFile* file6 = &fileList.files[5];
+    assertValidFileListItem(file6, "3" FILE_SAMPLE1, PATH_SAMPLE_DIR3_FILE1);
+    freeSourceFileList(&fileList);
+}
+
+void testCreateSourceFileListConcurrentlyMatchesSequential(void) {
+    char* dirPath = RECKON_TEST_PATH_RES_BASE;
+    SourceFileList expected = newSourceFileList(dirPath);
+    SourceFileList actual = newSourceFileListConcurrently(dirPath, 8);
+    TEST_ASSERT_TRUE(actual.ok);
+    TEST_ASSERT_TRUE(actual.size > 8);
+    TEST_ASSERT_EQUAL_INT(expected.size, actual.size);
+    for (size_t i = 0; i < expected.size; ++i) {
+        TEST_ASSERT_EQUAL_STRING(expected.files[i].path, actual.files[i].path);
+    }
+    freeSourceFileList(&expected);
+    freeSourceFileList(&actual);
+}
+
+void testCreateSourceFileListConcurrentlyOfEmptyDirectory(void) {
+    char* emptyDirectory = PATH_DIR_RES4;
+    SourceFileList fileList = newSourceFileListConcurrently(emptyDirectory, 4);
+    TEST_ASSERT_TRUE(fileList.ok);
+    TEST_ASSERT_EQUAL_INT(0, fileList.size);
+    TEST_ASSERT_NULL(fileList.files);
+}
+
+void testStreamSourceFilesConcurrently(void) {
+    char* dirPath = RECKON_TEST_PATH_RES_BASE;
+    SourceFileList expected = newSourceFileList(dirPath);
+    size_t count = 0;
+    TEST_ASSERT_TRUE(streamSourceFiles(dirPath, 4, countStreamedFile, &count));
+    TEST_ASSERT_EQUAL_INT(expected.size, count);
+    freeSourceFileList(&expected);
+}
+
+void testStreamSourceFilesAbortedByConsumer(void) {
+    char* dirPath = RECKON_TEST_PATH_RES_BASE;
+    TEST_ASSERT_FALSE(streamSourceFiles(dirPath, 4, abortStreamedFiles, NULL));
+    TEST_ASSERT_FALSE(streamSourceFiles(NULL, 4, abortStreamedFiles, NULL));
+}
+
+void testCreateSourceFileListPacksFilePaths(void) {
+    char* dirPath = RECKON_TEST_PATH_RES_BASE;
+    SourceFileList fileList = newSourceFileListConcurrently(dirPath, 4);
+    TEST_ASSERT_TRUE(fileList.ok);
+    TEST_ASSERT_TRUE(fileList.size > 8);
+    const char* paths = (const char*) (fileList.files + fileList.size);
+    for (size_t i = 0; i < fileList.size; ++i) {
+        RcnSourceFile* file = &fileList.files[i];
+        TEST_ASSERT_TRUE(file->isPathShared);
+        TEST_ASSERT_EQUAL_PTR(paths, file->path);
+        TEST_ASSERT_TRUE(file->name > file->path);
+        const size_t nameOffset = strlen(file->path) - strlen(file->name);
+        TEST_ASSERT_EQUAL_PTR(file->path + nameOffset, file->name);
+        paths += strlen(file->path) + 1;
+    }
+    freeSourceFileList(&fileList);
+}
+
+void testSortSourceFilesMatchesComparator(void) {
+    const char* dirs[] = {
+        "/a", "/b/c", "/b/long/directory/path/with/common/prefix", "/a/x"
+    };
+    const char* names[] = {
+        "main.c", "Main.c", "main.cpp", "m", "a_very_long_file_name_1.txt",
+        "a_very_long_file_name_2.txt", "a_very_long_file_name_1.txt.bak"
+    };
+    const size_t numDirs = sizeof(dirs) / sizeof(dirs[0]);
+    const size_t numNames = sizeof(names) / sizeof(names[0]);
+    const size_t size = 500;
+    RcnSourceFile* expected = calloc(size, sizeof(RcnSourceFile));
+    RcnSourceFile* actual = calloc(size, sizeof(RcnSourceFile));
+    TEST_ASSERT_NOT_NULL(expected);
+    TEST_ASSERT_NOT_NULL(actual);
+    for (size_t i = 0; i < size; ++i) {
+        char path[128];
+        // Some paths occur more than once
+        snprintf(
+            path,
+            sizeof(path),
+            "%s/%zu/%s",
+            dirs[(i / 3) % numDirs],
+            (i * 7) % 40,
+            names[i % numNames]
+        );
+        initSourceFile(&expected[i], path);
+    }
+    memcpy(actual, expected, size * sizeof(RcnSourceFile));
+    qsort(expected, size, sizeof(RcnSourceFile), compareSourceFileByName);
+    sortSourceFiles(actual, size, sizeof(RcnSourceFile));
+    for (size_t i = 0; i < size; ++i) {
+        TEST_ASSERT_EQUAL_STRING(expected[i].path, actual[i].path);
+        deinitSourceFile(&expected[i]);
+    }
+    free(expected);
+    free(actual);
+}
+
+void testPathArenaAllocatesPathsOfAnySize(void) {
+    PathArena arena = {0};
+    const size_t largeSize = 100UL * 1024UL;
+    char* small = allocArenaPath(&arena, 4);
+    TEST_ASSERT_NOT_NULL(small);
+    memcpy(small, "abc", 4);
+    char* large = allocArenaPath(&arena, largeSize);
+    TEST_ASSERT_NOT_NULL(large);
+    memset(large, 'x', largeSize - 1);
+    large[largeSize - 1] = '\0';
+    for (size_t i = 0; i < 1000; ++i) {
+        char* path = allocArenaPath(&arena, 100);
+        TEST_ASSERT_NOT_NULL(path);
+        memset(path, 'y', 100);
+    }
+    TEST_ASSERT_EQUAL_STRING("abc", small);
+    TEST_ASSERT_EQUAL_INT(largeSize - 1, strlen(large));
+    clearPathArena(&arena);
+    TEST_ASSERT_NOT_NULL(arena.chunks);
+    TEST_ASSERT_NOT_NULL(allocArenaPath(&arena, 100));
+    freePathArena(&arena);
+    TEST_ASSERT_NULL(arena.chunks);
+}
+
 // NOLINTEND(readability-magic-numbers)
 
 int main(void) {
@@ -333,17 +708,40 @@ int main(void) {
     RUN_TEST(testDeinitSourceFileFreesContent);
     RUN_TEST(testReadSourceFile);
     RUN_TEST(testFreeSourceFileContent);
+    RUN_TEST(testFreeSourceFileContentResetsDetectedEncoding);
+    RUN_TEST(testReadSourceFileContentMapped);
+    RUN_TEST(testReadSourceFileContentMappedOfSmallFileIsCopied);
+    RUN_TEST(testReadSourceFileContentMappedOfNonExistentFileFails);
+    RUN_TEST(testReadSourceFileContentBufferedReusesReleasedMemory);
+    RUN_TEST(testReadSourceFileContentBufferedKeepsUnreleasedContent);
+    RUN_TEST(testReadSourceFileContentBufferedWithoutBuffer);
     RUN_TEST(testReadSourceFileContentOfNonExistentFileFails);
     RUN_TEST(testReadSourceFileContentWithFailedStateFails);
     RUN_TEST(testReadSourceFileContentWithNullInputFails);
     RUN_TEST(testReadSourceFileContentIsNotReadIfAlreadyRead);
     RUN_TEST(testReadSourceFileFailsWhenFilePathIsNull);
+    RUN_TEST(testReadSourceFileHead);
+    RUN_TEST(testReadSourceFileHeadOfNonExistentFileFails);
+    RUN_TEST(testAdviseFileReadDoesNotChangeFile);
+    RUN_TEST(testAdviseFileReadIgnoresNonExistentFile);
     RUN_TEST(testDetectSourceFormatSupported);
     RUN_TEST(testDetectSourceFormatUnsupported);
+    RUN_TEST(testDetectSourceFormatOfRecordWithoutStoredFormat);
     RUN_TEST(testCreateSourceFileListOfEmptyDirectory);
     RUN_TEST(testCreateSourceFileListFailsWhenInputPathIsNull);
     RUN_TEST(testCreateSourceFileListOfDirectoryContainingOnlyOneValidFile);
     RUN_TEST(testCreateSourceFileListOfDirectoryWithMoreSubdirectories);
     RUN_TEST(testCreateSourceFileListOfDirectoryWithTrailingSlashInPath);
+    RUN_TEST(testCreateSourceFileListRecordsScannedSizeIfSeen);
+    RUN_TEST(testReadSourceFileContentRecordsScannedSize);
+    RUN_TEST(testProbeFileSize);
+    RUN_TEST(testCreateSourceFileListConcurrently);
+    RUN_TEST(testCreateSourceFileListConcurrentlyMatchesSequential);
+    RUN_TEST(testCreateSourceFileListConcurrentlyOfEmptyDirectory);
+    RUN_TEST(testStreamSourceFilesConcurrently);
+    RUN_TEST(testStreamSourceFilesAbortedByConsumer);
+    RUN_TEST(testCreateSourceFileListPacksFilePaths);
+    RUN_TEST(testSortSourceFilesMatchesComparator);
+    RUN_TEST(testPathArenaAllocatesPathsOfAnySize);
     return UNITY_END();
 }
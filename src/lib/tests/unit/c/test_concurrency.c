@@ -0,0 +1,230 @@
+/*
+ * Copyright (C) 2026 Raven Computing
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "unity.h"
+
+#include "concurrency.h"
+
+void setUp(void) { }
+
+void tearDown(void) { }
+
+// NOLINTBEGIN(readability-magic-numbers)
+
+typedef struct CounterTask {
+    size_t* counter;
+    size_t increments;
+} CounterTask;
+
+typedef struct QueueTask {
+    BoundedQueue* queue;
+    bool isProducer;
+    size_t numItems;
+    size_t sum;
+    size_t popped;
+} QueueTask;
+
+static void incrementCounter(void* arg) {
+    CounterTask* task = (CounterTask*) arg;
+    for (size_t i = 0; i < task->increments; ++i) {
+        atomicFetchAdd(task->counter, 1);
+    }
+}
+
+static void produceOrConsume(void* arg) {
+    QueueTask* task = (QueueTask*) arg;
+    if (task->isProducer) {
+        for (size_t i = 1; i <= task->numItems; ++i) {
+            while (!boundedQueueTryPush(task->queue, &i)) { }
+        }
+        boundedQueueClose(task->queue);
+        return;
+    }
+    size_t item = 0;
+    while (boundedQueuePop(task->queue, &item)) {
+        task->sum += item;
+        task->popped += 1;
+    }
+}
+
+void testRunConcurrentlyRunsAllTasks(void) {
+    size_t counter = 0;
+    CounterTask tasks[8];
+    for (size_t i = 0; i < 8; ++i) {
+        tasks[i] = (CounterTask){
+            .counter = &counter,
+            .increments = 1000
+        };
+    }
+    const size_t count = runConcurrently(
+        incrementCounter,
+        tasks,
+        sizeof(CounterTask),
+        8
+    );
+    TEST_ASSERT_EQUAL_INT(8, count);
+    TEST_ASSERT_EQUAL_INT(8000, atomicLoad(&counter));
+}
+
+void testRunConcurrentlyWithNoTasks(void) {
+    TEST_ASSERT_EQUAL_INT(
+        0,
+        runConcurrently(incrementCounter, NULL, sizeof(CounterTask), 0)
+    );
+}
+
+void testAtomicStoreMinKeepsSmallestValue(void) {
+    size_t value = SIZE_MAX;
+    atomicStoreMin(&value, 42);
+    TEST_ASSERT_EQUAL_INT(42, atomicLoad(&value));
+    atomicStoreMin(&value, 100);
+    TEST_ASSERT_EQUAL_INT(42, atomicLoad(&value));
+    atomicStoreMin(&value, 7);
+    TEST_ASSERT_EQUAL_INT(7, atomicLoad(&value));
+}
+
+void testAtomicStoreReplacesValue(void) {
+    size_t value = 0;
+    atomicStore(&value, 42);
+    TEST_ASSERT_EQUAL_INT(42, atomicLoad(&value));
+    atomicStore(&value, 0);
+    TEST_ASSERT_EQUAL_INT(0, atomicLoad(&value));
+}
+
+void testMonotonicTimeMicrosDoesNotDecrease(void) {
+    uint64_t previous = monotonicTimeMicros();
+    for (size_t i = 0; i < 1000; ++i) {
+        const uint64_t current = monotonicTimeMicros();
+        TEST_ASSERT_TRUE(current >= previous);
+        previous = current;
+    }
+}
+
+static OnceFlag onceFlag;
+static size_t onceCalls;
+
+static void countOnceCall(void) {
+    atomicFetchAdd(&onceCalls, 1);
+}
+
+static void callOnceTask(void* arg) {
+    callOnce(&onceFlag, countOnceCall);
+    // The effects of the function are visible to every caller
+    *((size_t*) arg) = atomicLoad(&onceCalls);
+}
+
+void testCallOnceCallsFunctionOnlyOnce(void) {
+    size_t observed[8] = {0};
+    const size_t count = runConcurrently(
+        callOnceTask,
+        observed,
+        sizeof(size_t),
+        8
+    );
+    callOnce(&onceFlag, countOnceCall);
+    TEST_ASSERT_EQUAL_INT(1, atomicLoad(&onceCalls));
+    for (size_t i = 0; i < count; ++i) {
+        TEST_ASSERT_EQUAL_INT(1, observed[i]);
+    }
+}
+
+void testBoundedQueueIsFirstInFirstOut(void) {
+    BoundedQueue* queue = newBoundedQueue(sizeof(int), 3);
+    TEST_ASSERT_NOT_NULL(queue);
+    int item = 1;
+    TEST_ASSERT_TRUE(boundedQueueTryPush(queue, &item));
+    item = 2;
+    TEST_ASSERT_TRUE(boundedQueueTryPush(queue, &item));
+    item = 3;
+    TEST_ASSERT_TRUE(boundedQueueTryPush(queue, &item));
+    item = 4;
+    TEST_ASSERT_FALSE(boundedQueueTryPush(queue, &item));
+    TEST_ASSERT_TRUE(boundedQueueTryPop(queue, &item));
+    TEST_ASSERT_EQUAL_INT(1, item);
+    item = 5;
+    TEST_ASSERT_TRUE(boundedQueueTryPush(queue, &item));
+    TEST_ASSERT_TRUE(boundedQueuePop(queue, &item));
+    TEST_ASSERT_EQUAL_INT(2, item);
+    TEST_ASSERT_TRUE(boundedQueuePop(queue, &item));
+    TEST_ASSERT_EQUAL_INT(3, item);
+    TEST_ASSERT_TRUE(boundedQueuePop(queue, &item));
+    TEST_ASSERT_EQUAL_INT(5, item);
+    TEST_ASSERT_FALSE(boundedQueueTryPop(queue, &item));
+    freeBoundedQueue(queue);
+}
+
+void testBoundedQueueClosed(void) {
+    BoundedQueue* queue = newBoundedQueue(sizeof(int), 4);
+    TEST_ASSERT_NOT_NULL(queue);
+    int item = 1;
+    TEST_ASSERT_TRUE(boundedQueueTryPush(queue, &item));
+    boundedQueueClose(queue);
+    item = 2;
+    TEST_ASSERT_FALSE(boundedQueueTryPush(queue, &item));
+    TEST_ASSERT_TRUE(boundedQueuePop(queue, &item));
+    TEST_ASSERT_EQUAL_INT(1, item);
+    TEST_ASSERT_FALSE(boundedQueuePop(queue, &item));
+    freeBoundedQueue(queue);
+}
+
+void testBoundedQueueWithInvalidArguments(void) {
+    TEST_ASSERT_NULL(newBoundedQueue(0, 4));
+    TEST_ASSERT_NULL(newBoundedQueue(sizeof(int), 0));
+    freeBoundedQueue(NULL);
+}
+
+void testBoundedQueueWithConcurrentConsumers(void) {
+    BoundedQueue* queue = newBoundedQueue(sizeof(size_t), 4);
+    TEST_ASSERT_NOT_NULL(queue);
+    QueueTask tasks[4] = {0};
+    for (size_t i = 0; i < 4; ++i) {
+        tasks[i].queue = queue;
+    }
+    tasks[0].isProducer = true;
+    tasks[0].numItems = 10000;
+    runConcurrently(produceOrConsume, tasks, sizeof(QueueTask), 4);
+    size_t sum = 0;
+    size_t popped = 0;
+    for (size_t i = 1; i < 4; ++i) {
+        sum += tasks[i].sum;
+        popped += tasks[i].popped;
+    }
+    TEST_ASSERT_EQUAL_INT(10000, popped);
+    TEST_ASSERT_EQUAL_INT(50005000, sum);
+    freeBoundedQueue(queue);
+}
+
+// NOLINTEND(readability-magic-numbers)
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(testRunConcurrentlyRunsAllTasks);
+    RUN_TEST(testRunConcurrentlyWithNoTasks);
+    RUN_TEST(testAtomicStoreMinKeepsSmallestValue);
+    RUN_TEST(testAtomicStoreReplacesValue);
+    RUN_TEST(testMonotonicTimeMicrosDoesNotDecrease);
+    RUN_TEST(testCallOnceCallsFunctionOnlyOnce);
+    RUN_TEST(testBoundedQueueIsFirstInFirstOut);
+    RUN_TEST(testBoundedQueueClosed);
+    RUN_TEST(testBoundedQueueWithInvalidArguments);
+    RUN_TEST(testBoundedQueueWithConcurrentConsumers);
+    return UNITY_END();
+}
@@ -30,6 +30,66 @@ void tearDown(void) { }
 
 // NOLINTBEGIN(readability-magic-numbers)
 
+static void assertEqualCountStatistics(
+    RcnCountStatistics* expected,
+    RcnCountStatistics* actual
+) {
+    TEST_ASSERT_EQUAL(expected->state.ok, actual->state.ok);
+    TEST_ASSERT_EQUAL_INT(expected->state.errorCode, actual->state.errorCode);
+    TEST_ASSERT_EQUAL_PTR(
+        expected->state.errorMessage,
+        actual->state.errorMessage
+    );
+    TEST_ASSERT_EQUAL_INT(
+        expected->totalLogicalLines,
+        actual->totalLogicalLines
+    );
+    TEST_ASSERT_EQUAL_INT(
+        expected->totalPhysicalLines,
+        actual->totalPhysicalLines
+    );
+    TEST_ASSERT_EQUAL_INT(expected->totalWords, actual->totalWords);
+    TEST_ASSERT_EQUAL_INT(expected->totalCharacters, actual->totalCharacters);
+    TEST_ASSERT_EQUAL_INT(expected->totalSourceSize, actual->totalSourceSize);
+    for (int i = 0; i < RECKON_NUM_SUPPORTED_FORMATS; ++i) {
+        TEST_ASSERT_EQUAL_INT(
+            expected->logicalLines[i],
+            actual->logicalLines[i]
+        );
+        TEST_ASSERT_EQUAL_INT(
+            expected->physicalLines[i],
+            actual->physicalLines[i]
+        );
+        TEST_ASSERT_EQUAL_INT(expected->words[i], actual->words[i]);
+        TEST_ASSERT_EQUAL_INT(expected->characters[i], actual->characters[i]);
+        TEST_ASSERT_EQUAL_INT(expected->sourceSize[i], actual->sourceSize[i]);
+    }
+    TEST_ASSERT_EQUAL_INT(expected->count.size, actual->count.size);
+    TEST_ASSERT_EQUAL_INT(
+        expected->count.sizeProcessed,
+        actual->count.sizeProcessed
+    );
+    for (size_t i = 0; i < expected->count.size; ++i) {
+        RcnCountResultGroup* result1 = &expected->count.results[i];
+        RcnCountResultGroup* result2 = &actual->count.results[i];
+        TEST_ASSERT_EQUAL_STRING(
+            expected->count.files[i].path,
+            actual->count.files[i].path
+        );
+        TEST_ASSERT_EQUAL(result1->isProcessed, result2->isProcessed);
+        TEST_ASSERT_EQUAL(result1->state.ok, result2->state.ok);
+        TEST_ASSERT_EQUAL_INT(
+            result1->state.errorCode,
+            result2->state.errorCode
+        );
+        TEST_ASSERT_EQUAL_INT(result1->logicalLines, result2->logicalLines);
+        TEST_ASSERT_EQUAL_INT(result1->physicalLines, result2->physicalLines);
+        TEST_ASSERT_EQUAL_INT(result1->words, result2->words);
+        TEST_ASSERT_EQUAL_INT(result1->characters, result2->characters);
+        TEST_ASSERT_EQUAL_INT(result1->sourceSize, result2->sourceSize);
+    }
+}
+
 void testCountStatisticsOnlyLogicalLines(void) {
     char* path = RECKON_TEST_PATH_RES_BASE "/java/Sample.java";
     RcnCountStatistics* stats = rcnCreateCountStatistics(path);
@@ -771,6 +831,490 @@ void testCountStatisticsWithStopOnErrorOptionActivated(void) {
     rcnFreeCountStatistics(stats);
 }
 
+void testCountStatisticsWithMultipleThreadsMatchesSequential(void) {
+    char* path = RECKON_TEST_PATH_RES_BASE;
+    RcnCountStatistics* expected = rcnCreateCountStatistics(path);
+    RcnCountStatistics* actual = rcnCreateCountStatistics(path);
+    RcnStatOptions options = {0};
+    rcnCount(expected, options);
+    options.threads = 4;
+    rcnCount(actual, options);
+    TEST_ASSERT_TRUE(actual->count.size > 4);
+    TEST_ASSERT_TRUE(actual->count.sizeProcessed > 0);
+    assertEqualCountStatistics(expected, actual);
+    rcnFreeCountStatistics(expected);
+    rcnFreeCountStatistics(actual);
+}
+
+void testCountStatisticsWithMoreThreadsThanFiles(void) {
+    char* path = RECKON_TEST_PATH_RES_BASE "/mixed";
+    RcnCountStatistics* expected = rcnCreateCountStatistics(path);
+    RcnCountStatistics* actual = rcnCreateCountStatistics(path);
+    RcnStatOptions options = {
+        .operations = RCN_OPT_COUNT_PHYSICAL_LINES | RCN_OPT_COUNT_WORDS
+    };
+    rcnCount(expected, options);
+    options.threads = 64;
+    rcnCount(actual, options);
+    assertEqualCountStatistics(expected, actual);
+    rcnFreeCountStatistics(expected);
+    rcnFreeCountStatistics(actual);
+}
+
+void testCountStatisticsWithMultipleThreadsAndStopOnErrorDeactivated(void) {
+    char* path = RECKON_TEST_PATH_RES_BASE "/java";
+    RcnCountStatistics* expected = rcnCreateCountStatistics(path);
+    RcnCountStatistics* actual = rcnCreateCountStatistics(path);
+    RcnStatOptions options = {
+        .stopOnError = false
+    };
+    TEST_ASSERT_EQUAL_INT(3, actual->count.size);
+    // Mess up file path of the 2/3 file to trigger a not found error
+    char* pathOfWrongFile = expected->count.files[1].path;
+    pathOfWrongFile[strlen(pathOfWrongFile)-6] = 'X';
+    pathOfWrongFile = actual->count.files[1].path;
+    pathOfWrongFile[strlen(pathOfWrongFile)-6] = 'X';
+    rcnCount(expected, options);
+    options.threads = 3;
+    rcnCount(actual, options);
+    TEST_ASSERT_TRUE(actual->state.ok);
+    TEST_ASSERT_EQUAL_INT(RCN_ERR_INVALID_INPUT, actual->state.errorCode);
+    TEST_ASSERT_EQUAL_INT(2, actual->count.sizeProcessed);
+    assertEqualCountStatistics(expected, actual);
+    rcnFreeCountStatistics(expected);
+    rcnFreeCountStatistics(actual);
+}
+
+void testCountStatisticsWithMultipleThreadsAndStopOnErrorActivated(void) {
+    char* path = RECKON_TEST_PATH_RES_BASE "/java";
+    RcnCountStatistics* expected = rcnCreateCountStatistics(path);
+    RcnCountStatistics* actual = rcnCreateCountStatistics(path);
+    RcnStatOptions options = {
+        .stopOnError = true
+    };
+    TEST_ASSERT_EQUAL_INT(3, actual->count.size);
+    // Mess up file path of the 2/3 file to trigger a not found error
+    char* pathOfWrongFile = expected->count.files[1].path;
+    pathOfWrongFile[strlen(pathOfWrongFile)-6] = 'X';
+    pathOfWrongFile = actual->count.files[1].path;
+    pathOfWrongFile[strlen(pathOfWrongFile)-6] = 'X';
+    rcnCount(expected, options);
+    options.threads = 3;
+    rcnCount(actual, options);
+    TEST_ASSERT_FALSE(actual->state.ok);
+    TEST_ASSERT_EQUAL_INT(RCN_ERR_INVALID_INPUT, actual->state.errorCode);
+    TEST_ASSERT_EQUAL_INT(1, actual->count.sizeProcessed);
+    TEST_ASSERT_FALSE(actual->count.results[2].isProcessed);
+    TEST_ASSERT_EQUAL_INT(0, actual->count.results[2].logicalLines);
+    assertEqualCountStatistics(expected, actual);
+    rcnFreeCountStatistics(expected);
+    rcnFreeCountStatistics(actual);
+}
+
+void testCountStatisticsWithThreadsLargestFileAfterStoppingFile(void) {
+    char* path = RECKON_TEST_PATH_RES_BASE "/java";
+    RcnCountStatistics* expected = rcnCreateCountStatistics(path);
+    RcnCountStatistics* actual = rcnCreateCountStatistics(path);
+    RcnStatOptions options = {
+        .stopOnError = true
+    };
+    TEST_ASSERT_EQUAL_INT(3, actual->count.size);
+    // Mess up file path of the 2/3 file to trigger a not found error
+    char* pathOfWrongFile = expected->count.files[1].path;
+    pathOfWrongFile[strlen(pathOfWrongFile)-6] = 'X';
+    pathOfWrongFile = actual->count.files[1].path;
+    pathOfWrongFile[strlen(pathOfWrongFile)-6] = 'X';
+    // The 3/3 file is scheduled first but must not contribute to the results
+    actual->count.files[2].scannedSize = SIZE_MAX;
+    rcnCount(expected, options);
+    options.threads = 2;
+    rcnCount(actual, options);
+    TEST_ASSERT_FALSE(actual->state.ok);
+    TEST_ASSERT_EQUAL_INT(1, actual->count.sizeProcessed);
+    TEST_ASSERT_FALSE(actual->count.results[2].isProcessed);
+    TEST_ASSERT_EQUAL_INT(0, actual->count.results[2].logicalLines);
+    assertEqualCountStatistics(expected, actual);
+    rcnFreeCountStatistics(expected);
+    rcnFreeCountStatistics(actual);
+}
+
+void testCountStatisticsWithReadAheadMatchesSequential(void) {
+    char* path = RECKON_TEST_PATH_RES_BASE;
+    RcnCountStatistics* expected = rcnCreateCountStatistics(path);
+    RcnCountStatistics* actual1 = rcnCreateCountStatistics(path);
+    RcnCountStatistics* actual2 = rcnCreateCountStatistics(path);
+    RcnStatOptions options = {0};
+    rcnCount(expected, options);
+    options.readAhead = 4;
+    rcnCount(actual1, options);
+    options.threads = 4;
+    rcnCount(actual2, options);
+    assertEqualCountStatistics(expected, actual1);
+    assertEqualCountStatistics(expected, actual2);
+    rcnFreeCountStatistics(expected);
+    rcnFreeCountStatistics(actual1);
+    rcnFreeCountStatistics(actual2);
+}
+
+void testCountStatisticsWithMappedFileContentMatchesCopied(void) {
+    char* path = RECKON_TEST_PATH_RES_BASE;
+    RcnCountStatistics* expected = rcnCreateCountStatistics(path);
+    RcnCountStatistics* actual = rcnCreateCountStatistics(path);
+    RcnStatOptions options = {
+        .keepFileContent = true
+    };
+    rcnCount(expected, options);
+    options.mapFileContent = true;
+    rcnCount(actual, options);
+    assertEqualCountStatistics(expected, actual);
+    for (size_t i = 0; i < actual->count.size; ++i) {
+        RcnSourceFile* file1 = &expected->count.files[i];
+        RcnSourceFile* file2 = &actual->count.files[i];
+        TEST_ASSERT_FALSE(file1->isContentMapped);
+        TEST_ASSERT_EQUAL(file1->isContentRead, file2->isContentRead);
+        TEST_ASSERT_EQUAL_INT(file1->content.size, file2->content.size);
+    }
+    rcnFreeCountStatistics(expected);
+    rcnFreeCountStatistics(actual);
+}
+
+void testCountStatisticsWithLocaleWordDelimitersMatchesDefault(void) {
+    char* path = RECKON_TEST_PATH_RES_BASE;
+    RcnCountStatistics* expected = rcnCreateCountStatistics(path);
+    RcnCountStatistics* actual = rcnCreateCountStatistics(path);
+    RcnStatOptions options = {0};
+    rcnCount(expected, options);
+    // The current locale is the "C" locale unless set by the test
+    options.localeWordDelimiters = true;
+    rcnCount(actual, options);
+    assertEqualCountStatistics(expected, actual);
+    rcnFreeCountStatistics(expected);
+    rcnFreeCountStatistics(actual);
+}
+
+void testCountStatisticsWithTranscodedUTF16MatchesDefault(void) {
+    char* path = RECKON_TEST_PATH_RES_BASE;
+    RcnCountStatistics* expected = rcnCreateCountStatistics(path);
+    RcnCountStatistics* actual = rcnCreateCountStatistics(path);
+    RcnStatOptions options = {0};
+    rcnCount(expected, options);
+    options.transcodeUTF16 = true;
+    rcnCount(actual, options);
+    assertEqualCountStatistics(expected, actual);
+    rcnFreeCountStatistics(expected);
+    rcnFreeCountStatistics(actual);
+}
+
+void testCountPathWithTranscodedUTF16AndMultipleThreads(void) {
+    char* path = RECKON_TEST_PATH_RES_BASE "/encodings";
+    RcnCountStatistics* expected = rcnCreateCountStatistics(path);
+    RcnStatOptions options = {0};
+    rcnCount(expected, options);
+    options.transcodeUTF16 = true;
+    options.threads = 4;
+    RcnCountStatistics* actual = rcnCountPath(path, options);
+    TEST_ASSERT_NOT_NULL(actual);
+    assertEqualCountStatistics(expected, actual);
+    rcnFreeCountStatistics(expected);
+    rcnFreeCountStatistics(actual);
+}
+
+void testCountStatisticsSkipsBinaryContent(void) {
+    char* path = RECKON_TEST_PATH_RES_BASE "/binary";
+    RcnCountStatistics* stats = rcnCreateCountStatistics(path);
+    RcnStatOptions options = {
+        .stopOnError = true,
+        .skipBinaryContent = true
+    };
+    rcnCount(stats, options);
+    // The statistics of a single file have the state of its result
+    TEST_ASSERT_FALSE(stats->state.ok);
+    TEST_ASSERT_EQUAL_INT(RCN_ERR_BINARY_CONTENT, stats->state.errorCode);
+    TEST_ASSERT_EQUAL_INT(1, stats->count.size);
+    TEST_ASSERT_EQUAL_INT(0, stats->count.sizeProcessed);
+    TEST_ASSERT_EQUAL_INT(0, stats->totalSourceSize);
+    RcnCountResultGroup* result = &stats->count.results[0];
+    TEST_ASSERT_FALSE(result->state.ok);
+    TEST_ASSERT_FALSE(result->isProcessed);
+    TEST_ASSERT_EQUAL_INT(RCN_ERR_BINARY_CONTENT, result->state.errorCode);
+    TEST_ASSERT_EQUAL_INT(0, result->physicalLines);
+    rcnFreeCountStatistics(stats);
+}
+
+void testCountStatisticsSkipsBinaryContentWithoutLoadingIt(void) {
+    char* path = RECKON_TEST_PATH_RES_BASE "/binary";
+    RcnCountStatistics* stats = rcnCreateCountStatistics(path);
+    RcnStatOptions options = {
+        .skipBinaryContent = true,
+        .keepFileContent = true
+    };
+    rcnCount(stats, options);
+    TEST_ASSERT_EQUAL_INT(1, stats->count.size);
+    TEST_ASSERT_EQUAL_INT(
+        RCN_ERR_BINARY_CONTENT,
+        stats->count.results[0].state.errorCode
+    );
+    // Only the start of the file is inspected, the content is never loaded
+    TEST_ASSERT_FALSE(stats->count.files[0].isContentRead);
+    TEST_ASSERT_NULL(stats->count.files[0].content.text);
+    TEST_ASSERT_EQUAL_INT(RCN_FILE_OP_OK, stats->count.files[0].status);
+    rcnFreeCountStatistics(stats);
+}
+
+void testCountStatisticsCountsBinaryContentByDefault(void) {
+    char* path = RECKON_TEST_PATH_RES_BASE "/binary";
+    RcnCountStatistics* stats = rcnCreateCountStatistics(path);
+    RcnStatOptions options = {0};
+    rcnCount(stats, options);
+    TEST_ASSERT_EQUAL_INT(1, stats->count.sizeProcessed);
+    TEST_ASSERT_TRUE(stats->count.results[0].isProcessed);
+    TEST_ASSERT_TRUE(stats->totalSourceSize > 0);
+    rcnFreeCountStatistics(stats);
+}
+
+void testCountStatisticsContinuesWhenParsingIsCancelled(void) {
+    char* path = RECKON_TEST_PATH_RES_BASE "/mixed";
+    const uint32_t threads[] = {1, 4};
+    for (size_t i = 0; i < sizeof(threads) / sizeof(threads[0]); ++i) {
+        RcnCountStatistics* stats = rcnCreateCountStatistics(path);
+        RcnStatOptions options = {
+            .stopOnError = true,
+            .threads = threads[i]
+        };
+        rcnCancelParsing(true);
+        rcnCount(stats, options);
+        rcnCancelParsing(false);
+        size_t cancelled = 0;
+        for (size_t j = 0; j < stats->count.size; ++j) {
+            RcnCountResultGroup* result = &stats->count.results[j];
+            if (result->state.errorCode == RCN_ERR_PARSE_CANCELLED) {
+                TEST_ASSERT_FALSE(result->state.ok);
+                TEST_ASSERT_FALSE(result->isProcessed);
+                ++cancelled;
+            }
+        }
+        TEST_ASSERT_EQUAL_INT(2, cancelled);
+        TEST_ASSERT_EQUAL_INT(0, stats->totalLogicalLines);
+        TEST_ASSERT_TRUE(stats->count.sizeProcessed >= 1);
+        rcnFreeCountStatistics(stats);
+    }
+}
+
+void testCountStatisticsCanBeCountedRepeatedly(void) {
+    char* path = RECKON_TEST_PATH_RES_BASE;
+    RcnCountStatistics* expected = rcnCreateCountStatistics(path);
+    RcnCountStatistics* actual = rcnCreateCountStatistics(path);
+    RcnStatOptions options = {
+        .operations = (
+            RCN_OPT_COUNT_PHYSICAL_LINES
+            | RCN_OPT_COUNT_WORDS
+            | RCN_OPT_COUNT_CHARACTERS
+        ),
+        .keepFileContent = true
+    };
+    rcnCount(expected, options);
+    rcnCount(actual, options);
+    for (size_t i = 0; i < actual->count.size; ++i) {
+        TEST_ASSERT_TRUE(actual->count.files[i].isContentRead);
+        TEST_ASSERT_TRUE(actual->count.files[i].isEncodingDetected);
+    }
+    rcnCount(actual, options);
+    assertEqualCountStatistics(expected, actual);
+    // Counts of operations that are not performed again are reset
+    options.operations = RCN_OPT_COUNT_WORDS;
+    rcnCount(actual, options);
+    TEST_ASSERT_EQUAL_INT(0, actual->totalPhysicalLines);
+    TEST_ASSERT_EQUAL_INT(0, actual->totalCharacters);
+    TEST_ASSERT_EQUAL_INT(expected->totalWords, actual->totalWords);
+    TEST_ASSERT_EQUAL_INT(
+        expected->count.sizeProcessed,
+        actual->count.sizeProcessed
+    );
+    rcnFreeCountStatistics(expected);
+    rcnFreeCountStatistics(actual);
+}
+
+void testCountStatisticsCountedRepeatedlyWithoutKeptContent(void) {
+    char* path = RECKON_TEST_PATH_RES_BASE "/mixed";
+    RcnCountStatistics* expected = rcnCreateCountStatistics(path);
+    RcnCountStatistics* actual = rcnCreateCountStatistics(path);
+    RcnStatOptions options = {
+        .operations = RCN_OPT_COUNT_PHYSICAL_LINES,
+        .threads = 4
+    };
+    rcnCount(expected, options);
+    rcnCount(actual, options);
+    // Contents are released, so their encodings must be detected again
+    for (size_t i = 0; i < actual->count.size; ++i) {
+        TEST_ASSERT_FALSE(actual->count.files[i].isContentRead);
+        TEST_ASSERT_FALSE(actual->count.files[i].isEncodingDetected);
+        TEST_ASSERT_TRUE(actual->count.files[i].isFormatDetected);
+    }
+    rcnCount(actual, options);
+    assertEqualCountStatistics(expected, actual);
+    rcnFreeCountStatistics(expected);
+    rcnFreeCountStatistics(actual);
+}
+
+void testCountPathSkippingBinaryContentMatchesDefaultForText(void) {
+    char* path = RECKON_TEST_PATH_RES_BASE "/encodings";
+    RcnCountStatistics* expected = rcnCreateCountStatistics(path);
+    RcnStatOptions options = {0};
+    rcnCount(expected, options);
+    options.skipBinaryContent = true;
+    options.threads = 4;
+    RcnCountStatistics* actual = rcnCountPath(path, options);
+    TEST_ASSERT_NOT_NULL(actual);
+    assertEqualCountStatistics(expected, actual);
+    rcnFreeCountStatistics(expected);
+    rcnFreeCountStatistics(actual);
+}
+
+void testCountPathWithMultipleThreadsMatchesSequential(void) {
+    char* path = RECKON_TEST_PATH_RES_BASE;
+    RcnCountStatistics* expected = rcnCreateCountStatistics(path);
+    RcnStatOptions options = {0};
+    rcnCount(expected, options);
+    options.threads = 4;
+    RcnCountStatistics* actual = rcnCountPath(path, options);
+    TEST_ASSERT_NOT_NULL(actual);
+    TEST_ASSERT_TRUE(actual->count.size > 4);
+    TEST_ASSERT_TRUE(actual->count.sizeProcessed > 0);
+    assertEqualCountStatistics(expected, actual);
+    rcnFreeCountStatistics(expected);
+    rcnFreeCountStatistics(actual);
+}
+
+void testCountPathWithMoreThreadsThanFiles(void) {
+    char* path = RECKON_TEST_PATH_RES_BASE "/mixed";
+    RcnCountStatistics* expected = rcnCreateCountStatistics(path);
+    RcnStatOptions options = {
+        .operations = RCN_OPT_COUNT_PHYSICAL_LINES | RCN_OPT_COUNT_WORDS
+    };
+    rcnCount(expected, options);
+    options.threads = 64;
+    RcnCountStatistics* actual = rcnCountPath(path, options);
+    TEST_ASSERT_NOT_NULL(actual);
+    assertEqualCountStatistics(expected, actual);
+    rcnFreeCountStatistics(expected);
+    rcnFreeCountStatistics(actual);
+}
+
+void testCountPathWithSingleFile(void) {
+    char* path = RECKON_TEST_PATH_RES_BASE "/java/Sample.java";
+    RcnCountStatistics* expected = rcnCreateCountStatistics(path);
+    RcnStatOptions options = {0};
+    rcnCount(expected, options);
+    options.threads = 4;
+    RcnCountStatistics* actual = rcnCountPath(path, options);
+    TEST_ASSERT_NOT_NULL(actual);
+    TEST_ASSERT_EQUAL_INT(1, actual->count.size);
+    assertEqualCountStatistics(expected, actual);
+    rcnFreeCountStatistics(expected);
+    rcnFreeCountStatistics(actual);
+}
+
+void testCountPathWithSplitSingleFileMatchesSequential(void) {
+    char* path = RECKON_TEST_PATH_RES_BASE "/c/sample_annotated.c";
+    RcnCountStatistics* expected = rcnCreateCountStatistics(path);
+    RcnStatOptions options = {0};
+    rcnCount(expected, options);
+    options.threads = 4;
+    options.splitThreshold = 1;
+    RcnCountStatistics* actual = rcnCountPath(path, options);
+    TEST_ASSERT_NOT_NULL(actual);
+    TEST_ASSERT_EQUAL_INT(1, actual->count.size);
+    TEST_ASSERT_TRUE(actual->count.results[0].isProcessed);
+    assertEqualCountStatistics(expected, actual);
+    options.operations = RCN_OPT_COUNT_WORDS;
+    rcnCount(expected, options);
+    rcnCount(actual, options);
+    TEST_ASSERT_TRUE(actual->count.results[0].words > 0);
+    assertEqualCountStatistics(expected, actual);
+    rcnFreeCountStatistics(expected);
+    rcnFreeCountStatistics(actual);
+}
+
+void testCountPathWithSplitThresholdAndMultipleThreads(void) {
+    char* path = RECKON_TEST_PATH_RES_BASE;
+    RcnCountStatistics* expected = rcnCreateCountStatistics(path);
+    RcnStatOptions options = {0};
+    rcnCount(expected, options);
+    options.threads = 4;
+    options.splitThreshold = 1;
+    RcnCountStatistics* actual = rcnCountPath(path, options);
+    TEST_ASSERT_NOT_NULL(actual);
+    assertEqualCountStatistics(expected, actual);
+    rcnFreeCountStatistics(expected);
+    rcnFreeCountStatistics(actual);
+}
+
+void testCountPathSplitsLargeFileOfDirectory(void) {
+    // The largest file is split while the other threads have nothing else
+    // to count, so they help with counting its segments
+    char* path = RECKON_TEST_PATH_RES_BASE "/c";
+    RcnStatOptions options = {
+        .operations = (
+            RCN_OPT_COUNT_PHYSICAL_LINES
+            | RCN_OPT_COUNT_WORDS
+            | RCN_OPT_COUNT_CHARACTERS
+        )
+    };
+    RcnCountStatistics* expected = rcnCreateCountStatistics(path);
+    rcnCount(expected, options);
+    TEST_ASSERT_EQUAL_INT(3, expected->count.sizeProcessed);
+    options.threads = 8;
+    options.splitThreshold = 8 * 1024;
+    RcnCountStatistics* pipelined = rcnCountPath(path, options);
+    TEST_ASSERT_NOT_NULL(pipelined);
+    assertEqualCountStatistics(expected, pipelined);
+    RcnCountStatistics* scheduled = rcnCreateCountStatistics(path);
+    rcnCount(scheduled, options);
+    assertEqualCountStatistics(expected, scheduled);
+    rcnFreeCountStatistics(expected);
+    rcnFreeCountStatistics(pipelined);
+    rcnFreeCountStatistics(scheduled);
+}
+
+void testCountPathWithStopOnErrorLeavesLaterFilesUnprocessed(void) {
+    // The file with the syntax error is ordered before most other files
+    char* path = RECKON_TEST_PATH_RES_BASE;
+    RcnCountStatistics* expected = rcnCreateCountStatistics(path);
+    RcnStatOptions options = {
+        .stopOnError = true,
+        .keepFileContent = true // used to track read ops
+    };
+    rcnCount(expected, options);
+    TEST_ASSERT_EQUAL_INT(RCN_ERR_SYNTAX_ERROR, expected->state.errorCode);
+    options.threads = 4;
+    RcnCountStatistics* actual = rcnCountPath(path, options);
+    TEST_ASSERT_NOT_NULL(actual);
+    assertEqualCountStatistics(expected, actual);
+    for (size_t i = 0; i < expected->count.size; ++i) {
+        RcnSourceFile* file1 = &expected->count.files[i];
+        RcnSourceFile* file2 = &actual->count.files[i];
+        TEST_ASSERT_EQUAL_INT(file1->status, file2->status);
+        TEST_ASSERT_EQUAL(file1->isContentRead, file2->isContentRead);
+    }
+    rcnFreeCountStatistics(expected);
+    rcnFreeCountStatistics(actual);
+}
+
+void testCountPathWithInvalidPath(void) {
+    char* path = RECKON_TEST_PATH_RES_BASE "/does/not/exist";
+    RcnStatOptions options = {
+        .threads = 4
+    };
+    RcnCountStatistics* stats = rcnCountPath(path, options);
+    TEST_ASSERT_NOT_NULL(stats);
+    TEST_ASSERT_FALSE(stats->state.ok);
+    TEST_ASSERT_EQUAL_INT(RCN_ERR_INVALID_INPUT, stats->state.errorCode);
+    TEST_ASSERT_NOT_NULL(stats->state.errorMessage);
+    TEST_ASSERT_NULL(stats->count.files);
+    rcnFreeCountStatistics(stats);
+    TEST_ASSERT_NULL(rcnCountPath(NULL, options));
+}
+
 // NOLINTEND(readability-magic-numbers)
 
 int main(void) {
@@ -789,5 +1333,30 @@ int main(void) {
     RUN_TEST(testCountStatisticsWithKeepFileContentOptionActivated);
     RUN_TEST(testCountStatisticsWithStopOnErrorOptionDeactivated);
     RUN_TEST(testCountStatisticsWithStopOnErrorOptionActivated);
+    RUN_TEST(testCountStatisticsWithMultipleThreadsMatchesSequential);
+    RUN_TEST(testCountStatisticsWithMoreThreadsThanFiles);
+    RUN_TEST(testCountStatisticsWithMultipleThreadsAndStopOnErrorDeactivated);
+    RUN_TEST(testCountStatisticsWithMultipleThreadsAndStopOnErrorActivated);
+    RUN_TEST(testCountStatisticsWithThreadsLargestFileAfterStoppingFile);
+    RUN_TEST(testCountStatisticsWithReadAheadMatchesSequential);
+    RUN_TEST(testCountStatisticsWithMappedFileContentMatchesCopied);
+    RUN_TEST(testCountStatisticsWithLocaleWordDelimitersMatchesDefault);
+    RUN_TEST(testCountStatisticsWithTranscodedUTF16MatchesDefault);
+    RUN_TEST(testCountPathWithTranscodedUTF16AndMultipleThreads);
+    RUN_TEST(testCountStatisticsSkipsBinaryContent);
+    RUN_TEST(testCountStatisticsSkipsBinaryContentWithoutLoadingIt);
+    RUN_TEST(testCountStatisticsCountsBinaryContentByDefault);
+    RUN_TEST(testCountStatisticsContinuesWhenParsingIsCancelled);
+    RUN_TEST(testCountStatisticsCanBeCountedRepeatedly);
+    RUN_TEST(testCountStatisticsCountedRepeatedlyWithoutKeptContent);
+    RUN_TEST(testCountPathSkippingBinaryContentMatchesDefaultForText);
+    RUN_TEST(testCountPathWithMultipleThreadsMatchesSequential);
+    RUN_TEST(testCountPathWithMoreThreadsThanFiles);
+    RUN_TEST(testCountPathWithSingleFile);
+    RUN_TEST(testCountPathWithSplitSingleFileMatchesSequential);
+    RUN_TEST(testCountPathWithSplitThresholdAndMultipleThreads);
+    RUN_TEST(testCountPathSplitsLargeFileOfDirectory);
+    RUN_TEST(testCountPathWithStopOnErrorLeavesLaterFilesUnprocessed);
+    RUN_TEST(testCountPathWithInvalidPath);
     return UNITY_END();
 }
@@ -0,0 +1,681 @@
+/*
+ * Copyright (C) 2026 Raven Computing
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity.h"
+
+#include "reckon/reckon.h"
+#include "evaluation.h"
+#include "fileio.h"
+
+#define TEST_RES_DIR RECKON_TEST_PATH_RES_BASE "/encodings"
+#define TEST_FILE_TEXT_UTF_8 TEST_RES_DIR "/text_UTF_8.txt"
+#define TEST_FILE_TEXT_UTF_8_BOM TEST_RES_DIR "/text_UTF_8_with_BOM.txt"
+#define TEST_FILE_TEXT_UTF_16_LE TEST_RES_DIR "/text_UTF_16LE.txt"
+#define TEST_FILE_TEXT_UTF_16_BE TEST_RES_DIR "/text_UTF_16BE.txt"
+#define TEST_FILE_TEXT_UTF_16_LE_NO_NL \
+    TEST_RES_DIR "/text_UTF_16LE_noNLend.txt"
+#define TEST_FILE_TEXT_UTF_16_BE_NO_NL \
+    TEST_RES_DIR "/text_UTF_16BE_noNLend.txt"
+#define TEST_FILE_SOURCE_C RECKON_TEST_PATH_RES_BASE "/c/sample.c"
+#define TEST_FILE_SOURCE_ANNOTATED_C \
+    RECKON_TEST_PATH_RES_BASE "/c/sample_annotated.c"
+
+// NOLINTBEGIN(readability-magic-numbers)
+
+static const uint32_t ALL_STREAM_OPERATIONS = (
+    RCN_OPT_COUNT_PHYSICAL_LINES
+    | RCN_OPT_COUNT_WORDS
+    | RCN_OPT_COUNT_CHARACTERS
+);
+
+static const char* const TEST_FILES[] = {
+    TEST_FILE_TEXT_UTF_8,
+    TEST_FILE_TEXT_UTF_8_BOM,
+    TEST_FILE_TEXT_UTF_16_LE,
+    TEST_FILE_TEXT_UTF_16_BE,
+    TEST_FILE_TEXT_UTF_16_LE_NO_NL,
+    TEST_FILE_TEXT_UTF_16_BE_NO_NL,
+    TEST_FILE_SOURCE_C
+};
+
+static const size_t NUM_TEST_FILES = sizeof(TEST_FILES) / sizeof(char*);
+
+void setUp(void) { }
+
+void tearDown(void) { }
+
+/**
+ * Counts the given source text with a count stream by passing it in two
+ * chunks, split at the specified position, followed by chunks of the
+ * specified size.
+ */
+static RcnCountResultGroup countInChunks(
+    RcnSourceText source,
+    size_t split,
+    size_t chunkSize
+) {
+    RcnCountStream* stream = rcnCreateCountStream(ALL_STREAM_OPERATIONS);
+    TEST_ASSERT_NOT_NULL(stream);
+    RcnSourceText first = {
+        .text = source.text,
+        .size = split
+    };
+    TEST_ASSERT_TRUE(rcnUpdateCountStream(stream, first));
+    for (size_t offset = split; offset < source.size; offset += chunkSize) {
+        const size_t remaining = source.size - offset;
+        RcnSourceText chunk = {
+            .text = source.text + offset,
+            .size = (remaining < chunkSize) ? remaining : chunkSize
+        };
+        TEST_ASSERT_TRUE(rcnUpdateCountStream(stream, chunk));
+    }
+    RcnCountResultGroup result = rcnFinishCountStream(stream);
+    rcnFreeCountStream(stream);
+    return result;
+}
+
+static void assertMatchesWholeText(
+    RcnSourceText source,
+    RcnCountResultGroup result
+) {
+    TEST_ASSERT_TRUE(result.state.ok);
+    TEST_ASSERT_EQUAL_INT(RCN_ERR_NONE, result.state.errorCode);
+    TEST_ASSERT_TRUE(result.isProcessed);
+    TEST_ASSERT_EQUAL_INT(
+        rcnCountPhysicalLines(source).count,
+        result.physicalLines
+    );
+    TEST_ASSERT_EQUAL_INT(rcnCountWords(source).count, result.words);
+    TEST_ASSERT_EQUAL_INT(
+        rcnCountCharacters(source).count,
+        result.characters
+    );
+    TEST_ASSERT_EQUAL_INT(source.size, result.sourceSize);
+    TEST_ASSERT_EQUAL_INT(0, result.logicalLines);
+}
+
+static void assertMatchesForAllSplits(RcnSourceText source) {
+    for (size_t split = 0; split <= source.size; ++split) {
+        assertMatchesWholeText(source, countInChunks(source, split, 1));
+        assertMatchesWholeText(source, countInChunks(source, split, 2));
+        assertMatchesWholeText(source, countInChunks(source, split, 3));
+        assertMatchesWholeText(
+            source,
+            countInChunks(source, split, source.size + 1)
+        );
+    }
+}
+
+void testStreamCountsMatchWholeTextForAllChunkSizes(void) {
+    for (size_t i = 0; i < NUM_TEST_FILES; ++i) {
+        RcnSourceFile* file = newSourceFile(TEST_FILES[i]);
+        TEST_ASSERT_TRUE(readSourceFileContent(file));
+        for (size_t chunkSize = 1; chunkSize <= 9; ++chunkSize) {
+            assertMatchesWholeText(
+                file->content,
+                countInChunks(file->content, 0, chunkSize)
+            );
+        }
+        assertMatchesWholeText(
+            file->content,
+            countInChunks(file->content, 0, 4096)
+        );
+        freeSourceFile(file);
+    }
+}
+
+void testStreamCountsMatchWholeTextForAllSplitsUTF8(void) {
+    char text[] =
+        "\xef\xbb\xbf" "A \xc3\xa4\xe2\x82\xac\xf0\x9f\x98\x80 b\n"
+        "\t\xe2\x82\xac\xe2\x82\xac c\r\n\xf0\x9f\x98\x80";
+    RcnSourceText source = {
+        .text = text,
+        .size = sizeof(text) - 1
+    };
+    assertMatchesForAllSplits(source);
+    // Without BOM
+    source.text += 3;
+    source.size -= 3;
+    assertMatchesForAllSplits(source);
+}
+
+void testStreamCountsMatchWholeTextForAllSplitsTruncatedUTF8(void) {
+    char text[] = "a\xe2\x82\n\xf0\x9f\x98 \xc3";
+    RcnSourceText source = {
+        .text = text,
+        .size = sizeof(text) - 1
+    };
+    assertMatchesForAllSplits(source);
+}
+
+void testStreamCountsMatchWholeTextForAllSplitsUTF16LE(void) {
+    // BOM, 'a', surrogate pair, '\n', stray BOM, high surrogate, 'b',
+    // stray low surrogate, ' ', 'c', high surrogate, trailing byte
+    char text[] =
+        "\xff\xfe" "a\x00" "\x3d\xd8\x00\xde" "\n\x00" "\xff\xfe"
+        "\x3d\xd8" "b\x00" "\x00\xde" " \x00" "c\x00" "\x3d\xd8" "x";
+    RcnSourceText source = {
+        .text = text,
+        .size = sizeof(text) - 1
+    };
+    assertMatchesForAllSplits(source);
+    // Without trailing byte and high surrogate
+    source.size -= 3;
+    assertMatchesForAllSplits(source);
+}
+
+void testStreamCountsMatchWholeTextForAllSplitsUTF16BE(void) {
+    char text[] =
+        "\xfe\xff" "\x00" "a" "\xd8\x3d\xde\x00" "\x00\n" "\x00 "
+        "\xd8\x3d" "\x00" "b" "\x00\n" "\x00" "c";
+    RcnSourceText source = {
+        .text = text,
+        .size = sizeof(text) - 1
+    };
+    assertMatchesForAllSplits(source);
+}
+
+void testStreamCountsMatchWholeTextForTinyTexts(void) {
+    char text[] = "\n\xfe\xff\xef\xbb\xbf\nx";
+    for (size_t start = 0; start < sizeof(text) - 1; ++start) {
+        for (size_t size = 1; start + size < sizeof(text); ++size) {
+            RcnSourceText source = {
+                .text = text + start,
+                .size = size
+            };
+            assertMatchesForAllSplits(source);
+        }
+    }
+}
+
+void testStreamCountsEmptyText(void) {
+    RcnCountStream* stream = rcnCreateCountStream(ALL_STREAM_OPERATIONS);
+    TEST_ASSERT_NOT_NULL(stream);
+    RcnSourceText empty = {
+        .text = NULL,
+        .size = 0
+    };
+    TEST_ASSERT_TRUE(rcnUpdateCountStream(stream, empty));
+    RcnCountResultGroup result = rcnFinishCountStream(stream);
+    TEST_ASSERT_TRUE(result.state.ok);
+    TEST_ASSERT_TRUE(result.isProcessed);
+    TEST_ASSERT_EQUAL_INT(0, result.physicalLines);
+    TEST_ASSERT_EQUAL_INT(0, result.words);
+    TEST_ASSERT_EQUAL_INT(0, result.characters);
+    TEST_ASSERT_EQUAL_INT(0, result.sourceSize);
+    rcnFreeCountStream(stream);
+}
+
+void testStreamCountsOnlySelectedOperations(void) {
+    char text[] = "one two\nthree";
+    RcnSourceText source = {
+        .text = text,
+        .size = sizeof(text) - 1
+    };
+    RcnCountStream* stream = rcnCreateCountStream(RCN_OPT_COUNT_WORDS);
+    TEST_ASSERT_NOT_NULL(stream);
+    TEST_ASSERT_TRUE(rcnUpdateCountStream(stream, source));
+    RcnCountResultGroup result = rcnFinishCountStream(stream);
+    TEST_ASSERT_TRUE(result.state.ok);
+    TEST_ASSERT_EQUAL_INT(0, result.physicalLines);
+    TEST_ASSERT_EQUAL_INT(3, result.words);
+    TEST_ASSERT_EQUAL_INT(0, result.characters);
+    TEST_ASSERT_EQUAL_INT(13, result.sourceSize);
+    rcnFreeCountStream(stream);
+}
+
+void testStreamFailsOnNullChunk(void) {
+    char text[] = "abc def";
+    RcnSourceText source = {
+        .text = text,
+        .size = sizeof(text) - 1
+    };
+    RcnSourceText invalid = {
+        .text = NULL,
+        .size = 4
+    };
+    RcnCountStream* stream = rcnCreateCountStream(ALL_STREAM_OPERATIONS);
+    TEST_ASSERT_NOT_NULL(stream);
+    TEST_ASSERT_TRUE(rcnUpdateCountStream(stream, source));
+    TEST_ASSERT_FALSE(rcnUpdateCountStream(stream, invalid));
+    TEST_ASSERT_FALSE(rcnUpdateCountStream(stream, source));
+    RcnCountResultGroup result = rcnFinishCountStream(stream);
+    TEST_ASSERT_FALSE(result.state.ok);
+    TEST_ASSERT_EQUAL_INT(RCN_ERR_INVALID_INPUT, result.state.errorCode);
+    TEST_ASSERT_NOT_NULL(result.state.errorMessage);
+    TEST_ASSERT_FALSE(result.isProcessed);
+    TEST_ASSERT_EQUAL_INT(0, result.words);
+    rcnFreeCountStream(stream);
+}
+
+void testStreamFailsWhenUsedAfterFinish(void) {
+    char text[] = "abc";
+    RcnSourceText source = {
+        .text = text,
+        .size = sizeof(text) - 1
+    };
+    RcnCountStream* stream = rcnCreateCountStream(ALL_STREAM_OPERATIONS);
+    TEST_ASSERT_NOT_NULL(stream);
+    TEST_ASSERT_TRUE(rcnUpdateCountStream(stream, source));
+    RcnCountResultGroup result = rcnFinishCountStream(stream);
+    TEST_ASSERT_TRUE(result.state.ok);
+    TEST_ASSERT_FALSE(rcnUpdateCountStream(stream, source));
+    result = rcnFinishCountStream(stream);
+    TEST_ASSERT_FALSE(result.state.ok);
+    TEST_ASSERT_EQUAL_INT(RCN_ERR_INVALID_INPUT, result.state.errorCode);
+    rcnFreeCountStream(stream);
+}
+
+static bool updateStream(RcnSourceText chunk, void* arg) {
+    return rcnUpdateCountStream((RcnCountStream*) arg, chunk);
+}
+
+void testStreamCountsFileReadInChunks(void) {
+    RcnSourceFile* file = newSourceFile(TEST_FILE_TEXT_UTF_16_LE);
+    TEST_ASSERT_TRUE(readSourceFileContent(file));
+    RcnCountStream* stream = rcnCreateCountStream(ALL_STREAM_OPERATIONS);
+    TEST_ASSERT_NOT_NULL(stream);
+    RcnSourceFile* streamedFile = newSourceFile(TEST_FILE_TEXT_UTF_16_LE);
+    TEST_ASSERT_TRUE(
+        readSourceFileChunks(
+            streamedFile,
+            0,
+            updateStream,
+            stream
+        )
+    );
+    TEST_ASSERT_FALSE(streamedFile->isContentRead);
+    assertMatchesWholeText(file->content, rcnFinishCountStream(stream));
+    rcnFreeCountStream(stream);
+    freeSourceFile(streamedFile);
+    freeSourceFile(file);
+}
+
+void testCountTextMetricsMatchesSeparateCounts(void) {
+    for (size_t i = 0; i < NUM_TEST_FILES; ++i) {
+        RcnSourceFile* file = newSourceFile(TEST_FILES[i]);
+        TEST_ASSERT_TRUE(readSourceFileContent(file));
+        assertMatchesWholeText(
+            file->content,
+            rcnCountTextMetrics(file->content, ALL_STREAM_OPERATIONS)
+        );
+        freeSourceFile(file);
+    }
+}
+
+void testCountTextMetricsMatchesSeparateCountsForLargeText(void) {
+    // Multi-byte characters cross the boundaries of the counted tiles
+    const char pattern[] = "ab \xe2\x82\xac\n\xf0\x9f\x98\x80" "c\t";
+    const size_t patternSize = sizeof(pattern) - 1;
+    const size_t size = 200 * 1024;
+    char* text = malloc(size);
+    TEST_ASSERT_NOT_NULL(text);
+    for (size_t i = 0; i < size; ++i) {
+        text[i] = pattern[i % patternSize];
+    }
+    for (size_t end = size - 8; end <= size; ++end) {
+        RcnSourceText source = {
+            .text = text,
+            .size = end
+        };
+        assertMatchesWholeText(
+            source,
+            rcnCountTextMetrics(source, ALL_STREAM_OPERATIONS)
+        );
+    }
+    free(text);
+}
+
+void testCountTextMetricsCountsOnlySelectedOperations(void) {
+    char text[] = "one two\nthree";
+    RcnSourceText source = {
+        .text = text,
+        .size = sizeof(text) - 1
+    };
+    RcnCountResultGroup result = rcnCountTextMetrics(
+        source,
+        RCN_OPT_COUNT_PHYSICAL_LINES | RCN_OPT_COUNT_CHARACTERS
+    );
+    TEST_ASSERT_TRUE(result.state.ok);
+    TEST_ASSERT_TRUE(result.isProcessed);
+    TEST_ASSERT_EQUAL_INT(2, result.physicalLines);
+    TEST_ASSERT_EQUAL_INT(0, result.words);
+    TEST_ASSERT_EQUAL_INT(13, result.characters);
+    TEST_ASSERT_EQUAL_INT(13, result.sourceSize);
+}
+
+void testCountTextMetricsFailsOnInvalidInput(void) {
+    RcnSourceText source = {
+        .text = NULL,
+        .size = 1
+    };
+    RcnCountResultGroup result = rcnCountTextMetrics(
+        source,
+        ALL_STREAM_OPERATIONS
+    );
+    TEST_ASSERT_FALSE(result.state.ok);
+    TEST_ASSERT_EQUAL_INT(RCN_ERR_INVALID_INPUT, result.state.errorCode);
+    TEST_ASSERT_FALSE(result.isProcessed);
+    source.text = "AAAAAA....AAAA";
+    source.size = 0x000000FFFFFFFFFF;
+    result = rcnCountTextMetrics(source, ALL_STREAM_OPERATIONS);
+    TEST_ASSERT_FALSE(result.state.ok);
+    TEST_ASSERT_EQUAL_INT(RCN_ERR_INPUT_TOO_LARGE, result.state.errorCode);
+    source.text = NULL;
+    source.size = 0;
+    result = rcnCountTextMetrics(source, ALL_STREAM_OPERATIONS);
+    TEST_ASSERT_TRUE(result.state.ok);
+    TEST_ASSERT_EQUAL_INT(0, result.physicalLines);
+}
+
+/**
+ * A deterministic pseudo-random number generator (xorshift),
+ * so that failing inputs can be reproduced.
+ */
+static uint32_t nextRandom(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/**
+ * Counts the given source text with a count stream by passing it in chunks
+ * of the specified size, which are split into up to the specified number
+ * of segments. Every third chunk is passed without splitting it.
+ */
+static RcnCountResultGroup countInSegmentedChunks(
+    RcnSourceText source,
+    bool isLocaleAware,
+    size_t chunkSize,
+    size_t maxSegments
+) {
+    RcnCountStream* stream = createCountStream(
+        ALL_STREAM_OPERATIONS,
+        isLocaleAware
+    );
+    TEST_ASSERT_NOT_NULL(stream);
+    size_t index = 0;
+    for (size_t offset = 0; offset < source.size; offset += chunkSize) {
+        RcnSourceText chunk = {
+            .text = source.text + offset,
+            .size = source.size - offset
+        };
+        if (chunk.size > chunkSize) {
+            chunk.size = chunkSize;
+        }
+        const bool ok = (
+            (index++ % 3 == 2)
+            ? rcnUpdateCountStream(stream, chunk)
+            : updateCountStreamInSegments(
+                stream,
+                chunk,
+                maxSegments,
+                NULL,
+                NULL
+            )
+        );
+        TEST_ASSERT_TRUE(ok);
+    }
+    RcnCountResultGroup result = rcnFinishCountStream(stream);
+    rcnFreeCountStream(stream);
+    return result;
+}
+
+/**
+ * Asserts that the counts of the given source text in up to any number
+ * of segments between two and the specified maximum are the same as the
+ * counts of the entire source text. The same applies to the chunks of
+ * a count stream, whose sizes do not need to be aligned to characters.
+ */
+static void assertSegmentedCountsMatch(
+    RcnSourceText source,
+    TextEncoding encoding,
+    size_t maxSegments
+) {
+    for (int locale = 0; locale <= 1; ++locale) {
+        const bool isLocaleAware = locale != 0;
+        RcnCountResultGroup expected = countTextMetrics(
+            source,
+            encoding,
+            ALL_STREAM_OPERATIONS,
+            isLocaleAware
+        );
+        for (size_t segments = 2; segments <= maxSegments; ++segments) {
+            RcnCountResultGroup actual = countTextMetricsInSegments(
+                source,
+                encoding,
+                ALL_STREAM_OPERATIONS,
+                isLocaleAware,
+                segments,
+                NULL,
+                NULL
+            );
+            TEST_ASSERT_TRUE(actual.state.ok);
+            TEST_ASSERT_TRUE(actual.isProcessed);
+            TEST_ASSERT_EQUAL_INT(expected.physicalLines, actual.physicalLines);
+            TEST_ASSERT_EQUAL_INT(expected.words, actual.words);
+            TEST_ASSERT_EQUAL_INT(expected.characters, actual.characters);
+            TEST_ASSERT_EQUAL_INT(expected.sourceSize, actual.sourceSize);
+        }
+        RcnCountResultGroup streamed = countInSegmentedChunks(
+            source,
+            isLocaleAware,
+            source.size,
+            1
+        );
+        for (size_t segments = 2; segments <= maxSegments; ++segments) {
+            RcnCountResultGroup actual = countInSegmentedChunks(
+                source,
+                isLocaleAware,
+                12345,
+                segments
+            );
+            TEST_ASSERT_TRUE(actual.state.ok);
+            TEST_ASSERT_EQUAL_INT(streamed.physicalLines, actual.physicalLines);
+            TEST_ASSERT_EQUAL_INT(streamed.words, actual.words);
+            TEST_ASSERT_EQUAL_INT(streamed.characters, actual.characters);
+            TEST_ASSERT_EQUAL_INT(streamed.sourceSize, actual.sourceSize);
+        }
+    }
+}
+
+void testSegmentedCountsMatchWholeTextUTF8(void) {
+    // Sequences of all lengths, white space, null bytes and bytes which
+    // are not well-formed, like truncated sequences and stray continuations
+    static const char* const tokens[] = {
+        "ab", " ", "\n", "\r\n", "\t", "\xc3\xa9", "\xe2\x82\xac",
+        "\xf0\x9f\x98\x80", "\0", "\xf0", "\x80", "\xe2\x82"
+    };
+    const size_t numTokens = sizeof(tokens) / sizeof(tokens[0]);
+    const size_t size = 64 * 1024;
+    char* text = malloc(size);
+    TEST_ASSERT_NOT_NULL(text);
+    uint32_t state = 0x2545F491;
+    for (int round = 0; round < 4; ++round) {
+        size_t offset = 0;
+        while (offset < size) {
+            const char* token = tokens[nextRandom(&state) % numTokens];
+            const size_t length = (*token == '\0') ? 1 : strlen(token);
+            for (size_t i = 0; i < length && offset < size; ++i) {
+                text[offset++] = token[i];
+            }
+        }
+        RcnSourceText source = { .text = text, .size = size - round };
+        assertSegmentedCountsMatch(source, TextEncodingUTF8, 16);
+    }
+    free(text);
+}
+
+static void assertSegmentedCountsMatchUTF16(bool isLittleEndian) {
+    // Code units of all classes, including unpaired surrogates
+    static const uint16_t units[] = {
+        'a', ' ', '\n', '\t', 0x00E9, 0x3000, 0x2028, 0x0000,
+        0xD83D, 0xDE00, 0xD800, 0xDFFF, 0xFEFF
+    };
+    const size_t numUnits = sizeof(units) / sizeof(units[0]);
+    const size_t size = 64 * 1024;
+    char* text = malloc(size + 1);
+    TEST_ASSERT_NOT_NULL(text);
+    uint32_t state = 0x9E3779B9;
+    for (int round = 0; round < 4; ++round) {
+        text[0] = isLittleEndian ? '\xFF' : '\xFE';
+        text[1] = isLittleEndian ? '\xFE' : '\xFF';
+        for (size_t offset = 2; offset < size; offset += 2) {
+            const uint16_t unit = units[nextRandom(&state) % numUnits];
+            const char low = (char) (unit & 0xFF);
+            const char high = (char) (unit >> 8);
+            text[offset] = isLittleEndian ? low : high;
+            text[offset + 1] = isLittleEndian ? high : low;
+        }
+        text[size] = 'x';
+        // Includes sizes with a trailing single byte
+        RcnSourceText source = { .text = text, .size = size + (round % 2) };
+        assertSegmentedCountsMatch(
+            source,
+            isLittleEndian ? TextEncodingUTF16LE : TextEncodingUTF16BE,
+            12
+        );
+    }
+    free(text);
+}
+
+void testSegmentedCountsMatchWholeTextUTF16LE(void) {
+    assertSegmentedCountsMatchUTF16(true);
+}
+
+void testSegmentedCountsMatchWholeTextUTF16BE(void) {
+    assertSegmentedCountsMatchUTF16(false);
+}
+
+void testSegmentedCountsMatchWholeTextWithWordsAcrossSegments(void) {
+    const size_t size = 64 * 1024;
+    char* text = malloc(size);
+    TEST_ASSERT_NOT_NULL(text);
+    // A single word which spans all segments
+    memset(text, 'a', size);
+    RcnSourceText source = { .text = text, .size = size };
+    assertSegmentedCountsMatch(source, TextEncodingUTF8, 8);
+    // Two words separated by null bytes, which neither start nor end a word
+    memset(text + 2, '\0', size - 4);
+    assertSegmentedCountsMatch(source, TextEncodingUTF8, 8);
+    text[0] = ' ';
+    assertSegmentedCountsMatch(source, TextEncodingUTF8, 8);
+    free(text);
+}
+
+void testSegmentedCountsMatchWholeTextWithoutCharacterBoundaries(void) {
+    // Every byte might start a four-byte sequence, so no split is possible
+    const size_t size = 32 * 1024;
+    char* text = malloc(size);
+    TEST_ASSERT_NOT_NULL(text);
+    memset(text, '\xf0', size);
+    RcnSourceText source = { .text = text, .size = size - 1 };
+    assertSegmentedCountsMatch(source, TextEncodingUTF8, 4);
+    free(text);
+}
+
+void testSegmentedCountsOfSmallTextAreNotSplit(void) {
+    char text[] = "one two\nthree";
+    RcnSourceText source = { .text = text, .size = sizeof(text) - 1 };
+    RcnCountResultGroup result = countTextMetricsInSegments(
+        source,
+        TextEncodingUTF8,
+        ALL_STREAM_OPERATIONS,
+        false,
+        8,
+        NULL,
+        NULL
+    );
+    TEST_ASSERT_TRUE(result.state.ok);
+    TEST_ASSERT_EQUAL_INT(2, result.physicalLines);
+    TEST_ASSERT_EQUAL_INT(3, result.words);
+    TEST_ASSERT_EQUAL_INT(13, result.characters);
+    assertSegmentedCountsMatch(source, TextEncodingUTF8, 4);
+}
+
+static bool updateStreamInSegments(RcnSourceText chunk, void* arg) {
+    return updateCountStreamInSegments(
+        (RcnCountStream*) arg,
+        chunk,
+        4,
+        NULL,
+        NULL
+    );
+}
+
+void testSegmentedStreamCountsFileReadInChunks(void) {
+    // Only the first chunk of the larger file is large enough to be split,
+    // the smaller file is read in a single chunk which is not split
+    static const char* const files[] = {
+        TEST_FILE_SOURCE_ANNOTATED_C,
+        TEST_FILE_TEXT_UTF_16_LE
+    };
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); ++i) {
+        RcnSourceFile* file = newSourceFile(files[i]);
+        TEST_ASSERT_TRUE(readSourceFileContent(file));
+        RcnCountStream* stream = rcnCreateCountStream(ALL_STREAM_OPERATIONS);
+        TEST_ASSERT_NOT_NULL(stream);
+        RcnSourceFile* streamedFile = newSourceFile(files[i]);
+        TEST_ASSERT_TRUE(
+            readSourceFileChunks(
+                streamedFile,
+                9 * 1024 + 1,
+                updateStreamInSegments,
+                stream
+            )
+        );
+        TEST_ASSERT_FALSE(streamedFile->isContentRead);
+        assertMatchesWholeText(file->content, rcnFinishCountStream(stream));
+        rcnFreeCountStream(stream);
+        freeSourceFile(streamedFile);
+        freeSourceFile(file);
+    }
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(testStreamCountsMatchWholeTextForAllChunkSizes);
+    RUN_TEST(testStreamCountsMatchWholeTextForAllSplitsUTF8);
+    RUN_TEST(testStreamCountsMatchWholeTextForAllSplitsTruncatedUTF8);
+    RUN_TEST(testStreamCountsMatchWholeTextForAllSplitsUTF16LE);
+    RUN_TEST(testStreamCountsMatchWholeTextForAllSplitsUTF16BE);
+    RUN_TEST(testStreamCountsMatchWholeTextForTinyTexts);
+    RUN_TEST(testStreamCountsEmptyText);
+    RUN_TEST(testStreamCountsOnlySelectedOperations);
+    RUN_TEST(testStreamFailsOnNullChunk);
+    RUN_TEST(testStreamFailsWhenUsedAfterFinish);
+    RUN_TEST(testStreamCountsFileReadInChunks);
+    RUN_TEST(testCountTextMetricsMatchesSeparateCounts);
+    RUN_TEST(testCountTextMetricsMatchesSeparateCountsForLargeText);
+    RUN_TEST(testCountTextMetricsCountsOnlySelectedOperations);
+    RUN_TEST(testCountTextMetricsFailsOnInvalidInput);
+    RUN_TEST(testSegmentedCountsMatchWholeTextUTF8);
+    RUN_TEST(testSegmentedCountsMatchWholeTextUTF16LE);
+    RUN_TEST(testSegmentedCountsMatchWholeTextUTF16BE);
+    RUN_TEST(testSegmentedCountsMatchWholeTextWithWordsAcrossSegments);
+    RUN_TEST(testSegmentedCountsMatchWholeTextWithoutCharacterBoundaries);
+    RUN_TEST(testSegmentedCountsOfSmallTextAreNotSplit);
+    RUN_TEST(testSegmentedStreamCountsFileReadInChunks);
+    return UNITY_END();
+}
+
+// NOLINTEND(readability-magic-numbers)
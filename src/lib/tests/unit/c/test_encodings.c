@@ -65,11 +65,168 @@ void testTextEncodingIsDetectedCorrectlyUTF16BE(void) {
     freeSourceFile(file);
 }
 
+void testBinaryContentIsNotDetectedInText(void) {
+    const char* paths[] = {
+        TEST_FILE_TEXT_UTF_8,
+        TEST_FILE_TEXT_UTF_8_BOM,
+        TEST_FILE_TEXT_UTF_16_LE,
+        TEST_FILE_TEXT_UTF_16_BE
+    };
+    for (size_t i = 0; i < sizeof(paths) / sizeof(paths[0]); ++i) {
+        RcnSourceFile* file = newSourceFile(paths[i]);
+        readSourceFileContent(file);
+        const TextEncoding encoding = detectEncoding(file->content);
+        TEST_ASSERT_FALSE(isBinaryContent(file->content, encoding));
+        freeSourceFile(file);
+    }
+}
+
+void testBinaryContentIsDetectedByNullBytes(void) {
+    char text[] = { 'a', 'b', '\n', 0, 'c', '\n' };
+    RcnSourceText source = { .text = text, .size = sizeof(text) };
+    TEST_ASSERT_TRUE(isBinaryContent(source, TextEncodingUTF8));
+    // The null byte is part of a code unit in UTF-16
+    TEST_ASSERT_FALSE(isBinaryContent(source, TextEncodingUTF16LE));
+    // Only the start of the source text is inspected
+    enum { LARGE_SIZE = 16384, TEXT_SIZE = 12000 };
+    char* large = calloc(LARGE_SIZE, 1);
+    TEST_ASSERT_NOT_NULL(large);
+    memset(large, 'a', TEXT_SIZE);
+    source = (RcnSourceText){ .text = large, .size = LARGE_SIZE };
+    TEST_ASSERT_FALSE(isBinaryContent(source, TextEncodingUTF8));
+    free(large);
+}
+
+void testBinaryContentIsDetectedByNullCodeUnits(void) {
+    // BOM, 'a', null, 'b' in UTF-16BE
+    char text[] = { '\xFE', '\xFF', 0, 'a', 0, 0, 0, 'b' };
+    RcnSourceText source = { .text = text, .size = sizeof(text) };
+    TEST_ASSERT_TRUE(isBinaryContent(source, TextEncodingUTF16BE));
+}
+
+void testBinaryContentIsDetectedByControlBytes(void) {
+    char text[20];
+    memset(text, 'a', sizeof(text));
+    RcnSourceText source = { .text = text, .size = sizeof(text) };
+    text[3] = '\x01';
+    text[7] = '\x1B';
+    text[9] = '\t';
+    TEST_ASSERT_FALSE(isBinaryContent(source, TextEncodingUTF8));
+    text[11] = '\x7F';
+    text[13] = '\x02';
+    TEST_ASSERT_FALSE(isBinaryContent(source, TextEncodingUTF8));
+    text[15] = '\x03';
+    TEST_ASSERT_TRUE(isBinaryContent(source, TextEncodingUTF8));
+}
+
+void testTranscodeToUTF8IsRejectedForUTF8(void) {
+    RcnSourceFile* file = newSourceFile(TEST_FILE_TEXT_UTF_8_BOM);
+    readSourceFileContent(file);
+    TextBuffer buffer = {0};
+    RcnSourceText transcoded = {0};
+    TEST_ASSERT_FALSE(
+        transcodeToUTF8(
+            file->content,
+            detectEncoding(file->content),
+            &buffer,
+            &transcoded
+        )
+    );
+    TEST_ASSERT_NULL(transcoded.text);
+    freeTextBuffer(&buffer);
+    freeSourceFile(file);
+}
+
+void testTranscodeToUTF8KeepsCountsOfUTF16(void) {
+    const char* paths[] = {
+        TEST_FILE_TEXT_UTF_16_LE,
+        TEST_FILE_TEXT_UTF_16_BE
+    };
+    const char* firstLine = "This is some test text data\n";
+    TextBuffer buffer = {0};
+    for (size_t i = 0; i < sizeof(paths) / sizeof(paths[0]); ++i) {
+        RcnSourceFile* file = newSourceFile(paths[i]);
+        readSourceFileContent(file);
+        RcnSourceText transcoded = {0};
+        TEST_ASSERT_TRUE(
+            transcodeToUTF8(
+                file->content,
+                detectEncoding(file->content),
+                &buffer,
+                &transcoded
+            )
+        );
+        TEST_ASSERT_EQUAL_INT(TextEncodingUTF8, detectEncoding(transcoded));
+        TEST_ASSERT_EQUAL_MEMORY(
+            firstLine,
+            transcoded.text,
+            strlen(firstLine)
+        );
+        TEST_ASSERT_EQUAL_INT(transcoded.size, strlen(transcoded.text));
+        TEST_ASSERT_EQUAL_INT(
+            rcnCountPhysicalLines(file->content).count,
+            rcnCountPhysicalLines(transcoded).count
+        );
+        TEST_ASSERT_EQUAL_INT(
+            rcnCountWords(file->content).count,
+            rcnCountWords(transcoded).count
+        );
+        TEST_ASSERT_EQUAL_INT(
+            rcnCountCharacters(file->content).count,
+            rcnCountCharacters(transcoded).count
+        );
+        freeSourceFile(file);
+    }
+    freeTextBuffer(&buffer);
+}
+
+void testTranscodeToUTF8IsRejectedForUnpairedSurrogate(void) {
+    // BOM, 'a', high surrogate, 'b' in UTF-16LE
+    char text[] = { '\xFF', '\xFE', 'a', 0, 0, '\xD8', 'b', 0 };
+    RcnSourceText source = { .text = text, .size = sizeof(text) };
+    const TextEncoding encoding = TextEncodingUTF16LE;
+    TextBuffer buffer = {0};
+    RcnSourceText transcoded = {0};
+    TEST_ASSERT_FALSE(
+        transcodeToUTF8(source, encoding, &buffer, &transcoded)
+    );
+    TEST_ASSERT_NULL(transcoded.text);
+    // The same text with a trailing single byte
+    source.size = sizeof(text) - 3;
+    TEST_ASSERT_FALSE(
+        transcodeToUTF8(source, encoding, &buffer, &transcoded)
+    );
+    freeTextBuffer(&buffer);
+}
+
+void testTranscodeToUTF8WithOnlyBOM(void) {
+    char text[] = { '\xFE', '\xFF' };
+    RcnSourceText source = { .text = text, .size = sizeof(text) };
+    const TextEncoding encoding = TextEncodingUTF16BE;
+    TextBuffer buffer = {0};
+    RcnSourceText transcoded = {0};
+    TEST_ASSERT_TRUE(
+        transcodeToUTF8(source, encoding, &buffer, &transcoded)
+    );
+    TEST_ASSERT_NOT_NULL(transcoded.text);
+    TEST_ASSERT_EQUAL_INT(0, transcoded.size);
+    TEST_ASSERT_EQUAL_STRING("", transcoded.text);
+    freeTextBuffer(&buffer);
+}
+
 int main(void) {
     UNITY_BEGIN();
     RUN_TEST(testTextEncodingIsDetectedCorrectlyWithDefaultUTF8);
     RUN_TEST(testTextEncodingIsDetectedCorrectlyWithBOMforUTF8);
     RUN_TEST(testTextEncodingIsDetectedCorrectlyUTF16LE);
     RUN_TEST(testTextEncodingIsDetectedCorrectlyUTF16BE);
+    RUN_TEST(testBinaryContentIsNotDetectedInText);
+    RUN_TEST(testBinaryContentIsDetectedByNullBytes);
+    RUN_TEST(testBinaryContentIsDetectedByNullCodeUnits);
+    RUN_TEST(testBinaryContentIsDetectedByControlBytes);
+    RUN_TEST(testTranscodeToUTF8IsRejectedForUTF8);
+    RUN_TEST(testTranscodeToUTF8KeepsCountsOfUTF16);
+    RUN_TEST(testTranscodeToUTF8IsRejectedForUnpairedSurrogate);
+    RUN_TEST(testTranscodeToUTF8WithOnlyBOM);
     return UNITY_END();
 }
@@ -40,6 +40,20 @@ void testCreateEvaluationFunctionForJava(void) {
     TEST_ASSERT_NOT_NULL(evaluator);
 }
 
+void testCreateQueryForJava(void) {
+    TSQuery* query = createQuery(RCN_LANG_JAVA);
+    TEST_ASSERT_NOT_NULL(query);
+    TEST_ASSERT_TRUE(ts_query_capture_count(query) > 0);
+    ts_query_delete(query);
+}
+
+void testCreateQueryForC(void) {
+    TSQuery* query = createQuery(RCN_LANG_C);
+    TEST_ASSERT_NOT_NULL(query);
+    TEST_ASSERT_TRUE(ts_query_capture_count(query) > 0);
+    ts_query_delete(query);
+}
+
 void testGetInlineSourceCommentStringForJava(void) {
     RcnTextFormat language = RCN_LANG_JAVA;
     const char* string = getInlineSourceCommentString(language);
@@ -57,21 +71,55 @@ void testCreateEvaluationFunctionForUnknownLanguageReturnsNull(void) {
     TEST_ASSERT_NULL(evaluator);
 }
 
+void testCreateQueryForUnknownLanguageReturnsNull(void) {
+    TSQuery* query = createQuery(12345); // NOLINT
+    TEST_ASSERT_NULL(query);
+}
+
 void testGetInlineSourceCommentStrForUnknownLangReturnsDefaultValue(void) {
     const char* string = getInlineSourceCommentString(12345); // NOLINT
     TEST_ASSERT_NOT_NULL(string);
     TEST_ASSERT_EQUAL_STRING("//", string);
 }
 
+void testAcquireParserReturnsCachedParser(void) {
+    ParserCache cache = {0};
+    TSParser* parser1 = acquireParser(&cache, RCN_LANG_JAVA);
+    TEST_ASSERT_NOT_NULL(parser1);
+    TSParser* parser2 = acquireParser(&cache, RCN_LANG_JAVA);
+    TEST_ASSERT_EQUAL_PTR(parser1, parser2);
+    TSParser* parser3 = acquireParser(&cache, RCN_LANG_C);
+    TEST_ASSERT_NOT_NULL(parser3);
+    TEST_ASSERT_TRUE(parser1 != parser3);
+    TEST_ASSERT_EQUAL_PTR(parser1, cache.parsers[RCN_LANG_JAVA]);
+    TEST_ASSERT_EQUAL_PTR(parser3, cache.parsers[RCN_LANG_C]);
+    freeParserCache(&cache);
+    TEST_ASSERT_NULL(cache.parsers[RCN_LANG_JAVA]);
+    TEST_ASSERT_NULL(cache.parsers[RCN_LANG_C]);
+    TEST_ASSERT_FALSE(cache.hasCursor);
+}
+
+void testAcquireParserForUnknownLanguageReturnsNull(void) {
+    ParserCache cache = {0};
+    TEST_ASSERT_NULL(acquireParser(&cache, 12345)); // NOLINT
+    TEST_ASSERT_NULL(acquireParser(&cache, RCN_TEXT_UNFORMATTED));
+    freeParserCache(&cache);
+}
+
 // NOLINTEND(readability-magic-numbers)
 
 int main(void) {
     UNITY_BEGIN();
     RUN_TEST(testCreateParserForJava);
     RUN_TEST(testCreateEvaluationFunctionForJava);
+    RUN_TEST(testCreateQueryForJava);
+    RUN_TEST(testCreateQueryForC);
     RUN_TEST(testGetInlineSourceCommentStringForJava);
     RUN_TEST(testCreateParserForUnknownLanguageReturnsNull);
     RUN_TEST(testCreateEvaluationFunctionForUnknownLanguageReturnsNull);
+    RUN_TEST(testCreateQueryForUnknownLanguageReturnsNull);
     RUN_TEST(testGetInlineSourceCommentStrForUnknownLangReturnsDefaultValue);
+    RUN_TEST(testAcquireParserReturnsCachedParser);
+    RUN_TEST(testAcquireParserForUnknownLanguageReturnsNull);
     return UNITY_END();
 }
@@ -15,6 +15,7 @@
  */
 
 #include <stdlib.h>
+#include <stdio.h>
 #include <string.h>
 
 #include "unity.h"
@@ -186,12 +187,16 @@ void testEvaluateSourceTreeFailsWhenGivenInputWithUnknownLanguage(void) {
         .text = code,
         .size = strlen(code)
     };
+    ParserCache cache = {0};
     RcnResultState result = evaluateSourceTree(
         source,
+        TextEncodingUTF8,
         12345, // NOLINT
         NULL,
-        NULL
+        NULL,
+        &cache
     );
+    freeParserCache(&cache);
     TEST_ASSERT_FALSE(result.ok);
     TEST_ASSERT_EQUAL_INT(RCN_ERR_UNSUPPORTED_FORMAT, result.errorCode);
     TEST_ASSERT_EQUAL_STRING(
@@ -200,6 +205,216 @@ void testEvaluateSourceTreeFailsWhenGivenInputWithUnknownLanguage(void) {
     );
 }
 
+static void visitNodeWithoutPruning(TSNode node, NodeEvalTrace* trace) {
+    (void) node;
+    (void) trace;
+}
+
+void testEvaluateSourceTreeSkipsSubtreesOfPrunedNodes(void) {
+    char* code = (
+        "#include <stdio.h>\n"
+        "#define GREETING \"Hello\" \" World\"\n"
+        "static const char* names[] = {\n"
+        "    \"alpha\", \"beta\", \"gamma\",\n"
+        "    \"delta\\n\", \"epsilon\\t\"\n"
+        "};\n"
+        "int main(void) {\n"
+        "    char sep = ',';\n"
+        "    puts(GREETING);\n"
+        "    return sep;\n"
+        "}\n"
+    );
+    RcnSourceText source = {
+        .text = code,
+        .size = strlen(code)
+    };
+    ParserCache cache = {0};
+    RcnCountResult result = {0};
+    NodeEvalTrace trace = {0};
+    trace.result = &result;
+    RcnResultState state = evaluateSourceTree(
+        source,
+        TextEncodingUTF8,
+        RCN_LANG_C,
+        createEvaluationFunction(RCN_LANG_C),
+        &trace,
+        &cache
+    );
+    NodeEvalTrace fullTrace = {0};
+    RcnResultState fullState = evaluateSourceTree(
+        source,
+        TextEncodingUTF8,
+        RCN_LANG_C,
+        visitNodeWithoutPruning,
+        &fullTrace,
+        &cache
+    );
+    freeParserCache(&cache);
+    TEST_ASSERT_TRUE(state.ok);
+    TEST_ASSERT_TRUE(fullState.ok);
+    TEST_ASSERT_EQUAL_INT(7, result.count);
+    TEST_ASSERT_TRUE(trace.numVisitedNodes > 0);
+    TEST_ASSERT_TRUE(trace.numVisitedNodes < fullTrace.numVisitedNodes);
+    TEST_ASSERT_EQUAL_UINT64(trace.idx, trace.numVisitedNodes);
+}
+
+static void visitNodeJavaWithoutPruning(TSNode node, NodeEvalTrace* trace) {
+    createEvaluationFunction(RCN_LANG_JAVA)(node, trace);
+    trace->skipChildren = false;
+}
+
+void testEvaluateSourceTreeCountsKeywordsInJavaNames(void) {
+    char* code =
+        "package com.acme.module;\n"
+        "import java.lang.module.ModuleFinder;\n"
+        "public class A {\n"
+        "    ModuleFinder finder;\n"
+        "}\n";
+
+    RcnSourceText source = {
+        .text = code,
+        .size = strlen(code)
+    };
+    ParserCache cache = {0};
+    RcnCountResult result = {0};
+    NodeEvalTrace trace = {0};
+    trace.result = &result;
+    RcnResultState state = evaluateSourceTree(
+        source,
+        TextEncodingUTF8,
+        RCN_LANG_JAVA,
+        createEvaluationFunction(RCN_LANG_JAVA),
+        &trace,
+        &cache
+    );
+    RcnCountResult fullResult = {0};
+    NodeEvalTrace fullTrace = {0};
+    fullTrace.result = &fullResult;
+    RcnResultState fullState = evaluateSourceTree(
+        source,
+        TextEncodingUTF8,
+        RCN_LANG_JAVA,
+        visitNodeJavaWithoutPruning,
+        &fullTrace,
+        &cache
+    );
+    freeParserCache(&cache);
+    TEST_ASSERT_TRUE(state.ok);
+    TEST_ASSERT_TRUE(fullState.ok);
+    // Pruning must never change the counts
+    TEST_ASSERT_TRUE(fullResult.count >= 4);
+    TEST_ASSERT_EQUAL_INT(fullResult.count, result.count);
+    TEST_ASSERT_EQUAL_UINT64(fullTrace.numVisitedNodes, trace.numVisitedNodes);
+}
+
+void testEvaluateLogicalLinesByQueryAgreesWithVisitorForJava(void) {
+    char* code =
+        "package mytest;\n"
+        "public class A {\n"
+        "    int m() { int x = 0; return x;}\n"
+        "    void s(int k) {\n"
+        "        switch (k) {\n"
+        "            case 1 -> { foo(); }\n"
+        "            default -> bar();\n"
+        "        }\n"
+        "    }\n"
+        "}\n";
+
+    RcnSourceText source = {
+        .text = code,
+        .size = strlen(code)
+    };
+    ParserCache cache = {0};
+    RcnCountResult visited = evaluateLogicalLines(
+        RCN_LANG_JAVA,
+        source,
+        TextEncodingUTF8,
+        &cache
+    );
+    RcnCountResult matched = evaluateLogicalLinesByQuery(
+        RCN_LANG_JAVA,
+        source,
+        TextEncodingUTF8,
+        &cache
+    );
+    freeParserCache(&cache);
+    TEST_ASSERT_TRUE(visited.state.ok);
+    TEST_ASSERT_TRUE(matched.state.ok);
+    TEST_ASSERT_EQUAL_INT(RCN_ERR_NONE, matched.state.errorCode);
+    TEST_ASSERT_NULL(matched.state.errorMessage);
+    TEST_ASSERT_EQUAL_INT(9, visited.count);
+    TEST_ASSERT_EQUAL_INT(9, matched.count);
+}
+
+void testEvaluateLogicalLinesByQueryAgreesWithVisitorForC(void) {
+    char* code = (
+        "#include <stdio.h>\n"
+        "typedef struct point {\n"
+        "    int x;\n"
+        "} point;\n"
+        "void draw(struct point* p);\n"
+        "int main(void) {\n"
+        "    char sep = ',';\n"
+        "    struct point* p = malloc(sizeof(struct point));\n"
+        "    p = (struct point*) p;\n"
+        "    sep = sizeof(struct point);\n"
+        "    sep = sizeof(union value);\n"
+        "    for (int i = 0; i < 2; i++) {\n"
+        "        if (i) {\n"
+        "            sep = ';';\n"
+        "        } else if (sep) {\n"
+        "            sep = '.';\n"
+        "        }\n"
+        "    }\n"
+        "    do {\n"
+        "        puts(\"done\");\n"
+        "    } while (0);\n"
+        "    return sep;\n"
+        "}\n"
+    );
+    RcnSourceText source = {
+        .text = code,
+        .size = strlen(code)
+    };
+    ParserCache cache = {0};
+    RcnCountResult visited = evaluateLogicalLines(
+        RCN_LANG_C,
+        source,
+        TextEncodingUTF8,
+        &cache
+    );
+    RcnCountResult matched = evaluateLogicalLinesByQuery(
+        RCN_LANG_C,
+        source,
+        TextEncodingUTF8,
+        &cache
+    );
+    freeParserCache(&cache);
+    TEST_ASSERT_TRUE(visited.state.ok);
+    TEST_ASSERT_TRUE(matched.state.ok);
+    TEST_ASSERT_EQUAL_INT(20, visited.count);
+    TEST_ASSERT_EQUAL_INT(20, matched.count);
+}
+
+void testEvaluateLogicalLinesByQueryFailsWhenGivenUnknownLanguage(void) {
+    char* code = "int x = 0;\n";
+    RcnSourceText source = {
+        .text = code,
+        .size = strlen(code)
+    };
+    ParserCache cache = {0};
+    RcnCountResult result = evaluateLogicalLinesByQuery(
+        12345, // NOLINT
+        source,
+        TextEncodingUTF8,
+        &cache
+    );
+    freeParserCache(&cache);
+    TEST_ASSERT_FALSE(result.state.ok);
+    TEST_ASSERT_EQUAL_INT(RCN_ERR_UNSUPPORTED_FORMAT, result.state.errorCode);
+    TEST_ASSERT_EQUAL_INT(0, result.count);
+}
+
 void testMarkLogicalLinesSimpleJavaIsSuccessful(void) {
     char* code =
         "package mytest;\n"
@@ -362,6 +577,91 @@ void testLogicalLineCountWithSyntaxErrorFails(void) {
     TEST_ASSERT_EQUAL_INT(0, res.count);
 }
 
+void testLogicalLineCountFailsWhenParsingIsCancelled(void) {
+    char* code =
+        "package mytest;\n"
+        "public class A {\n"
+        "    int m() { int x = 0; return x;}\n"
+        "}\n";
+
+    RcnSourceText source = {
+        .text = code,
+        .size = strlen(code)
+    };
+    rcnCancelParsing(true);
+    RcnCountResult res = rcnCountLogicalLines(RCN_LANG_JAVA, source);
+    rcnCancelParsing(false);
+    TEST_ASSERT_FALSE(res.state.ok);
+    TEST_ASSERT_EQUAL_INT(RCN_ERR_PARSE_CANCELLED, res.state.errorCode);
+    TEST_ASSERT_EQUAL_STRING(
+        "Parsing of source code was cancelled",
+        res.state.errorMessage
+    );
+    TEST_ASSERT_EQUAL_INT(0, res.count);
+    res = rcnCountLogicalLines(RCN_LANG_JAVA, source);
+    TEST_ASSERT_TRUE(res.state.ok);
+    TEST_ASSERT_EQUAL_INT(5, res.count);
+}
+
+void testLogicalLineCountFailsWhenTimeBudgetIsExceeded(void) {
+    const size_t numLines = 100000;
+    const size_t lineSize = 32;
+    char* code = malloc(numLines * lineSize);
+    TEST_ASSERT_NOT_NULL(code);
+    size_t size = 0;
+    for (size_t i = 0; i < numLines; ++i) {
+        size += (size_t) snprintf(
+            code + size,
+            lineSize,
+            "int a%zu = %zu;\n",
+            i,
+            i
+        );
+    }
+    RcnSourceText source = {
+        .text = code,
+        .size = size
+    };
+    ParserCache cache = {0};
+    cache.timeoutMicros = 1;
+    RcnCountResult res = evaluateLogicalLines(
+        RCN_LANG_C,
+        source,
+        TextEncodingUTF8,
+        &cache
+    );
+    freeParserCache(&cache);
+    free(code);
+    TEST_ASSERT_FALSE(res.state.ok);
+    TEST_ASSERT_EQUAL_INT(RCN_ERR_PARSE_CANCELLED, res.state.errorCode);
+    TEST_ASSERT_EQUAL_STRING(
+        "Parsing of source code exceeded the time budget",
+        res.state.errorMessage
+    );
+    TEST_ASSERT_EQUAL_INT(0, res.count);
+}
+
+void testLogicalLineCountSucceedsWithLargestTimeBudget(void) {
+    // The deadline would overflow, so parsing must not be cut off
+    char code[] = "int a = 1;\nint b = 2;\n";
+    RcnSourceText source = {
+        .text = code,
+        .size = sizeof(code) - 1
+    };
+    ParserCache cache = {0};
+    cache.timeoutMicros = UINT64_MAX;
+    RcnCountResult res = evaluateLogicalLines(
+        RCN_LANG_C,
+        source,
+        TextEncodingUTF8,
+        &cache
+    );
+    freeParserCache(&cache);
+    TEST_ASSERT_TRUE(res.state.ok);
+    TEST_ASSERT_EQUAL_INT(RCN_ERR_NONE, res.state.errorCode);
+    TEST_ASSERT_EQUAL_INT(2, res.count);
+}
+
 void testMarkLogicalLinesFailsWhenGivenUTF16Input(void) {
     RcnSourceText result = rcnMarkLogicalLinesInFile(
         TEST_FILE_SOURCE_UTF_16_LE
@@ -414,7 +714,15 @@ int main(void) {
     RUN_TEST(testLogicalLineCountWithEncodedSourceUTF16BE);
     RUN_TEST(testLogicalLineCountWithTooLargeTextInputFails);
     RUN_TEST(testEvaluateSourceTreeFailsWhenGivenInputWithUnknownLanguage);
+    RUN_TEST(testEvaluateSourceTreeSkipsSubtreesOfPrunedNodes);
+    RUN_TEST(testEvaluateSourceTreeCountsKeywordsInJavaNames);
+    RUN_TEST(testEvaluateLogicalLinesByQueryAgreesWithVisitorForJava);
+    RUN_TEST(testEvaluateLogicalLinesByQueryAgreesWithVisitorForC);
+    RUN_TEST(testEvaluateLogicalLinesByQueryFailsWhenGivenUnknownLanguage);
     RUN_TEST(testLogicalLineCountWithSyntaxErrorFails);
+    RUN_TEST(testLogicalLineCountFailsWhenParsingIsCancelled);
+    RUN_TEST(testLogicalLineCountFailsWhenTimeBudgetIsExceeded);
+    RUN_TEST(testLogicalLineCountSucceedsWithLargestTimeBudget);
     RUN_TEST(testMarkLogicalLinesSimpleJavaIsSuccessful);
     RUN_TEST(testMarkLogicalLinesWithTooLargeTextInputFails);
     RUN_TEST(testMarkLogicalLinesWithNullTextInputFails);
@@ -0,0 +1,997 @@
+/*
+ * Copyright (C) 2026 Raven Computing
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "unity.h"
+
+#include "simd.h"
+
+void setUp(void) { }
+
+void tearDown(void) { }
+
+// NOLINTBEGIN(readability-magic-numbers)
+
+/**
+ * A deterministic pseudo-random number generator (xorshift),
+ * so that failing inputs can be reproduced.
+ */
+static uint32_t nextRandom(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/**
+ * Fills the given buffer with bytes randomly chosen from the given alphabet.
+ */
+static void fillRandom(
+    char* buffer,
+    size_t size,
+    const char* alphabet,
+    size_t alphabetSize,
+    uint32_t* state
+) {
+    for (size_t i = 0; i < size; ++i) {
+        buffer[i] = alphabet[nextRandom(state) % alphabetSize];
+    }
+}
+
+/**
+ * Asserts that all supported kernel variants agree with the scalar
+ * reference for all offsets and sizes of the given buffer up to the
+ * specified maximum size.
+ */
+static void assertByteCountKernelsAgree(
+    const char* buffer,
+    size_t maxSize,
+    char byte
+) {
+    ByteCountKernel reference = getByteCountKernel(SimdLevelScalar);
+    for (int level = SimdLevelPortable; level < SIMD_NUM_LEVELS; ++level) {
+        ByteCountKernel kernel = getByteCountKernel((SimdLevel) level);
+        if (!kernel) {
+            continue;
+        }
+        for (size_t offset = 0; offset < 64 && offset < maxSize; ++offset) {
+            for (size_t size = 0; offset + size <= maxSize; ++size) {
+                TEST_ASSERT_EQUAL_INT(
+                    reference(buffer + offset, size, byte),
+                    kernel(buffer + offset, size, byte)
+                );
+            }
+        }
+    }
+}
+
+/**
+ * Asserts that all supported variants of the control byte count kernel agree
+ * with the scalar reference for all offsets and sizes of the given buffer up
+ * to the specified maximum size.
+ */
+static void assertControlByteCountKernelsAgree(
+    const char* buffer,
+    size_t maxSize
+) {
+    ControlByteCountKernel reference = getControlByteCountKernel(
+        SimdLevelScalar
+    );
+    for (int level = SimdLevelPortable; level < SIMD_NUM_LEVELS; ++level) {
+        ControlByteCountKernel kernel = getControlByteCountKernel(
+            (SimdLevel) level
+        );
+        if (!kernel) {
+            continue;
+        }
+        for (size_t offset = 0; offset < 64 && offset < maxSize; ++offset) {
+            for (size_t size = 0; offset + size <= maxSize; ++size) {
+                TEST_ASSERT_EQUAL_INT(
+                    reference(buffer + offset, size),
+                    kernel(buffer + offset, size)
+                );
+            }
+        }
+    }
+}
+
+/**
+ * Asserts that all supported variants of the UTF-8 count kernel agree with
+ * the scalar reference, in both the count and the number of consumed bytes,
+ * for all offsets and sizes of the given buffer up to the specified maximum
+ * size. Sizes are incremented by the specified step.
+ */
+static void assertUTF8CountKernelsAgree(
+    const char* buffer,
+    size_t maxSize,
+    size_t sizeStep
+) {
+    UTF8CountKernel reference = getUTF8CountKernel(SimdLevelScalar);
+    for (int level = SimdLevelPortable; level < SIMD_NUM_LEVELS; ++level) {
+        UTF8CountKernel kernel = getUTF8CountKernel((SimdLevel) level);
+        if (!kernel) {
+            continue;
+        }
+        for (size_t offset = 0; offset < 64 && offset < maxSize; ++offset) {
+            for (size_t size = 0; offset + size <= maxSize; size += sizeStep) {
+                size_t expectedCount = 0;
+                size_t actualCount = 0;
+                TEST_ASSERT_EQUAL_INT(
+                    reference(buffer + offset, size, &expectedCount),
+                    kernel(buffer + offset, size, &actualCount)
+                );
+                TEST_ASSERT_EQUAL_INT(expectedCount, actualCount);
+            }
+        }
+    }
+}
+
+/**
+ * Fills the given buffer with the UTF-8 encoding of random code points with
+ * one to four bytes. Returns the number of encoded characters.
+ */
+static size_t fillRandomUTF8(char* buffer, size_t size, uint32_t* state) {
+    size_t offset = 0;
+    size_t count = 0;
+    while (offset < size) {
+        const uint32_t random = nextRandom(state);
+        size_t length = 1 + ((random >> 8) % 4);
+        if (length > size - offset) {
+            length = 1;
+        }
+        const unsigned char payload = (unsigned char) (random & 0x3F);
+        switch (length) {
+        case 1:
+            buffer[offset] = (char) (0x20 + (payload & 0x3F));
+            break;
+        case 2:
+            buffer[offset] = (char) (0xC2 + (payload & 0x1D));
+            break;
+        case 3:
+            buffer[offset] = (char) (0xE1 + (payload & 0x0B));
+            break;
+        default:
+            buffer[offset] = (char) (0xF1 + (payload & 0x02));
+            break;
+        }
+        for (size_t i = 1; i < length; ++i) {
+            buffer[offset + i] = (char) (0x80 | ((random >> (i * 6)) & 0x3F));
+        }
+        offset += length;
+        ++count;
+    }
+    return count;
+}
+
+/**
+ * Asserts that all supported variants of the word count kernel agree with
+ * the scalar reference, in both the count and the in-word state, for all
+ * offsets and sizes of the given buffer up to the specified maximum size
+ * and for both initial in-word states. Sizes are incremented by the
+ * specified step.
+ */
+static void assertWordCountKernelsAgree(
+    const char* buffer,
+    size_t maxSize,
+    size_t sizeStep
+) {
+    WordCountKernel reference = getWordCountKernel(SimdLevelScalar);
+    for (int level = SimdLevelPortable; level < SIMD_NUM_LEVELS; ++level) {
+        WordCountKernel kernel = getWordCountKernel((SimdLevel) level);
+        if (!kernel) {
+            continue;
+        }
+        for (size_t offset = 0; offset < 64 && offset < maxSize; ++offset) {
+            for (size_t size = 0; offset + size <= maxSize; size += sizeStep) {
+                for (int state = 0; state < 2; ++state) {
+                    bool expectedInWord = state != 0;
+                    bool actualInWord = state != 0;
+                    TEST_ASSERT_EQUAL_INT(
+                        reference(buffer + offset, size, &expectedInWord),
+                        kernel(buffer + offset, size, &actualInWord)
+                    );
+                    TEST_ASSERT_EQUAL(expectedInWord, actualInWord);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Writes the given code units to the given buffer in the specified
+ * byte order.
+ */
+static void encodeUTF16(
+    char* buffer,
+    const uint16_t* units,
+    size_t numUnits,
+    bool isLittleEndian
+) {
+    for (size_t i = 0; i < numUnits; ++i) {
+        const char low = (char) (units[i] & 0xFF);
+        const char high = (char) (units[i] >> 8);
+        buffer[2 * i] = isLittleEndian ? low : high;
+        buffer[(2 * i) + 1] = isLittleEndian ? high : low;
+    }
+}
+
+/**
+ * Fills the given buffer with the specified number of code units which are
+ * randomly chosen from the given alphabet of code units, encoded in the
+ * specified byte order.
+ */
+static void fillRandomUTF16(
+    char* buffer,
+    size_t numUnits,
+    const uint16_t* alphabet,
+    size_t alphabetSize,
+    bool isLittleEndian,
+    uint32_t* state
+) {
+    for (size_t i = 0; i < numUnits; ++i) {
+        const uint16_t unit = alphabet[nextRandom(state) % alphabetSize];
+        encodeUTF16(buffer + (2 * i), &unit, 1, isLittleEndian);
+    }
+}
+
+/**
+ * Asserts that all supported variants of the UTF-16 kernels agree with the
+ * scalar references for all offsets and all numbers of code units of the
+ * given buffer up to the specified maximum number of code units. Numbers of
+ * code units are incremented by the specified step.
+ */
+static void assertUTF16KernelsAgree(
+    const char* buffer,
+    size_t maxUnits,
+    size_t unitStep,
+    bool isLittleEndian
+) {
+    const char nlByte0 = isLittleEndian ? '\n' : '\0';
+    const char nlByte1 = isLittleEndian ? '\0' : '\n';
+    CodeUnitCountKernel referenceUnits = getCodeUnitCountKernel(
+        SimdLevelScalar
+    );
+    UTF16WordCountKernel referenceWords = getUTF16WordCountKernel(
+        SimdLevelScalar,
+        isLittleEndian
+    );
+    UTF16CountKernel referenceCharacters = getUTF16CountKernel(
+        SimdLevelScalar,
+        isLittleEndian
+    );
+    for (int level = SimdLevelPortable; level < SIMD_NUM_LEVELS; ++level) {
+        CodeUnitCountKernel units = getCodeUnitCountKernel((SimdLevel) level);
+        UTF16WordCountKernel words = getUTF16WordCountKernel(
+            (SimdLevel) level,
+            isLittleEndian
+        );
+        UTF16CountKernel characters = getUTF16CountKernel(
+            (SimdLevel) level,
+            isLittleEndian
+        );
+        if (!units) {
+            TEST_ASSERT_NULL(words);
+            TEST_ASSERT_NULL(characters);
+            continue;
+        }
+        for (size_t offset = 0; offset < 64 && offset < maxUnits; ++offset) {
+            const char* text = buffer + offset;
+            const size_t available = maxUnits - ((offset + 1) / 2);
+            for (size_t num = 0; num <= available; num += unitStep) {
+                TEST_ASSERT_EQUAL_INT(
+                    referenceUnits(text, num, nlByte0, nlByte1),
+                    units(text, num, nlByte0, nlByte1)
+                );
+                TEST_ASSERT_EQUAL_INT(
+                    referenceCharacters(text, num),
+                    characters(text, num)
+                );
+                for (int state = 0; state < 2; ++state) {
+                    bool expectedInWord = state != 0;
+                    bool actualInWord = state != 0;
+                    TEST_ASSERT_EQUAL_INT(
+                        referenceWords(text, num, &expectedInWord),
+                        words(text, num, &actualInWord)
+                    );
+                    TEST_ASSERT_EQUAL(expectedInWord, actualInWord);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Asserts that all supported variants of the UTF-16 transcode kernel agree
+ * with the scalar reference for all offsets and all numbers of code units
+ * of the given buffer up to the specified maximum number of code units.
+ * Numbers of code units are incremented by the specified step. The
+ * transcoded texts are only compared if the transcoding succeeds.
+ */
+static void assertUTF16TranscodeKernelsAgree(
+    const char* buffer,
+    size_t maxUnits,
+    size_t unitStep,
+    bool isLittleEndian
+) {
+    char* expected = malloc((3 * maxUnits) + 1);
+    char* actual = malloc((3 * maxUnits) + 1);
+    TEST_ASSERT_NOT_NULL(expected);
+    TEST_ASSERT_NOT_NULL(actual);
+    UTF16TranscodeKernel reference = getUTF16TranscodeKernel(
+        SimdLevelScalar,
+        isLittleEndian
+    );
+    for (int level = SimdLevelPortable; level < SIMD_NUM_LEVELS; ++level) {
+        UTF16TranscodeKernel kernel = getUTF16TranscodeKernel(
+            (SimdLevel) level,
+            isLittleEndian
+        );
+        if (!kernel) {
+            continue;
+        }
+        for (size_t offset = 0; offset < 64 && offset < maxUnits; ++offset) {
+            const char* text = buffer + offset;
+            const size_t available = maxUnits - ((offset + 1) / 2);
+            for (size_t num = 0; num <= available; num += unitStep) {
+                size_t expectedSize = 0;
+                size_t actualSize = 0;
+                const bool isExpected = reference(
+                    text,
+                    num,
+                    expected,
+                    &expectedSize
+                );
+                TEST_ASSERT_EQUAL(
+                    isExpected,
+                    kernel(text, num, actual, &actualSize)
+                );
+                if (isExpected) {
+                    TEST_ASSERT_EQUAL_INT(expectedSize, actualSize);
+                    TEST_ASSERT_EQUAL_MEMORY(expected, actual, actualSize);
+                }
+            }
+        }
+    }
+    free(expected);
+    free(actual);
+}
+
+void testSimdLevelIsDetected(void) {
+    const SimdLevel level = getSimdLevel();
+    TEST_ASSERT_TRUE(level >= SimdLevelPortable);
+    TEST_ASSERT_TRUE((int) level < SIMD_NUM_LEVELS);
+    TEST_ASSERT_EQUAL_INT(level, getSimdLevel());
+}
+
+void testByteCountKernelsAreAvailableUpToDetectedLevel(void) {
+    const SimdLevel detected = getSimdLevel();
+    for (int level = SimdLevelScalar; level < SIMD_NUM_LEVELS; ++level) {
+        ByteCountKernel kernel = getByteCountKernel((SimdLevel) level);
+        if (level <= (int) detected) {
+            TEST_ASSERT_NOT_NULL(kernel);
+        } else {
+            TEST_ASSERT_NULL(kernel);
+        }
+    }
+}
+
+void testByteCountKernelsCountSimpleText(void) {
+    const char* text = "int main(void) {\n    return 0;\n}\n";
+    const size_t size = strlen(text);
+    for (int level = SimdLevelScalar; level < SIMD_NUM_LEVELS; ++level) {
+        ByteCountKernel kernel = getByteCountKernel((SimdLevel) level);
+        if (kernel) {
+            TEST_ASSERT_EQUAL_INT(3, kernel(text, size, '\n'));
+            TEST_ASSERT_EQUAL_INT(0, kernel(text, size, '\r'));
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(3, countByte(text, size, '\n'));
+}
+
+void testByteCountKernelsAgreeOnRandomText(void) {
+    enum { BUFFER_SIZE = 400 };
+    const char alphabet[] = "\n\r\t aZ{}";
+    char buffer[BUFFER_SIZE];
+    uint32_t state = 0x2545F491;
+    for (int round = 0; round < 4; ++round) {
+        fillRandom(buffer, BUFFER_SIZE, alphabet, 8, &state);
+        assertByteCountKernelsAgree(buffer, BUFFER_SIZE, '\n');
+    }
+}
+
+void testByteCountKernelsAgreeOnAdversarialBytes(void) {
+    enum { BUFFER_SIZE = 300 };
+    // Bytes that differ from the searched byte only in a single bit,
+    // including bytes with the sign bit set
+    const char alphabet[] = {
+        '\n', (char) 0x8A, 0x0B, 0x08, 0x1A, 0x4A, 0x00, (char) 0xFF
+    };
+    char buffer[BUFFER_SIZE];
+    uint32_t state = 0x9E3779B9;
+    fillRandom(buffer, BUFFER_SIZE, alphabet, sizeof(alphabet), &state);
+    assertByteCountKernelsAgree(buffer, BUFFER_SIZE, '\n');
+    assertByteCountKernelsAgree(buffer, BUFFER_SIZE, (char) 0x8A);
+    assertByteCountKernelsAgree(buffer, BUFFER_SIZE, (char) 0xFF);
+    assertByteCountKernelsAgree(buffer, BUFFER_SIZE, '\0');
+}
+
+void testByteCountKernelsAgreeOnUniformText(void) {
+    enum { BUFFER_SIZE = 200 };
+    char buffer[BUFFER_SIZE];
+    memset(buffer, '\n', BUFFER_SIZE);
+    assertByteCountKernelsAgree(buffer, BUFFER_SIZE, '\n');
+    memset(buffer, 'x', BUFFER_SIZE);
+    assertByteCountKernelsAgree(buffer, BUFFER_SIZE, '\n');
+}
+
+void testByteCountKernelsCountLargeTextWithoutOverflow(void) {
+    // Exceeds the number of vectors that can be summed up in 8-bit lanes
+    const size_t size = (1024UL * 1024UL) + 13;
+    char* buffer = malloc(size);
+    TEST_ASSERT_NOT_NULL(buffer);
+    memset(buffer, '\n', size);
+    for (int level = SimdLevelScalar; level < SIMD_NUM_LEVELS; ++level) {
+        ByteCountKernel kernel = getByteCountKernel((SimdLevel) level);
+        if (kernel) {
+            TEST_ASSERT_EQUAL_INT(size, kernel(buffer, size, '\n'));
+        }
+    }
+    uint32_t state = 0x12345678;
+    fillRandom(buffer, size, "\nab", 3, &state);
+    ByteCountKernel reference = getByteCountKernel(SimdLevelScalar);
+    const size_t expected = reference(buffer, size, '\n');
+    for (int level = SimdLevelPortable; level < SIMD_NUM_LEVELS; ++level) {
+        ByteCountKernel kernel = getByteCountKernel((SimdLevel) level);
+        if (kernel) {
+            TEST_ASSERT_EQUAL_INT(expected, kernel(buffer, size, '\n'));
+        }
+    }
+    free(buffer);
+}
+
+void testControlByteCountKernelsClassifyAllBytes(void) {
+    // Each byte is placed at every position of a block of regular text
+    char buffer[128];
+    for (int byte = 0; byte < 256; ++byte) {
+        const bool isControl = (
+            byte < 0x20
+            && !isspace(byte)
+            && byte != 0x1B
+        );
+        for (size_t position = 0; position < sizeof(buffer); ++position) {
+            memset(buffer, 'a', sizeof(buffer));
+            buffer[position] = (char) byte;
+            for (int level = 0; level < SIMD_NUM_LEVELS; ++level) {
+                ControlByteCountKernel kernel = getControlByteCountKernel(
+                    (SimdLevel) level
+                );
+                if (kernel) {
+                    TEST_ASSERT_EQUAL_INT(
+                        isControl ? 1 : 0,
+                        kernel(buffer, sizeof(buffer))
+                    );
+                }
+            }
+        }
+    }
+}
+
+void testControlByteCountKernelsAgreeOnAdversarialBytes(void) {
+    enum { BUFFER_SIZE = 300 };
+    // Bytes at the bounds of the excluded ranges and with the sign bit set
+    const char alphabet[] = {
+        0x00, 0x08, '\t', '\r', 0x0E, 0x1B, 0x1F, ' ',
+        (char) 0x80, (char) 0x89, (char) 0x9F, (char) 0xFF
+    };
+    char buffer[BUFFER_SIZE];
+    uint32_t state = 0x7F4A7C15;
+    for (int round = 0; round < 4; ++round) {
+        fillRandom(buffer, BUFFER_SIZE, alphabet, sizeof(alphabet), &state);
+        assertControlByteCountKernelsAgree(buffer, BUFFER_SIZE);
+    }
+}
+
+void testControlByteCountKernelsCountLargeTextWithoutOverflow(void) {
+    // Exceeds the number of vectors that can be summed up in 8-bit lanes
+    const size_t size = (1024UL * 1024UL) + 13;
+    char* buffer = malloc(size);
+    TEST_ASSERT_NOT_NULL(buffer);
+    memset(buffer, 0x01, size);
+    for (int level = SimdLevelScalar; level < SIMD_NUM_LEVELS; ++level) {
+        ControlByteCountKernel kernel = getControlByteCountKernel(
+            (SimdLevel) level
+        );
+        if (kernel) {
+            TEST_ASSERT_EQUAL_INT(size, kernel(buffer, size));
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(size, countControlBytes(buffer, size));
+    free(buffer);
+}
+
+void testUTF8CountKernelsCountSimpleText(void) {
+    // "Grüße, 世界 😀" with one, two, three and four byte sequences
+    const char* text = (
+        "Gr\xC3\xBC\xC3\x9F" "e, \xE4\xB8\x96\xE7\x95\x8C \xF0\x9F\x98\x80"
+    );
+    const size_t size = strlen(text);
+    for (int level = SimdLevelScalar; level < SIMD_NUM_LEVELS; ++level) {
+        UTF8CountKernel kernel = getUTF8CountKernel((SimdLevel) level);
+        if (kernel) {
+            size_t count = 0;
+            TEST_ASSERT_EQUAL_INT(size, kernel(text, size, &count));
+            TEST_ASSERT_EQUAL_INT(11, count);
+            count = 0;
+            // The last sequence is truncated
+            TEST_ASSERT_EQUAL_INT(size - 4, kernel(text, size - 1, &count));
+            TEST_ASSERT_EQUAL_INT(10, count);
+        }
+    }
+    size_t count = 0;
+    TEST_ASSERT_EQUAL_INT(size, countUTF8Sequences(text, size, &count));
+    TEST_ASSERT_EQUAL_INT(11, count);
+}
+
+void testUTF8CountKernelsAgreeOnValidText(void) {
+    enum { BUFFER_SIZE = 700 };
+    char buffer[BUFFER_SIZE];
+    uint32_t state = 0x5EED1234;
+    const size_t expected = fillRandomUTF8(buffer, BUFFER_SIZE, &state);
+    size_t count = 0;
+    UTF8CountKernel kernel = getUTF8CountKernel(getSimdLevel());
+    TEST_ASSERT_EQUAL_INT(BUFFER_SIZE, kernel(buffer, BUFFER_SIZE, &count));
+    TEST_ASSERT_EQUAL_INT(expected, count);
+    assertUTF8CountKernelsAgree(buffer, BUFFER_SIZE, 1);
+}
+
+void testUTF8CountKernelsAgreeOnMalformedText(void) {
+    enum { BUFFER_SIZE = 700 };
+    char buffer[BUFFER_SIZE];
+    uint32_t state = 0xC0FFEE11;
+    fillRandomUTF8(buffer, BUFFER_SIZE, &state);
+    // Stray continuation bytes, lead bytes without continuation bytes
+    // and bytes which are never part of UTF-8 text
+    const char malformed[] = {
+        (char) 0x80, (char) 0xBF, (char) 0xC3, (char) 0xE2,
+        (char) 0xF0, (char) 0xF7, (char) 0xF8, (char) 0xFF
+    };
+    for (size_t i = 0; i < 12; ++i) {
+        buffer[nextRandom(&state) % BUFFER_SIZE] = malformed[i % 8];
+    }
+    assertUTF8CountKernelsAgree(buffer, BUFFER_SIZE, 1);
+}
+
+void testUTF8CountKernelsAgreeOnAdversarialBytes(void) {
+    enum { BUFFER_SIZE = 400 };
+    const char alphabet[] = {
+        'a', '\n', (char) 0x80, (char) 0xBF, (char) 0xC3, (char) 0xDF,
+        (char) 0xE2, (char) 0xEF, (char) 0xF0, (char) 0xF7, (char) 0xF8,
+        (char) 0xFF
+    };
+    char buffer[BUFFER_SIZE];
+    uint32_t state = 0x0BADF00D;
+    fillRandom(buffer, BUFFER_SIZE, alphabet, sizeof(alphabet), &state);
+    assertUTF8CountKernelsAgree(buffer, BUFFER_SIZE, 1);
+}
+
+void testUTF8CountKernelsAgreeOnBlocksWithHighestLeadByte(void) {
+    enum { BUFFER_SIZE = 256 };
+    char buffer[BUFFER_SIZE];
+    // Full blocks of well-formed sequences with the highest four-byte lead
+    for (size_t i = 0; i < BUFFER_SIZE; ++i) {
+        buffer[i] = (char) ((i % 4 == 0) ? 0xF7 : 0xBF);
+    }
+    UTF8CountKernel kernel = getUTF8CountKernel(getSimdLevel());
+    size_t count = 0;
+    TEST_ASSERT_EQUAL_INT(BUFFER_SIZE, kernel(buffer, BUFFER_SIZE, &count));
+    TEST_ASSERT_EQUAL_INT(BUFFER_SIZE / 4, count);
+    assertUTF8CountKernelsAgree(buffer, BUFFER_SIZE, 1);
+    // Sequences which span the boundaries of blocks
+    for (size_t i = 0; i < BUFFER_SIZE; ++i) {
+        buffer[i] = (char) ((i % 5 == 0) ? 'a' : ((i % 5 == 1) ? 0xF7 : 0x80));
+    }
+    assertUTF8CountKernelsAgree(buffer, BUFFER_SIZE, 1);
+    // Lead bytes without continuation bytes
+    for (size_t i = 0; i < BUFFER_SIZE; ++i) {
+        buffer[i] = (char) ((i % 4 == 0) ? 0xF7 : 'A');
+    }
+    assertUTF8CountKernelsAgree(buffer, BUFFER_SIZE, 1);
+}
+
+void testUTF8CountKernelsAgreeOnLargeText(void) {
+    const size_t size = (256UL * 1024UL) + 7;
+    char* buffer = malloc(size);
+    TEST_ASSERT_NOT_NULL(buffer);
+    uint32_t state = 0xFACEB00C;
+    fillRandomUTF8(buffer, size, &state);
+    // Mostly well-formed text with a few malformed blocks
+    for (size_t i = 0; i < size; i += 10000) {
+        buffer[i] = (char) 0x80;
+    }
+    assertUTF8CountKernelsAgree(buffer, size, 65521);
+    free(buffer);
+}
+
+void testWordCountKernelsCountSimpleText(void) {
+    const char* text = "  one\ttwo\n\nthree\v\f\rfour\0five six ";
+    const size_t size = 33;
+    for (int level = SimdLevelScalar; level < SIMD_NUM_LEVELS; ++level) {
+        WordCountKernel kernel = getWordCountKernel((SimdLevel) level);
+        if (kernel) {
+            bool inWord = false;
+            TEST_ASSERT_EQUAL_INT(5, kernel(text, size, &inWord));
+            TEST_ASSERT_FALSE(inWord);
+            inWord = true;
+            TEST_ASSERT_EQUAL_INT(0, kernel(text + 2, 1, &inWord));
+            TEST_ASSERT_TRUE(inWord);
+        }
+    }
+    bool inWord = false;
+    TEST_ASSERT_EQUAL_INT(5, countWordStarts(text, size, &inWord));
+}
+
+void testWordCountKernelsClassifyAllBytesLikeCLocale(void) {
+    // Each byte is placed between two words at every position of a block
+    char buffer[128];
+    for (int byte = 0; byte < 256; ++byte) {
+        const size_t expected = isspace(byte) ? 2 : 1;
+        for (size_t position = 1; position < 127; ++position) {
+            memset(buffer, ' ', sizeof(buffer));
+            buffer[position - 1] = 'a';
+            buffer[position] = (char) byte;
+            buffer[position + 1] = 'b';
+            for (int level = 0; level < SIMD_NUM_LEVELS; ++level) {
+                WordCountKernel kernel = getWordCountKernel(
+                    (SimdLevel) level
+                );
+                if (kernel) {
+                    bool inWord = false;
+                    TEST_ASSERT_EQUAL_INT(
+                        expected,
+                        kernel(buffer, sizeof(buffer), &inWord)
+                    );
+                }
+            }
+        }
+    }
+}
+
+void testWordCountKernelsAgreeOnAdversarialBytes(void) {
+    enum { BUFFER_SIZE = 400 };
+    const char alphabet[] = {
+        'a', 'Z', ' ', '\t', '\n', '\v', '\f', '\r', '\0', (char) 0x08,
+        (char) 0x0E, (char) 0x85, (char) 0xA0, (char) 0x89, (char) 0xFF
+    };
+    char buffer[BUFFER_SIZE];
+    uint32_t state = 0x13572468;
+    fillRandom(buffer, BUFFER_SIZE, alphabet, sizeof(alphabet), &state);
+    assertWordCountKernelsAgree(buffer, BUFFER_SIZE, 1);
+}
+
+void testWordCountKernelsAgreeOnSparseWhiteSpace(void) {
+    enum { BUFFER_SIZE = 600 };
+    char buffer[BUFFER_SIZE];
+    uint32_t state = 0x2468ACE0;
+    // Words spanning several blocks
+    fillRandom(buffer, BUFFER_SIZE, "abcdefghijklmnopqrstuvwxyz ", 27, &state);
+    for (size_t i = 0; i < BUFFER_SIZE; i += 97) {
+        buffer[i] = '\0';
+    }
+    assertWordCountKernelsAgree(buffer, BUFFER_SIZE, 1);
+}
+
+void testWordCountKernelsAgreeOnLargeText(void) {
+    const size_t size = (256UL * 1024UL) + 13;
+    char* buffer = malloc(size);
+    TEST_ASSERT_NOT_NULL(buffer);
+    uint32_t state = 0x9E3779B9;
+    fillRandom(buffer, size, "int x = 0;\n\t\0\xC3\xA9", 15, &state);
+    assertWordCountKernelsAgree(buffer, size, 65519);
+    free(buffer);
+}
+
+void testUTF16KernelsCountSimpleText(void) {
+    // BOM, "a b\n", surrogate pair, stray low surrogate, high surrogate,
+    // 'c', swapped BOM, a character whose bytes are a space and a newline
+    const uint16_t units[] = {
+        0xFEFF, 'a', ' ', 'b', '\n', 0xD83D, 0xDE00, 0xDC00, 0xD800, 'c',
+        0xFFFE, 0x0A20
+    };
+    const size_t numUnits = sizeof(units) / sizeof(uint16_t);
+    char text[sizeof(units)];
+    for (int order = 0; order < 2; ++order) {
+        const bool isLittleEndian = order != 0;
+        encodeUTF16(text, units, numUnits, isLittleEndian);
+        TEST_ASSERT_EQUAL_INT(
+            1,
+            countCodeUnit(
+                text,
+                numUnits,
+                isLittleEndian ? '\n' : '\0',
+                isLittleEndian ? '\0' : '\n'
+            )
+        );
+        bool inWord = false;
+        TEST_ASSERT_EQUAL_INT(
+            3,
+            countUTF16WordStarts(text, numUnits, &inWord, isLittleEndian)
+        );
+        TEST_ASSERT_TRUE(inWord);
+        TEST_ASSERT_EQUAL_INT(
+            7,
+            countUTF16Characters(text, numUnits, isLittleEndian)
+        );
+    }
+}
+
+void testUTF16KernelsAgreeOnAdversarialCodeUnits(void) {
+    enum { NUM_UNITS = 300 };
+    const uint16_t alphabet[] = {
+        0x0000, 0x0009, 0x000A, 0x000D, 0x0020, 0x0041, 0x0A20, 0x0A00,
+        0x2000, 0x3000, 0x0D0A, 0xD800, 0xDBFF, 0xDC00, 0xDFFF, 0xFEFF,
+        0xFFFE, 0xFF20, 0x2020
+    };
+    const size_t alphabetSize = sizeof(alphabet) / sizeof(uint16_t);
+    char buffer[2 * NUM_UNITS];
+    uint32_t state = 0x7F4A7C15;
+    for (int order = 0; order < 2; ++order) {
+        const bool isLittleEndian = order != 0;
+        fillRandomUTF16(
+            buffer,
+            NUM_UNITS,
+            alphabet,
+            alphabetSize,
+            isLittleEndian,
+            &state
+        );
+        assertUTF16KernelsAgree(buffer, NUM_UNITS, 1, isLittleEndian);
+    }
+}
+
+void testUTF16KernelsAgreeOnTextWithSparseSpecialUnits(void) {
+    enum { NUM_UNITS = 400 };
+    const uint16_t alphabet[] = {
+        'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 0x00E9, 0x4E16, ' ',
+        '\n', 'x', 'y', 'z'
+    };
+    char buffer[2 * NUM_UNITS];
+    uint32_t state = 0x31415926;
+    for (int order = 0; order < 2; ++order) {
+        const bool isLittleEndian = order != 0;
+        fillRandomUTF16(
+            buffer,
+            NUM_UNITS,
+            alphabet,
+            sizeof(alphabet) / sizeof(uint16_t),
+            isLittleEndian,
+            &state
+        );
+        // Surrogate pairs across blocks and a stray byte order mark
+        const uint16_t pair[] = { 0xD83D, 0xDE00 };
+        for (size_t i = 31; i + 1 < NUM_UNITS; i += 32) {
+            encodeUTF16(buffer + (2 * i), pair, 2, isLittleEndian);
+        }
+        const uint16_t bom = 0xFEFF;
+        encodeUTF16(buffer + 202, &bom, 1, isLittleEndian);
+        assertUTF16KernelsAgree(buffer, NUM_UNITS, 1, isLittleEndian);
+    }
+}
+
+void testUTF16KernelsAgreeOnLargeText(void) {
+    const size_t numUnits = (128UL * 1024UL) + 5;
+    char* buffer = malloc(2 * numUnits);
+    TEST_ASSERT_NOT_NULL(buffer);
+    const uint16_t alphabet[] = {
+        'i', 'n', 't', ' ', '\n', 0x00FC, 0xD83D, 0xDE00, 0xFEFF, 0x0000
+    };
+    uint32_t state = 0xDEADBEEF;
+    for (int order = 0; order < 2; ++order) {
+        const bool isLittleEndian = order != 0;
+        fillRandomUTF16(buffer, numUnits, alphabet, 10, isLittleEndian, &state);
+        assertUTF16KernelsAgree(buffer, numUnits, 32749, isLittleEndian);
+    }
+    free(buffer);
+}
+
+// NOLINTEND(readability-magic-numbers)
+
+void testUTF16TranscodeKernelsTranscodeSimpleText(void) {
+    // 'a', two-byte, three-byte and four-byte sequences, newline
+    const uint16_t units[] = { 'a', 0x00E9, 0x20AC, 0xD83D, 0xDE00, '\n' };
+    const size_t numUnits = sizeof(units) / sizeof(uint16_t);
+    const char* expected = "a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80\n";
+    char text[sizeof(units)];
+    char out[3 * sizeof(units)];
+    for (int order = 0; order < 2; ++order) {
+        const bool isLittleEndian = order != 0;
+        encodeUTF16(text, units, numUnits, isLittleEndian);
+        size_t size = 0;
+        TEST_ASSERT_TRUE(
+            transcodeUTF16(text, numUnits, out, &size, isLittleEndian)
+        );
+        TEST_ASSERT_EQUAL_INT(strlen(expected), size);
+        TEST_ASSERT_EQUAL_MEMORY(expected, out, size);
+    }
+}
+
+void testUTF16TranscodeKernelsRejectUnitsWithoutUTF8Equivalent(void) {
+    // Stray high surrogate, stray low surrogate, trailing high surrogate,
+    // byte order mark and swapped byte order mark
+    const uint16_t rejected[][2] = {
+        { 0xD800, 'a' },
+        { 'a', 0xDC00 },
+        { 'a', 0xD83D },
+        { 'a', 0xFEFF },
+        { 0xFFFE, 'a' }
+    };
+    const size_t numRejected = sizeof(rejected) / sizeof(rejected[0]);
+    char text[4];
+    char out[6];
+    for (int order = 0; order < 2; ++order) {
+        const bool isLittleEndian = order != 0;
+        for (size_t i = 0; i < numRejected; ++i) {
+            encodeUTF16(text, rejected[i], 2, isLittleEndian);
+            for (int level = 0; level < SIMD_NUM_LEVELS; ++level) {
+                UTF16TranscodeKernel kernel = getUTF16TranscodeKernel(
+                    (SimdLevel) level,
+                    isLittleEndian
+                );
+                size_t size = 0;
+                if (kernel) {
+                    TEST_ASSERT_FALSE(kernel(text, 2, out, &size));
+                }
+            }
+        }
+    }
+}
+
+void testUTF16TranscodeKernelsAgreeOnAdversarialCodeUnits(void) {
+    enum { NUM_UNITS = 300 };
+    const uint16_t alphabet[] = {
+        0x0000, 0x0041, 0x007F, 0x0080, 0x00FF, 0x0100, 0x07FF, 0x0800,
+        0x0A20, 0xD7FF, 0xE000, 0xFFFF, 0xFF80, 0x8000, 0x0D0A, 0x2020,
+        0xD800, 0xDBFF, 0xDC00, 0xDFFF, 0xFEFF, 0xFFFE
+    };
+    const size_t alphabetSize = sizeof(alphabet) / sizeof(uint16_t);
+    char buffer[2 * NUM_UNITS];
+    uint32_t state = 0x2545F491;
+    for (int order = 0; order < 2; ++order) {
+        const bool isLittleEndian = order != 0;
+        // Rejected code units are only in the second half of the alphabet
+        for (size_t size = alphabetSize - 6; size <= alphabetSize; ++size) {
+            fillRandomUTF16(
+                buffer,
+                NUM_UNITS,
+                alphabet,
+                size,
+                isLittleEndian,
+                &state
+            );
+            assertUTF16TranscodeKernelsAgree(
+                buffer,
+                NUM_UNITS,
+                1,
+                isLittleEndian
+            );
+        }
+    }
+}
+
+void testUTF16TranscodeKernelsAgreeOnTextWithSparseSpecialUnits(void) {
+    enum { NUM_UNITS = 400 };
+    const uint16_t alphabet[] = {
+        'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', ' ', '\n',
+        'x', 'y', 'z'
+    };
+    char buffer[2 * NUM_UNITS];
+    uint32_t state = 0x27182818;
+    for (int order = 0; order < 2; ++order) {
+        const bool isLittleEndian = order != 0;
+        fillRandomUTF16(
+            buffer,
+            NUM_UNITS,
+            alphabet,
+            sizeof(alphabet) / sizeof(uint16_t),
+            isLittleEndian,
+            &state
+        );
+        // Surrogate pairs across blocks and sparse non-ASCII characters
+        const uint16_t pair[] = { 0xD83D, 0xDE00 };
+        for (size_t i = 15; i + 1 < NUM_UNITS; i += 48) {
+            encodeUTF16(buffer + (2 * i), pair, 2, isLittleEndian);
+        }
+        const uint16_t special[] = { 0x00E9, 0x4E16 };
+        encodeUTF16(buffer + 202, special, 2, isLittleEndian);
+        assertUTF16TranscodeKernelsAgree(
+            buffer,
+            NUM_UNITS,
+            1,
+            isLittleEndian
+        );
+    }
+}
+
+void testUTF16TranscodeKernelsAgreeOnLargeText(void) {
+    const size_t numUnits = (128UL * 1024UL) + 5;
+    char* buffer = malloc(2 * numUnits);
+    TEST_ASSERT_NOT_NULL(buffer);
+    const uint16_t alphabet[] = {
+        'i', 'n', 't', ' ', '\n', 'a', 'b', '(', ')', ';', 0x00FC, 0x4E16
+    };
+    uint32_t state = 0xC0FFEE11;
+    for (int order = 0; order < 2; ++order) {
+        const bool isLittleEndian = order != 0;
+        fillRandomUTF16(buffer, numUnits, alphabet, 10, isLittleEndian, &state);
+        // Non-ASCII code units only in the second half of the text
+        fillRandomUTF16(
+            buffer + (2 * (numUnits / 2)),
+            numUnits - (numUnits / 2),
+            alphabet,
+            12,
+            isLittleEndian,
+            &state
+        );
+        assertUTF16TranscodeKernelsAgree(
+            buffer,
+            numUnits,
+            32749,
+            isLittleEndian
+        );
+    }
+    free(buffer);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(testSimdLevelIsDetected);
+    RUN_TEST(testByteCountKernelsAreAvailableUpToDetectedLevel);
+    RUN_TEST(testByteCountKernelsCountSimpleText);
+    RUN_TEST(testByteCountKernelsAgreeOnRandomText);
+    RUN_TEST(testByteCountKernelsAgreeOnAdversarialBytes);
+    RUN_TEST(testByteCountKernelsAgreeOnUniformText);
+    RUN_TEST(testByteCountKernelsCountLargeTextWithoutOverflow);
+    RUN_TEST(testControlByteCountKernelsClassifyAllBytes);
+    RUN_TEST(testControlByteCountKernelsAgreeOnAdversarialBytes);
+    RUN_TEST(testControlByteCountKernelsCountLargeTextWithoutOverflow);
+    RUN_TEST(testUTF8CountKernelsCountSimpleText);
+    RUN_TEST(testUTF8CountKernelsAgreeOnValidText);
+    RUN_TEST(testUTF8CountKernelsAgreeOnMalformedText);
+    RUN_TEST(testUTF8CountKernelsAgreeOnAdversarialBytes);
+    RUN_TEST(testUTF8CountKernelsAgreeOnBlocksWithHighestLeadByte);
+    RUN_TEST(testUTF8CountKernelsAgreeOnLargeText);
+    RUN_TEST(testWordCountKernelsCountSimpleText);
+    RUN_TEST(testWordCountKernelsClassifyAllBytesLikeCLocale);
+    RUN_TEST(testWordCountKernelsAgreeOnAdversarialBytes);
+    RUN_TEST(testWordCountKernelsAgreeOnSparseWhiteSpace);
+    RUN_TEST(testWordCountKernelsAgreeOnLargeText);
+    RUN_TEST(testUTF16KernelsCountSimpleText);
+    RUN_TEST(testUTF16KernelsAgreeOnAdversarialCodeUnits);
+    RUN_TEST(testUTF16KernelsAgreeOnTextWithSparseSpecialUnits);
+    RUN_TEST(testUTF16KernelsAgreeOnLargeText);
+    RUN_TEST(testUTF16TranscodeKernelsTranscodeSimpleText);
+    RUN_TEST(testUTF16TranscodeKernelsRejectUnitsWithoutUTF8Equivalent);
+    RUN_TEST(testUTF16TranscodeKernelsAgreeOnAdversarialCodeUnits);
+    RUN_TEST(testUTF16TranscodeKernelsAgreeOnTextWithSparseSpecialUnits);
+    RUN_TEST(testUTF16TranscodeKernelsAgreeOnLargeText);
+    return UNITY_END();
+}
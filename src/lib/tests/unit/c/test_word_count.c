@@ -39,6 +39,37 @@ void testWordCountIsCorrect(void) {
     TEST_ASSERT_EQUAL_INT(3, result.count);
 }
 
+void testWordCountIgnoresNonASCIIWhiteSpace(void) {
+    // No-break space and next line in Latin-1, a word in every locale
+    char* text = "one\xA0two\x85three four";
+    RcnSourceText source = {
+        .text = text,
+        .size = strlen(text)
+    };
+    RcnCountResult result = rcnCountWords(source);
+    TEST_ASSERT_TRUE(result.state.ok);
+    TEST_ASSERT_EQUAL_INT(2, result.count);
+}
+
+void testWordCountInLongText(void) {
+    char text[1000];
+    size_t size = 0;
+    size_t expected = 0;
+    for (size_t length = 1; size + length + 2 <= sizeof(text); ++length) {
+        memset(text + size, 'w', length);
+        size += length;
+        text[size++] = (length % 3 == 0) ? '\n' : ' ';
+        ++expected;
+    }
+    RcnSourceText source = {
+        .text = text,
+        .size = size
+    };
+    RcnCountResult result = rcnCountWords(source);
+    TEST_ASSERT_TRUE(result.state.ok);
+    TEST_ASSERT_EQUAL_INT(expected, result.count);
+}
+
 void testWordCountWithInvalidInputFails(void) {
     RcnSourceText source = {
         .text = NULL,
@@ -153,9 +184,32 @@ void testWordCountEncodedTextUTF16LE(void) {
     freeSourceFile(file);
 }
 
+void testWordCountUTF16ClassifiesCodeUnits(void) {
+    // BOM, ' ', 'a', U+0A20 with the bytes of a space and a newline, ' ',
+    // 'b', U+3000 ideographic space which is not white space in "C"
+    char textLE[] =
+        "\xff\xfe" " \x00" "a\x00" "\x20\x0a" " \x00" "b\x00" "\x00\x30";
+    char textBE[] =
+        "\xfe\xff" "\x00 " "\x00" "a" "\x0a\x20" "\x00 " "\x00" "b" "\x30\x00";
+    RcnSourceText source = {
+        .text = textLE,
+        .size = sizeof(textLE) - 1
+    };
+    RcnCountResult result = rcnCountWords(source);
+    TEST_ASSERT_TRUE(result.state.ok);
+    TEST_ASSERT_EQUAL_INT(2, result.count);
+    source.text = textBE;
+    source.size = sizeof(textBE) - 1;
+    result = rcnCountWords(source);
+    TEST_ASSERT_TRUE(result.state.ok);
+    TEST_ASSERT_EQUAL_INT(2, result.count);
+}
+
 int main(void) {
     UNITY_BEGIN();
     RUN_TEST(testWordCountIsCorrect);
+    RUN_TEST(testWordCountIgnoresNonASCIIWhiteSpace);
+    RUN_TEST(testWordCountInLongText);
     RUN_TEST(testWordCountWithInvalidInputFails);
     RUN_TEST(testWordCountWithTooLargeTextInputFails);
     RUN_TEST(testWordCountWithZeroLengthInputSucceeds);
@@ -165,5 +219,6 @@ int main(void) {
     RUN_TEST(testWordCountEncodedTextUTF8WithBOM);
     RUN_TEST(testWordCountEncodedTextUTF16BE);
     RUN_TEST(testWordCountEncodedTextUTF16LE);
+    RUN_TEST(testWordCountUTF16ClassifiesCodeUnits);
     return UNITY_END();
 }
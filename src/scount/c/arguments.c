@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
 
@@ -23,6 +24,33 @@
 #define RECKON_VERSION "unknown"
 #endif
 
+/**
+ * The maximum number of jobs that can be specified with `--jobs`.
+ */
+static const unsigned long MAX_JOBS = 1024;
+
+/**
+ * The maximum number of seconds that can be specified with `--parse-timeout`.
+ */
+static const unsigned long MAX_PARSE_TIMEOUT = 86400;
+
+/**
+ * Parses the value of an option that takes a decimal number of at
+ * most the specified maximum.
+ * Returns zero if the specified value is not such a number.
+ */
+static unsigned int parseNumber(const char* value, unsigned long max) {
+    if (value == NULL || value[0] < '0' || value[0] > '9') {
+        return 0;
+    }
+    char* end = NULL;
+    const unsigned long number = strtoul(value, &end, 10);
+    if (*end != '\0' || number > max) {
+        return 0;
+    }
+    return (unsigned int) number;
+}
+
 AppArgs parseArgs(int argc, char** argv) {
     AppArgs args = {0};
     for (int i = 1; i < argc; ++i) {
@@ -30,6 +58,30 @@ AppArgs parseArgs(int argc, char** argv) {
             args.annotateCounts = true;
         } else if (strcmp(argv[i], "--verbose") == 0) {
             args.verbose = true;
+        } else if (strcmp(argv[i], "--map-files") == 0) {
+            args.mapFiles = true;
+        } else if (strcmp(argv[i], "--skip-binary") == 0) {
+            args.skipBinary = true;
+        } else if (strcmp(argv[i], "--jobs") == 0
+                || strcmp(argv[i], "-j") == 0) {
+
+            args.jobs = parseNumber(
+                (i + 1 < argc) ? argv[++i] : NULL,
+                MAX_JOBS
+            );
+            if (args.jobs == 0) {
+                args.errorMessage = "Invalid number of jobs specified.";
+                break;
+            }
+        } else if (strcmp(argv[i], "--parse-timeout") == 0) {
+            args.parseTimeout = parseNumber(
+                (i + 1 < argc) ? argv[++i] : NULL,
+                MAX_PARSE_TIMEOUT
+            );
+            if (args.parseTimeout == 0) {
+                args.errorMessage = "Invalid parse timeout specified.";
+                break;
+            }
         } else if (strcmp(argv[i], "--help") == 0
                 || strcmp(argv[i], "-?") == 0) {
 
@@ -51,14 +103,17 @@ AppArgs parseArgs(int argc, char** argv) {
             }
         }
     }
-    if (args.inputPath == NULL) {
+    if (args.inputPath == NULL && args.errorMessage == NULL) {
         args.errorMessage = "No input path specified.";
     }
     return args;
 }
 
 void showUsage(void) {
-    logI("Usage: scount [--verbose] [--annotate-counts] <PATH>");
+    logI(
+        "Usage: scount [--verbose] [--jobs <N>] [--map-files] "
+        "[--skip-binary] [--parse-timeout <S>] [--annotate-counts] <PATH>"
+    );
 }
 
 void showVersion(AppArgs args) {
@@ -95,6 +150,21 @@ void showHelpText(void) {
     logI("  [--annotate-counts] Mark counted logical lines and output the result.");
     logI("                      This option can only be used on a single file input.");
     logI(" ");
+    logI("  [-j|--jobs <N>]     Process files with up to N parallel jobs.");
+    logI("                      Must be in the range [1, 1024]. Defaults to 1.");
+    logI(" ");
+    logI("  [--map-files]       Map file contents into memory instead of copying them.");
+    logI("                      Files must not be modified while they are counted.");
+    logI(" ");
+    logI("  [--skip-binary]     Skip files whose content appears to be binary.");
+    logI("                      Skipped files do not contribute to the totals.");
+    logI(" ");
+    logI("  [--parse-timeout <S>]");
+    logI("                      Skip the logical lines of files whose parsing takes");
+    logI("                      longer than S seconds. Must be in the range [1, 86400].");
+    logI("                      The counts then depend on the speed of the host.");
+    logI("                      Defaults to no time limit.");
+    logI(" ");
     logI("  [--verbose]         Enable verbose output.");
     logI(" ");
     logI("  [-#|--version]      Show program version information.");
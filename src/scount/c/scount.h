@@ -46,14 +46,18 @@ typedef enum ExitStatus {
  * Structure holding all parsed application arguments.
  */
 typedef struct AppArgs {
-    char* inputPath;     // The input `<PATH>` to process
-    char* errorMessage;  // Error message in case of invalid input
-    int indexUnknown;    // Index into `argv` when unknown arg found, or zero
-    bool annotateCounts; // Option: `--annotate-counts`
-    bool verbose;        // Option: `--verbose`
-    bool version;        // Option: `-#|--version`
-    bool versionShort;   // Option: `-#`
-    bool help;           // Option: `-?`|`--help`
+    char* inputPath;           // The input `<PATH>` to process
+    char* errorMessage;        // Error message in case of invalid input
+    int indexUnknown;          // Index into `argv` of unknown arg, or zero
+    unsigned int jobs;         // Option: `-j|--jobs <N>`
+    unsigned int parseTimeout; // Option: `--parse-timeout <S>`
+    bool annotateCounts;       // Option: `--annotate-counts`
+    bool mapFiles;             // Option: `--map-files`
+    bool skipBinary;           // Option: `--skip-binary`
+    bool verbose;              // Option: `--verbose`
+    bool version;              // Option: `-#|--version`
+    bool versionShort;         // Option: `-#`
+    bool help;                 // Option: `-?`|`--help`
 } AppArgs;
 
 /**
@@ -16,11 +16,28 @@
 
 #include <stdlib.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 
 #include "reckon/reckon.h"
 #include "scount.h"
 
+/**
+ * The number of source files to read ahead of the processing.
+ */
+static const uint32_t READ_AHEAD_FILES = 16;
+
+/**
+ * The minimum size in bytes of a file content for it to be counted in
+ * multiple segments concurrently.
+ */
+static const uint32_t SPLIT_THRESHOLD = 16 * 1024 * 1024;
+
+/**
+ * The number of microseconds in a second.
+ */
+static const uint64_t MICROS_PER_SECOND = 1000 * 1000;
+
 static void reportError(const char* path, RcnCountStatistics* stats) {
     if (stats->state.errorCode == RCN_ERR_INVALID_INPUT) {
         logE("Invalid input path: '%s'", path);
@@ -57,6 +74,19 @@ static void reportInputVerbose(const char* path, RcnCountStatistics* stats) {
     }
 }
 
+static void reportCancelledFiles(RcnCountStatistics* stats) {
+    for (size_t i = 0; i < stats->count.size; ++i) {
+        const RcnCountResultGroup* result = &stats->count.results[i];
+        if (result->state.errorCode == RCN_ERR_PARSE_CANCELLED) {
+            logW(
+                "Skipped file: '%s' (%s)",
+                stats->count.files[i].path,
+                result->state.errorMessage
+            );
+        }
+    }
+}
+
 static void reportNothingWasProc(const char* path, RcnCountStatistics* stats) {
     if (stats->count.size == 1) {
         const RcnSourceFile* const file = &stats->count.files[0];
@@ -81,14 +111,21 @@ ExitStatus outputStatistics(AppArgs args) {
     if (!path) {
         return APP_EXIT_INVALID_INPUT;
     }
-    RcnCountStatistics* const stats = rcnCreateCountStatistics(path);
+    RcnStatOptions options = {0};
+    options.threads = args.jobs;
+    options.readAhead = READ_AHEAD_FILES;
+    options.mapFileContent = args.mapFiles;
+    options.skipBinaryContent = args.skipBinary;
+    options.splitThreshold = SPLIT_THRESHOLD;
+    options.parseTimeoutMicros = args.parseTimeout * MICROS_PER_SECOND;
+    RcnCountStatistics* const stats = rcnCountPath(path, options);
     if(!stats) {
         // LCOV_EXCL_START
         logE("Failed to create count statistics for path: '%s'", path);
         return APP_EXIT_INVALID_INPUT;
         // LCOV_EXCL_STOP
     }
-    if(stats->state.errorCode != RCN_ERR_NONE) {
+    if(stats->count.files == NULL) {
         reportError(path, stats);
         rcnFreeCountStatistics(stats);
         return APP_EXIT_INVALID_INPUT;
@@ -97,9 +134,6 @@ ExitStatus outputStatistics(AppArgs args) {
         reportInputVerbose(path, stats);
     }
 
-    RcnStatOptions options = {0};
-    rcnCount(stats, options);
-
     const RcnErrorCode errorCode = stats->state.errorCode;
     if (!stats->state.ok && errorCode != RCN_ERR_UNSUPPORTED_FORMAT) {
         reportError(path, stats);
@@ -107,6 +141,8 @@ ExitStatus outputStatistics(AppArgs args) {
         return APP_EXIT_INVALID_INPUT;
     }
 
+    reportCancelledFiles(stats);
+
     if (stats->count.sizeProcessed == 0) {
         reportNothingWasProc(path, stats);
         rcnFreeCountStatistics(stats);
@@ -124,6 +124,56 @@ function test_scount_with_directory_that_contains_file_with_syntax_error() {
   assert_stderr_is_empty;
 }
 
+function test_scount_with_multiple_jobs_prints_same_output_as_sequential() {
+  run_app --jobs 4 "${TEST_RES_DIR}/mixed";
+  assert_exit_status $EXIT_SUCCESS;
+  assert_stdout_equals_file "expected/mixed.txt";
+  assert_stderr_is_empty;
+}
+
+function test_scount_with_multiple_jobs_and_file_with_syntax_error() {
+  run_app -j 3 "${TEST_RES_DIR}/mixedWithSyntaxError";
+  assert_exit_status $EXIT_SUCCESS;
+  assert_stdout_equals_file "expected/mixedWithSyntaxError.txt";
+  assert_stderr_is_empty;
+}
+
+function test_scount_with_mapped_files_prints_same_output_as_copied() {
+  run_app --map-files --jobs 4 "${TEST_RES_DIR}/mixed";
+  assert_exit_status $EXIT_SUCCESS;
+  assert_stdout_equals_file "expected/mixed.txt";
+  assert_stderr_is_empty;
+}
+
+function test_scount_with_parse_timeout_prints_same_output_as_without() {
+  run_app --parse-timeout 3600 "${TEST_RES_DIR}/mixed";
+  assert_exit_status $EXIT_SUCCESS;
+  assert_stdout_equals_file "expected/mixed.txt";
+  assert_stderr_is_empty;
+}
+
+function test_scount_counts_binary_file_in_directory_by_default() {
+  run_app "${TEST_RES_DIR}/mixedWithBinaryFile";
+  assert_exit_status $EXIT_SUCCESS;
+  assert_stdout_equals_file "expected/mixedWithBinaryFile.txt";
+  assert_stderr_is_empty;
+}
+
+function test_scount_with_skip_binary_excludes_binary_file_from_totals() {
+  run_app --skip-binary "${TEST_RES_DIR}/mixedWithBinaryFile";
+  assert_exit_status $EXIT_SUCCESS;
+  assert_stdout_equals_file "expected/mixedWithBinaryFileSkipped.txt";
+  assert_stderr_is_empty;
+}
+
+function test_scount_counts_single_binary_file_by_default() {
+  run_app "${TEST_RES_DIR}/mixedWithBinaryFile/image.txt";
+  assert_exit_status $EXIT_SUCCESS;
+  assert_stdout_contains "File: image.txt";
+  assert_stdout_contains "Source Size in Bytes  (SZE):        512";
+  assert_stderr_is_empty;
+}
+
 function test_scount_with_file_that_has_syntax_error() {
   local file="${TEST_RES_DIR}/mixedWithSyntaxError/has_syntax_error.c";
   run_app "$file";
@@ -47,6 +47,29 @@ function test_executing_scount_with_multiple_path_arguments_prints_error() {
   assert_stdout_is_empty;
 }
 
+function test_executing_scount_with_invalid_number_of_jobs_prints_error() {
+  run_app --jobs 0 "${TEST_PROJECT_DIR}/src/lib/tests/res";
+  assert_exit_status $EXIT_INVALID_ARGUMENT;
+  assert_stderr_equals "Invalid number of jobs specified.";
+  assert_stdout_is_empty;
+}
+
+function test_executing_scount_with_invalid_parse_timeout_prints_error() {
+  run_app --parse-timeout 0 "${TEST_PROJECT_DIR}/src/lib/tests/res";
+  assert_exit_status $EXIT_INVALID_ARGUMENT;
+  assert_stderr_equals "Invalid parse timeout specified.";
+  assert_stdout_is_empty;
+}
+
+function test_scount_with_skip_binary_prints_error_for_single_binary_file() {
+  local file="${TEST_PROJECT_DIR}/src/lib/tests/res/binary/image.txt";
+  run_app --skip-binary "$file";
+  assert_exit_status $EXIT_INVALID_INPUT;
+  assert_stdout_is_empty;
+  assert_stderr_equals "An error has occurred for: '${file}'${_NL}" \
+                       "The file content is binary (0x07)";
+}
+
 function test_scount_prints_error_when_annotating_source_of_nonexistent_file() {
   run_app --annotate-counts "${TEST_PROJECT_DIR}/this-file-does-not-exist";
   assert_exit_status $EXIT_INVALID_INPUT;
@@ -179,6 +179,142 @@ void testHelpWithInputSetsHelpAndInput(void) {
     TEST_ASSERT_NULL(args.errorMessage);
 }
 
+void testJobsOptionSetsJobs(void) {
+    char* argv[] = { "scount", "--jobs", "4", "File.java" };
+    int argc = (int)(sizeof(argv) / sizeof(argv[0]));
+    AppArgs args = parseArgs(argc, argv);
+    bool isValid = isInputValid(args);
+    TEST_ASSERT_TRUE(isValid);
+    TEST_ASSERT_EQUAL_UINT(4, args.jobs);
+    TEST_ASSERT_EQUAL_STRING("File.java", args.inputPath);
+    TEST_ASSERT_NULL(args.errorMessage);
+}
+
+void testJobsAliasSetsJobs(void) {
+    char* argv[] = { "scount", "File.java", "-j", "2" };
+    int argc = (int)(sizeof(argv) / sizeof(argv[0]));
+    AppArgs args = parseArgs(argc, argv);
+    bool isValid = isInputValid(args);
+    TEST_ASSERT_TRUE(isValid);
+    TEST_ASSERT_EQUAL_UINT(2, args.jobs);
+    TEST_ASSERT_EQUAL_STRING("File.java", args.inputPath);
+}
+
+void testJobsDefaultIsZero(void) {
+    char* argv[] = { "scount", "File.java" };
+    int argc = (int)(sizeof(argv) / sizeof(argv[0]));
+    AppArgs args = parseArgs(argc, argv);
+    TEST_ASSERT_EQUAL_UINT(0, args.jobs);
+}
+
+void testInvalidJobsSetsMessageInvalidJobs(void) {
+    char* invalidValues[] = { "0", "abc", "4x", "-1", "1025", "" };
+    const size_t size = sizeof(invalidValues) / sizeof(invalidValues[0]);
+    for (size_t i = 0; i < size; ++i) {
+        char* argv[] = { "scount", "--jobs", invalidValues[i], "File.java" };
+        int argc = (int)(sizeof(argv) / sizeof(argv[0]));
+        AppArgs args = parseArgs(argc, argv);
+        bool isValid = isInputValid(args);
+        TEST_ASSERT_FALSE(isValid);
+        TEST_ASSERT_EQUAL_STRING(
+            "Invalid number of jobs specified.",
+            args.errorMessage
+        );
+    }
+}
+
+void testJobsWithoutValueSetsMessageInvalidJobs(void) {
+    char* argv[] = { "scount", "File.java", "--jobs" };
+    int argc = (int)(sizeof(argv) / sizeof(argv[0]));
+    AppArgs args = parseArgs(argc, argv);
+    bool isValid = isInputValid(args);
+    TEST_ASSERT_FALSE(isValid);
+    TEST_ASSERT_EQUAL_STRING(
+        "Invalid number of jobs specified.",
+        args.errorMessage
+    );
+}
+
+void testMapFilesOptionSetsMapFiles(void) {
+    char* argv[] = { "scount", "--map-files", "File.java" };
+    int argc = (int)(sizeof(argv) / sizeof(argv[0]));
+    AppArgs args = parseArgs(argc, argv);
+    bool isValid = isInputValid(args);
+    TEST_ASSERT_TRUE(isValid);
+    TEST_ASSERT_TRUE(args.mapFiles);
+    TEST_ASSERT_EQUAL_STRING("File.java", args.inputPath);
+}
+
+void testMapFilesDefaultIsFalse(void) {
+    char* argv[] = { "scount", "File.java" };
+    int argc = (int)(sizeof(argv) / sizeof(argv[0]));
+    AppArgs args = parseArgs(argc, argv);
+    TEST_ASSERT_FALSE(args.mapFiles);
+}
+
+void testParseTimeoutOptionSetsParseTimeout(void) {
+    char* argv[] = { "scount", "--parse-timeout", "30", "File.java" };
+    int argc = (int)(sizeof(argv) / sizeof(argv[0]));
+    AppArgs args = parseArgs(argc, argv);
+    bool isValid = isInputValid(args);
+    TEST_ASSERT_TRUE(isValid);
+    TEST_ASSERT_EQUAL_UINT(30, args.parseTimeout);
+    TEST_ASSERT_EQUAL_STRING("File.java", args.inputPath);
+}
+
+void testParseTimeoutDefaultIsZero(void) {
+    char* argv[] = { "scount", "File.java" };
+    int argc = (int)(sizeof(argv) / sizeof(argv[0]));
+    AppArgs args = parseArgs(argc, argv);
+    TEST_ASSERT_EQUAL_UINT(0, args.parseTimeout);
+}
+
+void testInvalidParseTimeoutSetsMessageInvalidParseTimeout(void) {
+    char* invalidValues[] = { "0", "abc", "4s", "-1", "86401", "" };
+    const size_t size = sizeof(invalidValues) / sizeof(invalidValues[0]);
+    for (size_t i = 0; i < size; ++i) {
+        char* argv[] = {
+            "scount",
+            "--parse-timeout",
+            invalidValues[i],
+            "File.java"
+        };
+        int argc = (int)(sizeof(argv) / sizeof(argv[0]));
+        AppArgs args = parseArgs(argc, argv);
+        bool isValid = isInputValid(args);
+        TEST_ASSERT_FALSE(isValid);
+        TEST_ASSERT_EQUAL_STRING(
+            "Invalid parse timeout specified.",
+            args.errorMessage
+        );
+    }
+    char* argv[] = { "scount", "File.java", "--parse-timeout" };
+    int argc = (int)(sizeof(argv) / sizeof(argv[0]));
+    AppArgs args = parseArgs(argc, argv);
+    TEST_ASSERT_FALSE(isInputValid(args));
+    TEST_ASSERT_EQUAL_STRING(
+        "Invalid parse timeout specified.",
+        args.errorMessage
+    );
+}
+
+void testSkipBinaryOptionSetsSkipBinary(void) {
+    char* argv[] = { "scount", "File.java", "--skip-binary" };
+    int argc = (int)(sizeof(argv) / sizeof(argv[0]));
+    AppArgs args = parseArgs(argc, argv);
+    bool isValid = isInputValid(args);
+    TEST_ASSERT_TRUE(isValid);
+    TEST_ASSERT_TRUE(args.skipBinary);
+    TEST_ASSERT_EQUAL_STRING("File.java", args.inputPath);
+}
+
+void testSkipBinaryDefaultIsFalse(void) {
+    char* argv[] = { "scount", "File.java" };
+    int argc = (int)(sizeof(argv) / sizeof(argv[0]));
+    AppArgs args = parseArgs(argc, argv);
+    TEST_ASSERT_FALSE(args.skipBinary);
+}
+
 int main(void) {
     UNITY_BEGIN();
     RUN_TEST(testNoArgsSetsMessageNoInputAndInvalid);
@@ -193,5 +329,17 @@ int main(void) {
     RUN_TEST(testMultipleInputsSetsMessageMultiple);
     RUN_TEST(testFlagsAndInputOrderMixed);
     RUN_TEST(testHelpWithInputSetsHelpAndInput);
+    RUN_TEST(testJobsOptionSetsJobs);
+    RUN_TEST(testJobsAliasSetsJobs);
+    RUN_TEST(testJobsDefaultIsZero);
+    RUN_TEST(testInvalidJobsSetsMessageInvalidJobs);
+    RUN_TEST(testJobsWithoutValueSetsMessageInvalidJobs);
+    RUN_TEST(testMapFilesOptionSetsMapFiles);
+    RUN_TEST(testMapFilesDefaultIsFalse);
+    RUN_TEST(testParseTimeoutOptionSetsParseTimeout);
+    RUN_TEST(testParseTimeoutDefaultIsZero);
+    RUN_TEST(testInvalidParseTimeoutSetsMessageInvalidParseTimeout);
+    RUN_TEST(testSkipBinaryOptionSetsSkipBinary);
+    RUN_TEST(testSkipBinaryDefaultIsFalse);
     return UNITY_END();
 }